@@ -0,0 +1,85 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * LEO Satellite Distributed Example
+ * Runs the echo of the LEO satellite example with the planes partitioned across MPI ranks,
+ * e.g. mpirun -np 2 ./waf --run leo-satellite-distributed-example
+ *
+ * ENSC 427: Communication Networks
+ * Spring 2020
+ * Team 11
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/leo-satellite-config.h"
+#include "ns3/applications-module.h"
+#include "ns3/mpi-interface.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("LeoSatelliteDistributedExample");
+
+int 
+main (int argc, char *argv[])
+{
+#ifdef NS3_MPI
+  uint32_t n_planes = 6;
+  uint32_t n_sats_per_plane = 8;
+  double altitude = 2000;
+  std::string ground_stations_file = "";
+  bool nullmsg = false;
+
+  CommandLine cmd;
+  cmd.AddValue ("n_planes", "Number of planes in satellite constellation", n_planes);
+  cmd.AddValue ("n_sats_per_plane", "Number of satellites per plane in the satellite constellation", n_sats_per_plane);
+  cmd.AddValue ("altitude", "Altitude of satellites in constellation in kilometers ... must be between 500 and 2000", altitude);
+  cmd.AddValue ("ground_stations", "File with the latitude and longitude of the ground stations, the echo runs between the first two", ground_stations_file);
+  cmd.AddValue ("nullmsg", "Synchronize the ranks with null messages rather than granted time windows", nullmsg);
+  cmd.Parse (argc,argv);
+
+  //null messages are only exchanged with the ranks linked to at the start, so the constellation aborts
+  //when a handover links other ranks, granted time windows keep working then
+  GlobalValue::Bind ("SimulatorImplementationType",
+                     StringValue (nullmsg ? "ns3::NullMessageSimulatorImpl" : "ns3::DistributedSimulatorImpl"));
+  //the ranks must be known before the constellation is created
+  MpiInterface::Enable (&argc, &argv);
+  uint32_t system_id = MpiInterface::GetSystemId ();
+
+  Config::SetDefault ("ns3::LeoSatelliteConfig::GroundStationsFile", StringValue (ground_stations_file));
+  Config::SetDefault ("ns3::LeoSatelliteConfig::ScheduleHandovers", BooleanValue (true));
+
+  LogComponentEnable("UdpEchoClientApplication", LOG_LEVEL_INFO);
+  LogComponentEnable("UdpEchoServerApplication", LOG_LEVEL_INFO);
+
+  //every rank creates the whole constellation, only the nodes of its planes are simulated there
+  LeoSatelliteConfig sat_network(n_planes, n_sats_per_plane, altitude);
+
+  Ptr<Node> server = sat_network.ground_stations.Get(1);
+  if (server->GetSystemId() == system_id)
+  {
+    UdpEchoServerHelper echoServer (9);
+    ApplicationContainer serverApps = echoServer.Install(server);
+    serverApps.Start (Seconds (1.0));
+    serverApps.Stop (Seconds (2000.0));
+  }
+
+  Ptr<Node> client = sat_network.ground_stations.Get(0);
+  if (client->GetSystemId() == system_id)
+  {
+    UdpEchoClientHelper echoClient (sat_network.ground_station_interfaces[1].GetAddress(0), 9);
+    echoClient.SetAttribute("MaxPackets", UintegerValue (20));
+    echoClient.SetAttribute("Interval", TimeValue(Seconds(100.0)));
+    echoClient.SetAttribute("PacketSize", UintegerValue (1024));
+    ApplicationContainer clientApps = echoClient.Install (client);
+    clientApps.Start (Seconds (2.0));
+    clientApps.Stop (Seconds (2000.0));
+  }
+
+  Simulator::Stop(Seconds(2000));
+  Simulator::Run();
+  Simulator::Destroy ();
+  MpiInterface::Disable ();
+  return 0;
+#else
+  NS_FATAL_ERROR ("Can't use distributed simulator without MPI compiled in");
+#endif
+}
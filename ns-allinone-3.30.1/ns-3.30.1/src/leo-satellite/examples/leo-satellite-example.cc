@@ -25,14 +25,24 @@ main (int argc, char *argv[])
   uint32_t n_planes = 3;
   uint32_t n_sats_per_plane = 4;
   double altitude = 2000;
+  std::string ground_stations_file = "";
+  std::string link_state_file = "";
 
   CommandLine cmd;
   cmd.AddValue ("n_planes", "Number of planes in satellite constellation", n_planes);
   cmd.AddValue ("n_sats_per_plane", "Number of satellites per plane in the satellite constellation", n_sats_per_plane);
   cmd.AddValue ("altitude", "Altitude of satellites in constellation in kilometers ... must be between 500 and 2000", altitude);
 
+  cmd.AddValue ("ground_stations", "File with the latitude and longitude of the ground stations, the echo runs between the first two", ground_stations_file);
+  cmd.AddValue ("link_state", "CSV file the state of every inter-plane and ground link is written to on every update", link_state_file);
+
   cmd.Parse (argc,argv);
 
+  Config::SetDefault ("ns3::LeoSatelliteConfig::GroundStationsFile", StringValue (ground_stations_file));
+  Config::SetDefault ("ns3::LeoSatelliteConfig::LinkStateFile", StringValue (link_state_file));
+  //links are updated by the constellation itself whenever a satellite pairing or ground attachment changes
+  Config::SetDefault ("ns3::LeoSatelliteConfig::ScheduleHandovers", BooleanValue (true));
+
   LogComponentEnable("UdpEchoClientApplication", LOG_LEVEL_INFO);
   LogComponentEnable("UdpEchoServerApplication", LOG_LEVEL_INFO);
 
@@ -56,13 +66,7 @@ main (int argc, char *argv[])
   FlowMonitorHelper flowmonHelper;
   flowmonHelper.InstallAll();
 
-  for(uint32_t i=0; i<19; i++)
-  {
-    Simulator::Stop(Seconds(100));
-    Simulator::Run();
-    sat_network.UpdateLinks();
-  }
-  Simulator::Stop(Seconds(100));
+  Simulator::Stop(Seconds(2000));
   Simulator::Run();
  
   Simulator::Destroy ();
@@ -0,0 +1,80 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * LEO Satellite Routing Benchmark
+ * Compares the time spent updating links and routes with global, incremental and grid routing
+ *
+ * ENSC 427: Communication Networks
+ * Spring 2020
+ * Team 11
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/leo-satellite-config.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("LeoSatelliteRoutingBenchmark");
+
+/* Builds the constellation with the given routing and runs n_updates link updates,
+   returns the wall clock time [ms] spent in the updates */
+int64_t
+RunUpdates (LeoSatelliteConfig::RoutingType routing, uint32_t n_planes, uint32_t n_sats_per_plane,
+            double altitude, uint32_t n_updates, double interval, int64_t &setup_time)
+{
+  Config::SetDefault ("ns3::LeoSatelliteConfig::Routing", EnumValue (routing));
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Ptr<LeoSatelliteConfig> sat_network = CreateObject<LeoSatelliteConfig> (n_planes, n_sats_per_plane, altitude);
+  setup_time = clock.End ();
+
+  int64_t update_time = 0;
+  for (uint32_t i=0; i<n_updates; i++)
+  {
+    Simulator::Stop (Seconds (interval));
+    Simulator::Run ();
+    clock.Start ();
+    sat_network->UpdateLinks ();
+    update_time += clock.End ();
+  }
+
+  Simulator::Destroy ();
+  return update_time;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t n_planes = 7;
+  uint32_t n_sats_per_plane = 20;
+  double altitude = 1000;
+  uint32_t n_updates = 20;
+  double interval = 100;
+
+  CommandLine cmd;
+  cmd.AddValue ("n_planes", "Number of planes in satellite constellation", n_planes);
+  cmd.AddValue ("n_sats_per_plane", "Number of satellites per plane in the satellite constellation", n_sats_per_plane);
+  cmd.AddValue ("altitude", "Altitude of satellites in constellation in kilometers ... must be between 500 and 2000", altitude);
+  cmd.AddValue ("n_updates", "Number of link updates to time", n_updates);
+  cmd.AddValue ("interval", "Time between link updates in seconds", interval);
+  cmd.Parse (argc,argv);
+
+  int64_t global_setup, incremental_setup, grid_setup;
+  int64_t global = RunUpdates (LeoSatelliteConfig::GLOBAL_ROUTING, n_planes, n_sats_per_plane, altitude, n_updates, interval, global_setup);
+  int64_t incremental = RunUpdates (LeoSatelliteConfig::INCREMENTAL_ROUTING, n_planes, n_sats_per_plane, altitude, n_updates, interval, incremental_setup);
+  int64_t grid = RunUpdates (LeoSatelliteConfig::GRID_ROUTING, n_planes, n_sats_per_plane, altitude, n_updates, interval, grid_setup);
+
+  std::cout << n_planes << " planes x " << n_sats_per_plane << " satellites, " << n_updates << " updates every " << interval << " s" << std::endl;
+  std::cout << "Global routing:      setup " << global_setup << " ms, updates " << global << " ms" << std::endl;
+  std::cout << "Incremental routing: setup " << incremental_setup << " ms, updates " << incremental << " ms" << std::endl;
+  std::cout << "Grid routing:        setup " << grid_setup << " ms, updates " << grid << " ms" << std::endl;
+  if (incremental > 0)
+  {
+    std::cout << "Incremental update speedup: " << double (global)/incremental << "x" << std::endl;
+  }
+  if (grid > 0)
+  {
+    std::cout << "Grid update speedup: " << double (global)/grid << "x" << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,69 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * LEO Satellite Startup Benchmark
+ * Measures the time spent building constellations with different numbers of planes
+ *
+ * ENSC 427: Communication Networks
+ * Spring 2020
+ * Team 11
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/leo-satellite-config.h"
+#include <sstream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("LeoSatelliteStartupBenchmark");
+
+/* Builds the constellation with the given routing,
+   returns the wall clock time [ms] spent in the constructor */
+int64_t
+RunSetup (LeoSatelliteConfig::RoutingType routing, uint32_t n_planes, uint32_t n_sats_per_plane, double altitude)
+{
+  Config::SetDefault ("ns3::LeoSatelliteConfig::Routing", EnumValue (routing));
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Ptr<LeoSatelliteConfig> sat_network = CreateObject<LeoSatelliteConfig> (n_planes, n_sats_per_plane, altitude);
+  int64_t setup_time = clock.End ();
+
+  sat_network = 0;
+  Simulator::Destroy ();
+  return setup_time;
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::string planes = "6,12,24";
+  uint32_t n_sats_per_plane = 22;
+  double altitude = 550;
+  std::string routing = "Incremental";
+
+  CommandLine cmd;
+  cmd.AddValue ("planes", "Comma separated numbers of planes in the satellite constellations to time", planes);
+  cmd.AddValue ("n_sats_per_plane", "Number of satellites per plane in the satellite constellation", n_sats_per_plane);
+  cmd.AddValue ("altitude", "Altitude of satellites in constellation in kilometers ... must be between 500 and 2000", altitude);
+  cmd.AddValue ("routing", "Routing of the constellation: Global, Incremental or Grid", routing);
+  cmd.Parse (argc,argv);
+
+  LeoSatelliteConfig::RoutingType routing_type = LeoSatelliteConfig::INCREMENTAL_ROUTING;
+  if (routing == "Global")
+    routing_type = LeoSatelliteConfig::GLOBAL_ROUTING;
+  else if (routing == "Grid")
+    routing_type = LeoSatelliteConfig::GRID_ROUTING;
+  else
+    NS_ABORT_MSG_UNLESS (routing == "Incremental", "Unknown routing " << routing);
+
+  std::cout << n_sats_per_plane << " satellites per plane, " << routing << " routing" << std::endl;
+  std::istringstream plane_list (planes);
+  std::string n_planes;
+  while (std::getline (plane_list, n_planes, ','))
+  {
+    uint32_t n = std::atoi (n_planes.c_str ());
+    NS_ABORT_MSG_IF (n == 0, "Invalid number of planes " << n_planes);
+    std::cout << n << " planes: setup " << RunSetup (routing_type, n, n_sats_per_plane, altitude) << " ms" << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,36 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * LEO Satellite Routing Helper
+ * Installs the constellation routing protocol on the nodes of a satellite network
+ *
+ * ENSC 427: Communication Networks
+ * Spring 2020
+ * Team 11
+ */
+
+#include "leo-satellite-routing-helper.h"
+#include "ns3/leo-satellite-routing.h"
+#include "ns3/node.h"
+
+namespace ns3 {
+
+LeoSatelliteRoutingHelper::LeoSatelliteRoutingHelper (Ptr<LeoSatelliteRouteManager> manager)
+  : m_manager (manager)
+{
+}
+
+LeoSatelliteRoutingHelper*
+LeoSatelliteRoutingHelper::Copy (void) const
+{
+  return new LeoSatelliteRoutingHelper (*this);
+}
+
+Ptr<Ipv4RoutingProtocol>
+LeoSatelliteRoutingHelper::Create (Ptr<Node> node) const
+{
+  Ptr<LeoSatelliteRouting> routing = CreateObject<LeoSatelliteRouting> ();
+  routing->SetRouteManager (m_manager);
+  return routing;
+}
+
+} // namespace ns3
@@ -0,0 +1,49 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * LEO Satellite Routing Helper
+ * Installs the constellation routing protocol on the nodes of a satellite network
+ *
+ * ENSC 427: Communication Networks
+ * Spring 2020
+ * Team 11
+ */
+#ifndef LEO_SATELLITE_ROUTING_HELPER_H
+#define LEO_SATELLITE_ROUTING_HELPER_H
+
+#include "ns3/ipv4-routing-helper.h"
+#include "ns3/leo-satellite-route-manager.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup leo-satellite
+ * \brief Helper class that adds ns3::LeoSatelliteRouting objects sharing one route manager
+ */
+class LeoSatelliteRoutingHelper : public Ipv4RoutingHelper
+{
+public:
+  /**
+   * \param manager the route manager answering the lookups of every installed protocol
+   */
+  LeoSatelliteRoutingHelper (Ptr<LeoSatelliteRouteManager> manager);
+
+  /**
+   * \returns pointer to clone of this LeoSatelliteRoutingHelper
+   */
+  LeoSatelliteRoutingHelper* Copy (void) const;
+
+  /**
+   * \param node the node on which the routing protocol will run
+   * \returns a newly-created routing protocol
+   *
+   * This method will be called by ns3::InternetStackHelper::Install
+   */
+  virtual Ptr<Ipv4RoutingProtocol> Create (Ptr<Node> node) const;
+
+private:
+  Ptr<LeoSatelliteRouteManager> m_manager;
+};
+
+} // namespace ns3
+
+#endif /* LEO_SATELLITE_ROUTING_HELPER_H */
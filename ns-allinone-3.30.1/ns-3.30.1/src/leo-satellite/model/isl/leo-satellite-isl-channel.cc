@@ -0,0 +1,253 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * LEO Satellite ISL Channel
+ * Point-to-point laser link whose far end can be re-pointed to another satellite
+ *
+ * ENSC 427: Communication Networks
+ * Spring 2020
+ * Team 11
+ */
+
+#include "leo-satellite-isl-channel.h"
+#include "leo-satellite-isl-net-device.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/node.h"
+#include "ns3/boolean.h"
+#include "ns3/mpi-interface.h"
+#include "ns3/leo-satellite-mobility.h"
+#include "ns3/leo-satellite-spatial-index.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LeoSatelliteIslChannel");
+
+NS_OBJECT_ENSURE_REGISTERED (LeoSatelliteIslChannel);
+
+TypeId
+LeoSatelliteIslChannel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LeoSatelliteIslChannel")
+    .SetParent<Channel> ()
+    .SetGroupName ("LeoSatellite")
+    .AddConstructor<LeoSatelliteIslChannel> ()
+    .AddAttribute ("Delay", "Propagation delay through the channel, "
+                   "used when the delay is not computed from the positions of the two ends. "
+                   "Least delay of packets to an end simulated by another MPI rank otherwise.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&LeoSatelliteIslChannel::m_delay),
+                   MakeTimeChecker ())
+    .AddAttribute ("ComputeDelay", "Compute the propagation delay of every packet from the positions "
+                   "of the two ends, when both have a mobility model.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&LeoSatelliteIslChannel::m_computeDelay),
+                   MakeBooleanChecker ())
+    .AddAttribute ("DelayRefreshInterval", "Interval over which the distance between the two ends "
+                   "is interpolated linearly from its values at the start and the end of the interval.",
+                   TimeValue (MilliSeconds (100)),
+                   MakeTimeAccessor (&LeoSatelliteIslChannel::m_refreshInterval),
+                   MakeTimeChecker (NanoSeconds (1)))
+  ;
+  return tid;
+}
+
+LeoSatelliteIslChannel::LeoSatelliteIslChannel ()
+  : m_refreshTime (-1),
+    m_refreshDistance (0),
+    m_distanceRate (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LeoSatelliteIslChannel::~LeoSatelliteIslChannel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+LeoSatelliteIslChannel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_device = 0;
+  m_peer = 0;
+  m_deviceMobility = 0;
+  m_peerMobility = 0;
+  Channel::DoDispose ();
+}
+
+void
+LeoSatelliteIslChannel::Connect (Ptr<LeoSatelliteIslNetDevice> device, Ptr<LeoSatelliteIslNetDevice> peer)
+{
+  NS_LOG_FUNCTION (this << device << peer);
+  NS_ASSERT_MSG (m_device == 0, "Channel already connected");
+  NS_ASSERT (device->GetChannel () == 0);
+  m_device = device;
+  device->SetChannel (this);
+  SetPeer (peer);
+}
+
+void
+LeoSatelliteIslChannel::SetPeer (Ptr<LeoSatelliteIslNetDevice> peer)
+{
+  NS_LOG_FUNCTION (this << peer);
+  if (peer == m_peer)
+  {
+    return;
+  }
+  if (m_peer != 0)
+  {
+    m_peer->SetChannel (0);
+  }
+  if (peer != 0)
+  {
+    Ptr<LeoSatelliteIslChannel> previous = DynamicCast<LeoSatelliteIslChannel> (peer->GetChannel ());
+    if (previous != 0)
+    {
+      previous->Remove (peer);
+    }
+    peer->SetChannel (this);
+  }
+  m_peer = peer;
+  UpdateEnds ();
+}
+
+void
+LeoSatelliteIslChannel::Remove (Ptr<LeoSatelliteIslNetDevice> device)
+{
+  NS_LOG_FUNCTION (this << device);
+  if (device == m_peer)
+  {
+    m_peer = 0;
+  }
+  else
+  {
+    NS_ASSERT (device == m_device);
+    m_device = 0;
+  }
+  device->SetChannel (0);
+  UpdateEnds ();
+}
+
+bool
+LeoSatelliteIslChannel::TransmitStart (Ptr<const Packet> packet, Ptr<LeoSatelliteIslNetDevice> src, Time txTime)
+{
+  NS_LOG_FUNCTION (this << packet << src << txTime);
+  Ptr<LeoSatelliteIslNetDevice> dst = GetOther (src);
+  if (dst == 0)
+  {
+    return false;
+  }
+  Time delay = GetDelay (Simulator::Now () + txTime);
+  if (dst->GetNode ()->GetSystemId () != src->GetNode ()->GetSystemId ())
+  {
+    // the other rank must not receive anything within the lookahead of the distributed simulator
+    MpiInterface::SendPacket (packet->Copy (), Simulator::Now () + txTime + Max (delay, m_delay),
+                              dst->GetNode ()->GetId (), dst->GetIfIndex ());
+    return true;
+  }
+  Simulator::ScheduleWithContext (dst->GetNode ()->GetId (), txTime + delay,
+                                  &LeoSatelliteIslNetDevice::Receive, dst, packet->Copy ());
+  return true;
+}
+
+Ptr<LeoSatelliteIslNetDevice>
+LeoSatelliteIslChannel::GetOther (Ptr<const LeoSatelliteIslNetDevice> device) const
+{
+  if (device == m_device)
+  {
+    return m_peer;
+  }
+  NS_ASSERT (device == m_peer);
+  return m_device;
+}
+
+std::size_t
+LeoSatelliteIslChannel::GetNDevices (void) const
+{
+  return (m_device != 0) + (m_peer != 0);
+}
+
+Ptr<NetDevice>
+LeoSatelliteIslChannel::GetDevice (std::size_t i) const
+{
+  NS_ASSERT (i < 2);
+  if (i == 0)
+  {
+    return (m_device != 0) ? m_device : m_peer;
+  }
+  return (m_device != 0) ? m_peer : 0;
+}
+
+double
+LeoSatelliteIslChannel::GetDistance (void)
+{
+  return GetDistance (Simulator::Now ());
+}
+
+Time
+LeoSatelliteIslChannel::GetDelay (void)
+{
+  return GetDelay (Simulator::Now ());
+}
+
+double
+LeoSatelliteIslChannel::GetDistance (Time time)
+{
+  if (m_deviceMobility == 0 || m_peerMobility == 0)
+  {
+    return 0;
+  }
+  if (m_refreshTime.IsNegative () || time < m_refreshTime || time >= m_refreshTime + m_refreshInterval)
+  {
+    Time end = time + m_refreshInterval;
+    m_refreshTime = time;
+    m_refreshDistance = LeoSatelliteSpatialIndex::GetStraightLineDistance (GetPosition (m_deviceMobility, time),
+                                                                           GetPosition (m_peerMobility, time));
+    double endDistance = LeoSatelliteSpatialIndex::GetStraightLineDistance (GetPosition (m_deviceMobility, end),
+                                                                            GetPosition (m_peerMobility, end));
+    m_distanceRate = (endDistance - m_refreshDistance)/m_refreshInterval.GetSeconds ();
+    NS_LOG_LOGIC ("Distance " << m_refreshDistance << " km at " << time.GetSeconds () << " s, changing by " << m_distanceRate << " km/s");
+  }
+  return m_refreshDistance + m_distanceRate*(time - m_refreshTime).GetSeconds ();
+}
+
+Time
+LeoSatelliteIslChannel::GetDelay (Time time)
+{
+  if (!m_computeDelay || m_deviceMobility == 0 || m_peerMobility == 0)
+  {
+    return m_delay;
+  }
+  return Seconds (GetDistance (time)*1000/299792458);
+}
+
+Vector
+LeoSatelliteIslChannel::GetPosition (Ptr<MobilityModel> mobility, Time time)
+{
+  Ptr<LeoSatelliteMobilityModel> satellite = DynamicCast<LeoSatelliteMobilityModel> (mobility);
+  if (satellite != 0)
+  {
+    return satellite->PropagatePosition (time);
+  }
+  //ground stations do not move
+  return mobility->GetPosition ();
+}
+
+void
+LeoSatelliteIslChannel::UpdateEnds (void)
+{
+  m_deviceMobility = (m_device != 0) ? m_device->GetNode ()->GetObject<MobilityModel> () : 0;
+  m_peerMobility = (m_peer != 0) ? m_peer->GetNode ()->GetObject<MobilityModel> () : 0;
+  m_refreshTime = Time (-1);
+  // the end that stays on the channel sees its link change as well as the one that came or left
+  if (m_device != 0)
+  {
+    m_device->UpdateLinkState ();
+  }
+  if (m_peer != 0)
+  {
+    m_peer->UpdateLinkState ();
+  }
+}
+
+} // namespace ns3
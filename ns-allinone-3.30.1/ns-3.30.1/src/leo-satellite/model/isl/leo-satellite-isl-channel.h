@@ -0,0 +1,160 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * LEO Satellite ISL Channel
+ * Point-to-point laser link whose far end can be re-pointed to another satellite
+ *
+ * ENSC 427: Communication Networks
+ * Spring 2020
+ * Team 11
+ */
+#ifndef LEO_SATELLITE_ISL_CHANNEL_H
+#define LEO_SATELLITE_ISL_CHANNEL_H
+
+#include "ns3/channel.h"
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/mobility-model.h"
+
+namespace ns3 {
+
+class LeoSatelliteIslNetDevice;
+
+/**
+ * \ingroup leo-satellite
+ * \brief point-to-point channel between two LeoSatelliteIslNetDevice.
+ *
+ * The first device is the fixed end of the link, the second one (the peer)
+ * can be replaced at any time with SetPeer (), in constant time. A device
+ * belongs to at most one channel: re-pointing a channel to a device takes
+ * the device away from its previous channel.
+ *
+ * The same channel is used for the links within a plane, the inter-plane
+ * links and the links between ground stations and satellites.
+ *
+ * When both ends have a mobility model and ComputeDelay is set, the
+ * propagation delay of every packet follows from the distance between the
+ * two ends when the packet has been sent. Positions are (latitude, longitude,
+ * altitude) vectors; satellites are propagated on their own with
+ * LeoSatelliteMobilityModel::PropagatePosition (), other nodes are taken at
+ * their current position. The distance is evaluated at the start and the end
+ * of a DelayRefreshInterval and interpolated linearly within it, so most
+ * packets cost a multiplication. The Delay attribute is used otherwise.
+ *
+ * When the two ends belong to different MPI ranks, packets are sent through
+ * MpiInterface to the MpiReceiver aggregated to the other end, after at least
+ * the Delay attribute, which the distributed simulators read as lookahead.
+ */
+class LeoSatelliteIslChannel : public Channel
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  LeoSatelliteIslChannel ();
+  virtual ~LeoSatelliteIslChannel ();
+
+  /**
+   * \brief Connect the fixed end and the peer of the link
+   * \param device the fixed end of the link
+   * \param peer the first peer of the link
+   */
+  void Connect (Ptr<LeoSatelliteIslNetDevice> device, Ptr<LeoSatelliteIslNetDevice> peer);
+
+  /**
+   * \brief Re-point the link to another peer
+   *
+   * The previous peer is left without channel
+   * \param peer the new peer, 0 to leave the link without peer
+   */
+  void SetPeer (Ptr<LeoSatelliteIslNetDevice> peer);
+
+  /**
+   * \brief Disconnect a device from this channel
+   * \param device one of the two ends of the link
+   */
+  void Remove (Ptr<LeoSatelliteIslNetDevice> device);
+
+  /**
+   * \brief Start sending a packet to the other end of the link
+   * \param packet the packet
+   * \param src the device sending the packet
+   * \param txTime transmission time of the packet
+   * \return false if the link has no other end
+   */
+  bool TransmitStart (Ptr<const Packet> packet, Ptr<LeoSatelliteIslNetDevice> src, Time txTime);
+
+  /**
+   * \param device one of the two ends of the link
+   * \return the other end of the link, 0 if there is none
+   */
+  Ptr<LeoSatelliteIslNetDevice> GetOther (Ptr<const LeoSatelliteIslNetDevice> device) const;
+
+  /**
+   * \return the number of connected devices, 2 when the link has a peer
+   */
+  virtual std::size_t GetNDevices (void) const;
+
+  /**
+   * \param i the index of the device, 0 for the fixed end and 1 for the peer
+   * \return the device
+   */
+  virtual Ptr<NetDevice> GetDevice (std::size_t i) const;
+
+  /**
+   * \return the distance between the two ends at the current simulation time [km],
+   *         0 if one of them has no mobility model
+   */
+  double GetDistance (void);
+
+  /**
+   * \return the propagation delay of a packet sent at the current simulation time
+   */
+  Time GetDelay (void);
+
+private:
+  virtual void DoDispose (void);
+
+  /**
+   * \param time the simulation time, not before the current one
+   * \return the distance between the two ends at time [km]
+   */
+  double GetDistance (Time time);
+
+  /**
+   * \param time the simulation time, not before the current one
+   * \return the propagation delay of a packet whose last bit leaves at time
+   */
+  Time GetDelay (Time time);
+
+  /**
+   * \param mobility mobility model of one end
+   * \param time the simulation time
+   * \return the position of the end at time
+   */
+  static Vector GetPosition (Ptr<MobilityModel> mobility, Time time);
+
+  /**
+   * \brief Update the mobility models of the two ends, forget the cached distance
+   * and let both ends notify the link going up or down
+   */
+  void UpdateEnds (void);
+
+  Time m_delay; // propagation delay when it is not computed from the positions
+  bool m_computeDelay;
+  Time m_refreshInterval; // length of the interval over which the distance is interpolated
+  Ptr<MobilityModel> m_deviceMobility; // mobility model of the fixed end, 0 if it has none
+  Ptr<MobilityModel> m_peerMobility; // mobility model of the peer, 0 if it has none
+  Time m_refreshTime; // start of the interpolation interval, negative if there is none
+  double m_refreshDistance; // distance at m_refreshTime [km]
+  double m_distanceRate; // change of the distance within the interpolation interval [km/s]
+  Ptr<LeoSatelliteIslNetDevice> m_device; // fixed end of the link
+  Ptr<LeoSatelliteIslNetDevice> m_peer; // current other end of the link
+};
+
+} // namespace ns3
+
+#endif /* LEO_SATELLITE_ISL_CHANNEL_H */
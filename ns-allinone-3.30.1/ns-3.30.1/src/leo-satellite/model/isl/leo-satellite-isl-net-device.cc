@@ -0,0 +1,331 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * LEO Satellite ISL Net Device
+ * Laser terminal of a satellite or ground station, connected to at most one re-pointable link
+ *
+ * ENSC 427: Communication Networks
+ * Spring 2020
+ * Team 11
+ */
+
+#include "leo-satellite-isl-net-device.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/node.h"
+#include "ns3/pointer.h"
+#include "ns3/uinteger.h"
+#include "ns3/drop-tail-queue.h"
+#include "ns3/ppp-header.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LeoSatelliteIslNetDevice");
+
+NS_OBJECT_ENSURE_REGISTERED (LeoSatelliteIslNetDevice);
+
+TypeId
+LeoSatelliteIslNetDevice::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LeoSatelliteIslNetDevice")
+    .SetParent<NetDevice> ()
+    .SetGroupName ("LeoSatellite")
+    .AddConstructor<LeoSatelliteIslNetDevice> ()
+    .AddAttribute ("Mtu", "The MAC-level Maximum Transmission Unit",
+                   UintegerValue (1500),
+                   MakeUintegerAccessor (&LeoSatelliteIslNetDevice::SetMtu,
+                                         &LeoSatelliteIslNetDevice::GetMtu),
+                   MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("DataRate", "The data rate of the laser terminal",
+                   DataRateValue (DataRate ("5.36Gbps")),
+                   MakeDataRateAccessor (&LeoSatelliteIslNetDevice::m_bps),
+                   MakeDataRateChecker ())
+    .AddAttribute ("TxQueue", "The queue of packets waiting for transmission",
+                   PointerValue (),
+                   MakePointerAccessor (&LeoSatelliteIslNetDevice::m_queue),
+                   MakePointerChecker<Queue<Packet> > ())
+    .AddTraceSource ("MacTx", "A packet has been accepted for transmission",
+                     MakeTraceSourceAccessor (&LeoSatelliteIslNetDevice::m_macTxTrace),
+                     "ns3::Packet::TracedCallback")
+    .AddTraceSource ("MacTxDrop", "A packet has been dropped before transmission",
+                     MakeTraceSourceAccessor (&LeoSatelliteIslNetDevice::m_macTxDropTrace),
+                     "ns3::Packet::TracedCallback")
+    .AddTraceSource ("MacRx", "A packet has been received and is passed up",
+                     MakeTraceSourceAccessor (&LeoSatelliteIslNetDevice::m_macRxTrace),
+                     "ns3::Packet::TracedCallback")
+  ;
+  return tid;
+}
+
+LeoSatelliteIslNetDevice::LeoSatelliteIslNetDevice ()
+  : m_address (Mac48Address::Allocate ()),
+    m_ifIndex (0),
+    m_mtu (1500),
+    m_transmitting (false),
+    m_linkUp (false)
+{
+  NS_LOG_FUNCTION (this);
+  m_queue = CreateObject<DropTailQueue<Packet> > ();
+}
+
+LeoSatelliteIslNetDevice::~LeoSatelliteIslNetDevice ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+LeoSatelliteIslNetDevice::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_node = 0;
+  m_channel = 0;
+  m_queue = 0;
+  m_rxCallback.Nullify ();
+  m_promiscCallback.Nullify ();
+  NetDevice::DoDispose ();
+}
+
+void
+LeoSatelliteIslNetDevice::SetChannel (Ptr<LeoSatelliteIslChannel> channel)
+{
+  NS_LOG_FUNCTION (this << channel);
+  m_channel = channel;
+  UpdateLinkState ();
+}
+
+void
+LeoSatelliteIslNetDevice::UpdateLinkState (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_linkUp != IsLinkUp ())
+  {
+    m_linkUp = !m_linkUp;
+    m_linkChangeCallbacks ();
+  }
+}
+
+bool
+LeoSatelliteIslNetDevice::Send (Ptr<Packet> packet, const Address &dest, uint16_t protocolNumber)
+{
+  NS_LOG_FUNCTION (this << packet << dest << protocolNumber);
+  if (!IsLinkUp ())
+  {
+    m_macTxDropTrace (packet);
+    return false;
+  }
+
+  PppHeader ppp;
+  switch (protocolNumber)
+  {
+    case 0x0800: ppp.SetProtocol (0x0021); break; // IPv4
+    case 0x86DD: ppp.SetProtocol (0x0057); break; // IPv6
+    default: NS_ASSERT_MSG (false, "PPP Protocol number not defined!");
+  }
+  packet->AddHeader (ppp);
+
+  m_macTxTrace (packet);
+  if (!m_queue->Enqueue (packet))
+  {
+    m_macTxDropTrace (packet);
+    return false;
+  }
+  if (!m_transmitting)
+  {
+    TransmitStart ();
+  }
+  return true;
+}
+
+void
+LeoSatelliteIslNetDevice::TransmitStart (void)
+{
+  Ptr<Packet> packet = m_queue->Dequeue ();
+  if (packet == 0)
+  {
+    return;
+  }
+  NS_LOG_FUNCTION (this << packet);
+  Time txTime = m_bps.CalculateBytesTxTime (packet->GetSize ());
+  // a link re-pointed while the packet was waiting may have no other end anymore
+  if (m_channel == 0 || !m_channel->TransmitStart (packet, this, txTime))
+  {
+    m_macTxDropTrace (packet);
+  }
+  m_transmitting = true;
+  Simulator::Schedule (txTime, &LeoSatelliteIslNetDevice::TransmitComplete, this);
+}
+
+void
+LeoSatelliteIslNetDevice::TransmitComplete (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_transmitting = false;
+  TransmitStart ();
+}
+
+void
+LeoSatelliteIslNetDevice::Receive (Ptr<Packet> packet)
+{
+  NS_LOG_FUNCTION (this << packet);
+  PppHeader ppp;
+  packet->RemoveHeader (ppp);
+  uint16_t protocol = 0;
+  switch (ppp.GetProtocol ())
+  {
+    case 0x0021: protocol = 0x0800; break; // IPv4
+    case 0x0057: protocol = 0x86DD; break; // IPv6
+    default: NS_ASSERT_MSG (false, "PPP Protocol number not defined!");
+  }
+
+  Address remote = GetBroadcast ();
+  if (m_channel != 0 && m_channel->GetOther (this) != 0)
+  {
+    remote = m_channel->GetOther (this)->GetAddress ();
+  }
+  if (!m_promiscCallback.IsNull ())
+  {
+    m_promiscCallback (this, packet, protocol, remote, GetAddress (), NetDevice::PACKET_HOST);
+  }
+  m_macRxTrace (packet);
+  m_rxCallback (this, packet, protocol, remote);
+}
+
+void
+LeoSatelliteIslNetDevice::SetIfIndex (const uint32_t index)
+{
+  m_ifIndex = index;
+}
+
+uint32_t
+LeoSatelliteIslNetDevice::GetIfIndex (void) const
+{
+  return m_ifIndex;
+}
+
+Ptr<Channel>
+LeoSatelliteIslNetDevice::GetChannel (void) const
+{
+  return m_channel;
+}
+
+void
+LeoSatelliteIslNetDevice::SetAddress (Address address)
+{
+  m_address = Mac48Address::ConvertFrom (address);
+}
+
+Address
+LeoSatelliteIslNetDevice::GetAddress (void) const
+{
+  return m_address;
+}
+
+bool
+LeoSatelliteIslNetDevice::SetMtu (const uint16_t mtu)
+{
+  m_mtu = mtu;
+  return true;
+}
+
+uint16_t
+LeoSatelliteIslNetDevice::GetMtu (void) const
+{
+  return m_mtu;
+}
+
+bool
+LeoSatelliteIslNetDevice::IsLinkUp (void) const
+{
+  return m_channel != 0 && m_channel->GetNDevices () == 2;
+}
+
+void
+LeoSatelliteIslNetDevice::AddLinkChangeCallback (Callback<void> callback)
+{
+  m_linkChangeCallbacks.ConnectWithoutContext (callback);
+}
+
+bool
+LeoSatelliteIslNetDevice::IsBroadcast (void) const
+{
+  return true;
+}
+
+Address
+LeoSatelliteIslNetDevice::GetBroadcast (void) const
+{
+  return Mac48Address ("ff:ff:ff:ff:ff:ff");
+}
+
+bool
+LeoSatelliteIslNetDevice::IsMulticast (void) const
+{
+  return true;
+}
+
+Address
+LeoSatelliteIslNetDevice::GetMulticast (Ipv4Address multicastGroup) const
+{
+  return Mac48Address ("01:00:5e:00:00:00");
+}
+
+Address
+LeoSatelliteIslNetDevice::GetMulticast (Ipv6Address addr) const
+{
+  return Mac48Address ("33:33:00:00:00:00");
+}
+
+bool
+LeoSatelliteIslNetDevice::IsPointToPoint (void) const
+{
+  return true;
+}
+
+bool
+LeoSatelliteIslNetDevice::IsBridge (void) const
+{
+  return false;
+}
+
+bool
+LeoSatelliteIslNetDevice::SendFrom (Ptr<Packet> packet, const Address &source, const Address &dest, uint16_t protocolNumber)
+{
+  return false;
+}
+
+Ptr<Node>
+LeoSatelliteIslNetDevice::GetNode (void) const
+{
+  return m_node;
+}
+
+void
+LeoSatelliteIslNetDevice::SetNode (Ptr<Node> node)
+{
+  m_node = node;
+}
+
+bool
+LeoSatelliteIslNetDevice::NeedsArp (void) const
+{
+  return false;
+}
+
+void
+LeoSatelliteIslNetDevice::SetReceiveCallback (NetDevice::ReceiveCallback cb)
+{
+  m_rxCallback = cb;
+}
+
+void
+LeoSatelliteIslNetDevice::SetPromiscReceiveCallback (NetDevice::PromiscReceiveCallback cb)
+{
+  m_promiscCallback = cb;
+}
+
+bool
+LeoSatelliteIslNetDevice::SupportsSendFrom (void) const
+{
+  return false;
+}
+
+} // namespace ns3
@@ -0,0 +1,121 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * LEO Satellite ISL Net Device
+ * Laser terminal of a satellite or ground station, connected to at most one re-pointable link
+ *
+ * ENSC 427: Communication Networks
+ * Spring 2020
+ * Team 11
+ */
+#ifndef LEO_SATELLITE_ISL_NET_DEVICE_H
+#define LEO_SATELLITE_ISL_NET_DEVICE_H
+
+#include "ns3/net-device.h"
+#include "ns3/mac48-address.h"
+#include "ns3/data-rate.h"
+#include "ns3/queue.h"
+#include "ns3/traced-callback.h"
+#include "ns3/leo-satellite-isl-channel.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup leo-satellite
+ * \brief point-to-point net device for LeoSatelliteIslChannel.
+ *
+ * A lightweight version of PointToPointNetDevice: packets are queued, sent
+ * one after the other at DataRate, framed with a PPP header, and delivered to
+ * whichever device is at the other end of the channel when their
+ * transmission starts. The channel of the device changes when its link is
+ * re-pointed; without channel the link is down and packets are dropped.
+ */
+class LeoSatelliteIslNetDevice : public NetDevice
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  LeoSatelliteIslNetDevice ();
+  virtual ~LeoSatelliteIslNetDevice ();
+
+  /**
+   * \brief Set the channel the device is connected to, called by the channel
+   * \param channel the channel, 0 when the device is disconnected
+   */
+  void SetChannel (Ptr<LeoSatelliteIslChannel> channel);
+
+  /**
+   * \brief Notify the link change callbacks if the link went up or down since
+   * the last notification, called by the channel whenever one of its ends changes
+   */
+  void UpdateLinkState (void);
+
+  /**
+   * \brief Receive a packet from the channel
+   * \param packet the packet, with its PPP header
+   */
+  void Receive (Ptr<Packet> packet);
+
+  // inherited from NetDevice
+  virtual void SetIfIndex (const uint32_t index);
+  virtual uint32_t GetIfIndex (void) const;
+  virtual Ptr<Channel> GetChannel (void) const;
+  virtual void SetAddress (Address address);
+  virtual Address GetAddress (void) const;
+  virtual bool SetMtu (const uint16_t mtu);
+  virtual uint16_t GetMtu (void) const;
+  virtual bool IsLinkUp (void) const;
+  virtual void AddLinkChangeCallback (Callback<void> callback);
+  virtual bool IsBroadcast (void) const;
+  virtual Address GetBroadcast (void) const;
+  virtual bool IsMulticast (void) const;
+  virtual Address GetMulticast (Ipv4Address multicastGroup) const;
+  virtual Address GetMulticast (Ipv6Address addr) const;
+  virtual bool IsPointToPoint (void) const;
+  virtual bool IsBridge (void) const;
+  virtual bool Send (Ptr<Packet> packet, const Address &dest, uint16_t protocolNumber);
+  virtual bool SendFrom (Ptr<Packet> packet, const Address &source, const Address &dest, uint16_t protocolNumber);
+  virtual Ptr<Node> GetNode (void) const;
+  virtual void SetNode (Ptr<Node> node);
+  virtual bool NeedsArp (void) const;
+  virtual void SetReceiveCallback (NetDevice::ReceiveCallback cb);
+  virtual void SetPromiscReceiveCallback (NetDevice::PromiscReceiveCallback cb);
+  virtual bool SupportsSendFrom (void) const;
+
+private:
+  virtual void DoDispose (void);
+
+  /**
+   * \brief Start sending the next packet of the queue, if any
+   */
+  void TransmitStart (void);
+
+  /**
+   * \brief The transmission of the current packet is over
+   */
+  void TransmitComplete (void);
+
+  Ptr<Node> m_node;
+  Ptr<LeoSatelliteIslChannel> m_channel;
+  Ptr<Queue<Packet> > m_queue;
+  Mac48Address m_address;
+  DataRate m_bps;
+  uint32_t m_ifIndex;
+  uint16_t m_mtu;
+  bool m_transmitting; // a packet is being sent
+  bool m_linkUp; // link state of the last link change notification
+  NetDevice::ReceiveCallback m_rxCallback;
+  NetDevice::PromiscReceiveCallback m_promiscCallback;
+  TracedCallback<> m_linkChangeCallbacks;
+
+  TracedCallback<Ptr<const Packet> > m_macTxTrace; // packet accepted for transmission
+  TracedCallback<Ptr<const Packet> > m_macTxDropTrace; // packet dropped before transmission
+  TracedCallback<Ptr<const Packet> > m_macRxTrace; // packet received and passed up
+};
+
+} // namespace ns3
+
+#endif /* LEO_SATELLITE_ISL_NET_DEVICE_H */
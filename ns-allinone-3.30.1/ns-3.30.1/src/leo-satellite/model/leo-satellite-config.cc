@@ -9,15 +9,25 @@
  */
 
 #include "leo-satellite-config.h"
+#include "ns3/leo-satellite-routing-helper.h"
+#include "ns3/ipv4-address-generator.h"
+#include "ns3/traffic-control-layer.h"
+#include "ns3/traffic-control-helper.h"
+#include "ns3/net-device-queue-interface.h"
+#include "ns3/mpi-interface.h"
+#include "ns3/mpi-receiver.h"
+#include <fstream>
+#include <sstream>
+#include <algorithm>
 
 namespace ns3 {
 
 NS_OBJECT_ENSURE_REGISTERED (LeoSatelliteConfig);
 NS_LOG_COMPONENT_DEFINE ("LeoSatelliteConfig");
 
-extern double CalculateDistanceGroundToSat (const Vector &a, const Vector &b);
+const uint32_t LeoSatelliteConfig::NO_GROUND_STATION;
 
-double speed_of_light = 299792458; //in m/s
+extern uint32_t currentNode; //satellite mobility initialization counter
 
 //typeid
 TypeId LeoSatelliteConfig::GetTypeId (void)
@@ -25,6 +35,122 @@ TypeId LeoSatelliteConfig::GetTypeId (void)
   static TypeId tid = TypeId ("ns3::LeoSatelliteConfig")
   .SetParent<Object> ()
   .SetGroupName("LeoSatellite")
+  .AddAttribute ("Routing",
+                 "Routing used between the nodes of the constellation.",
+                 EnumValue (LeoSatelliteConfig::GLOBAL_ROUTING),
+                 MakeEnumAccessor (&LeoSatelliteConfig::m_routing),
+                 MakeEnumChecker (LeoSatelliteConfig::GLOBAL_ROUTING, "Global",
+                                  LeoSatelliteConfig::INCREMENTAL_ROUTING, "Incremental",
+                                  LeoSatelliteConfig::GRID_ROUTING, "Grid"))
+  .AddAttribute ("Orbits",
+                 "Orbits of the satellites. Polar keeps the original layout of polar planes spread over 180 degrees "
+                 "of longitude. WalkerDelta spreads the planes over 360 degrees with Inclination and WalkerPhasing. "
+                 "Tle reads the orbits from TleFile.",
+                 EnumValue (LeoSatelliteConfig::POLAR_ORBITS),
+                 MakeEnumAccessor (&LeoSatelliteConfig::m_orbits),
+                 MakeEnumChecker (LeoSatelliteConfig::POLAR_ORBITS, "Polar",
+                                  LeoSatelliteConfig::WALKER_DELTA_ORBITS, "WalkerDelta",
+                                  LeoSatelliteConfig::TLE_ORBITS, "Tle"))
+  .AddAttribute ("Inclination",
+                 "Inclination of the planes of a Walker-delta constellation [degrees].",
+                 DoubleValue (53),
+                 MakeDoubleAccessor (&LeoSatelliteConfig::m_inclination),
+                 MakeDoubleChecker<double> (0, 180))
+  .AddAttribute ("WalkerPhasing",
+                 "Relative phasing F of a Walker-delta constellation: satellites of adjacent planes are "
+                 "360 F / (planes x satellites per plane) degrees apart along their orbits. Below the number of planes.",
+                 UintegerValue (1),
+                 MakeUintegerAccessor (&LeoSatelliteConfig::m_walkerPhasing),
+                 MakeUintegerChecker<uint32_t> ())
+  .AddAttribute ("TleFile",
+                 "File of two-line element sets, one per satellite, optionally preceded by the name of the satellite. "
+                 "The first planes x satellites per plane sets are split into planes by their ascending node. "
+                 "The latest epoch of the file is the start of the simulation.",
+                 StringValue (""),
+                 MakeStringAccessor (&LeoSatelliteConfig::m_tleFile),
+                 MakeStringChecker ())
+  .AddAttribute ("EarthRotation",
+                 "Make the orbits of a Walker-delta or two-line element constellation drift west with the rotation "
+                 "of the Earth under them. Polar orbits never drift.",
+                 BooleanValue (false),
+                 MakeBooleanAccessor (&LeoSatelliteConfig::m_earthRotation),
+                 MakeBooleanChecker ())
+  .AddAttribute ("GroundStationsFile",
+                 "File with one ground station per line as latitude, longitude in degrees [, altitude in km], "
+                 "separated by commas or white space. Lines starting with # are ignored. "
+                 "Two ground stations under the constellation are used when empty.",
+                 StringValue (""),
+                 MakeStringAccessor (&LeoSatelliteConfig::m_groundStationsFile),
+                 MakeStringChecker ())
+  .AddAttribute ("ScheduleHandovers",
+                 "Update the links at the predicted instants of every inter-plane or ground link change, "
+                 "instead of leaving calls to UpdateLinks to the user.",
+                 BooleanValue (false),
+                 MakeBooleanAccessor (&LeoSatelliteConfig::m_scheduleHandovers),
+                 MakeBooleanChecker ())
+  .AddAttribute ("HandoverResolution",
+                 "Accuracy of the predicted instant of a link change.",
+                 TimeValue (MilliSeconds (1)),
+                 MakeTimeAccessor (&LeoSatelliteConfig::m_handoverResolution),
+                 MakeTimeChecker (NanoSeconds (1)))
+  .AddAttribute ("HandoverStep",
+                 "Step of the search for link changes, 1/8 of the time between two satellites of a plane when 0. "
+                 "A link that changes partner and back within one step is missed, so the step has to be shorter "
+                 "than the shortest time any inter-plane or ground link keeps a partner. "
+                 "At most half of the time between two satellites of a plane.",
+                 TimeValue (Seconds (0)),
+                 MakeTimeAccessor (&LeoSatelliteConfig::m_handoverStep),
+                 MakeTimeChecker (Seconds (0)))
+  .AddAttribute ("GroundLinksPerSatellite",
+                 "Number of ground stations a satellite can be linked to at the same time.",
+                 UintegerValue (4),
+                 MakeUintegerAccessor (&LeoSatelliteConfig::m_groundLinksPerSatellite),
+                 MakeUintegerChecker<uint32_t> (1))
+  .AddAttribute ("ContactPlanDuration",
+                 "Compute the satellite of every ground station once for this long from the start, "
+                 "updates then look it up instead of searching for the closest satellite. No contact plan when 0.",
+                 TimeValue (Seconds (0)),
+                 MakeTimeAccessor (&LeoSatelliteConfig::m_contactPlanDuration),
+                 MakeTimeChecker (Seconds (0)))
+  .AddAttribute ("ContactPlanFile",
+                 "File the contact plan is loaded from, memory-mapped where possible, if it was computed for the same "
+                 "constellation, ground stations, start and ContactPlanDuration. Otherwise the contact plan is "
+                 "computed and saved to it. The contact plan is only kept in memory when empty.",
+                 StringValue (""),
+                 MakeStringAccessor (&LeoSatelliteConfig::m_contactPlanFile),
+                 MakeStringChecker ())
+  .AddAttribute ("RemoteLinkLookahead",
+                 "Least propagation delay of packets between satellites or ground stations simulated by different MPI "
+                 "ranks, which is the lookahead of the distributed simulator. Shorter links are delayed to it. "
+                 "The altitude of the satellites when 0, which is exact for the ground links.",
+                 TimeValue (Seconds (0)),
+                 MakeTimeAccessor (&LeoSatelliteConfig::m_remoteLinkLookahead),
+                 MakeTimeChecker (Seconds (0)))
+  .AddAttribute ("LinkStateFile",
+                 "File the state of every inter-plane and ground link is written to when the links are set up "
+                 "and on every update. Nothing is written when empty.",
+                 StringValue (""),
+                 MakeStringAccessor (&LeoSatelliteConfig::m_linkStateFile),
+                 MakeStringChecker ())
+  .AddAttribute ("LinkStateFormat",
+                 "Format of the LinkStateFile. Csv writes a header and one line per link as "
+                 "time [s], link (I for inter-plane, G for ground), a, b, distance [km], delay [s], repointed. "
+                 "Binary writes one 34 byte record per link in host byte order: time [s] as a double, "
+                 "link and repointed as one byte each, a and b as uint32, distance [km] and delay [s] as doubles.",
+                 EnumValue (LeoSatelliteConfig::CSV_LINK_STATE),
+                 MakeEnumAccessor (&LeoSatelliteConfig::m_linkStateFormat),
+                 MakeEnumChecker (LeoSatelliteConfig::CSV_LINK_STATE, "Csv",
+                                  LeoSatelliteConfig::BINARY_LINK_STATE, "Binary"))
+  .AddTraceSource ("InterPlaneLink",
+                   "State of an inter-plane link when it is set up or updated, "
+                   "a is the satellite at the fixed end and b the satellite of the next plane.",
+                   MakeTraceSourceAccessor (&LeoSatelliteConfig::m_interPlaneLinkTrace),
+                   "ns3::LeoSatelliteConfig::LinkStateTracedCallback")
+  .AddTraceSource ("GroundLink",
+                   "State of a ground link when it is set up or updated, "
+                   "a is the ground station and b the satellite.",
+                   MakeTraceSourceAccessor (&LeoSatelliteConfig::m_groundLinkTrace),
+                   "ns3::LeoSatelliteConfig::LinkStateTracedCallback")
   ;
   return tid;
 }
@@ -46,21 +172,74 @@ LeoSatelliteConfig::LeoSatelliteConfig (uint32_t num_planes, uint32_t num_satell
   this->num_satellites_per_plane = num_satellites_per_plane;
   this->m_altitude = altitude;
 
-  uint32_t total_num_satellites = num_planes*num_satellites_per_plane;
-  NodeContainer temp;
-  temp.Create(total_num_satellites);
+  //attributes must be set before the constellation is built
+  ObjectBase::ConstructSelf (AttributeConstructionList ());
 
-  //assign mobility model to all satellites
+  //with MPI every rank builds and updates the whole constellation, but only simulates the nodes of its planes
+  m_ranks = MpiInterface::IsEnabled() ? MpiInterface::GetSize() : 1;
+  if (m_remoteLinkLookahead.IsZero())
+    m_remoteLinkLookahead = Seconds(altitude*1000/299792458);
+  if (m_ranks > 1)
+    NS_LOG_INFO ("Planes partitioned across " << m_ranks << " ranks, lookahead " << m_remoteLinkLookahead.GetSeconds() << " s");
+  StringValue simulator;
+  GlobalValue::GetValueByName ("SimulatorImplementationType", simulator);
+  m_nullMessages = m_ranks > 1 && simulator.Get() == "ns3::NullMessageSimulatorImpl";
+
+  //the link states are the same on every rank, only the first one writes them
+  if (!m_linkStateFile.empty() && MpiInterface::GetSystemId() == 0)
+  {
+    std::ios_base::openmode mode = std::ios_base::out | std::ios_base::trunc;
+    if (m_linkStateFormat == BINARY_LINK_STATE)
+      mode |= std::ios_base::binary;
+    m_linkStateStream.open(m_linkStateFile.c_str(), mode);
+    NS_ABORT_MSG_UNLESS (m_linkStateStream.is_open(), "Link state file " << m_linkStateFile << " cannot be opened");
+    if (m_linkStateFormat == CSV_LINK_STATE)
+      m_linkStateStream << "time,link,a,b,distance,delay,repointed" << std::endl;
+    m_interPlaneLinkTrace.ConnectWithoutContext(MakeCallback(&LeoSatelliteConfig::WriteInterPlaneLinkState, this));
+    m_groundLinkTrace.ConnectWithoutContext(MakeCallback(&LeoSatelliteConfig::WriteGroundLinkState, this));
+  }
+
+  InternetStackHelper stack;
+  if (m_routing != GLOBAL_ROUTING)
+  {
+    if (m_routing == GRID_ROUTING)
+      m_routeManager = CreateObject<LeoSatelliteGridRouteManager> ();
+    else
+      m_routeManager = CreateObject<LeoSatelliteRouteManager> ();
+    Ipv4StaticRoutingHelper staticRouting;
+    LeoSatelliteRoutingHelper leoRouting (m_routeManager);
+    Ipv4ListRoutingHelper list;
+    list.Add (staticRouting, 0);
+    list.Add (leoRouting, 10);
+    stack.SetRoutingHelper (list);
+  }
+
+  //assign mobility model to all satellites, all of them views onto one ephemeris
+  currentNode = 0; //positions are derived from the order of creation within this constellation
+  m_ephemeris = CreateObject<LeoSatelliteEphemeris> ();
+  m_spatialIndex = CreateObject<LeoSatelliteSpatialIndex> ();
   MobilityHelper mobility;
   mobility.SetMobilityModel ("ns3::LeoSatelliteMobilityModel",
                              "NPerPlane", IntegerValue (num_satellites_per_plane),
                              "NumberofPlanes", IntegerValue (num_planes),
                              "Altitude", DoubleValue(altitude),
-                             "Time", DoubleValue(Simulator::Now().GetSeconds()));
-  mobility.Install(temp);
-  
-  for (NodeContainer::Iterator j = temp.Begin ();
-       j != temp.End (); ++j)
+                             "Time", DoubleValue(Simulator::Now().GetSeconds()),
+                             "Ephemeris", PointerValue(m_ephemeris));
+
+  if (m_orbits == POLAR_ORBITS)
+  {
+    uint32_t total_num_satellites = num_planes*num_satellites_per_plane;
+    NodeContainer temp;
+    for (uint32_t k=0; k<total_num_satellites; k++)
+    {
+      //the first half of every plane is created first, then the second half, see below
+      uint32_t k_plane = (k % (total_num_satellites/2))/(num_satellites_per_plane/2);
+      temp.Create(1, GetPlaneSystemId(std::min(k_plane, num_planes - 1), num_planes, m_ranks));
+    }
+    mobility.Install(temp);
+
+    for (NodeContainer::Iterator j = temp.Begin ();
+         j != temp.End (); ++j)
     {
       Ptr<Node> object = *j;
       Ptr<MobilityModel> position = object->GetObject<MobilityModel> ();
@@ -69,204 +248,267 @@ LeoSatelliteConfig::LeoSatelliteConfig (uint32_t num_planes, uint32_t num_satell
       NS_ASSERT (position != 0);
     }
 
-  //assigning nodes to e/ plane's node container as necessary
-  for (uint32_t i=0; i<num_planes; i++)
-  {
-     NodeContainer temp_plane;
-     for(uint32_t j=0; j<num_satellites_per_plane/2; j++)
-     {
-       Vector pos = temp.Get(i*num_satellites_per_plane/2 + j)->GetObject<MobilityModel> ()->GetPosition();
-       std::cout << Simulator::Now().GetSeconds() << ": plane # "<< i << " node # " <<j<< ": x = " << pos.x << ", y = " << pos.y << ", z = " << pos.z << std::endl;
-       temp_plane.Add(temp.Get(i*num_satellites_per_plane/2 + j));
-     }
-     for(uint32_t j=num_satellites_per_plane/2; j> 0; j--)
-     {
-       Vector pos = temp.Get(total_num_satellites/2 + i*num_satellites_per_plane/2 + j - 1)->GetObject<MobilityModel> ()->GetPosition();
-       std::cout << Simulator::Now().GetSeconds() << ": plane # "<< i << " node # " <<num_satellites_per_plane - j<< ": x = " << pos.x << ", y = " << pos.y << ", z = " << pos.z << std::endl;
-       temp_plane.Add(temp.Get(total_num_satellites/2 + i*num_satellites_per_plane/2 + j - 1));
-     }
-     InternetStackHelper stack;
-     stack.Install(temp_plane);
-     this->plane.push_back(temp_plane);
-  }
-
-  //setting up all intraplane links
-  Vector nodeAPosition = this->plane[0].Get(0)->GetObject<MobilityModel>()->GetPosition();
-  Vector nodeBPosition = this->plane[0].Get(1)->GetObject<MobilityModel>()->GetPosition();
-  double distance = CalculateDistance(nodeAPosition, nodeBPosition);
-  double delay = (distance * 1000)/speed_of_light; //should get delay in seconds
-  PointToPointHelper intraplane_link_helper;
-  intraplane_link_helper.SetDeviceAttribute ("DataRate", StringValue ("5.36Gbps"));
-  intraplane_link_helper.SetChannelAttribute ("Delay", TimeValue(Seconds (delay)));
-
-  std::cout<<"Setting up intra-plane links with distance of "<<distance<<" km and delay of "<<delay<<" seconds."<<std::endl;
-
-  for (uint32_t i=0; i<num_planes; i++)
+    //assigning nodes to e/ plane's node container as necessary
+    for (uint32_t i=0; i<num_planes; i++)
+    {
+      NodeContainer temp_plane;
+      for(uint32_t j=0; j<num_satellites_per_plane/2; j++)
+      {
+        NS_LOG_LOGIC ("plane # "<< i << " node # " <<j<< ": " << temp.Get(i*num_satellites_per_plane/2 + j)->GetObject<MobilityModel> ()->GetPosition());
+        temp_plane.Add(temp.Get(i*num_satellites_per_plane/2 + j));
+      }
+      for(uint32_t j=num_satellites_per_plane/2; j> 0; j--)
+      {
+        NS_LOG_LOGIC ("plane # "<< i << " node # " <<num_satellites_per_plane - j<< ": " << temp.Get(total_num_satellites/2 + i*num_satellites_per_plane/2 + j - 1)->GetObject<MobilityModel> ()->GetPosition());
+        temp_plane.Add(temp.Get(total_num_satellites/2 + i*num_satellites_per_plane/2 + j - 1));
+      }
+      stack.Install(temp_plane);
+      this->plane.push_back(temp_plane);
+    }
+  }
+  else
   {
-    for (uint32_t j=0; j<num_satellites_per_plane; j++)
+    //orbits numbered plane by plane, satellites in order along their orbit
+    std::vector<LeoSatelliteOrbit> orbits;
+    if (m_orbits == WALKER_DELTA_ORBITS)
     {
-      this->intra_plane_devices.push_back(intraplane_link_helper.Install(plane[i].Get(j), plane[i].Get((j+1)%num_satellites_per_plane)));
-      std::cout<<"Plane "<<i<<": channel between node "<<j<<" and node "<<(j+1)%num_satellites_per_plane<<std::endl;
+      NS_LOG_INFO ("Walker-delta constellation " << m_inclination << ": " << num_planes*num_satellites_per_plane << "/" << num_planes << "/" << m_walkerPhasing);
+      orbits = LeoSatelliteOrbits::WalkerDelta(num_planes, num_satellites_per_plane, m_walkerPhasing, m_inclination, altitude,
+                                               Simulator::Now().GetSeconds(), m_earthRotation);
+    }
+    else
+    {
+      NS_LOG_INFO ("Constellation read from " << m_tleFile);
+      orbits = LeoSatelliteOrbits::LoadTle(m_tleFile, num_planes, num_satellites_per_plane, Simulator::Now().GetSeconds(), m_earthRotation);
+    }
+    for (uint32_t i=0; i<num_planes; i++)
+    {
+      NodeContainer temp_plane;
+      temp_plane.Create(num_satellites_per_plane, GetPlaneSystemId(i, num_planes, m_ranks));
+      mobility.Install(temp_plane);
+      for (uint32_t j=0; j<num_satellites_per_plane; j++)
+      {
+        temp_plane.Get(j)->GetObject<LeoSatelliteMobilityModel> ()->SetOrbit(orbits[i*num_satellites_per_plane + j]);
+        NS_LOG_LOGIC ("plane # "<< i << " node # " <<j<< ": " << temp_plane.Get(j)->GetObject<MobilityModel> ()->GetPosition());
+      }
+      stack.Install(temp_plane);
+      this->plane.push_back(temp_plane);
     }
   }
 
-  //setting up interplane links
-  std::cout<<"Setting up inter-plane links"<<std::endl;
+  //mobility models of all satellites, numbered plane by plane
   for (uint32_t i=0; i<num_planes; i++)
   {
     for (uint32_t j=0; j<num_satellites_per_plane; j++)
     {
-      uint32_t nodeBIndex;
-      (i == num_planes - 1) ? nodeBIndex = num_satellites_per_plane - j - 1: nodeBIndex = j;
-      Vector nodeAPos = this->plane[i].Get(j)->GetObject<MobilityModel>()->GetPosition();
-      Vector nodeBPos = this->plane[(i+1)%num_planes].Get(nodeBIndex)->GetObject<MobilityModel>()->GetPosition();
-      double distance = CalculateDistance(nodeAPos, nodeBPos);
-      double delay = (distance*1000)/speed_of_light;
-      CsmaHelper interplane_link_helper;
-      interplane_link_helper.SetChannelAttribute("DataRate", StringValue ("5.36Gbps"));
-      interplane_link_helper.SetChannelAttribute("Delay", TimeValue(Seconds(delay)));
-
-      std::cout<<"Channel open between plane "<<i<<" satellite "<<j<<" and plane "<<(i+1)%num_planes<<" satellite "<<nodeBIndex<< " with distance "<<distance<< "km and delay of "<<delay<<" seconds"<<std::endl;
-
-      NodeContainer temp_node_container;
-      temp_node_container.Add(this->plane[i].Get(j));
-      temp_node_container.Add(this->plane[(i+1)%num_planes]);
-      NetDeviceContainer temp_netdevice_container;
-      temp_netdevice_container = interplane_link_helper.Install(temp_node_container);
-      Ptr<CsmaChannel> csma_channel;
-      Ptr<Channel> channel;
-      channel = temp_netdevice_container.Get(0)->GetChannel();
-      csma_channel = channel->GetObject<CsmaChannel> ();
-      
-      for (uint32_t k=0; k<num_satellites_per_plane; k++)
-      {
-        if (j != k)
-        {
-          csma_channel->Detach(temp_netdevice_container.Get(k+1)->GetObject<CsmaNetDevice> ());
-        }
-      }
-        
-      this->inter_plane_devices.push_back(temp_netdevice_container);
-      this->inter_plane_channels.push_back(csma_channel);
-      this->inter_plane_channel_tracker.push_back(nodeBIndex);
+      m_satelliteMobility.push_back(this->plane[i].Get(j)->GetObject<LeoSatelliteMobilityModel> ());
     }
   }
 
-  //setting up two ground stations for now
-  std::cout << "Setting up two ground stations" << std::endl;
-  ground_stations.Create(2);
+  //setting up ground stations, from the ground stations file if there is one
+  std::vector<Vector> ground_positions;
+  if (m_groundStationsFile.empty())
+  {
+    //two ground stations along the longitude of satellite orbits, at different latitudes and longitudes
+    double n_per_plane = num_satellites_per_plane;
+    ground_positions.push_back(Vector(90 - 180/(n_per_plane/2)/2, -180, 0));
+    ground_positions.push_back(Vector(90 - 180/(n_per_plane/2)/2 - 180/(n_per_plane/2)*(n_per_plane/4),
+                                      -180 + 360.0/(num_planes*2)*floor(3*num_planes/7), 0));
+  }
+  else
+  {
+    ground_positions = LoadGroundStations(m_groundStationsFile);
+  }
+  NS_LOG_INFO ("Setting up " << ground_positions.size() << " ground stations");
+  //ground stations are simulated by the rank of the satellite closest to them at the start
+  if (m_ranks > 1)
+    UpdateSpatialIndex(Simulator::Now());
+  for (uint32_t j=0; j<ground_positions.size(); j++)
+  {
+    uint32_t system_id = 0;
+    if (m_ranks > 1)
+      system_id = GetPlaneSystemId(m_spatialIndex->FindNearest(ground_positions[j])/num_satellites_per_plane, num_planes, m_ranks);
+    ground_stations.Create(1, system_id);
+  }
   //assign mobility model to ground stations
+  Ptr<ListPositionAllocator> ground_allocator = CreateObject<ListPositionAllocator> ();
+  for (uint32_t j=0; j<ground_positions.size(); j++)
+  {
+    ground_allocator->Add(ground_positions[j]);
+  }
   MobilityHelper groundMobility;
-  groundMobility.SetMobilityModel ("ns3::GroundStationMobilityModel",
-                             "NPerPlane", IntegerValue (num_satellites_per_plane),
-                             "NumberofPlanes", IntegerValue (num_planes));
+  groundMobility.SetPositionAllocator(ground_allocator);
+  groundMobility.SetMobilityModel ("ns3::GroundStationMobilityModel");
   groundMobility.Install(ground_stations);
   //Install IP stack
-  InternetStackHelper stack;
   stack.Install(ground_stations);
-  for (int j = 0; j<2; j++)
+  for (uint32_t j=0; j<ground_stations.GetN(); j++)
   {
     Vector temp = ground_stations.Get(j)->GetObject<MobilityModel> ()->GetPosition();
-    std::cout << Simulator::Now().GetSeconds() << ": ground station # " << j << ": x = " << temp.x << ", y = " << temp.y << std::endl;
+    NS_LOG_LOGIC ("ground station # " << j << ": x = " << temp.x << ", y = " << temp.y);
+    m_groundPositions.push_back(temp); //ground stations do not move
   }
-  //setting up links between ground stations and their closest satellites
-  std::cout<<"Setting links between ground stations and satellites"<<std::endl;
-  for (uint32_t i=0; i<2; i++)
-  {
-    Vector gndPos = ground_stations.Get(i)->GetObject<MobilityModel> ()->GetPosition();
-    uint32_t closestAdjSat = 0;
-    uint32_t closestAdjSatDist = 0;
-    uint32_t planeIndex;
-    if (i == 0)
-      planeIndex = 0;
-    else
-      planeIndex = floor(3*num_planes/7);
-    //find closest adjacent satellite for ground station
-    for (uint32_t j=0; j<this->num_satellites_per_plane; j++)
+  NS_ABORT_MSG_IF (ground_stations.GetN() > num_planes*num_satellites_per_plane*m_groundLinksPerSatellite,
+                   "Not enough ground links on the satellites for " << ground_stations.GetN() << " ground stations");
+
+  if (m_contactPlanDuration.IsStrictlyPositive())
+    SetupContactPlan(Simulator::Now());
+
+  //planning: partner of every inter-plane link and ground station, computed before any device exists
+  std::vector<uint32_t> inter_plane_targets, ground_station_targets;
+  ComputeLinks(Simulator::Now(), inter_plane_targets, ground_station_targets);
+
+  //setting up all intraplane links, the delay of every packet follows from the positions of the two satellites
+  NS_LOG_INFO ("Setting up intra-plane links");
+  for (uint32_t i=0; i<num_planes; i++)
+  {
+    for (uint32_t j=0; j<num_satellites_per_plane; j++)
     {
-      Vector pos = this->plane[planeIndex].Get(j)->GetObject<MobilityModel>()->GetPosition();
-      double temp_dist = CalculateDistanceGroundToSat(gndPos,pos);
-      if((temp_dist < closestAdjSatDist) || (j==0))
-      {
-        closestAdjSatDist = temp_dist;
-        closestAdjSat = j;
-      }
+      NetDeviceContainer devices;
+      devices.Add(CreateIslDevice(plane[i].Get(j)));
+      devices.Add(CreateIslDevice(plane[i].Get((j+1)%num_satellites_per_plane)));
+      Ptr<LeoSatelliteIslChannel> channel = CreateIslChannel();
+      channel->Connect(DynamicCast<LeoSatelliteIslNetDevice> (devices.Get(0)), DynamicCast<LeoSatelliteIslNetDevice> (devices.Get(1)));
+      this->intra_plane_devices.push_back(devices);
+      NS_LOG_LOGIC ("Plane "<<i<<": channel between node "<<j<<" and node "<<(j+1)%num_satellites_per_plane<<" with distance "<<channel->GetDistance()<<" km and delay of "<<channel->GetDelay().GetSeconds()<<" seconds");
+    }
+  }
+
+  //setting up interplane links, every satellite has one laser terminal towards the next plane
+  //and one towards the previous plane, the links are re-pointed when the satellites move
+  NS_LOG_INFO ("Setting up inter-plane links");
+  for (uint32_t i=0; i<num_planes; i++)
+  {
+    for (uint32_t j=0; j<num_satellites_per_plane; j++)
+    {
+      this->inter_plane_east_devices.push_back(CreateIslDevice(plane[i].Get(j)));
+      this->inter_plane_west_devices.push_back(CreateIslDevice(plane[i].Get(j)));
+    }
+  }
+  for (uint32_t i=0; i<num_planes; i++)
+  {
+    for (uint32_t j=0; j<num_satellites_per_plane; j++)
+    {
+      uint32_t nodeBIndex = inter_plane_targets[i*num_satellites_per_plane + j];
+      Ptr<LeoSatelliteIslChannel> channel = CreateIslChannel();
+      channel->Connect(this->inter_plane_east_devices[i*num_satellites_per_plane + j],
+                       this->inter_plane_west_devices[((i+1)%num_planes)*num_satellites_per_plane + nodeBIndex]);
+      this->inter_plane_channels.push_back(channel);
+      this->inter_plane_channel_tracker.push_back(nodeBIndex);
+      double distance = channel->GetDistance();
+      Time delay = channel->GetDelay();
+
+      NS_LOG_LOGIC ("Channel open between plane "<<i<<" satellite "<<j<<" and plane "<<(i+1)%num_planes<<" satellite "<<nodeBIndex<< " with distance "<<distance<< "km and delay of "<<delay.GetSeconds()<<" seconds");
+      m_interPlaneLinkTrace(i*num_satellites_per_plane + j, ((i+1)%num_planes)*num_satellites_per_plane + nodeBIndex, distance, delay, true);
     }
-    double delay = (closestAdjSatDist*1000)/speed_of_light;
-    CsmaHelper ground_station_link_helper;
-    ground_station_link_helper.SetChannelAttribute("DataRate", StringValue ("5.36Gbps"));
-    ground_station_link_helper.SetChannelAttribute("Delay", TimeValue(Seconds(delay)));
-
-    std::cout<<"Channel open between ground station " << i << " and plane " << planeIndex << " satellite "<<closestAdjSat<<" with distance "<<closestAdjSatDist<< "km and delay of "<<delay<<" seconds"<<std::endl;
-
-    NodeContainer temp_node_container;
-    temp_node_container.Add(ground_stations.Get(i));
-    temp_node_container.Add(this->plane[planeIndex]);
-    NetDeviceContainer temp_netdevice_container;
-    temp_netdevice_container = ground_station_link_helper.Install(temp_node_container);
-    Ptr<CsmaChannel> csma_channel;
-    Ptr<Channel> channel;
-    channel = temp_netdevice_container.Get(0)->GetChannel();
-    csma_channel = channel->GetObject<CsmaChannel> ();
-
-    for (uint32_t k=0; k<num_satellites_per_plane; k++)
+  }
+
+  //setting up links between ground stations and their closest satellites
+  NS_LOG_INFO ("Setting links between ground stations and satellites");
+  for (uint32_t i=0; i<num_planes; i++)
+  {
+    for (uint32_t j=0; j<num_satellites_per_plane; j++)
     {
-      if (closestAdjSat != k)
+      for (uint32_t k=0; k<m_groundLinksPerSatellite; k++)
       {
-        csma_channel->Detach(temp_netdevice_container.Get(k+1)->GetObject<CsmaNetDevice> ());
+        this->ground_link_devices.push_back(CreateIslDevice(plane[i].Get(j)));
+        this->ground_link_users.push_back(NO_GROUND_STATION);
       }
     }
-        
-    this->ground_station_devices.push_back(temp_netdevice_container);
-    this->ground_station_channels.push_back(csma_channel);
-    this->ground_station_channel_tracker.push_back(closestAdjSat);
+  }
+  for (uint32_t i=0; i<ground_stations.GetN(); i++)
+  {
+    //closest satellite of the whole constellation with a free ground link
+    uint32_t closestSat = ground_station_targets[i];
+    uint32_t slot = closestSat*m_groundLinksPerSatellite;
+    while (this->ground_link_users[slot] != NO_GROUND_STATION)
+      slot++;
+    this->ground_link_users[slot] = i;
+    Ptr<LeoSatelliteIslChannel> channel = CreateIslChannel();
+    this->ground_station_devices.push_back(CreateIslDevice(ground_stations.Get(i)));
+    channel->Connect(this->ground_station_devices[i], this->ground_link_devices[slot]);
+    this->ground_station_channels.push_back(channel);
+    this->ground_station_channel_tracker.push_back(closestSat);
+    double closestSatDist = channel->GetDistance();
+    Time delay = channel->GetDelay();
+
+    NS_LOG_LOGIC ("Channel open between ground station " << i << " and plane " << closestSat/num_satellites_per_plane << " satellite "<<closestSat%num_satellites_per_plane<<" with distance "<<closestSatDist<< "km and delay of "<<delay.GetSeconds()<<" seconds");
+    m_groundLinkTrace(i, closestSat, closestSatDist, delay, true);
   }
 
   //Configure IP Addresses for all NetDevices
-  Ipv4AddressHelper address;
-  address.SetBase ("10.1.0.0", "255.255.255.0");
+  //addresses follow from the position of the devices in the constellation, they are assigned directly
+  //instead of through Ipv4AddressHelper, whose duplicate check scans every address allocated so far
+  uint32_t intra_plane_base = Ipv4Address ("10.1.0.0").Get ();
+  uint32_t ground_base = Ipv4Address ("10.128.0.0").Get ();
+  uint32_t ground_link_base = Ipv4Address ("10.192.0.0").Get ();
+  NS_ABORT_MSG_IF (intra_plane_base + ((2*num_planes*num_satellites_per_plane + 1) << 8) > ground_base,
+                   "Too many satellites for the 10.1.0.0 - 10.127.255.255 range of the satellite links");
+  NS_ABORT_MSG_IF (uint64_t (this->ground_link_devices.size()) << 2 > ground_link_base - ground_base,
+                   "Too many ground links for the 10.192.0.0/10 range of the ground links");
+  //another constellation or helper allocating the same addresses is still caught as a collision
+  Ipv4AddressGenerator::AddAllocated (Ipv4Address (intra_plane_base + (1 << 8) + 1));
+  Ipv4AddressGenerator::AddAllocated (Ipv4Address (ground_base + 1));
+  Ipv4AddressGenerator::AddAllocated (Ipv4Address (ground_link_base + 1));
 
-  //configuring IP Addresses for IntraPlane devices
+  //configuring IP Addresses for IntraPlane devices, one /24 network per link starting at 10.1.1.0
+  Ipv4Mask link_mask ("255.255.255.0");
   for(uint32_t i=0; i< this->intra_plane_devices.size(); i++)
   {
-    address.NewNetwork();
-    this->intra_plane_interfaces.push_back(address.Assign(this->intra_plane_devices[i]));
+    Ipv4InterfaceContainer interfaces;
+    interfaces.Add(AssignAddress(this->intra_plane_devices[i].Get(0), Ipv4Address(intra_plane_base + ((i + 1) << 8) + 1), link_mask, true));
+    interfaces.Add(AssignAddress(this->intra_plane_devices[i].Get(1), Ipv4Address(intra_plane_base + ((i + 1) << 8) + 2), link_mask, true));
+    this->intra_plane_interfaces.push_back(interfaces);
   }
   
-  //configuring IP Addresses for InterPlane devices
-  for(uint32_t i=0; i< this->inter_plane_devices.size(); i++)
+  //configuring IP Addresses for InterPlane devices, the two ends first linked share the network following the intra-plane ones
+  for(uint32_t i=0; i< this->inter_plane_channels.size(); i++)
   {
-    address.NewNetwork();
-    this->inter_plane_interfaces.push_back(address.Assign(this->inter_plane_devices[i]));
-    for(uint32_t j=1; j<= this->num_satellites_per_plane; j++)
-    {
-      if(j != this->inter_plane_channel_tracker[i] + 1)
-      {
-        std::pair< Ptr< Ipv4 >, uint32_t > interface = this->inter_plane_interfaces[i].Get(j);
-        interface.first->SetDown(interface.second);
-      }
-    }
+    uint32_t network = intra_plane_base + ((this->intra_plane_devices.size() + i + 1) << 8);
+    AssignAddress(this->inter_plane_channels[i]->GetDevice(0), Ipv4Address(network + 1), link_mask, true);
+    AssignAddress(this->inter_plane_channels[i]->GetDevice(1), Ipv4Address(network + 2), link_mask, true);
   }
 
-  //configuring IP Addresses for Ground devices
+  //configuring IP Addresses for Ground devices, every ground station and every ground link of the satellites has its own /30 network
+  //ground links without ground station are down
+  Ipv4Mask ground_mask ("255.255.255.252");
   for(uint32_t i=0; i< this->ground_station_devices.size(); i++)
   {
-    address.NewNetwork();
-    this->ground_station_interfaces.push_back(address.Assign(this->ground_station_devices[i]));
-    for(uint32_t j=1; j<= this->num_satellites_per_plane; j++)
+    Ipv4InterfaceContainer interfaces;
+    interfaces.Add(AssignAddress(this->ground_station_devices[i], Ipv4Address(ground_base + (i << 2) + 1), ground_mask, true));
+    this->ground_station_interfaces.push_back(interfaces);
+  }
+  for(uint32_t i=0; i< this->ground_link_devices.size(); i++)
+  {
+    AssignAddress(this->ground_link_devices[i], Ipv4Address(ground_link_base + (i << 2) + 1), ground_mask,
+                  this->ground_link_users[i] != NO_GROUND_STATION);
+  }
+
+  //Populate Routing Tables
+  NS_LOG_INFO ("Populating Routing Tables");
+  if (m_routing != GLOBAL_ROUTING)
+    PopulateRouteManager ();
+  else
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+  NS_LOG_INFO ("Finished Populating Routing Tables");
+  if (m_linkStateStream.is_open())
+    m_linkStateStream.flush();
+
+  if (m_nullMessages)
+  {
+    std::vector<Ptr<LeoSatelliteIslChannel> > channels(this->inter_plane_channels);
+    channels.insert(channels.end(), this->ground_station_channels.begin(), this->ground_station_channels.end());
+    for (uint32_t i=0; i<channels.size(); i++)
     {
-      if(j != this->ground_station_channel_tracker[i] + 1)
-      {
-        std::pair< Ptr< Ipv4 >, uint32_t > interface = this->ground_station_interfaces[i].Get(j);
-        interface.first->SetDown(interface.second);
-      }
+      uint32_t a = channels[i]->GetDevice(0)->GetNode()->GetSystemId();
+      uint32_t b = channels[i]->GetDevice(1)->GetNode()->GetSystemId();
+      if (a != b)
+        m_remoteRanks.insert(std::make_pair(std::min(a, b), std::max(a, b)));
     }
   }
 
-  //Populate Routing Tables
-  std::cout<<"Populating Routing Tables"<<std::endl;
-  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
-  std::cout<<"Finished Populating Routing Tables"<<std::endl;
+  if (m_scheduleHandovers)
+    ScheduleNextHandover();
 
   // Set up packet sniffing for entire network
   /*CsmaHelper csma;
@@ -285,140 +527,607 @@ LeoSatelliteConfig::LeoSatelliteConfig (uint32_t num_planes, uint32_t num_satell
   }*/
 }
 
-void LeoSatelliteConfig::UpdateLinks()
+void LeoSatelliteConfig::ComputeLinks (Time time, std::vector<uint32_t> &inter_plane_targets, std::vector<uint32_t> &ground_station_targets)
 {
-  std::cout<<std::endl<<std::endl<<std::endl<<"Updating Links"<<std::endl;
+  //positions of all satellites at time, read by the planning of the planes
+  UpdateSpatialIndex(time);
 
-  std::vector<NodeContainer> update_links_plane = this->plane;
-  NodeContainer final_plane;
-  for(uint32_t j=0; j<num_satellites_per_plane; j++)
+  inter_plane_targets.resize(num_planes*num_satellites_per_plane);
+  for (uint32_t i=0; i<this->num_planes; i++)
   {
-    final_plane.Add(this->plane[0].Get(num_satellites_per_plane - j - 1));
+    PlanInterPlaneLinks(i, inter_plane_targets);
   }
-  update_links_plane.push_back(final_plane);
- 
-  for (uint32_t i=0; i<this->num_planes; i++)
+
+  ComputeGroundLinks(time, ground_station_targets);
+}
+
+void LeoSatelliteConfig::ComputeGroundLinks (Time time, std::vector<uint32_t> &ground_station_targets)
+{
+  ground_station_targets.resize(m_groundPositions.size());
+  if (m_contactPlan != 0 && m_contactPlan->Covers(time))
   {
-    Vector refSatPos;
-    uint32_t refSat = 0;
-    //find reference satellite (closest to equator)
-    for (uint32_t j=0; j<this->num_satellites_per_plane; j++)
+    for (uint32_t i=0; i<m_groundPositions.size(); i++)
     {
-      Vector pos = update_links_plane[i].Get(j)->GetObject<MobilityModel>()->GetPosition();
-      if ((std::abs(pos.x) < std::abs(refSatPos.x)) || j == 0)
-      {
-        refSatPos = pos;
-        refSat = j;
-      }
+      ground_station_targets[i] = m_contactPlan->GetSatellite(i, time);
     }
+    return;
+  }
 
-    //find the closest adjacent satellite to the reference satellite
-    uint32_t closestAdjSat = 0;
-    double closestAdjSatDist = 0;
-    Vector adjPos; //debug
-    for (uint32_t j=0; j<this->num_satellites_per_plane; j++)
+  //closest satellite of the whole constellation with a free ground link for every ground station
+  m_groundLinkLoad.assign(num_planes*num_satellites_per_plane, 0);
+  for (uint32_t i=0; i<m_groundPositions.size(); i++)
+  {
+    ground_station_targets[i] = m_spatialIndex->FindNearest(m_groundPositions[i], MakeCallback(&LeoSatelliteConfig::HasFreeGroundLink, this));
+    m_groundLinkLoad[ground_station_targets[i]]++;
+  }
+}
+
+void LeoSatelliteConfig::SetupContactPlan (Time start)
+{
+  Time end = start + m_contactPlanDuration;
+  uint64_t key = GetScenarioKey(start);
+  Ptr<LeoSatelliteContactPlan> contact_plan = CreateObject<LeoSatelliteContactPlan> ();
+  if (!m_contactPlanFile.empty() && contact_plan->Load(m_contactPlanFile, key))
+  {
+    NS_LOG_INFO ("Contact plan loaded from " << m_contactPlanFile);
+    m_contactPlan = contact_plan;
+    return;
+  }
+
+  NS_LOG_INFO ("Computing the contact plan from " << start.GetSeconds() << " s to " << end.GetSeconds() << " s");
+  std::vector<std::vector<LeoSatelliteContactPlan::Contact> > contacts;
+  BuildContactPlan(start, end, contacts);
+  contact_plan->SetContacts(contacts, start, end, num_planes*num_satellites_per_plane, key);
+  if (!m_contactPlanFile.empty())
+    contact_plan->Save(m_contactPlanFile);
+  m_contactPlan = contact_plan;
+}
+
+void LeoSatelliteConfig::BuildContactPlan (Time start, Time end, std::vector<std::vector<LeoSatelliteContactPlan::Contact> > &contacts)
+{
+  //same search as PredictNextHandover: steps of a fraction of the satellite spacing,
+  //then bisection down to HandoverResolution for every change found within a step
+  Time step = GetHandoverStep();
+  std::vector<uint32_t> current, next;
+  UpdateSpatialIndex(start);
+  ComputeGroundLinks(start, current);
+  contacts.assign(current.size(), std::vector<LeoSatelliteContactPlan::Contact> ());
+  for (uint32_t i=0; i<current.size(); i++)
+  {
+    LeoSatelliteContactPlan::Contact contact = {start.GetNanoSeconds(), end.GetNanoSeconds(), current[i], 0};
+    contacts[i].push_back(contact);
+  }
+
+  Time before = start;
+  while (before < end)
+  {
+    Time after = std::min(before + step, end);
+    UpdateSpatialIndex(after);
+    ComputeGroundLinks(after, next);
+    while (next != current)
     {
-      Vector pos = update_links_plane[i+1].Get(j)->GetObject<MobilityModel>()->GetPosition();
-      double temp_dist = CalculateDistance(refSatPos,pos);
-      if((temp_dist < closestAdjSatDist) || (j==0))
+      //first change within (before, after]
+      Time low = before;
+      Time high = after;
+      while (high - low > m_handoverResolution)
       {
-        closestAdjSatDist = temp_dist;
-        closestAdjSat = j;
-        adjPos = pos; //debug
+        Time middle = low + (high - low)/2;
+        UpdateSpatialIndex(middle);
+        ComputeGroundLinks(middle, next);
+        if (next == current)
+          low = middle;
+        else
+          high = middle;
       }
+      if (high >= end)
+        break;
+      UpdateSpatialIndex(high);
+      ComputeGroundLinks(high, next);
+      for (uint32_t i=0; i<current.size(); i++)
+      {
+        if (next[i] == current[i])
+          continue;
+        contacts[i].back().end = high.GetNanoSeconds();
+        LeoSatelliteContactPlan::Contact contact = {high.GetNanoSeconds(), end.GetNanoSeconds(), next[i], 0};
+        contacts[i].push_back(contact);
+      }
+      current = next;
+      before = high;
+      UpdateSpatialIndex(after);
+      ComputeGroundLinks(after, next);
     }
+    before = after;
+  }
+}
 
-    //calculate the reference increment factor for adjacent satellites in a plane
-    uint32_t ref_incr;
-    (refSat <= closestAdjSat) ? (ref_incr = closestAdjSat - refSat) : (ref_incr = this->num_satellites_per_plane - refSat + closestAdjSat);
+uint64_t LeoSatelliteConfig::GetScenarioKey (Time start) const
+{
+  //FNV-1a over the parameters, the ground positions and the satellite positions at start,
+  //which also stand for the contents of a TLE file
+  std::vector<double> values;
+  values.push_back(num_planes);
+  values.push_back(num_satellites_per_plane);
+  values.push_back(m_altitude);
+  values.push_back(m_orbits);
+  values.push_back(m_inclination);
+  values.push_back(m_walkerPhasing);
+  values.push_back(m_earthRotation);
+  values.push_back(m_groundLinksPerSatellite);
+  values.push_back(m_handoverResolution.GetNanoSeconds());
+  values.push_back(GetHandoverStep().GetNanoSeconds());
+  values.push_back(start.GetNanoSeconds());
+  values.push_back(m_contactPlanDuration.GetNanoSeconds());
+  for (uint32_t i=0; i<m_groundPositions.size(); i++)
+  {
+    values.push_back(m_groundPositions[i].x);
+    values.push_back(m_groundPositions[i].y);
+    values.push_back(m_groundPositions[i].z);
+  }
+  for (uint32_t i=0; i<m_satelliteMobility.size(); i++)
+  {
+    Vector position = m_satelliteMobility[i]->PropagatePosition(start);
+    values.push_back(position.x);
+    values.push_back(position.y);
+    values.push_back(position.z);
+  }
+  uint64_t key = 14695981039346656037ULL;
+  const unsigned char *bytes = reinterpret_cast<const unsigned char *> (&values[0]);
+  for (uint64_t i=0; i<values.size()*sizeof (double); i++)
+  {
+    key = (key ^ bytes[i])*1099511628211ULL;
+  }
+  return key;
+}
+
+bool LeoSatelliteConfig::HasReversedSeam () const
+{
+  return m_orbits == POLAR_ORBITS;
+}
+
+bool LeoSatelliteConfig::HasFreeGroundLink (uint32_t satellite) const
+{
+  return m_groundLinkLoad[satellite] < m_groundLinksPerSatellite;
+}
+
+void LeoSatelliteConfig::UpdateLinks()
+{
+  NS_LOG_INFO ("Updating Links");
 
+  Time now = Simulator::Now();
+  std::vector<uint32_t> inter_plane_targets;
+  std::vector<uint32_t> ground_station_targets;
+  ComputeLinks(now, inter_plane_targets, ground_station_targets);
+
+  for (uint32_t i=0; i<this->num_planes; i++)
+  {
     //update all adjacent satellites for this plane
     for (uint32_t j=0; j<this->num_satellites_per_plane; j++)
     {
       uint32_t access_idx = i*(this->num_satellites_per_plane) + j;
       uint32_t currAdjNodeID = this->inter_plane_channel_tracker[access_idx];
-      uint32_t nextAdjNodeID = (j + ref_incr)%(this->num_satellites_per_plane);
-      double nextAdjNodeDist;
-
-      Vector constNodePos = update_links_plane[i].Get(j)->GetObject<MobilityModel>()->GetPosition();
-      Vector nextAdjNodePos = update_links_plane[(i+1)/*%(this->num_planes)*/].Get(nextAdjNodeID)->GetObject<MobilityModel>()->GetPosition();
+      uint32_t nextAdjNodeID = inter_plane_targets[access_idx];
 
-      nextAdjNodeDist = CalculateDistance(constNodePos, nextAdjNodePos);
-
-      if (i == this->num_planes - 1)
-        nextAdjNodeID = num_satellites_per_plane - nextAdjNodeID - 1;
-
-      if(currAdjNodeID == nextAdjNodeID)
+      Ptr<LeoSatelliteIslChannel> channel = this->inter_plane_channels[access_idx];
+      if(currAdjNodeID != nextAdjNodeID)
       {
-        double new_delay = (nextAdjNodeDist*1000)/speed_of_light;
-        this->inter_plane_channels[access_idx]->SetAttribute("Delay", TimeValue(Seconds(new_delay)));
-        std::cout<<"Channel updated between plane "<<i<<" satellite "<<j<<" and plane "<<(i+1)%num_planes<<" satellite "<<nextAdjNodeID<< " with distance "<<nextAdjNodeDist<< "km and delay of "<<new_delay<<" seconds"<<std::endl;
-      }
-      else
-      {
-        this->inter_plane_channels[access_idx]->Detach(this->inter_plane_devices[access_idx].Get(currAdjNodeID+1)->GetObject<CsmaNetDevice> ());
-        std::pair< Ptr< Ipv4 >, uint32_t> interface = this->inter_plane_interfaces[access_idx].Get(currAdjNodeID+1);
-        interface.first->SetDown(interface.second);
-        this->inter_plane_channels[access_idx]->Reattach(this->inter_plane_devices[access_idx].Get(nextAdjNodeID+1)->GetObject<CsmaNetDevice> ());
-        interface = this->inter_plane_interfaces[access_idx].Get(nextAdjNodeID+1);
-        interface.first->SetUp(interface.second);
+        //the new peer leaves the link it was on, which gets its own new peer later in this loop
+        Ptr<LeoSatelliteIslNetDevice> peer = this->inter_plane_west_devices[((i+1)%num_planes)*num_satellites_per_plane + nextAdjNodeID];
+        channel->SetPeer(peer);
+        if (m_nullMessages)
+          CheckRemoteRanks(channel);
+        if (m_routeManager != 0)
+        {
+          std::pair< Ptr< Ipv4 >, uint32_t> interface = GetInterface(peer);
+          m_routeManager->UpdateLink(this->inter_plane_route_links[access_idx], peer->GetNode(), interface.second);
+        }
         this->inter_plane_channel_tracker[access_idx] = nextAdjNodeID;
-        double new_delay = (nextAdjNodeDist*1000)/speed_of_light;
-        this->inter_plane_channels[access_idx]->SetAttribute("Delay", TimeValue(Seconds(new_delay)));
-        std::cout<<"New channel between plane "<<i<<" satellite "<<j<<" and plane "<<(i+1)%num_planes<<" satellite "<<nextAdjNodeID<< " with distance "<<nextAdjNodeDist<< "km and delay of "<<new_delay<<" seconds"<<std::endl;
       }
+
+      //the channel computes the delay of every packet, the distance is only reported
+      double nextAdjNodeDist = channel->GetDistance();
+      Time new_delay = channel->GetDelay();
+      m_interPlaneLinkTrace(access_idx, ((i+1)%num_planes)*num_satellites_per_plane + nextAdjNodeID, nextAdjNodeDist, new_delay, currAdjNodeID != nextAdjNodeID);
+      NS_LOG_LOGIC ((currAdjNodeID == nextAdjNodeID ? "Channel updated" : "New channel")<<" between plane "<<i<<" satellite "<<j<<" and plane "<<(i+1)%num_planes<<" satellite "<<nextAdjNodeID<< " with distance "<<nextAdjNodeDist<< "km and delay of "<<new_delay.GetSeconds()<<" seconds");
     }
   }
 
   //updating links between ground stations and their closest satellites
-  for (uint32_t i=0; i<2; i++)
-  {
-    Vector gndPos = ground_stations.Get(i)->GetObject<MobilityModel> ()->GetPosition();
-    uint32_t closestAdjSat = 0;
-    uint32_t closestAdjSatDist = 0;
-    uint32_t planeIndex;
-    if (i == 0)
-      planeIndex = 0;
+  //ground links left by a ground station are freed before any is taken, as another station may take them
+  for (uint32_t i=0; i<ground_stations.GetN(); i++)
+  {
+    if (this->ground_station_channel_tracker[i] == ground_station_targets[i])
+      continue;
+    Ptr<NetDevice> previous = this->ground_station_channels[i]->GetDevice(1);
+    std::pair< Ptr< Ipv4 >, uint32_t> interface = GetInterface(previous);
+    interface.first->SetDown(interface.second);
+    uint32_t slot = this->ground_station_channel_tracker[i]*m_groundLinksPerSatellite;
+    while (this->ground_link_devices[slot] != previous)
+      slot++;
+    this->ground_link_users[slot] = NO_GROUND_STATION;
+  }
+  for (uint32_t i=0; i<ground_stations.GetN(); i++)
+  {
+    uint32_t closestSat = ground_station_targets[i];
+    uint32_t currAdjNodeID = this->ground_station_channel_tracker[i];
+    if(currAdjNodeID != closestSat)
+    {
+      uint32_t slot = closestSat*m_groundLinksPerSatellite;
+      while (this->ground_link_users[slot] != NO_GROUND_STATION)
+        slot++;
+      this->ground_link_users[slot] = i;
+      this->ground_station_channels[i]->SetPeer(this->ground_link_devices[slot]);
+      if (m_nullMessages)
+        CheckRemoteRanks(this->ground_station_channels[i]);
+      std::pair< Ptr< Ipv4 >, uint32_t> interface = GetInterface(this->ground_link_devices[slot]);
+      interface.first->SetUp(interface.second);
+      if (m_routeManager != 0)
+        m_routeManager->UpdateLink(this->ground_station_route_links[i], interface.first->GetObject<Node> (), interface.second);
+      this->ground_station_channel_tracker[i] = closestSat;
+    }
+
+    double closestSatDist = this->ground_station_channels[i]->GetDistance();
+    Time new_delay = this->ground_station_channels[i]->GetDelay();
+    m_groundLinkTrace(i, closestSat, closestSatDist, new_delay, currAdjNodeID != closestSat);
+    NS_LOG_LOGIC ((currAdjNodeID == closestSat ? "Channel updated" : "New channel")<<" between ground station "<<i<<" and plane "<<closestSat/num_satellites_per_plane<<" satellite "<<closestSat%num_satellites_per_plane<< " with distance "<<closestSatDist<< "km and delay of "<<new_delay.GetSeconds()<<" seconds");
+  }
+  
+  //Recompute Routing Tables
+  NS_LOG_INFO ("Recomputing Routing Tables");
+  if (m_routing != GLOBAL_ROUTING)
+  {
+    uint32_t rebuilt = m_routeManager->UpdateRoutes ();
+    NS_LOG_INFO ("Updated routes towards "<<rebuilt<<" of "<<m_routeManager->GetNNodes ()<<" nodes");
+  }
+  else
+    Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+  NS_LOG_INFO ("Finished Recomputing Routing Tables");
+  if (m_linkStateStream.is_open())
+    m_linkStateStream.flush();
+}
+
+Time LeoSatelliteConfig::PredictNextHandover (Time from, Time horizon)
+{
+  std::vector<uint32_t> inter_plane_from, ground_station_from;
+  ComputeLinks(from, inter_plane_from, ground_station_from);
+
+  //links only change partner once the satellites moved by a fraction of their spacing,
+  //look for the first step with other links, then for the instant of the change within it
+  Time step = GetHandoverStep();
+  std::vector<uint32_t> inter_plane_to, ground_station_to;
+  Time before = from;
+  Time after = from;
+  do
+  {
+    before = after;
+    after = std::min(after + step, from + horizon);
+    ComputeLinks(after, inter_plane_to, ground_station_to);
+  }
+  while (inter_plane_to == inter_plane_from && ground_station_to == ground_station_from && after < from + horizon);
+  if (inter_plane_to == inter_plane_from && ground_station_to == ground_station_from)
+    return Time::Max();
+
+  while (after - before > m_handoverResolution)
+  {
+    Time middle = before + (after - before)/2;
+    ComputeLinks(middle, inter_plane_to, ground_station_to);
+    if (inter_plane_to == inter_plane_from && ground_station_to == ground_station_from)
+      before = middle;
     else
-      planeIndex = floor(3*num_planes/7);
-    //find closest adjacent satellite for ground station
+      after = middle;
+  }
+  return after;
+}
+
+Time LeoSatelliteConfig::GetHandoverStep () const
+{
+  Time spacing = Seconds(360/m_ephemeris->GetAngularSpeed(0)/num_satellites_per_plane);
+  if (m_handoverStep.IsZero())
+    return spacing/8;
+  NS_ABORT_MSG_IF (m_handoverStep > spacing/2, "HandoverStep " << m_handoverStep.GetSeconds() << " s longer than half of the "
+                   << spacing.GetSeconds() << " s between two satellites of a plane");
+  return m_handoverStep;
+}
+
+void LeoSatelliteConfig::ScheduleNextHandover ()
+{
+  //links that are not where they should be are updated right away
+  Time now = Simulator::Now();
+  std::vector<uint32_t> inter_plane_targets, ground_station_targets;
+  ComputeLinks(now, inter_plane_targets, ground_station_targets);
+  Time next = now;
+  if (inter_plane_targets == inter_plane_channel_tracker && ground_station_targets == ground_station_channel_tracker)
+  {
+    //a full orbit brings back the links of the start, unless the orbits drift or the Earth rotates,
+    //so without a change within it the links are checked again at its end
+    Time horizon = Seconds(360/m_ephemeris->GetAngularSpeed(0));
+    next = PredictNextHandover(now, horizon);
+    if (next == Time::Max())
+    {
+      NS_LOG_LOGIC ("no handover within " << horizon.GetSeconds() << " s");
+      m_handoverEvent = Simulator::Schedule(horizon, &LeoSatelliteConfig::ScheduleNextHandover, this);
+      return;
+    }
+  }
+  NS_LOG_LOGIC ("next handover at " << next.GetSeconds() << " s");
+  m_handoverEvent = Simulator::Schedule(next - now, &LeoSatelliteConfig::HandleHandover, this);
+}
+
+void LeoSatelliteConfig::HandleHandover ()
+{
+  UpdateLinks();
+  ScheduleNextHandover();
+}
+
+Ptr<LeoSatelliteRouteManager> LeoSatelliteConfig::GetRouteManager () const
+{
+  return m_routeManager;
+}
+
+Ptr<LeoSatelliteEphemeris> LeoSatelliteConfig::GetEphemeris () const
+{
+  return m_ephemeris;
+}
+
+Ptr<LeoSatelliteContactPlan> LeoSatelliteConfig::GetContactPlan () const
+{
+  return m_contactPlan;
+}
+
+std::vector<Vector> LeoSatelliteConfig::LoadGroundStations (std::string file_name)
+{
+  std::ifstream file (file_name.c_str());
+  NS_ABORT_MSG_UNLESS (file.is_open(), "Ground stations file " << file_name << " not found");
+
+  std::vector<Vector> positions;
+  std::string line;
+  uint32_t line_number = 0;
+  while (std::getline(file, line))
+  {
+    line_number++;
+    std::replace(line.begin(), line.end(), ',', ' ');
+    std::istringstream fields (line);
+    std::string first;
+    if (!(fields >> first) || first[0] == '#')
+      continue; //empty line or comment
+
+    fields.clear();
+    fields.str(line);
+    double latitude, longitude;
+    if (!(fields >> latitude >> longitude))
+    {
+      //a header is allowed on the first line only
+      NS_ABORT_MSG_UNLESS (positions.empty() && line_number == 1, "Invalid ground station on line " << line_number << " of " << file_name);
+      continue;
+    }
+    NS_ABORT_MSG_UNLESS (std::abs(latitude) <= 90 && std::abs(longitude) <= 180,
+                         "Ground station out of range on line " << line_number << " of " << file_name);
+    //the altitude is optional
+    double altitude = 0;
+    std::string third;
+    if (fields >> third)
+    {
+      std::istringstream altitude_field (third);
+      NS_ABORT_MSG_UNLESS ((altitude_field >> altitude) && altitude_field.eof(),
+                           "Invalid altitude on line " << line_number << " of " << file_name);
+    }
+    positions.push_back(Vector(latitude, longitude, altitude));
+  }
+  NS_ABORT_MSG_IF (positions.empty(), "No ground station in " << file_name);
+  return positions;
+}
+
+Vector LeoSatelliteConfig::GetSatellitePosition (uint32_t plane, uint32_t index, Time time) const
+{
+  return m_satelliteMobility[plane*num_satellites_per_plane + index]->GetPositionAt(time);
+}
+
+void LeoSatelliteConfig::PlanInterPlaneLinks (uint32_t i, std::vector<uint32_t> &inter_plane_targets) const
+{
+  //with polar orbits, the plane after the last one is plane 0 in reverse order
+  uint32_t next_plane = (i+1)%num_planes;
+  bool reversed = (i == this->num_planes - 1) && HasReversedSeam();
+
+  Vector refSatPos;
+  uint32_t refSat = 0;
+  //find reference satellite (closest to equator)
+  for (uint32_t j=0; j<this->num_satellites_per_plane; j++)
+  {
+    const Vector &pos = m_satellitePositions[i*num_satellites_per_plane + j];
+    if ((std::abs(pos.x) < std::abs(refSatPos.x)) || j == 0)
+    {
+      refSatPos = pos;
+      refSat = j;
+    }
+  }
+
+  //find the closest adjacent satellite to the reference satellite
+  uint32_t closestAdjSat = 0;
+  double closestAdjSatDist = 0;
+  for (uint32_t j=0; j<this->num_satellites_per_plane; j++)
+  {
+    const Vector &pos = m_satellitePositions[next_plane*num_satellites_per_plane + (reversed ? num_satellites_per_plane - j - 1 : j)];
+    double temp_dist = CalculateDistance(refSatPos,pos);
+    if((temp_dist < closestAdjSatDist) || (j==0))
+    {
+      closestAdjSatDist = temp_dist;
+      closestAdjSat = j;
+    }
+  }
+
+  //calculate the reference increment factor for adjacent satellites in a plane
+  uint32_t ref_incr;
+  (refSat <= closestAdjSat) ? (ref_incr = closestAdjSat - refSat) : (ref_incr = this->num_satellites_per_plane - refSat + closestAdjSat);
+
+  //all adjacent satellites for this plane, every plane writes its own part of inter_plane_targets
+  for (uint32_t j=0; j<this->num_satellites_per_plane; j++)
+  {
+    uint32_t nextAdjNodeID = (j + ref_incr)%(this->num_satellites_per_plane);
+    if (reversed)
+      nextAdjNodeID = num_satellites_per_plane - nextAdjNodeID - 1;
+    inter_plane_targets[i*num_satellites_per_plane + j] = nextAdjNodeID;
+  }
+}
+
+void LeoSatelliteConfig::UpdateSpatialIndex (Time time)
+{
+  m_satellitePositions.resize(num_planes*num_satellites_per_plane);
+  for (uint32_t i=0; i<this->num_planes; i++)
+  {
     for (uint32_t j=0; j<this->num_satellites_per_plane; j++)
     {
-      Vector pos = this->plane[planeIndex].Get(j)->GetObject<MobilityModel>()->GetPosition();
-      double temp_dist = CalculateDistanceGroundToSat(gndPos,pos);
-      if((temp_dist < closestAdjSatDist) || (j==0))
-      {
-        closestAdjSatDist = temp_dist;
-        closestAdjSat = j;
-      }
+      m_satellitePositions[i*num_satellites_per_plane + j] = GetSatellitePosition(i, j, time);
     }
+  }
+  uint32_t moved = m_spatialIndex->Update(m_satellitePositions);
+  NS_LOG_LOGIC (moved << " satellites changed cell of the spatial index");
+}
 
-    uint32_t currAdjNodeID = this->ground_station_channel_tracker[i];
-    if(currAdjNodeID == closestAdjSat)
+void LeoSatelliteConfig::WriteInterPlaneLinkState (uint32_t a, uint32_t b, double distance, Time delay, bool repointed)
+{
+  WriteLinkState('I', a, b, distance, delay, repointed);
+}
+
+void LeoSatelliteConfig::WriteGroundLinkState (uint32_t a, uint32_t b, double distance, Time delay, bool repointed)
+{
+  WriteLinkState('G', a, b, distance, delay, repointed);
+}
+
+void LeoSatelliteConfig::WriteLinkState (char link, uint32_t a, uint32_t b, double distance, Time delay, bool repointed)
+{
+  double time = Simulator::Now().GetSeconds();
+  double delay_s = delay.GetSeconds();
+  if (m_linkStateFormat == CSV_LINK_STATE)
+  {
+    m_linkStateStream << time << ',' << link << ',' << a << ',' << b << ',' << distance << ',' << delay_s << ',' << repointed << '\n';
+    return;
+  }
+  uint8_t flag = repointed;
+  m_linkStateStream.write(reinterpret_cast<const char *> (&time), sizeof (time));
+  m_linkStateStream.write(&link, 1);
+  m_linkStateStream.write(reinterpret_cast<const char *> (&flag), 1);
+  m_linkStateStream.write(reinterpret_cast<const char *> (&a), sizeof (a));
+  m_linkStateStream.write(reinterpret_cast<const char *> (&b), sizeof (b));
+  m_linkStateStream.write(reinterpret_cast<const char *> (&distance), sizeof (distance));
+  m_linkStateStream.write(reinterpret_cast<const char *> (&delay_s), sizeof (delay_s));
+}
+
+std::pair<Ptr<Ipv4>, uint32_t> LeoSatelliteConfig::AssignAddress (Ptr<NetDevice> device, Ipv4Address address, Ipv4Mask mask, bool up) const
+{
+  //same as Ipv4AddressHelper::Assign, with the address given
+  Ptr<Node> node = device->GetNode();
+  Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+  int32_t interface = ipv4->GetInterfaceForDevice(device);
+  if (interface == -1)
+    interface = ipv4->AddInterface(device);
+  ipv4->AddAddress(interface, Ipv4InterfaceAddress(address, mask));
+  ipv4->SetMetric(interface, 1);
+  if (up)
+    ipv4->SetUp(interface);
+
+  Ptr<TrafficControlLayer> tc = node->GetObject<TrafficControlLayer> ();
+  Ptr<NetDeviceQueueInterface> ndqi = device->GetObject<NetDeviceQueueInterface> ();
+  if (tc != 0 && ndqi != 0 && tc->GetRootQueueDiscOnDevice(device) == 0)
+  {
+    TrafficControlHelper tcHelper = TrafficControlHelper::Default(ndqi->GetNTxQueues());
+    tcHelper.Install(device);
+  }
+  return std::make_pair(ipv4, uint32_t (interface));
+}
+
+Ptr<LeoSatelliteIslNetDevice> LeoSatelliteConfig::CreateIslDevice (Ptr<Node> node) const
+{
+  Ptr<LeoSatelliteIslNetDevice> device = CreateObject<LeoSatelliteIslNetDevice> ();
+  node->AddDevice(device);
+  if (m_ranks > 1)
+  {
+    //packets sent by other ranks are handed to the device by the MPI interface through its receiver
+    Ptr<MpiReceiver> receiver = CreateObject<MpiReceiver> ();
+    receiver->SetReceiveCallback(MakeCallback(&LeoSatelliteIslNetDevice::Receive, device));
+    device->AggregateObject(receiver);
+  }
+  return device;
+}
+
+Ptr<LeoSatelliteIslChannel> LeoSatelliteConfig::CreateIslChannel () const
+{
+  Ptr<LeoSatelliteIslChannel> channel = CreateObject<LeoSatelliteIslChannel> ();
+  //the distributed simulators take the lookahead from the Delay of the channels between ranks
+  if (m_ranks > 1)
+    channel->SetAttribute("Delay", TimeValue(m_remoteLinkLookahead));
+  return channel;
+}
+
+void LeoSatelliteConfig::CheckRemoteRanks (Ptr<LeoSatelliteIslChannel> channel) const
+{
+  uint32_t a = channel->GetDevice(0)->GetNode()->GetSystemId();
+  uint32_t b = channel->GetDevice(1)->GetNode()->GetSystemId();
+  NS_ABORT_MSG_IF (a != b && m_remoteRanks.count(std::make_pair(std::min(a, b), std::max(a, b))) == 0,
+                   "Handover links ranks " << std::min(a, b) << " and " << std::max(a, b) << ", which were not linked at the start "
+                   "and are not synchronized by ns3::NullMessageSimulatorImpl; use ns3::DistributedSimulatorImpl");
+}
+
+uint32_t LeoSatelliteConfig::GetPlaneSystemId (uint32_t plane, uint32_t num_planes, uint32_t ranks)
+{
+  NS_ASSERT (plane < num_planes && ranks > 0);
+  return uint64_t (plane)*ranks/num_planes;
+}
+
+std::pair<Ptr<Ipv4>, uint32_t> LeoSatelliteConfig::GetInterface (Ptr<NetDevice> device) const
+{
+  Ptr<Ipv4> ipv4 = device->GetNode()->GetObject<Ipv4> ();
+  return std::make_pair(ipv4, uint32_t (ipv4->GetInterfaceForDevice(device)));
+}
+
+void LeoSatelliteConfig::PopulateRouteManager ()
+{
+  for (uint32_t i=0; i<this->num_planes; i++)
+  {
+    for (uint32_t j=0; j<this->num_satellites_per_plane; j++)
     {
-      double new_delay = (closestAdjSatDist*1000)/speed_of_light;
-      this->ground_station_channels[i]->SetAttribute("Delay", TimeValue(Seconds(new_delay)));
-      std::cout<<"Channel updated between ground station "<<i<<" and plane "<<planeIndex<<" satellite "<<closestAdjSat<< " with distance "<<closestAdjSatDist<< "km and delay of "<<new_delay<<" seconds"<<std::endl;
-      }
-      else
+      m_routeManager->AddNode(this->plane[i].Get(j));
+    }
+  }
+  for (uint32_t i=0; i<this->ground_stations.GetN(); i++)
+  {
+    m_routeManager->AddNode(this->ground_stations.Get(i));
+  }
+
+  Ptr<LeoSatelliteGridRouteManager> grid = DynamicCast<LeoSatelliteGridRouteManager> (m_routeManager);
+  if (grid != 0)
+  {
+    grid->SetGrid(this->num_planes, this->num_satellites_per_plane, HasReversedSeam());
+    for (uint32_t i=0; i<this->num_planes; i++)
+    {
+      for (uint32_t j=0; j<this->num_satellites_per_plane; j++)
       {
-        this->ground_station_channels[i]->Detach(this->ground_station_devices[i].Get(currAdjNodeID+1)->GetObject<CsmaNetDevice> ());
-        std::pair< Ptr< Ipv4 >, uint32_t> interface = this->ground_station_interfaces[i].Get(currAdjNodeID+1);
-        interface.first->SetDown(interface.second);
-        this->ground_station_channels[i]->Reattach(this->ground_station_devices[i].Get(closestAdjSat+1)->GetObject<CsmaNetDevice> ());
-        interface = this->ground_station_interfaces[i].Get(closestAdjSat+1);
-        interface.first->SetUp(interface.second);
-        this->ground_station_channel_tracker[i] = closestAdjSat;
-        double new_delay = (closestAdjSatDist*1000)/speed_of_light;
-        this->ground_station_channels[i]->SetAttribute("Delay", TimeValue(Seconds(new_delay)));
-        std::cout<<"New channel between ground station "<<i<<" and plane "<<planeIndex<<" satellite "<<closestAdjSat<< " with distance "<<closestAdjSatDist<< "km and delay of "<<new_delay<<" seconds"<<std::endl;
+        grid->SetSatellite(this->plane[i].Get(j), i, j);
       }
+    }
   }
-  
-  //Recompute Routing Tables
-  std::cout<<"Recomputing Routing Tables"<<std::endl;
-  Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
-  std::cout<<"Finished Recomputing Routing Tables"<<std::endl;
+
+  //intra-plane links never change partner
+  for (uint32_t i=0; i<this->intra_plane_interfaces.size(); i++)
+  {
+    std::pair< Ptr< Ipv4 >, uint32_t > a = this->intra_plane_interfaces[i].Get(0);
+    std::pair< Ptr< Ipv4 >, uint32_t > b = this->intra_plane_interfaces[i].Get(1);
+    m_routeManager->AddLink(a.first->GetObject<Node> (), a.second, b.first->GetObject<Node> (), b.second);
+  }
+
+  //inter-plane and ground links start at their currently attached satellite
+  for (uint32_t i=0; i<this->inter_plane_channels.size(); i++)
+  {
+    std::pair< Ptr< Ipv4 >, uint32_t > a = GetInterface(this->inter_plane_channels[i]->GetDevice(0));
+    std::pair< Ptr< Ipv4 >, uint32_t > b = GetInterface(this->inter_plane_channels[i]->GetDevice(1));
+    this->inter_plane_route_links.push_back(m_routeManager->AddLink(a.first->GetObject<Node> (), a.second, b.first->GetObject<Node> (), b.second));
+  }
+  for (uint32_t i=0; i<this->ground_station_channels.size(); i++)
+  {
+    std::pair< Ptr< Ipv4 >, uint32_t > a = GetInterface(this->ground_station_channels[i]->GetDevice(0));
+    std::pair< Ptr< Ipv4 >, uint32_t > b = GetInterface(this->ground_station_channels[i]->GetDevice(1));
+    this->ground_station_route_links.push_back(m_routeManager->AddLink(a.first->GetObject<Node> (), a.second, b.first->GetObject<Node> (), b.second));
+  }
+
+  m_routeManager->ComputeRoutes();
 }
 
 }
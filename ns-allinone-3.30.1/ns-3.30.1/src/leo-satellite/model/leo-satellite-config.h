@@ -14,16 +14,24 @@
 #include "ns3/object.h"
 #include "ns3/ptr.h"
 #include "ns3/core-module.h"
-#include "ns3/point-to-point-module.h"
 #include "ns3/leo-satellite-mobility.h"
+#include "ns3/leo-satellite-ephemeris.h"
+#include "ns3/leo-satellite-orbits.h"
+#include "ns3/leo-satellite-spatial-index.h"
+#include "ns3/leo-satellite-contact-plan.h"
 #include "ns3/ground-station-mobility.h"
 #include <vector>
+#include <set>
+#include <fstream>
 #include "ns3/mobility-module.h"
-#include "ns3/csma-module.h"
+#include "ns3/leo-satellite-isl-channel.h"
+#include "ns3/leo-satellite-isl-net-device.h"
 #include <cmath>
 #include "ns3/internet-module.h"
 #include "ns3/ipv4-global-routing-helper.h"
 #include "ns3/applications-module.h"
+#include "ns3/leo-satellite-route-manager.h"
+#include "ns3/leo-satellite-grid-route-manager.h"
 
 namespace ns3 {
 
@@ -36,6 +44,45 @@ public:
    */
   static TypeId GetTypeId (void);
 
+  /**
+   * Routing used between the nodes of the constellation
+   */
+  enum RoutingType
+  {
+    GLOBAL_ROUTING,     // Ipv4GlobalRouting, recomputed from scratch on every update
+    INCREMENTAL_ROUTING, // LeoSatelliteRouting, only routes affected by changed links are updated
+    GRID_ROUTING // LeoSatelliteRouting, next hops derived from the plane/index of the satellites
+  };
+
+  /**
+   * Orbits of the satellites
+   */
+  enum OrbitType
+  {
+    POLAR_ORBITS, // polar planes over 180 degrees of longitude, the last and the first plane move in opposite directions
+    WALKER_DELTA_ORBITS, // Walker-delta constellation Inclination: T/P/WalkerPhasing
+    TLE_ORBITS // two-line element sets of TleFile
+  };
+
+  /**
+   * Format of the link state file
+   */
+  enum LinkStateFormat
+  {
+    CSV_LINK_STATE,
+    BINARY_LINK_STATE
+  };
+
+  /**
+   * TracedCallback signature for the state of an inter-plane or ground link
+   * \param a satellite at the fixed end of an inter-plane link, or ground station
+   * \param b satellite at the other end, numbered plane by plane
+   * \param distance length of the link [km]
+   * \param delay propagation delay of the link
+   * \param repointed true if b was not at the other end of the link before
+   */
+  typedef void (* LinkStateTracedCallback) (uint32_t a, uint32_t b, double distance, Time delay, bool repointed);
+
   LeoSatelliteConfig (uint32_t num_planes, uint32_t num_satellites_per_plane, double altitude);
 
   virtual ~LeoSatelliteConfig ();
@@ -43,6 +90,36 @@ public:
   
   void UpdateLinks (); //update the intersatellite links
 
+  /**
+   * \brief Predict the next change of an inter-plane or ground link
+   *
+   * The links are compared every HandoverStep, a link that changes partner and
+   * back within one step is not seen.
+   * \param from the time to start from
+   * \param horizon how far after from to look for a change
+   * \return the first time after from at which a link has another partner than at from,
+   *         accurate to HandoverResolution, Time::Max () if there is none within horizon
+   */
+  Time PredictNextHandover (Time from, Time horizon);
+
+  Ptr<LeoSatelliteRouteManager> GetRouteManager () const; //null when global routing is used
+
+  Ptr<LeoSatelliteEphemeris> GetEphemeris () const; //positions of all satellites
+
+  Ptr<LeoSatelliteContactPlan> GetContactPlan () const; //null when the ground links are computed on every update
+
+  /**
+   * \brief MPI rank simulating a plane
+   *
+   * Planes are split into contiguous blocks of the same size, give or take one,
+   * so that only the inter-plane links at the ends of a block cross ranks
+   * \param plane the plane
+   * \param num_planes number of planes of the constellation
+   * \param ranks number of MPI ranks
+   * \return the system id of the nodes of plane
+   */
+  static uint32_t GetPlaneSystemId (uint32_t plane, uint32_t num_planes, uint32_t ranks);
+
   NodeContainer ground_stations; //node container to hold ground stations
   std::vector<Ipv4InterfaceContainer> ground_station_interfaces;
 
@@ -52,16 +129,100 @@ private:
   double m_altitude;
 
   std::vector<NodeContainer> plane; //node container for each plane
-  std::vector<NetDeviceContainer> intra_plane_devices; //contains net devices for all P2P links for all planes
-  std::vector<NetDeviceContainer> inter_plane_devices;
-  std::vector<Ptr<CsmaChannel>> inter_plane_channels;
+  std::vector<NetDeviceContainer> intra_plane_devices; //contains net devices for all links within a plane for all planes
+  std::vector<Ptr<LeoSatelliteIslNetDevice> > inter_plane_east_devices; //fixed end of the inter-plane link of every satellite, numbered plane by plane
+  std::vector<Ptr<LeoSatelliteIslNetDevice> > inter_plane_west_devices; //end of every satellite linked to by the previous plane
+  std::vector<Ptr<LeoSatelliteIslChannel> > inter_plane_channels; //one per east device
   std::vector<uint32_t> inter_plane_channel_tracker; //this will have the node from the adjacent plane that is currently connected
-  std::vector<NetDeviceContainer> ground_station_devices; 
-  std::vector<Ptr<CsmaChannel>> ground_station_channels;
-  std::vector<uint32_t> ground_station_channel_tracker;
+  std::vector<Ptr<LeoSatelliteIslNetDevice> > ground_station_devices;
+  std::vector<Ptr<LeoSatelliteIslChannel> > ground_station_channels;
+  std::vector<uint32_t> ground_station_channel_tracker; //satellite currently connected, numbered plane by plane
+  std::vector<Ptr<LeoSatelliteIslNetDevice> > ground_link_devices; //ground links of every satellite, m_groundLinksPerSatellite per satellite
+  std::vector<uint32_t> ground_link_users; //ground station connected to every ground link device, NO_GROUND_STATION if none
   std::vector<Ipv4InterfaceContainer> intra_plane_interfaces;
-  std::vector<Ipv4InterfaceContainer> inter_plane_interfaces;
-  
+
+  void PopulateRouteManager (); //register all nodes and links with the route manager
+
+  Ptr<LeoSatelliteEphemeris> m_ephemeris;
+  Ptr<LeoSatelliteSpatialIndex> m_spatialIndex; //sub-points of all satellites, numbered plane by plane
+  std::vector<Vector> m_satellitePositions; //positions at the last update of the spatial index
+
+  std::string m_groundStationsFile;
+  std::vector<Vector> LoadGroundStations (std::string file_name); //latitude, longitude and altitude of every ground station in the file
+
+  std::vector<Ptr<LeoSatelliteMobilityModel> > m_satelliteMobility; //numbered plane by plane
+  std::vector<Vector> m_groundPositions;
+  Vector GetSatellitePosition (uint32_t plane, uint32_t index, Time time) const;
+
+  void UpdateSpatialIndex (Time time); //move the satellites to their cells of the spatial index at time
+
+  OrbitType m_orbits;
+  double m_inclination;
+  uint32_t m_walkerPhasing;
+  std::string m_tleFile;
+  bool m_earthRotation;
+  bool HasReversedSeam () const; //true if the links from the last plane to the first one reverse the order of the satellites
+
+  uint32_t m_groundLinksPerSatellite;
+  std::vector<uint32_t> m_groundLinkLoad; //ground stations attached to every satellite while computing the links
+  bool HasFreeGroundLink (uint32_t satellite) const;
+
+  //satellite of every ground station at time, from the contact plan if it covers time,
+  //otherwise from the spatial index, which must be up to date
+  void ComputeGroundLinks (Time time, std::vector<uint32_t> &ground_station_targets);
+
+  //ground links over [start, start + duration) computed once, or loaded from the contact plan file
+  Time m_contactPlanDuration;
+  std::string m_contactPlanFile;
+  Ptr<LeoSatelliteContactPlan> m_contactPlan;
+  void SetupContactPlan (Time start);
+  void BuildContactPlan (Time start, Time end, std::vector<std::vector<LeoSatelliteContactPlan::Contact> > &contacts);
+  uint64_t GetScenarioKey (Time start) const; //digest of everything the contact plan depends on
+  static const uint32_t NO_GROUND_STATION = 0xffffffff;
+
+  uint32_t m_ranks; //MPI ranks the planes are partitioned across, 1 without MPI
+  Time m_remoteLinkLookahead;
+  //the null message simulator only synchronizes with the ranks linked when it starts, so handovers must not link others
+  bool m_nullMessages;
+  std::set<std::pair<uint32_t, uint32_t> > m_remoteRanks; //pairs of ranks linked at the start, lowest first
+  void CheckRemoteRanks (Ptr<LeoSatelliteIslChannel> channel) const; //abort if channel links ranks not in m_remoteRanks
+
+  Ptr<LeoSatelliteIslNetDevice> CreateIslDevice (Ptr<Node> node) const; //add a laser terminal to node
+  Ptr<LeoSatelliteIslChannel> CreateIslChannel () const;
+  std::pair<Ptr<Ipv4>, uint32_t> GetInterface (Ptr<NetDevice> device) const; //Ipv4 interface of device
+  //add address to device like Ipv4AddressHelper::Assign, the interface is left down unless up
+  std::pair<Ptr<Ipv4>, uint32_t> AssignAddress (Ptr<NetDevice> device, Ipv4Address address, Ipv4Mask mask, bool up) const;
+
+  //partner of every inter-plane link and ground station at time, numbered like the channel trackers
+  //ground stations are attached to the closest satellite with a free ground link
+  void ComputeLinks (Time time, std::vector<uint32_t> &inter_plane_targets, std::vector<uint32_t> &ground_station_targets);
+
+  //inter-plane links are planned plane by plane from m_satellitePositions
+  void PlanInterPlaneLinks (uint32_t plane, std::vector<uint32_t> &inter_plane_targets) const;
+
+  bool m_scheduleHandovers;
+  Time m_handoverResolution;
+  Time m_handoverStep;
+  Time GetHandoverStep () const; //step of the search for link changes, HandoverStep or its default
+  EventId m_handoverEvent;
+  void ScheduleNextHandover (); //schedule UpdateLinks at the next predicted link change
+  void HandleHandover ();
+
+  TracedCallback<uint32_t, uint32_t, double, Time, bool> m_interPlaneLinkTrace;
+  TracedCallback<uint32_t, uint32_t, double, Time, bool> m_groundLinkTrace;
+
+  std::string m_linkStateFile;
+  LinkStateFormat m_linkStateFormat;
+  std::ofstream m_linkStateStream;
+  void WriteInterPlaneLinkState (uint32_t a, uint32_t b, double distance, Time delay, bool repointed);
+  void WriteGroundLinkState (uint32_t a, uint32_t b, double distance, Time delay, bool repointed);
+  void WriteLinkState (char link, uint32_t a, uint32_t b, double distance, Time delay, bool repointed); //one line or record of the link state file
+
+  RoutingType m_routing;
+  Ptr<LeoSatelliteRouteManager> m_routeManager;
+  std::vector<uint32_t> inter_plane_route_links; //route manager link id of each inter-plane channel
+  std::vector<uint32_t> ground_station_route_links; //route manager link id of each ground station channel
+
 };
   
 }
@@ -0,0 +1,347 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * LEO Satellite Contact Plan
+ * Precomputed satellite of every ground station over an interval, as sorted
+ * [start, end, satellite] contacts that can be saved and memory-mapped back
+ *
+ * ENSC 427: Communication Networks
+ * Spring 2020
+ * Team 11
+ */
+
+#include "leo-satellite-contact-plan.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include <fstream>
+#include <cstring>
+#include <iterator>
+
+#if defined (__unix__) || defined (__APPLE__)
+#include <unistd.h>
+#endif
+#if defined (_POSIX_MAPPED_FILES) && _POSIX_MAPPED_FILES > 0
+#define LEO_SATELLITE_CONTACT_PLAN_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#endif
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LeoSatelliteContactPlan");
+
+NS_OBJECT_ENSURE_REGISTERED (LeoSatelliteContactPlan);
+
+namespace {
+
+const char MAGIC[8] = {'L', 'E', 'O', 'C', 'P', 'L', 'N', '1'};
+
+// header of the file, followed by the contact indices and the contacts
+struct Header
+{
+  char magic[8];
+  uint64_t key;
+  int64_t start;
+  int64_t end;
+  uint32_t nGroundStations;
+  uint32_t nSatellites;
+  uint64_t reserved;
+};
+
+// true if the contacts after header fill size bytes and are consistent with it
+bool
+IsValid (const Header &header, const uint64_t *first, uint64_t size)
+{
+  uint64_t indexSize = (uint64_t (header.nGroundStations) + 1)*sizeof (uint64_t);
+  if (size < sizeof (Header) + indexSize || first[0] != 0)
+    return false;
+  for (uint32_t i=0; i<header.nGroundStations; i++)
+  {
+    if (first[i + 1] <= first[i])
+      return false;
+  }
+  return size == sizeof (Header) + indexSize + first[header.nGroundStations]*sizeof (LeoSatelliteContactPlan::Contact);
+}
+
+} // anonymous namespace
+
+TypeId
+LeoSatelliteContactPlan::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LeoSatelliteContactPlan")
+    .SetParent<Object> ()
+    .SetGroupName ("LeoSatellite")
+    .AddConstructor<LeoSatelliteContactPlan> ()
+  ;
+  return tid;
+}
+
+LeoSatelliteContactPlan::LeoSatelliteContactPlan ()
+  : m_nGroundStations (0),
+    m_nSatellites (0),
+    m_start (0),
+    m_end (0),
+    m_key (0),
+    m_first (0),
+    m_contacts (0),
+    m_mapping (0),
+    m_mappingSize (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LeoSatelliteContactPlan::~LeoSatelliteContactPlan ()
+{
+  NS_LOG_FUNCTION (this);
+  Clear ();
+}
+
+void
+LeoSatelliteContactPlan::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  Clear ();
+  Object::DoDispose ();
+}
+
+void
+LeoSatelliteContactPlan::Clear (void)
+{
+#ifdef LEO_SATELLITE_CONTACT_PLAN_MMAP
+  if (m_mapping != 0)
+  {
+    munmap (m_mapping, m_mappingSize);
+  }
+#endif
+  m_mapping = 0;
+  m_mappingSize = 0;
+  m_firstStorage.clear ();
+  m_contactStorage.clear ();
+  m_cursor.clear ();
+  m_first = 0;
+  m_contacts = 0;
+  m_nGroundStations = 0;
+  m_nSatellites = 0;
+  m_start = 0;
+  m_end = 0;
+}
+
+void
+LeoSatelliteContactPlan::SetContacts (const std::vector<std::vector<Contact> > &contacts, Time start, Time end,
+                                      uint32_t numSatellites, uint64_t key)
+{
+  NS_LOG_FUNCTION (this << contacts.size () << start << end << numSatellites);
+  Clear ();
+  m_firstStorage.assign (1, 0);
+  for (uint32_t i=0; i<contacts.size (); i++)
+  {
+    NS_ABORT_MSG_IF (contacts[i].empty () || contacts[i].front ().start != start.GetNanoSeconds ()
+                     || contacts[i].back ().end != end.GetNanoSeconds (),
+                     "Contacts of ground station " << i << " do not cover the plan");
+    for (uint32_t j=0; j<contacts[i].size (); j++)
+    {
+      NS_ABORT_MSG_IF (j > 0 && contacts[i][j].start != contacts[i][j - 1].end, "Contacts of ground station " << i << " are not contiguous");
+      NS_ABORT_MSG_IF (contacts[i][j].satellite >= numSatellites, "Contact with satellite " << contacts[i][j].satellite);
+      m_contactStorage.push_back (contacts[i][j]);
+      m_contactStorage.back ().reserved = 0;
+    }
+    m_firstStorage.push_back (m_contactStorage.size ());
+  }
+  m_nGroundStations = contacts.size ();
+  m_nSatellites = numSatellites;
+  m_start = start.GetNanoSeconds ();
+  m_end = end.GetNanoSeconds ();
+  m_first = &m_firstStorage[0];
+  m_contacts = m_contactStorage.empty () ? 0 : &m_contactStorage[0];
+  m_cursor.assign (m_firstStorage.begin (), m_firstStorage.end () - 1);
+  m_key = key;
+}
+
+void
+LeoSatelliteContactPlan::Save (std::string fileName) const
+{
+  NS_LOG_FUNCTION (this << fileName);
+  std::ofstream file (fileName.c_str (), std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+  NS_ABORT_MSG_UNLESS (file.is_open (), "Contact plan file " << fileName << " cannot be opened");
+  Header header;
+  std::memcpy (header.magic, MAGIC, sizeof (MAGIC));
+  header.key = m_key;
+  header.start = m_start;
+  header.end = m_end;
+  header.nGroundStations = m_nGroundStations;
+  header.nSatellites = m_nSatellites;
+  header.reserved = 0;
+  file.write (reinterpret_cast<const char *> (&header), sizeof (header));
+  file.write (reinterpret_cast<const char *> (m_first), (uint64_t (m_nGroundStations) + 1)*sizeof (uint64_t));
+  file.write (reinterpret_cast<const char *> (m_contacts), m_first[m_nGroundStations]*sizeof (Contact));
+  NS_ABORT_MSG_UNLESS (file.good (), "Contact plan file " << fileName << " cannot be written");
+}
+
+bool
+LeoSatelliteContactPlan::Load (std::string fileName, uint64_t key)
+{
+  NS_LOG_FUNCTION (this << fileName << key);
+  Clear ();
+
+  const char *data = 0;
+  uint64_t size = 0;
+  std::vector<char> buffer;
+#ifdef LEO_SATELLITE_CONTACT_PLAN_MMAP
+  int fd = open (fileName.c_str (), O_RDONLY);
+  if (fd >= 0)
+  {
+    struct stat status;
+    if (fstat (fd, &status) == 0 && status.st_size >= off_t (sizeof (Header)))
+    {
+      void *mapping = mmap (0, status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+      if (mapping != MAP_FAILED)
+      {
+        m_mapping = mapping;
+        m_mappingSize = status.st_size;
+        data = static_cast<const char *> (mapping);
+        size = status.st_size;
+      }
+    }
+    close (fd);
+  }
+#endif
+  if (data == 0)
+  {
+    std::ifstream file (fileName.c_str (), std::ios_base::in | std::ios_base::binary);
+    if (!file.is_open ())
+    {
+      NS_LOG_INFO ("Contact plan file " << fileName << " cannot be opened");
+      return false;
+    }
+    buffer.assign (std::istreambuf_iterator<char> (file), std::istreambuf_iterator<char> ());
+    data = buffer.empty () ? 0 : &buffer[0];
+    size = buffer.size ();
+  }
+
+  Header header;
+  bool valid = size >= sizeof (Header);
+  if (valid)
+  {
+    std::memcpy (&header, data, sizeof (header));
+    valid = std::memcmp (header.magic, MAGIC, sizeof (MAGIC)) == 0 && header.key == key && header.start < header.end
+      && IsValid (header, reinterpret_cast<const uint64_t *> (data + sizeof (Header)), size);
+  }
+  if (!valid)
+  {
+    NS_LOG_INFO ("Contact plan file " << fileName << " is not a contact plan of this scenario");
+    Clear ();
+    return false;
+  }
+
+  const uint64_t *first = reinterpret_cast<const uint64_t *> (data + sizeof (Header));
+  const Contact *contacts = reinterpret_cast<const Contact *> (first + header.nGroundStations + 1);
+  if (m_mapping == 0)
+  {
+    m_firstStorage.assign (first, first + header.nGroundStations + 1);
+    m_contactStorage.assign (contacts, contacts + first[header.nGroundStations]);
+    first = &m_firstStorage[0];
+    contacts = &m_contactStorage[0];
+  }
+  m_nGroundStations = header.nGroundStations;
+  m_nSatellites = header.nSatellites;
+  m_start = header.start;
+  m_end = header.end;
+  m_key = header.key;
+  m_first = first;
+  m_contacts = contacts;
+  m_cursor.assign (first, first + header.nGroundStations);
+  NS_LOG_INFO ("Loaded " << first[header.nGroundStations] << " contacts of " << m_nGroundStations
+               << " ground stations" << (m_mapping != 0 ? ", mapped" : ""));
+  return true;
+}
+
+bool
+LeoSatelliteContactPlan::IsMapped (void) const
+{
+  return m_mapping != 0;
+}
+
+uint32_t
+LeoSatelliteContactPlan::GetNGroundStations (void) const
+{
+  return m_nGroundStations;
+}
+
+uint32_t
+LeoSatelliteContactPlan::GetNSatellites (void) const
+{
+  return m_nSatellites;
+}
+
+Time
+LeoSatelliteContactPlan::GetStart (void) const
+{
+  return NanoSeconds (m_start);
+}
+
+Time
+LeoSatelliteContactPlan::GetEnd (void) const
+{
+  return NanoSeconds (m_end);
+}
+
+bool
+LeoSatelliteContactPlan::Covers (Time time) const
+{
+  int64_t t = time.GetNanoSeconds ();
+  return m_nGroundStations > 0 && t >= m_start && t < m_end;
+}
+
+uint32_t
+LeoSatelliteContactPlan::GetNContacts (uint32_t station) const
+{
+  NS_ASSERT (station < m_nGroundStations);
+  return m_first[station + 1] - m_first[station];
+}
+
+const LeoSatelliteContactPlan::Contact &
+LeoSatelliteContactPlan::GetContact (uint32_t station, uint32_t i) const
+{
+  NS_ASSERT (i < GetNContacts (station));
+  return m_contacts[m_first[station] + i];
+}
+
+const LeoSatelliteContactPlan::Contact &
+LeoSatelliteContactPlan::GetContact (uint32_t station, Time time)
+{
+  NS_ASSERT_MSG (Covers (time), "Time " << time.GetSeconds () << " s is not covered by the contact plan");
+  NS_ASSERT (station < m_nGroundStations);
+  int64_t t = time.GetNanoSeconds ();
+  uint64_t cursor = m_cursor[station];
+  if (t >= m_contacts[cursor].start && t < m_contacts[cursor].end)
+  {
+    return m_contacts[cursor];
+  }
+  if (t >= m_contacts[cursor].end && t < m_contacts[cursor + 1].end)
+  {
+    // next handover, the contacts of a ground station end with the plan so cursor + 1 exists
+    m_cursor[station] = cursor + 1;
+    return m_contacts[cursor + 1];
+  }
+  // binary search for the last contact starting at or before t
+  uint64_t low = m_first[station];
+  uint64_t high = m_first[station + 1];
+  while (high - low > 1)
+  {
+    uint64_t middle = low + (high - low)/2;
+    if (m_contacts[middle].start <= t)
+      low = middle;
+    else
+      high = middle;
+  }
+  m_cursor[station] = low;
+  return m_contacts[low];
+}
+
+uint32_t
+LeoSatelliteContactPlan::GetSatellite (uint32_t station, Time time)
+{
+  return GetContact (station, time).satellite;
+}
+
+} // namespace ns3
@@ -0,0 +1,163 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * LEO Satellite Contact Plan
+ * Precomputed satellite of every ground station over an interval, as sorted
+ * [start, end, satellite] contacts that can be saved and memory-mapped back
+ *
+ * ENSC 427: Communication Networks
+ * Spring 2020
+ * Team 11
+ */
+#ifndef LEO_SATELLITE_CONTACT_PLAN_H
+#define LEO_SATELLITE_CONTACT_PLAN_H
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup leo-satellite
+ * \brief contacts of every ground station with the satellites serving it.
+ *
+ * The contacts of a ground station are sorted, contiguous and cover the whole
+ * plan, [GetStart (), GetEnd ()). Every ground station keeps a cursor on its
+ * current contact: looking up a later time moves the cursor forward, so
+ * following the simulation through the plan costs a comparison per lookup
+ * and a step per handover. Earlier times are found by binary search.
+ *
+ * Contacts are stored flat, one array for all ground stations, which is also
+ * the layout of the file: a 48 byte header (magic "LEOCPLN1", scenario key,
+ * start and end [ns] as 64 bit integers, number of ground stations and
+ * satellites as 32 bit integers, 8 bytes reserved), the index of the first
+ * contact of every ground station and the total as 64 bit integers, then
+ * one 24 byte record per contact (start and end [ns] as 64 bit integers,
+ * satellite as 32 bit integer, 4 bytes reserved), all in host byte order.
+ * Where the platform has mmap () a loaded file is mapped rather than read.
+ */
+class LeoSatelliteContactPlan : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * One contact, as laid out in the file
+   */
+  struct Contact
+  {
+    int64_t start; //!< first instant of the contact [ns]
+    int64_t end; //!< first instant after the contact [ns]
+    uint32_t satellite; //!< satellite serving the ground station, numbered plane by plane
+    uint32_t reserved; //!< padding, 0
+  };
+
+  LeoSatelliteContactPlan ();
+  virtual ~LeoSatelliteContactPlan ();
+
+  /**
+   * \brief Replace the plan
+   * \param contacts contacts of every ground station, sorted and covering [start, end)
+   * \param start start of the plan
+   * \param end end of the plan
+   * \param numSatellites number of satellites of the constellation
+   * \param key identifies the scenario the plan was computed for
+   */
+  void SetContacts (const std::vector<std::vector<Contact> > &contacts, Time start, Time end,
+                    uint32_t numSatellites, uint64_t key);
+
+  /**
+   * \brief Write the plan to a file
+   * \param fileName the file
+   */
+  void Save (std::string fileName) const;
+
+  /**
+   * \brief Replace the plan by the one of a file
+   * \param fileName the file
+   * \param key the scenario the plan must have been computed for
+   * \return false, leaving the plan empty, if the file cannot be read, is not a
+   *         contact plan or was computed for another scenario
+   */
+  bool Load (std::string fileName, uint64_t key);
+
+  /**
+   * \return true if the plan was loaded from a memory-mapped file
+   */
+  bool IsMapped (void) const;
+
+  /**
+   * \return the number of ground stations, 0 if the plan is empty
+   */
+  uint32_t GetNGroundStations (void) const;
+
+  /**
+   * \return the number of satellites of the constellation
+   */
+  uint32_t GetNSatellites (void) const;
+
+  Time GetStart (void) const;
+  Time GetEnd (void) const;
+
+  /**
+   * \param time the time
+   * \return true if time is within [GetStart (), GetEnd ())
+   */
+  bool Covers (Time time) const;
+
+  /**
+   * \param station the ground station
+   * \return the number of contacts of station
+   */
+  uint32_t GetNContacts (uint32_t station) const;
+
+  /**
+   * \param station the ground station
+   * \param i the contact, in time order
+   * \return the contact
+   */
+  const Contact &GetContact (uint32_t station, uint32_t i) const;
+
+  /**
+   * \param station the ground station
+   * \param time a time covered by the plan
+   * \return the contact of station at time
+   */
+  const Contact &GetContact (uint32_t station, Time time);
+
+  /**
+   * \param station the ground station
+   * \param time a time covered by the plan
+   * \return the satellite serving station at time
+   */
+  uint32_t GetSatellite (uint32_t station, Time time);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  void Clear (void); // empty the plan and release its storage or mapping
+
+  uint32_t m_nGroundStations;
+  uint32_t m_nSatellites;
+  int64_t m_start; // [ns]
+  int64_t m_end; // [ns]
+  uint64_t m_key;
+  const uint64_t *m_first; // index of the first contact of every ground station, and the total
+  const Contact *m_contacts; // contacts of all ground stations
+  std::vector<uint64_t> m_firstStorage; // m_first when the plan is not mapped
+  std::vector<Contact> m_contactStorage; // m_contacts when the plan is not mapped
+  void *m_mapping; // mapped file, 0 if none
+  uint64_t m_mappingSize;
+  std::vector<uint64_t> m_cursor; // current contact of every ground station
+};
+
+} // namespace ns3
+
+#endif /* LEO_SATELLITE_CONTACT_PLAN_H */
@@ -12,7 +12,6 @@
 #include "ns3/vector.h"
 #include "ns3/double.h"
 #include "ns3/log.h"
-#include "ns3/integer.h"
 #define _USE_MATH_DEFINES
 #include <cmath>
 
@@ -22,8 +21,6 @@ NS_LOG_COMPONENT_DEFINE ("GroundStationMobility");
 
 NS_OBJECT_ENSURE_REGISTERED (GroundStationMobilityModel);
 
-uint32_t current = 0; // to know if we are setting up first or second ground station
-
 TypeId
 GroundStationMobilityModel::GetTypeId (void)
 {
@@ -31,14 +28,6 @@ GroundStationMobilityModel::GetTypeId (void)
     .SetParent<MobilityModel> ()
     .SetGroupName ("Mobility")
     .AddConstructor<GroundStationMobilityModel> ()
-    .AddAttribute ("NPerPlane", "The number of satellites per orbital plane.",
-                   IntegerValue (1),
-                   MakeIntegerAccessor (&GroundStationMobilityModel::m_nPerPlane),
-                   MakeIntegerChecker<uint32_t> ())
-    .AddAttribute ("NumberofPlanes", "The total number of orbital planes.",
-                   IntegerValue (1),
-                   MakeIntegerAccessor (&GroundStationMobilityModel::m_numPlanes),
-                   MakeIntegerChecker<uint32_t> ())
     .AddAttribute ("Latitude",
                    "Latitude of ground station.",
                    DoubleValue(1.0),
@@ -49,6 +38,11 @@ GroundStationMobilityModel::GetTypeId (void)
                    DoubleValue(1.0),
                    MakeDoubleAccessor (&GroundStationMobilityModel::m_longitude),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("Altitude",
+                   "Altitude of ground station [km].",
+                   DoubleValue(0.0),
+                   MakeDoubleAccessor (&GroundStationMobilityModel::m_altitude),
+                   MakeDoubleChecker<double> ())
   ;
 
   return tid;
@@ -58,32 +52,21 @@ GroundStationMobilityModel::GroundStationMobilityModel()
 {
 }
 
-/* To be called after MobilityModel object is created to set position.
-   Input should be a NULL vector as position is determined by number of orbital planes and number of satellites per   
-   orbital plane
-   Both ground stations are set along the longitude of a satellite's orbit (not at the same longitude), and at random 
-   latitudes   
- */
+/* Position is given as (latitude, longitude, altitude), the altitude in km like the one of
+   the satellites */
 void 
 GroundStationMobilityModel::DoSetPosition (const Vector &position)
 {
-  current++;
-  if (current == 1) // first ground station
-  {
-    m_latitude = 90 - 180/(m_nPerPlane/2)/2 ;
-    m_longitude = -180;
-  }
-  else // second ground station
-  {
-    m_latitude = 90 - 180/(m_nPerPlane/2)/2 - 180/(m_nPerPlane/2)*(m_nPerPlane/4);
-    m_longitude = -180 + 360/(m_numPlanes*2)*floor(3*m_numPlanes/7);
-  }
+  m_latitude = position.x;
+  m_longitude = position.y;
+  m_altitude = position.z;
+  NotifyCourseChange ();
 }
 
 Vector
 GroundStationMobilityModel::DoGetPosition (void) const
 {
-  Vector currentPosition = Vector(m_latitude, m_longitude, 0);
+  Vector currentPosition = Vector(m_latitude, m_longitude, m_altitude);
   return currentPosition;
 }
 
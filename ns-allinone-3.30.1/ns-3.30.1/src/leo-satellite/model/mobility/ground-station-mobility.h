@@ -21,9 +21,8 @@ namespace ns3 {
  * \ingroup leo-satellite
  * \brief ground station mobility model.
  *
- * For a simplified simulation, ground stations will be placed along the 
- * longitude of satellites orbiting above and at varying latitudes
- * Currently supports two ground stations
+ * Ground stations do not move, their position is set as (latitude, longitude, altitude)
+ * and can be placed anywhere on or above the surface of the Earth
  */
 class GroundStationMobilityModel : public MobilityModel
 {
@@ -40,13 +39,11 @@ private:
   virtual void DoSetPosition (const Vector &position);
   virtual Vector DoGetVelocity (void) const;
   friend double CalculateDistanceGroundToSat (const Vector &a, const Vector &b); // Vectors must correspond to a ground station and a LEO satellite
-  double m_nPerPlane; // number of satellites per plane 
-  double m_numPlanes; // number of planes
-  // The following variables are calculated automatically given the above parameteres
   double m_latitude; // latitude of ground station
                      // negative value indicates southern latitude, positive value indicates northern latitude
   double m_longitude; // longitude of ground station
                       // negative value indicates western longitude, positive value indicates eastern longitude
+  double m_altitude; // altitude of ground station above the surface of the Earth [km]
 };
 
 } // namespace ns3
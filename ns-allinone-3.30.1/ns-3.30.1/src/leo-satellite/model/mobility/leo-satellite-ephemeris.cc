@@ -0,0 +1,211 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * LEO Satellite Ephemeris
+ * Propagates the orbits of all satellites of a constellation in one batch
+ *
+ * ENSC 427: Communication Networks
+ * Spring 2020
+ * Team 11
+ */
+
+#include "leo-satellite-ephemeris.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include <cmath>
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LeoSatelliteEphemeris");
+
+NS_OBJECT_ENSURE_REGISTERED (LeoSatelliteEphemeris);
+
+TypeId
+LeoSatelliteEphemeris::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LeoSatelliteEphemeris")
+    .SetParent<Object> ()
+    .SetGroupName ("LeoSatellite")
+    .AddConstructor<LeoSatelliteEphemeris> ()
+  ;
+  return tid;
+}
+
+LeoSatelliteEphemeris::LeoSatelliteEphemeris ()
+  : m_updateTime (-1)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LeoSatelliteEphemeris::~LeoSatelliteEphemeris ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint32_t
+LeoSatelliteEphemeris::AddSatellite (double phase, double ascendingLongitude, double angularSpeed,
+                                     double epoch, double altitude)
+{
+  return AddOrbit (90, ascendingLongitude, 0, phase, angularSpeed, epoch, altitude);
+}
+
+uint32_t
+LeoSatelliteEphemeris::AddOrbit (double inclination, double ascendingLongitude, double nodeRate, double phase,
+                                 double angularSpeed, double epoch, double altitude)
+{
+  NS_LOG_FUNCTION (this << inclination << ascendingLongitude << nodeRate << phase << angularSpeed << epoch << altitude);
+  uint32_t index = m_phase.size ();
+  m_phase.push_back (0);
+  m_angularSpeed.push_back (0);
+  m_epoch.push_back (0);
+  m_ascendingLongitude.push_back (0);
+  m_descendingLongitude.push_back (0);
+  m_altitude.push_back (0);
+  m_nodeRate.push_back (0);
+  m_sinInclination.push_back (1);
+  m_cosInclination.push_back (0);
+  m_latitude.push_back (0);
+  m_longitude.push_back (0);
+  SetOrbit (index, inclination, ascendingLongitude, nodeRate, phase, angularSpeed, epoch, altitude);
+  return index;
+}
+
+void
+LeoSatelliteEphemeris::SetSatellite (uint32_t index, double phase, double ascendingLongitude, double angularSpeed,
+                                     double epoch, double altitude)
+{
+  SetOrbit (index, 90, ascendingLongitude, 0, phase, angularSpeed, epoch, altitude);
+}
+
+void
+LeoSatelliteEphemeris::SetOrbit (uint32_t index, double inclination, double ascendingLongitude, double nodeRate, double phase,
+                                 double angularSpeed, double epoch, double altitude)
+{
+  NS_LOG_FUNCTION (this << index << inclination << ascendingLongitude << nodeRate << phase << angularSpeed << epoch << altitude);
+  NS_ASSERT (index < m_phase.size ());
+  m_phase[index] = phase;
+  m_angularSpeed[index] = angularSpeed;
+  m_epoch[index] = epoch;
+  m_ascendingLongitude[index] = ascendingLongitude;
+  m_descendingLongitude[index] = (ascendingLongitude < 0) ? ascendingLongitude + 180 : ascendingLongitude - 180;
+  m_altitude[index] = altitude;
+  m_nodeRate[index] = nodeRate;
+
+  // exactly 0 and 1 for polar orbits, so that their positions do not depend on rounding
+  bool polar = (inclination == 90 && nodeRate == 0);
+  m_sinInclination[index] = polar ? 1 : std::sin (inclination*M_PI/180);
+  m_cosInclination[index] = polar ? 0 : std::cos (inclination*M_PI/180);
+  std::vector<uint32_t>::iterator it = std::lower_bound (m_inclined.begin (), m_inclined.end (), index);
+  bool listed = (it != m_inclined.end () && *it == index);
+  if (polar && listed)
+  {
+    m_inclined.erase (it);
+  }
+  else if (!polar && !listed)
+  {
+    m_inclined.insert (it, index);
+  }
+  m_updateTime = Time (-1); // positions computed before the change are no longer valid
+}
+
+/* Phase is wrapped to (-90, 270]: S to N half of the orbit up to 90, N to S half after.
+   The loop has no data dependent branches so that the compiler can vectorize it.
+   Inclined orbits are then computed with spherical trigonometry, only for their satellites */
+void
+LeoSatelliteEphemeris::Update (Time time)
+{
+  NS_LOG_FUNCTION (this << time);
+  double now = time.GetSeconds ();
+  uint32_t n = m_phase.size ();
+  const double *phase0 = m_phase.data ();
+  const double *angularSpeed = m_angularSpeed.data ();
+  const double *epoch = m_epoch.data ();
+  const double *ascending = m_ascendingLongitude.data ();
+  const double *descending = m_descendingLongitude.data ();
+  double *latitude = m_latitude.data ();
+  double *longitude = m_longitude.data ();
+  for (uint32_t i=0; i<n; i++)
+  {
+    double phase = phase0[i] + (now - epoch[i])*angularSpeed[i] + 90;
+    phase = phase - 360*std::floor (phase/360) - 90;
+    bool northToSouth = phase > 90;
+    latitude[i] = northToSouth ? 180 - phase : phase;
+    longitude[i] = northToSouth ? descending[i] : ascending[i];
+  }
+
+  // satellites of inclined or drifting orbits, overwriting the polar positions computed above
+  uint32_t nInclined = m_inclined.size ();
+  const uint32_t *inclined = m_inclined.data ();
+  const double *nodeRate = m_nodeRate.data ();
+  const double *sinInclination = m_sinInclination.data ();
+  const double *cosInclination = m_cosInclination.data ();
+  for (uint32_t k=0; k<nInclined; k++)
+  {
+    uint32_t i = inclined[k];
+    double elapsed = now - epoch[i];
+    double phase = (phase0[i] + elapsed*angularSpeed[i])*M_PI/180;
+    double sinPhase = std::sin (phase);
+    double cosPhase = std::cos (phase);
+    latitude[i] = std::asin (sinInclination[i]*sinPhase)*180/M_PI;
+    double lon = ascending[i] + elapsed*nodeRate[i] + std::atan2 (cosInclination[i]*sinPhase, cosPhase)*180/M_PI;
+    longitude[i] = lon - 360*std::floor ((lon + 180)/360);
+  }
+  m_updateTime = time;
+}
+
+Vector
+LeoSatelliteEphemeris::GetPosition (uint32_t index)
+{
+  return GetPosition (index, Simulator::Now ());
+}
+
+Vector
+LeoSatelliteEphemeris::GetPosition (uint32_t index, Time time)
+{
+  NS_ASSERT (index < m_phase.size ());
+  if (time != m_updateTime)
+  {
+    Update (time);
+  }
+  return Vector (m_latitude[index], m_longitude[index], m_altitude[index]);
+}
+
+Vector
+LeoSatelliteEphemeris::Propagate (uint32_t index, Time time) const
+{
+  NS_ASSERT (index < m_phase.size ());
+  //same as one iteration of Update ()
+  if (std::binary_search (m_inclined.begin (), m_inclined.end (), index))
+  {
+    double elapsed = time.GetSeconds () - m_epoch[index];
+    double phase = (m_phase[index] + elapsed*m_angularSpeed[index])*M_PI/180;
+    double sinPhase = std::sin (phase);
+    double cosPhase = std::cos (phase);
+    double lon = m_ascendingLongitude[index] + elapsed*m_nodeRate[index]
+      + std::atan2 (m_cosInclination[index]*sinPhase, cosPhase)*180/M_PI;
+    return Vector (std::asin (m_sinInclination[index]*sinPhase)*180/M_PI,
+                   lon - 360*std::floor ((lon + 180)/360), m_altitude[index]);
+  }
+  double phase = m_phase[index] + (time.GetSeconds () - m_epoch[index])*m_angularSpeed[index] + 90;
+  phase = phase - 360*std::floor (phase/360) - 90;
+  if (phase > 90)
+  {
+    return Vector (180 - phase, m_descendingLongitude[index], m_altitude[index]);
+  }
+  return Vector (phase, m_ascendingLongitude[index], m_altitude[index]);
+}
+
+double
+LeoSatelliteEphemeris::GetAngularSpeed (uint32_t index) const
+{
+  NS_ASSERT (index < m_phase.size ());
+  return m_angularSpeed[index];
+}
+
+uint32_t
+LeoSatelliteEphemeris::GetN (void) const
+{
+  return m_phase.size ();
+}
+
+} // namespace ns3
@@ -0,0 +1,150 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * LEO Satellite Ephemeris
+ * Propagates the orbits of all satellites of a constellation in one batch
+ *
+ * ENSC 427: Communication Networks
+ * Spring 2020
+ * Team 11
+ */
+#ifndef LEO_SATELLITE_EPHEMERIS_H
+#define LEO_SATELLITE_EPHEMERIS_H
+
+#include "ns3/object.h"
+#include "ns3/vector.h"
+#include "ns3/nstime.h"
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup leo-satellite
+ * \brief orbital state of every satellite of a constellation.
+ *
+ * The orbital parameters and the current positions are kept in structure of
+ * arrays form, one array per quantity indexed by satellite. Update () computes
+ * the positions of all satellites for a timestamp in a single branch-free loop;
+ * GetPosition () runs it at most once per timestamp queried in a row, so the
+ * LeoSatelliteMobilityModel of each satellite only has to read its entry.
+ *
+ * Orbits are circular. Polar orbits whose plane does not move keep the exact
+ * latitude and longitude of the original model; inclined orbits and orbits
+ * whose ascending node drifts (Earth rotation, J2 nodal regression) are
+ * propagated in a second branch-free loop over these satellites only.
+ */
+class LeoSatelliteEphemeris : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  LeoSatelliteEphemeris ();
+  virtual ~LeoSatelliteEphemeris ();
+
+  /**
+   * \brief Add a satellite moving in a polar orbit
+   * \param phase [degrees] along the orbit at epoch, 0 at the equator heading S to N
+   * \param ascendingLongitude longitude of the S to N half of the orbit
+   * \param angularSpeed [degrees/s] along the orbit
+   * \param epoch [s] simulation time at which the satellite is at phase
+   * \param altitude [km]
+   * \return the index of the satellite
+   */
+  uint32_t AddSatellite (double phase, double ascendingLongitude, double angularSpeed,
+                         double epoch, double altitude);
+
+  /**
+   * \brief Add a satellite moving in a circular orbit of any inclination
+   * \param inclination [degrees] between the orbit and the equator
+   * \param ascendingLongitude longitude of the ascending node at epoch
+   * \param nodeRate [degrees/s] drift of the longitude of the ascending node
+   * \param phase [degrees] along the orbit at epoch (argument of latitude), 0 at the ascending node
+   * \param angularSpeed [degrees/s] along the orbit
+   * \param epoch [s] simulation time at which the satellite is at phase
+   * \param altitude [km]
+   * \return the index of the satellite
+   */
+  uint32_t AddOrbit (double inclination, double ascendingLongitude, double nodeRate, double phase,
+                     double angularSpeed, double epoch, double altitude);
+
+  /**
+   * \brief Replace the orbit of a satellite
+   * \param index the index returned by AddSatellite ()
+   * \see AddSatellite ()
+   */
+  void SetSatellite (uint32_t index, double phase, double ascendingLongitude, double angularSpeed,
+                     double epoch, double altitude);
+
+  /**
+   * \brief Replace the orbit of a satellite
+   * \param index the index returned by AddSatellite () or AddOrbit ()
+   * \see AddOrbit ()
+   */
+  void SetOrbit (uint32_t index, double inclination, double ascendingLongitude, double nodeRate, double phase,
+                 double angularSpeed, double epoch, double altitude);
+
+  /**
+   * \brief Compute the positions of all satellites at a given time
+   * \param time the simulation time
+   */
+  void Update (Time time);
+
+  /**
+   * \param index the index returned by AddSatellite ()
+   * \return the position (latitude, longitude, altitude) of the satellite at the current simulation time
+   */
+  Vector GetPosition (uint32_t index);
+
+  /**
+   * \param index the index returned by AddSatellite ()
+   * \param time the simulation time
+   * \return the position (latitude, longitude, altitude) of the satellite at time
+   */
+  Vector GetPosition (uint32_t index, Time time);
+
+  /**
+   * \brief Position of a single satellite, without updating the others
+   *
+   * Cheaper than GetPosition () when positions are needed at many different
+   * times for a few satellites, e.g. for the propagation delay of a link
+   * \param index the index returned by AddSatellite ()
+   * \param time the simulation time
+   * \return the position (latitude, longitude, altitude) of the satellite at time
+   */
+  Vector Propagate (uint32_t index, Time time) const;
+
+  /**
+   * \param index the index returned by AddSatellite ()
+   * \return the angular speed of the satellite along its orbit [degrees/s]
+   */
+  double GetAngularSpeed (uint32_t index) const;
+
+  /**
+   * \return the number of satellites
+   */
+  uint32_t GetN (void) const;
+
+private:
+  // orbital parameters
+  std::vector<double> m_phase; // [degrees] at m_epoch
+  std::vector<double> m_angularSpeed; // [degrees/s]
+  std::vector<double> m_epoch; // [s]
+  std::vector<double> m_ascendingLongitude; // longitude of the S to N half of the orbit
+  std::vector<double> m_descendingLongitude; // longitude of the N to S half of the orbit
+  std::vector<double> m_altitude; // [km]
+  std::vector<double> m_nodeRate; // [degrees/s] drift of both longitudes
+  std::vector<double> m_sinInclination;
+  std::vector<double> m_cosInclination;
+  std::vector<uint32_t> m_inclined; // satellites not following the polar model, ascending
+  // positions at m_updateTime
+  std::vector<double> m_latitude;
+  std::vector<double> m_longitude;
+  Time m_updateTime; // negative until the first update
+};
+
+} // namespace ns3
+
+#endif /* LEO_SATELLITE_EPHEMERIS_H */
@@ -15,6 +15,7 @@
 #include "ns3/log.h"
 #include "ns3/simulator.h"
 #include "ns3/integer.h"
+#include "ns3/pointer.h"
 #define _USE_MATH_DEFINES
 #include <cmath>
 #include <algorithm>
@@ -44,12 +45,12 @@ LeoSatelliteMobilityModel::GetTypeId (void)
                    MakeIntegerAccessor (&LeoSatelliteMobilityModel::m_numPlanes),
                    MakeIntegerChecker<uint32_t> ())
     .AddAttribute ("Latitude",
-                   "Latitude of satellite.",
+                   "Latitude of satellite at Time.",
                    DoubleValue(1.0),
                    MakeDoubleAccessor (&LeoSatelliteMobilityModel::m_latitude),
                    MakeDoubleChecker<double> ())
     .AddAttribute ("Longitude",
-                   "Longitude of satellite. Constant for satellites in same plane.",
+                   "Longitude of satellite at Time. Constant for satellites in same plane.",
                    DoubleValue(1.0),
                    MakeDoubleAccessor (&LeoSatelliteMobilityModel::m_longitude),
                    MakeDoubleChecker<double> ())
@@ -64,16 +65,24 @@ LeoSatelliteMobilityModel::GetTypeId (void)
                    MakeDoubleAccessor (&LeoSatelliteMobilityModel::m_altitude),
                    MakeDoubleChecker<double> ())
     .AddAttribute ("Direction",
-                   "Direction of satellite relative to other satellites.",
+                   "Direction of satellite at Time relative to other satellites.",
                    BooleanValue(1),
                    MakeBooleanAccessor (&LeoSatelliteMobilityModel::m_direction),
                    MakeBooleanChecker ())
+    .AddAttribute ("Ephemeris",
+                   "Ephemeris shared with the other satellites of the constellation.",
+                   PointerValue (),
+                   MakePointerAccessor (&LeoSatelliteMobilityModel::m_ephemeris),
+                   MakePointerChecker<LeoSatelliteEphemeris> ())
   ;
 
   return tid;
 }
 
 LeoSatelliteMobilityModel::LeoSatelliteMobilityModel()
+  : m_index (0),
+    m_registered (false),
+    m_orbitSet (false)
 {
   currentNode++;
   m_current = currentNode;
@@ -96,6 +105,11 @@ LeoSatelliteMobilityModel::LeoSatelliteMobilityModel()
 void 
 LeoSatelliteMobilityModel::DoSetPosition (const Vector &position)
 {
+  if (m_orbitSet)
+  {
+    return;
+  }
+
   // Determine speed of satellite from altitude
   double G = 6.673e-11; // gravitational constant [Nm^2/kg^2]
   double earthMass = 5.972e24; // mass of Earth [kg]
@@ -103,6 +117,10 @@ LeoSatelliteMobilityModel::DoSetPosition (const Vector &position)
 
   m_speed = std::sqrt(G*earthMass/(earthRadius*1000 + altitude*1000));
 
+  // Degrees travelled along the orbit per second
+  double orbitalPeriod = 2*M_PI*(earthRadius + altitude)/(m_speed/1000); // [seconds]
+  double angularSpeed = 360/orbitalPeriod;
+
   // Set latitude and longitude of satellite from number of orbital planes and number of satellites per orbital plane
   // First satellite in plane will have a longitude that is a half-step down from 90 degrees 
   if (m_current == 1)
@@ -122,85 +140,83 @@ LeoSatelliteMobilityModel::DoSetPosition (const Vector &position)
   // Set direction based on which orbital plane satellite belongs to
   uint32_t plane = floor((m_current - 1)/(m_nPerPlane/2));
   (plane % 2 == 1) ? m_direction = 0: m_direction = 1;
+
+  // Initial phase along the orbit, measured from the equator on the S to N half of the orbit
+  // The S to N half of the orbit is at m_longitude for direction 1, on the opposite side of the Earth otherwise
+  double phase;
+  double ascendingLongitude;
+  if (m_direction == 1)
+  {
+    phase = m_latitude;
+    ascendingLongitude = m_longitude;
+  }
+  else
+  {
+    phase = 180 - m_latitude;
+    ascendingLongitude = (m_longitude < 0) ? m_longitude + 180 : m_longitude - 180;
+  }
+
+  // Register the orbit with the ephemeris, once per satellite
+  if (m_ephemeris == 0)
+  {
+    m_ephemeris = CreateObject<LeoSatelliteEphemeris> ();
+  }
+  if (m_registered)
+  {
+    m_ephemeris->SetSatellite (m_index, phase, ascendingLongitude, angularSpeed, m_time, altitude);
+  }
+  else
+  {
+    m_index = m_ephemeris->AddSatellite (phase, ascendingLongitude, angularSpeed, m_time, altitude);
+    m_registered = true;
+  }
 }
 
+/* Position is a pure function of the initial phase and the time since m_time,
+   computed by the ephemeris for all satellites sharing it */
 Vector
 LeoSatelliteMobilityModel::DoGetPosition (void) const
 {
-   double altitude = m_altitude;
-   double latitude = m_latitude;
-   double longitude = m_longitude;
-   bool direction = m_direction; 
-   double currentTime = Simulator::Now().GetSeconds();
-   double radius = earthRadius + altitude; 
-   double newLatitude;
-
-   // How many orbital periods have been completed, then converted to degree displacement
-   double orbitalPeriod = 2*M_PI*radius/(m_speed/1000); // [seconds]
-   double orbitalPeriodTravelled = (currentTime - m_time)/orbitalPeriod;
-   double degreeDisplacement = fmod(orbitalPeriodTravelled*360, 360); 
-
-   if (direction == 1)
-   {
-      if ((latitude + degreeDisplacement) > 90)
-      {
-         degreeDisplacement = degreeDisplacement - (90 - latitude); // We've accounted for the degrees taken to get to north pole
-         latitude = 90;
-         if (longitude < 0)
-            longitude = longitude + 180;
-          else
-            longitude = longitude - 180;
-         direction = 0;
-
-        if ((latitude - degreeDisplacement) < -90)
-        {
-          degreeDisplacement = degreeDisplacement - 180; // We've accounted for the degrees taken to get to south pole
-          latitude = -90;
-          if (longitude < 0)
-            longitude = longitude + 180;
-          else
-            longitude = longitude - 180;
-          direction = 1;
-        }
-      }
-      (direction == 1) ? newLatitude = latitude + degreeDisplacement : newLatitude = latitude - degreeDisplacement;
-   }
-
-   else if (direction == 0)
-   {
-      if ((latitude - degreeDisplacement) < -90)
-      {
-         degreeDisplacement = degreeDisplacement - (latitude - (-90)); // We've accounted for the degrees taken to get to south pole
-         latitude = -90;
-         if (longitude < 0)
-            longitude = longitude + 180;
-          else
-            longitude = longitude - 180;
-         direction = 1;
-
-        if ((latitude + degreeDisplacement) > 90)
-        {
-          degreeDisplacement = degreeDisplacement - 180; // We've accounted for the degrees taken to get to north pole
-          latitude = 90;
-          if (longitude < 0)
-            longitude = longitude + 180;
-          else
-            longitude = longitude - 180;
-          direction = 0;
-        }
-      }
-      (direction == 1) ? newLatitude = latitude + degreeDisplacement : newLatitude = latitude - degreeDisplacement;
-   }
-   
-   // Update latitude, longitude, direction, and time values for this object
-   m_latitude = newLatitude;
-   m_longitude = longitude;
-   m_time = currentTime;
-   m_direction = direction;
-
-   // Create vector to return
-   Vector currentPosition = Vector(m_latitude, m_longitude, altitude);
-   return currentPosition;
+   NS_ASSERT_MSG (m_registered, "Position of satellite " << m_current << " was never set");
+   return m_ephemeris->GetPosition(m_index);
+}
+
+Vector
+LeoSatelliteMobilityModel::GetPositionAt (Time time) const
+{
+   NS_ASSERT_MSG (m_registered, "Position of satellite " << m_current << " was never set");
+   return m_ephemeris->GetPosition(m_index, time);
+}
+
+void
+LeoSatelliteMobilityModel::SetOrbit (const LeoSatelliteOrbit &orbit)
+{
+  if (m_ephemeris == 0)
+  {
+    m_ephemeris = CreateObject<LeoSatelliteEphemeris> ();
+  }
+  if (m_registered)
+  {
+    m_ephemeris->SetOrbit (m_index, orbit.inclination, orbit.ascendingLongitude, orbit.nodeRate, orbit.phase,
+                           orbit.angularSpeed, orbit.epoch, orbit.altitude);
+  }
+  else
+  {
+    m_index = m_ephemeris->AddOrbit (orbit.inclination, orbit.ascendingLongitude, orbit.nodeRate, orbit.phase,
+                                     orbit.angularSpeed, orbit.epoch, orbit.altitude);
+    m_registered = true;
+  }
+  m_altitude = orbit.altitude;
+  m_time = orbit.epoch;
+  m_orbitSet = true;
+  NotifyCourseChange ();
+}
+
+Vector
+LeoSatelliteMobilityModel::PropagatePosition (Time time) const
+{
+   NS_ASSERT_MSG (m_registered, "Position of satellite " << m_current << " was never set");
+   return m_ephemeris->Propagate(m_index, time);
 }
 
 /* Args "a" and "b" to be obtained from LeoSatelliteMobilityModel::DoGetPosition for each argument 
@@ -14,6 +14,8 @@
 #include "ns3/ptr.h"
 #include "ns3/mobility-model.h"
 #include "ns3/vector.h"
+#include "ns3/leo-satellite-ephemeris.h"
+#include "ns3/leo-satellite-orbits.h"
 
 namespace ns3 {
 
@@ -24,6 +26,14 @@ namespace ns3 {
  * Each satellite moves in a polar orbit within its plane
  * Satellites move with a fixed velocity determined by their altitude
  * Satellites in adjacent planes move in opposing directions
+ * The orbit is registered with a LeoSatelliteEphemeris when the position is set,
+ * the model is a view onto its entry. Satellites of a constellation share one
+ * ephemeris so that all positions are computed in one batch per simulation time,
+ * a model without an ephemeris creates its own.
+ *
+ * SetOrbit () places the satellite on any circular orbit instead, e.g. of a
+ * Walker-delta constellation or from a two-line element set; SetPosition ()
+ * has no effect afterwards.
  */
 class LeoSatelliteMobilityModel : public MobilityModel
 {
@@ -35,6 +45,24 @@ public:
   static TypeId GetTypeId (void);
   LeoSatelliteMobilityModel();
 
+  /**
+   * \param time the simulation time, in the past or in the future
+   * \return the position of the satellite at time
+   */
+  Vector GetPositionAt (Time time) const;
+
+  /**
+   * \param time the simulation time, in the past or in the future
+   * \return the position of the satellite at time, computed for this satellite alone
+   */
+  Vector PropagatePosition (Time time) const;
+
+  /**
+   * \brief Place the satellite on an orbit instead of the polar layout of the constellation
+   * \param orbit the orbit
+   */
+  void SetOrbit (const LeoSatelliteOrbit &orbit);
+
 private:
   virtual Vector DoGetPosition (void) const;
   virtual void DoSetPosition (const Vector &position);
@@ -43,16 +71,20 @@ private:
   uint32_t m_current; // current node
   double m_nPerPlane; // number of satellites per plane -> m_nPerPlane/2 must be even number
   double m_numPlanes; // number of planes -> must be an odd number
-  mutable double m_time; // time when current m_latitude, m_longitude, and m_direction were set
+  double m_time; // time when m_latitude, m_longitude, and m_direction were set
   double m_altitude; // [km]
   // The following variables are calculated automatically given the above parameteres
-  mutable double m_latitude; // latitude of satellite at m_time
+  double m_latitude; // latitude of satellite at m_time
                      // negative value indicates southern latitude, positive value indicates northern latitude
-  mutable double m_longitude; // initial longitude of satellite
+  double m_longitude; // longitude of satellite at m_time
                       // negative value indicates western longitude, positive value indicates eastern longitude
-  mutable bool m_direction; // each adjacent plane will be orbiting in an opposite direction 
+  bool m_direction; // each adjacent plane will be orbiting in an opposite direction 
                     // 1 = S to N, 0 = N to S
   double m_speed; // [m/s]
+  Ptr<LeoSatelliteEphemeris> m_ephemeris; // orbital state of the satellite
+  uint32_t m_index; // index of the satellite within m_ephemeris
+  bool m_registered; // true once the orbit was added to m_ephemeris
+  bool m_orbitSet; // true once the orbit was given with SetOrbit ()
 };
 
 } // namespace ns3
@@ -0,0 +1,230 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * LEO Satellite Orbits
+ * Orbits of Walker-delta constellations and of satellites read from two-line element sets
+ *
+ * ENSC 427: Communication Networks
+ * Spring 2020
+ * Team 11
+ */
+
+#include "leo-satellite-orbits.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include <fstream>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LeoSatelliteOrbits");
+
+const double LeoSatelliteOrbits::EARTH_ROTATION = 360.98564736629/86400;
+
+namespace {
+
+const double EARTH_RADIUS = 6378.1; // [km], as in the mobility models
+const double EARTH_MU = 6.673e-11*5.972e24; // G times the mass of Earth [m^3/s^2], as in LeoSatelliteMobilityModel
+const double EARTH_J2 = 1.08263e-3;
+
+double
+WrapLongitude (double longitude)
+{
+  return longitude - 360*std::floor ((longitude + 180)/360);
+}
+
+double
+WrapAngle (double angle)
+{
+  return angle - 360*std::floor (angle/360);
+}
+
+// element set read from a file, angles in degrees
+struct TwoLineElements
+{
+  double julianDate;
+  double inclination;
+  double rightAscension;
+  double phase;
+  double meanMotion; // [revolutions/day]
+};
+
+// orders satellites by one of their angles
+struct CompareAngles
+{
+  CompareAngles (const std::vector<double> &angles) : m_angles (angles) {}
+  bool operator() (uint32_t a, uint32_t b) const { return m_angles[a] < m_angles[b]; }
+  const std::vector<double> &m_angles;
+};
+
+} // anonymous namespace
+
+std::vector<LeoSatelliteOrbit>
+LeoSatelliteOrbits::WalkerDelta (uint32_t numPlanes, uint32_t numSatellitesPerPlane, uint32_t phasing,
+                                 double inclination, double altitude, double epoch, bool earthRotation)
+{
+  NS_LOG_FUNCTION (numPlanes << numSatellitesPerPlane << phasing << inclination << altitude << epoch << earthRotation);
+  NS_ABORT_MSG_IF (numPlanes == 0 || numSatellitesPerPlane == 0, "Empty Walker-delta constellation");
+  NS_ABORT_MSG_IF (phasing >= numPlanes, "Walker-delta phasing " << phasing << " must be below the number of planes " << numPlanes);
+
+  double total = numPlanes*numSatellitesPerPlane;
+  double nodeRate = GetNodalRegression (inclination, altitude) - (earthRotation ? EARTH_ROTATION : 0);
+  std::vector<LeoSatelliteOrbit> orbits;
+  for (uint32_t p=0; p<numPlanes; p++)
+  {
+    for (uint32_t s=0; s<numSatellitesPerPlane; s++)
+    {
+      LeoSatelliteOrbit orbit;
+      orbit.inclination = inclination;
+      orbit.ascendingLongitude = -180 + 360.0*p/numPlanes;
+      orbit.nodeRate = nodeRate;
+      orbit.phase = WrapAngle (360.0*s/numSatellitesPerPlane + 360.0*phasing*p/total);
+      orbit.angularSpeed = GetAngularSpeed (altitude);
+      orbit.epoch = epoch;
+      orbit.altitude = altitude;
+      orbits.push_back (orbit);
+    }
+  }
+  return orbits;
+}
+
+std::vector<LeoSatelliteOrbit>
+LeoSatelliteOrbits::LoadTle (std::string fileName, uint32_t numPlanes, uint32_t numSatellitesPerPlane,
+                             double epoch, bool earthRotation)
+{
+  std::ifstream file (fileName.c_str ());
+  NS_ABORT_MSG_UNLESS (file.is_open (), "Two-line element file " << fileName << " cannot be opened");
+  return ReadTle (file, numPlanes, numSatellitesPerPlane, epoch, earthRotation);
+}
+
+std::vector<LeoSatelliteOrbit>
+LeoSatelliteOrbits::ReadTle (std::istream &stream, uint32_t numPlanes, uint32_t numSatellitesPerPlane,
+                             double epoch, bool earthRotation)
+{
+  NS_LOG_FUNCTION (numPlanes << numSatellitesPerPlane << epoch << earthRotation);
+  uint32_t total = numPlanes*numSatellitesPerPlane;
+
+  //element sets, fields at the fixed columns of the format
+  std::vector<TwoLineElements> sets;
+  std::string line, first;
+  while (sets.size () < total && std::getline (stream, line))
+  {
+    if (!line.empty () && line[line.size () - 1] == '\r')
+      line.erase (line.size () - 1);
+    if (line.compare (0, 2, "1 ") == 0)
+    {
+      first = line;
+      continue;
+    }
+    if (line.compare (0, 2, "2 ") != 0 || first.empty ())
+    {
+      first.clear ();
+      continue;
+    }
+    NS_ABORT_MSG_IF (first.size () < 32 || line.size () < 63, "Truncated two-line element set:\n" << first << "\n" << line);
+    TwoLineElements set;
+    uint32_t year = std::atoi (first.substr (18, 2).c_str ());
+    year += (year < 57) ? 2000 : 1900;
+    double day = std::atof (first.substr (20, 12).c_str ());
+    //julian date of January 1st, 0h of the year, and day 1.0 is January 1st, 0h
+    uint32_t y = year - 1;
+    set.julianDate = 1721425.5 + 365.0*y + y/4 - y/100 + y/400 + day - 1;
+    set.inclination = std::atof (line.substr (8, 8).c_str ());
+    set.rightAscension = std::atof (line.substr (17, 8).c_str ());
+    double argumentOfPerigee = std::atof (line.substr (34, 8).c_str ());
+    double meanAnomaly = std::atof (line.substr (43, 8).c_str ());
+    set.phase = WrapAngle (argumentOfPerigee + meanAnomaly);
+    set.meanMotion = std::atof (line.substr (52, 11).c_str ());
+    NS_ABORT_MSG_IF (set.meanMotion <= 0, "Invalid mean motion in two-line element set:\n" << line);
+    sets.push_back (set);
+    first.clear ();
+  }
+  NS_ABORT_MSG_IF (sets.size () < total, "Only " << sets.size () << " two-line element sets for "
+                   << numPlanes << " planes of " << numSatellitesPerPlane << " satellites");
+
+  double reference = sets[0].julianDate;
+  for (uint32_t i=1; i<total; i++)
+  {
+    reference = std::max (reference, sets[i].julianDate);
+  }
+
+  std::vector<LeoSatelliteOrbit> unsorted;
+  std::vector<double> rightAscension; // at the reference epoch
+  std::vector<double> phase; // at the reference epoch
+  for (uint32_t i=0; i<total; i++)
+  {
+    const TwoLineElements &set = sets[i];
+    LeoSatelliteOrbit orbit;
+    double meanMotion = set.meanMotion*2*M_PI/86400; // [rad/s]
+    orbit.inclination = set.inclination;
+    orbit.altitude = std::pow (EARTH_MU/(meanMotion*meanMotion), 1.0/3)/1000 - EARTH_RADIUS;
+    orbit.angularSpeed = set.meanMotion*360/86400;
+    orbit.phase = set.phase;
+    orbit.epoch = epoch + (set.julianDate - reference)*86400;
+    double regression = GetNodalRegression (orbit.inclination, orbit.altitude);
+    orbit.nodeRate = regression - (earthRotation ? EARTH_ROTATION : 0);
+    //the Earth turns under the nodes from the epoch of the set, or is frozen at the reference epoch
+    double siderealTime = GetSiderealTime (earthRotation ? set.julianDate : reference);
+    orbit.ascendingLongitude = WrapLongitude (set.rightAscension - siderealTime);
+    unsorted.push_back (orbit);
+
+    double elapsed = epoch - orbit.epoch;
+    rightAscension.push_back (WrapAngle (set.rightAscension + regression*elapsed));
+    phase.push_back (WrapAngle (orbit.phase + orbit.angularSpeed*elapsed));
+  }
+
+  //planes are consecutive by ascending node, starting after the largest gap so that no plane wraps around 0
+  std::vector<uint32_t> order;
+  for (uint32_t i=0; i<total; i++)
+  {
+    order.push_back (i);
+  }
+  std::sort (order.begin (), order.end (), CompareAngles (rightAscension));
+  uint32_t start = 0;
+  double largestGap = -1;
+  for (uint32_t i=0; i<total; i++)
+  {
+    double gap = WrapAngle (rightAscension[order[i]] - rightAscension[order[(i + total - 1)%total]]);
+    if (total == 1 || gap > largestGap)
+    {
+      largestGap = gap;
+      start = i;
+    }
+  }
+  std::rotate (order.begin (), order.begin () + start, order.end ());
+
+  std::vector<LeoSatelliteOrbit> orbits;
+  for (uint32_t p=0; p<numPlanes; p++)
+  {
+    std::vector<uint32_t>::iterator begin = order.begin () + p*numSatellitesPerPlane;
+    std::sort (begin, begin + numSatellitesPerPlane, CompareAngles (phase));
+    for (uint32_t s=0; s<numSatellitesPerPlane; s++)
+    {
+      orbits.push_back (unsorted[*(begin + s)]);
+    }
+  }
+  return orbits;
+}
+
+double
+LeoSatelliteOrbits::GetAngularSpeed (double altitude)
+{
+  double radius = (EARTH_RADIUS + altitude)*1000; // [m]
+  return std::sqrt (EARTH_MU/(radius*radius*radius))*180/M_PI;
+}
+
+double
+LeoSatelliteOrbits::GetNodalRegression (double inclination, double altitude)
+{
+  double ratio = EARTH_RADIUS/(EARTH_RADIUS + altitude);
+  return -1.5*GetAngularSpeed (altitude)*EARTH_J2*ratio*ratio*std::cos (inclination*M_PI/180);
+}
+
+double
+LeoSatelliteOrbits::GetSiderealTime (double julianDate)
+{
+  return WrapAngle (280.46061837 + 360.98564736629*(julianDate - 2451545.0));
+}
+
+} // namespace ns3
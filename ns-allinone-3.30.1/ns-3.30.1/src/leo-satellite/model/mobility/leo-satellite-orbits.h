@@ -0,0 +1,116 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * LEO Satellite Orbits
+ * Orbits of Walker-delta constellations and of satellites read from two-line element sets
+ *
+ * ENSC 427: Communication Networks
+ * Spring 2020
+ * Team 11
+ */
+#ifndef LEO_SATELLITE_ORBITS_H
+#define LEO_SATELLITE_ORBITS_H
+
+#include <stdint.h>
+#include <string>
+#include <istream>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup leo-satellite
+ * \brief circular orbit of a satellite, as taken by LeoSatelliteEphemeris::AddOrbit ()
+ */
+struct LeoSatelliteOrbit
+{
+  double inclination; //!< [degrees]
+  double ascendingLongitude; //!< longitude of the ascending node at epoch [degrees]
+  double nodeRate; //!< drift of the longitude of the ascending node [degrees/s]
+  double phase; //!< argument of latitude at epoch [degrees]
+  double angularSpeed; //!< [degrees/s]
+  double epoch; //!< simulation time at which the satellite is at phase [s]
+  double altitude; //!< [km]
+};
+
+/**
+ * \ingroup leo-satellite
+ * \brief orbits of a whole constellation, numbered plane by plane.
+ *
+ * Longitudes are relative to the Earth. When the rotation of the Earth is
+ * taken into account the ascending nodes drift west by 360 degrees per
+ * sidereal day, otherwise the Earth is frozen at the epoch of the orbits.
+ * The J2 regression of the nodes is always applied. Orbits are circular: the
+ * eccentricity of a two-line element set is ignored and its mean anomaly is
+ * taken as the true anomaly, an error of a few km for the near circular
+ * orbits of LEO constellations.
+ */
+class LeoSatelliteOrbits
+{
+public:
+  /**
+   * \brief Walker-delta constellation i: T/P/F
+   *
+   * Plane p has its ascending node at -180 + 360 p/P degrees, satellite s of
+   * plane p is at 360 s/S + 360 F p/T degrees along the orbit at epoch
+   * \param numPlanes number of planes P
+   * \param numSatellitesPerPlane number of satellites per plane S, T = P S
+   * \param phasing relative phasing F, between 0 and P - 1
+   * \param inclination [degrees]
+   * \param altitude [km]
+   * \param epoch simulation time of the layout above [s]
+   * \param earthRotation true to make the nodes drift with the rotation of the Earth
+   * \return the orbits of all satellites, numbered plane by plane
+   */
+  static std::vector<LeoSatelliteOrbit> WalkerDelta (uint32_t numPlanes, uint32_t numSatellitesPerPlane, uint32_t phasing,
+                                                     double inclination, double altitude, double epoch, bool earthRotation);
+
+  /**
+   * \brief Orbits of the satellites of a file of two-line element sets
+   *
+   * Element sets may be preceded by a line with the name of the satellite.
+   * The latest epoch of the file is at simulation time epoch. The first
+   * numPlanes numSatellitesPerPlane satellites of the file are split into
+   * planes by their ascending node, and sorted along their orbit within a plane.
+   * \param fileName the file
+   * \param numPlanes number of planes
+   * \param numSatellitesPerPlane number of satellites per plane
+   * \param epoch simulation time of the latest epoch of the file [s]
+   * \param earthRotation true to make the nodes drift with the rotation of the Earth
+   * \return the orbits of all satellites, numbered plane by plane
+   */
+  static std::vector<LeoSatelliteOrbit> LoadTle (std::string fileName, uint32_t numPlanes, uint32_t numSatellitesPerPlane,
+                                                 double epoch, bool earthRotation);
+
+  /**
+   * \see LoadTle ()
+   * \param stream two-line element sets
+   */
+  static std::vector<LeoSatelliteOrbit> ReadTle (std::istream &stream, uint32_t numPlanes, uint32_t numSatellitesPerPlane,
+                                                 double epoch, bool earthRotation);
+
+  /**
+   * \param altitude [km]
+   * \return the angular speed along a circular orbit at altitude [degrees/s]
+   */
+  static double GetAngularSpeed (double altitude);
+
+  /**
+   * \param inclination [degrees]
+   * \param altitude [km]
+   * \return the J2 drift of the ascending node of a circular orbit [degrees/s]
+   */
+  static double GetNodalRegression (double inclination, double altitude);
+
+  static const double EARTH_ROTATION; //!< [degrees/s], 360 degrees per sidereal day
+
+private:
+  /**
+   * \param julianDate the date
+   * \return the Greenwich mean sidereal time at julianDate [degrees]
+   */
+  static double GetSiderealTime (double julianDate);
+};
+
+} // namespace ns3
+
+#endif /* LEO_SATELLITE_ORBITS_H */
@@ -0,0 +1,219 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * LEO Satellite Spatial Index
+ * Buckets the sub-points of all satellites on a latitude/longitude grid to find
+ * the satellite closest to a ground position without scanning the constellation
+ *
+ * ENSC 427: Communication Networks
+ * Spring 2020
+ * Team 11
+ */
+
+#include "leo-satellite-spatial-index.h"
+#include "ns3/log.h"
+#include "ns3/double.h"
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LeoSatelliteSpatialIndex");
+
+NS_OBJECT_ENSURE_REGISTERED (LeoSatelliteSpatialIndex);
+
+const uint32_t LeoSatelliteSpatialIndex::NONE;
+
+TypeId
+LeoSatelliteSpatialIndex::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LeoSatelliteSpatialIndex")
+    .SetParent<Object> ()
+    .SetGroupName ("LeoSatellite")
+    .AddConstructor<LeoSatelliteSpatialIndex> ()
+    .AddAttribute ("CellSize",
+                   "Size of the cells of the grid [degrees]. Rounded so that a whole number of cells spans every latitude and longitude.",
+                   DoubleValue (10.0),
+                   MakeDoubleAccessor (&LeoSatelliteSpatialIndex::m_cellSize),
+                   MakeDoubleChecker<double> (0.1, 90.0))
+  ;
+  return tid;
+}
+
+LeoSatelliteSpatialIndex::LeoSatelliteSpatialIndex ()
+  : m_nRows (0),
+    m_nColumns (0),
+    m_rowSize (0),
+    m_columnSize (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LeoSatelliteSpatialIndex::~LeoSatelliteSpatialIndex ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+int32_t
+LeoSatelliteSpatialIndex::GetRow (double latitude) const
+{
+  int32_t row = std::floor ((latitude + 90)/m_rowSize);
+  return std::min (std::max (row, 0), int32_t (m_nRows) - 1);
+}
+
+int32_t
+LeoSatelliteSpatialIndex::GetColumn (double longitude) const
+{
+  return std::floor ((longitude + 180)/m_columnSize);
+}
+
+uint32_t
+LeoSatelliteSpatialIndex::Update (const std::vector<Vector> &positions)
+{
+  NS_LOG_FUNCTION (this << positions.size ());
+  bool rebuild = positions.size () != m_positions.size ();
+  if (rebuild)
+  {
+    m_nRows = std::ceil (180/m_cellSize);
+    m_nColumns = 2*m_nRows;
+    m_rowSize = 180.0/m_nRows;
+    m_columnSize = 360.0/m_nColumns;
+    m_cells.assign (m_nRows*m_nColumns, std::vector<uint32_t> ());
+    m_cell.assign (positions.size (), 0);
+    m_slot.assign (positions.size (), 0);
+  }
+  m_positions = positions;
+
+  uint32_t moved = 0;
+  for (uint32_t i=0; i<positions.size (); i++)
+  {
+    int32_t column = GetColumn (positions[i].y) % int32_t (m_nColumns);
+    if (column < 0)
+      column += m_nColumns;
+    uint32_t cell = GetRow (positions[i].x)*m_nColumns + column;
+    if (!rebuild)
+    {
+      if (cell == m_cell[i])
+        continue;
+      // swap the last satellite of the old cell into the freed slot
+      std::vector<uint32_t> &old = m_cells[m_cell[i]];
+      old[m_slot[i]] = old.back ();
+      m_slot[old.back ()] = m_slot[i];
+      old.pop_back ();
+    }
+    m_cell[i] = cell;
+    m_slot[i] = m_cells[cell].size ();
+    m_cells[cell].push_back (i);
+    moved++;
+  }
+  NS_LOG_LOGIC (moved << " of " << positions.size () << " satellites changed cell");
+  return moved;
+}
+
+uint32_t
+LeoSatelliteSpatialIndex::FindNearest (const Vector &position) const
+{
+  return FindNearest (position, MakeNullCallback<bool, uint32_t> ());
+}
+
+uint32_t
+LeoSatelliteSpatialIndex::FindNearest (const Vector &position, Callback<bool, uint32_t> accept) const
+{
+  NS_LOG_FUNCTION (this << position);
+  if (m_positions.empty ())
+  {
+    return NONE;
+  }
+
+  double radius = m_rowSize;
+  while (true)
+  {
+    // bounding box of the cap of the given radius around the position
+    int32_t firstRow = GetRow (position.x - radius);
+    int32_t lastRow = GetRow (position.x + radius);
+    int32_t firstColumn = 0;
+    int32_t lastColumn = m_nColumns - 1;
+    if (std::abs (position.x) + radius < 90)
+    {
+      double sinLongitude = std::sin (radius*M_PI/180)/std::cos (position.x*M_PI/180);
+      if (sinLongitude < 1)
+      {
+        double deltaLongitude = std::asin (sinLongitude)*180/M_PI;
+        firstColumn = GetColumn (position.y - deltaLongitude);
+        lastColumn = GetColumn (position.y + deltaLongitude);
+        if (lastColumn - firstColumn + 1 >= int32_t (m_nColumns))
+        {
+          firstColumn = 0;
+          lastColumn = m_nColumns - 1;
+        }
+      }
+    }
+
+    uint32_t best = NONE;
+    double bestAngle = 0;
+    for (int32_t row=firstRow; row<=lastRow; row++)
+    {
+      for (int32_t c=firstColumn; c<=lastColumn; c++)
+      {
+        int32_t column = c % int32_t (m_nColumns);
+        if (column < 0)
+          column += m_nColumns;
+        const std::vector<uint32_t> &cell = m_cells[row*m_nColumns + column];
+        for (uint32_t k=0; k<cell.size (); k++)
+        {
+          if (!accept.IsNull () && !accept (cell[k]))
+            continue;
+          double angle = GetCentralAngle (position, m_positions[cell[k]]);
+          if (best == NONE || angle < bestAngle || (angle == bestAngle && cell[k] < best))
+          {
+            best = cell[k];
+            bestAngle = angle;
+          }
+        }
+      }
+    }
+
+    // any satellite closer than the best one would have been inside the cap
+    if ((best != NONE && bestAngle <= radius) || radius >= 180)
+    {
+      return best;
+    }
+    radius = std::min (2*radius, 180.0);
+  }
+}
+
+uint32_t
+LeoSatelliteSpatialIndex::GetN (void) const
+{
+  return m_positions.size ();
+}
+
+/* Haversine formula, ignoring the slight ellipsoidal effects of Earth */
+double
+LeoSatelliteSpatialIndex::GetCentralAngle (const Vector &a, const Vector &b)
+{
+  double latitude1 = a.x*M_PI/180;
+  double latitude2 = b.x*M_PI/180;
+  double deltaLatitude = (b.x - a.x)*M_PI/180;
+  double deltaLongitude = (b.y - a.y)*M_PI/180;
+  double y = pow(sin(deltaLatitude/2), 2) + cos(latitude1)*cos(latitude2)*pow(sin(deltaLongitude/2), 2);
+  return 2*atan2(sqrt(y), sqrt(std::max (1 - y, 0.0)))*180/M_PI;
+}
+
+double
+LeoSatelliteSpatialIndex::GetSlantRange (const Vector &ground, const Vector &satellite)
+{
+  return GetStraightLineDistance (ground, satellite);
+}
+
+double
+LeoSatelliteSpatialIndex::GetStraightLineDistance (const Vector &a, const Vector &b)
+{
+  double earthRadius = 6378.1; // radius of Earth [km]
+  double radiusA = earthRadius + a.z;
+  double radiusB = earthRadius + b.z;
+  double angle = GetCentralAngle (a, b)*M_PI/180;
+  return std::sqrt (radiusA*radiusA + radiusB*radiusB - 2*radiusA*radiusB*std::cos (angle));
+}
+
+} // namespace ns3
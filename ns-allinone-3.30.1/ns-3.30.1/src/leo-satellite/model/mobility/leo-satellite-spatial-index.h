@@ -0,0 +1,124 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * LEO Satellite Spatial Index
+ * Buckets the sub-points of all satellites on a latitude/longitude grid to find
+ * the satellite closest to a ground position without scanning the constellation
+ *
+ * ENSC 427: Communication Networks
+ * Spring 2020
+ * Team 11
+ */
+#ifndef LEO_SATELLITE_SPATIAL_INDEX_H
+#define LEO_SATELLITE_SPATIAL_INDEX_H
+
+#include "ns3/object.h"
+#include "ns3/vector.h"
+#include "ns3/callback.h"
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup leo-satellite
+ * \brief latitude/longitude bucket grid over the sub-points of the satellites.
+ *
+ * Positions are (latitude, longitude, altitude) vectors as returned by the
+ * satellite and ground station mobility models. The grid is laid out on the
+ * first Update (), later updates only move the satellites whose sub-point left
+ * its cell.
+ *
+ * FindNearest () returns the satellite with the smallest central angle to the
+ * given position, i.e. the closest one for satellites at the same altitude.
+ * It searches the cells overlapping the bounding box of a spherical cap around
+ * the position, doubling the radius of the cap until a satellite is found
+ * inside it.
+ */
+class LeoSatelliteSpatialIndex : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  LeoSatelliteSpatialIndex ();
+  virtual ~LeoSatelliteSpatialIndex ();
+
+  /**
+   * \brief Move the satellites to their current cells
+   *
+   * The index is rebuilt from scratch if the number of satellites changed
+   * \param positions position of every satellite, indexed by satellite
+   * \return the number of satellites that changed cell
+   */
+  uint32_t Update (const std::vector<Vector> &positions);
+
+  /**
+   * \param position the ground position (latitude, longitude)
+   * \return the index of the satellite closest to position, NONE if the index is empty
+   */
+  uint32_t FindNearest (const Vector &position) const;
+
+  /**
+   * \param position the ground position (latitude, longitude)
+   * \param accept called with the index of a satellite, false to leave the satellite out
+   * \return the index of the accepted satellite closest to position, NONE if there is none
+   */
+  uint32_t FindNearest (const Vector &position, Callback<bool, uint32_t> accept) const;
+
+  /**
+   * \return the number of satellites in the index
+   */
+  uint32_t GetN (void) const;
+
+  /**
+   * \param a first position (latitude, longitude)
+   * \param b second position (latitude, longitude)
+   * \return the angle between the two positions seen from the centre of the Earth [degrees]
+   */
+  static double GetCentralAngle (const Vector &a, const Vector &b);
+
+  /**
+   * \param ground the ground position (latitude, longitude, altitude)
+   * \param satellite the satellite position (latitude, longitude, altitude)
+   * \return the straight line distance between the two positions [km]
+   */
+  static double GetSlantRange (const Vector &ground, const Vector &satellite);
+
+  /**
+   * \param a first position (latitude, longitude, altitude)
+   * \param b second position (latitude, longitude, altitude)
+   * \return the straight line distance between the two positions [km]
+   */
+  static double GetStraightLineDistance (const Vector &a, const Vector &b);
+
+  static const uint32_t NONE = 0xffffffff; //!< returned when there is no satellite
+
+private:
+  /**
+   * \param latitude the latitude [degrees]
+   * \return the row of the cells containing the latitude
+   */
+  int32_t GetRow (double latitude) const;
+
+  /**
+   * \param longitude the longitude [degrees]
+   * \return the column of the cells containing the longitude, not wrapped
+   */
+  int32_t GetColumn (double longitude) const;
+
+  double m_cellSize; // requested cell size [degrees]
+  uint32_t m_nRows;
+  uint32_t m_nColumns;
+  double m_rowSize; // [degrees]
+  double m_columnSize; // [degrees]
+  std::vector<std::vector<uint32_t> > m_cells; // satellites of every cell, row by row
+  std::vector<Vector> m_positions; // position of every satellite at the last update
+  std::vector<uint32_t> m_cell; // cell of every satellite
+  std::vector<uint32_t> m_slot; // position of every satellite within its cell
+};
+
+} // namespace ns3
+
+#endif /* LEO_SATELLITE_SPATIAL_INDEX_H */
@@ -0,0 +1,224 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * LEO Satellite Grid Route Manager
+ * Derives next hops arithmetically from the plane/index coordinates of the satellites
+ * and the current offset of the inter-plane links
+ *
+ * ENSC 427: Communication Networks
+ * Spring 2020
+ * Team 11
+ */
+
+#include "leo-satellite-grid-route-manager.h"
+#include "ns3/log.h"
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LeoSatelliteGridRouteManager");
+
+NS_OBJECT_ENSURE_REGISTERED (LeoSatelliteGridRouteManager);
+
+const uint32_t LeoSatelliteGridRouteManager::NOT_SATELLITE;
+
+TypeId
+LeoSatelliteGridRouteManager::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LeoSatelliteGridRouteManager")
+    .SetParent<LeoSatelliteRouteManager> ()
+    .SetGroupName ("LeoSatellite")
+    .AddConstructor<LeoSatelliteGridRouteManager> ()
+  ;
+  return tid;
+}
+
+LeoSatelliteGridRouteManager::LeoSatelliteGridRouteManager ()
+  : m_numPlanes (0),
+    m_numSatellitesPerPlane (0),
+    m_seam (0),
+    m_reversedSeam (true)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LeoSatelliteGridRouteManager::~LeoSatelliteGridRouteManager ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+LeoSatelliteGridRouteManager::SetGrid (uint32_t numPlanes, uint32_t numSatellitesPerPlane, bool reversedSeam)
+{
+  NS_LOG_FUNCTION (this << numPlanes << numSatellitesPerPlane << reversedSeam);
+  NS_ASSERT_MSG (numPlanes >= 2, "Grid routing needs the inter-plane links to leave the plane");
+  m_numPlanes = numPlanes;
+  m_numSatellitesPerPlane = numSatellitesPerPlane;
+  m_reversedSeam = reversedSeam;
+  m_satellites.assign (numPlanes*numSatellitesPerPlane, UNREACHABLE);
+}
+
+void
+LeoSatelliteGridRouteManager::SetSatellite (Ptr<Node> node, uint32_t plane, uint32_t index)
+{
+  NS_LOG_FUNCTION (this << node->GetId () << plane << index);
+  NS_ASSERT (plane < m_numPlanes && index < m_numSatellitesPerPlane);
+  uint32_t n = GetNodeIndex (node);
+  if (n >= m_plane.size ())
+  {
+    m_plane.resize (n + 1, NOT_SATELLITE);
+    m_index.resize (n + 1, NOT_SATELLITE);
+  }
+  m_plane[n] = plane;
+  m_index[n] = index;
+  m_satellites[plane*m_numSatellitesPerPlane + index] = n;
+}
+
+void
+LeoSatelliteGridRouteManager::ComputeRoutes (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_plane.resize (GetNNodes (), NOT_SATELLITE);
+  m_index.resize (GetNNodes (), NOT_SATELLITE);
+  m_planeOffset.assign (m_numPlanes, 0);
+
+  // every satellite of a plane uses the same offset, read it from the first one
+  for (uint32_t i=0; i<m_numPlanes; i++)
+  {
+    uint32_t first = m_satellites[i*m_numSatellitesPerPlane];
+    uint32_t nextPlane = (i + 1)%m_numPlanes;
+    const std::vector<uint32_t> &links = m_adjacency[first];
+    for (uint32_t l=0; l<links.size (); l++)
+    {
+      const Link &link = m_links[links[l]];
+      if (link.nodeA != first || m_plane[link.nodeB] != nextPlane)
+      {
+        continue;
+      }
+      uint32_t peerIndex = m_index[link.nodeB];
+      if (nextPlane != 0)
+      {
+        m_planeOffset[nextPlane] = (m_planeOffset[i] + peerIndex)%m_numSatellitesPerPlane;
+      }
+      else
+      {
+        uint32_t x = (m_numSatellitesPerPlane - m_planeOffset[i])%m_numSatellitesPerPlane;
+        m_seam = m_reversedSeam ? (peerIndex + x)%m_numSatellitesPerPlane
+                                : (peerIndex + m_numSatellitesPerPlane - x)%m_numSatellitesPerPlane;
+      }
+      break;
+    }
+  }
+  m_pending.clear ();
+}
+
+uint32_t
+LeoSatelliteGridRouteManager::UpdateRoutes (void)
+{
+  ComputeRoutes ();
+  return 0;
+}
+
+uint32_t
+LeoSatelliteGridRouteManager::GetSatellite (uint32_t node) const
+{
+  if (m_plane[node] != NOT_SATELLITE)
+  {
+    return node;
+  }
+  // ground stations have a single link
+  NS_ASSERT (m_adjacency[node].size () == 1);
+  return Other (m_links[m_adjacency[node][0]], node);
+}
+
+uint32_t
+LeoSatelliteGridRouteManager::GetRingDistance (uint32_t x, uint32_t y) const
+{
+  uint32_t d = (x + m_numSatellitesPerPlane - y)%m_numSatellitesPerPlane;
+  return std::min (d, m_numSatellitesPerPlane - d);
+}
+
+uint32_t
+LeoSatelliteGridRouteManager::GetSatelliteDistance (uint32_t a, uint32_t b) const
+{
+  uint32_t s = m_numSatellitesPerPlane;
+  uint32_t p = m_plane[a];
+  uint32_t q = m_plane[b];
+  uint32_t x = (m_index[a] + s - m_planeOffset[p])%s;
+  uint32_t y = (m_index[b] + s - m_planeOffset[q])%s;
+  uint32_t planes = (p > q) ? p - q : q - p;
+
+  uint32_t direct = planes + GetRingDistance (x, y);
+  if (m_reversedSeam)
+  {
+    uint32_t seam = m_numPlanes - planes + GetRingDistance ((m_seam + s - x)%s, y);
+    return std::min (direct, seam);
+  }
+  // crossing the seam east shifts the virtual index by m_seam, crossing it west by -m_seam
+  uint32_t east = (p >= q) ? GetRingDistance ((x + m_seam)%s, y) : UNREACHABLE;
+  uint32_t west = (p <= q) ? GetRingDistance ((x + s - m_seam)%s, y) : UNREACHABLE;
+  uint32_t seam = m_numPlanes - planes + std::min (east, west);
+  return std::min (direct, seam);
+}
+
+uint32_t
+LeoSatelliteGridRouteManager::GetDistance (uint32_t src, uint32_t dst) const
+{
+  NS_ASSERT (src < GetNNodes () && dst < GetNNodes () && !m_planeOffset.empty ());
+  if (src == dst)
+  {
+    return 0;
+  }
+  uint32_t a = GetSatellite (src);
+  uint32_t b = GetSatellite (dst);
+  uint32_t access = (a != src) + (b != dst);
+  return (a == b) ? access : GetSatelliteDistance (a, b) + access;
+}
+
+bool
+LeoSatelliteGridRouteManager::GetNextHop (uint32_t src, uint32_t dst, uint32_t &interface, Ipv4Address &gateway) const
+{
+  if (src == dst || m_planeOffset.empty ())
+  {
+    return false;
+  }
+  const std::vector<uint32_t> &links = m_adjacency[src];
+  if (m_plane[src] == NOT_SATELLITE)
+  {
+    GetPort (links[0], src, interface, gateway);
+    return true;
+  }
+
+  uint32_t target = GetSatellite (dst);
+  uint32_t best = UNREACHABLE;
+  uint32_t bestDistance = UNREACHABLE;
+  for (uint32_t l=0; l<links.size (); l++)
+  {
+    uint32_t neighbour = Other (m_links[links[l]], src);
+    if (target == src)
+    {
+      // the destination is a ground station attached to this satellite
+      if (neighbour == dst)
+      {
+        best = links[l];
+        break;
+      }
+    }
+    else if (m_plane[neighbour] != NOT_SATELLITE)
+    {
+      uint32_t distance = GetSatelliteDistance (neighbour, target);
+      if (distance < bestDistance)
+      {
+        bestDistance = distance;
+        best = links[l];
+      }
+    }
+  }
+  if (best == UNREACHABLE)
+  {
+    return false;
+  }
+  GetPort (best, src, interface, gateway);
+  return true;
+}
+
+} // namespace ns3
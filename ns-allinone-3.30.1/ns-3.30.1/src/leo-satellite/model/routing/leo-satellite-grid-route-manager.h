@@ -0,0 +1,100 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * LEO Satellite Grid Route Manager
+ * Derives next hops arithmetically from the plane/index coordinates of the satellites
+ * and the current offset of the inter-plane links
+ *
+ * ENSC 427: Communication Networks
+ * Spring 2020
+ * Team 11
+ */
+#ifndef LEO_SATELLITE_GRID_ROUTE_MANAGER_H
+#define LEO_SATELLITE_GRID_ROUTE_MANAGER_H
+
+#include "leo-satellite-route-manager.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup leo-satellite
+ * \brief analytic routing engine for the constellation grid.
+ *
+ * Intra-plane links form a ring, and every satellite of plane i is linked to the
+ * satellite of plane i+1 found at a common offset, so numbering each plane from the
+ * end of its inter-plane links gives every satellite a "virtual" index kept across
+ * planes. The links between the last and the first plane reverse that numbering with
+ * counter-rotating polar planes, and shift it by C with co-rotating (Walker-delta) planes.
+ *
+ * The shortest path between two satellites either stays on one side of that seam or
+ * crosses it once, so the hop count is
+ *   min (|p - q| + ring (x, y), P - |p - q| + ring (C - x, y))
+ * where a shifted seam replaces ring (C - x, y) by ring (x + C, y) if p >= q, ring (x - C, y) if p <= q,
+ * for satellites at plane p, virtual index x and plane q, virtual index y, and the
+ * next hop is the neighbour closest to the destination. No routing table is kept,
+ * only the offset of every plane.
+ */
+class LeoSatelliteGridRouteManager : public LeoSatelliteRouteManager
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  LeoSatelliteGridRouteManager ();
+  virtual ~LeoSatelliteGridRouteManager ();
+
+  /**
+   * \brief Set the size of the grid
+   * \param numPlanes number of orbital planes, at least 2
+   * \param numSatellitesPerPlane number of satellites per plane
+   * \param reversedSeam true if the last plane is linked to the first one in reverse order,
+   *        as with counter-rotating polar planes, false if both move the same way
+   */
+  void SetGrid (uint32_t numPlanes, uint32_t numSatellitesPerPlane, bool reversedSeam = true);
+
+  /**
+   * \brief Place a node of the routing graph on the grid
+   * \param node the satellite, already added with AddNode ()
+   * \param plane orbital plane of the satellite
+   * \param index position of the satellite along the intra-plane ring
+   */
+  void SetSatellite (Ptr<Node> node, uint32_t plane, uint32_t index);
+
+  /**
+   * \brief Read the offset of every plane from the current inter-plane links
+   */
+  virtual void ComputeRoutes (void);
+
+  /**
+   * \brief Read the offset of every plane from the current inter-plane links
+   * \return 0, no per-destination state has to be rebuilt
+   */
+  virtual uint32_t UpdateRoutes (void);
+
+  virtual uint32_t GetDistance (uint32_t src, uint32_t dst) const;
+
+protected:
+  virtual bool GetNextHop (uint32_t src, uint32_t dst, uint32_t &interface, Ipv4Address &gateway) const;
+
+private:
+  uint32_t GetSatellite (uint32_t node) const; // the node itself, or the satellite a ground station is attached to
+  uint32_t GetRingDistance (uint32_t x, uint32_t y) const;
+  uint32_t GetSatelliteDistance (uint32_t a, uint32_t b) const;
+
+  static const uint32_t NOT_SATELLITE = 0xffffffff;
+
+  uint32_t m_numPlanes;
+  uint32_t m_numSatellitesPerPlane;
+  std::vector<uint32_t> m_plane; // routing graph index -> plane, NOT_SATELLITE for ground stations
+  std::vector<uint32_t> m_index; // routing graph index -> position in plane
+  std::vector<uint32_t> m_satellites; // plane*m_numSatellitesPerPlane + index -> routing graph index
+  std::vector<uint32_t> m_planeOffset; // index of the first virtual satellite of each plane
+  uint32_t m_seam; // virtual index x of the last plane is linked to virtual index m_seam - x (m_seam + x if not reversed) of the first plane
+  bool m_reversedSeam;
+};
+
+} // namespace ns3
+
+#endif /* LEO_SATELLITE_GRID_ROUTE_MANAGER_H */
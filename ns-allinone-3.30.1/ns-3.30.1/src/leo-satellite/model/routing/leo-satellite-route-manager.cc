@@ -0,0 +1,319 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * LEO Satellite Route Manager
+ * Keeps the link graph of the constellation and the shortest path trees towards every node,
+ * updating only the trees affected by links that changed partner
+ *
+ * ENSC 427: Communication Networks
+ * Spring 2020
+ * Team 11
+ */
+
+#include "leo-satellite-route-manager.h"
+#include "ns3/log.h"
+#include "ns3/ipv4.h"
+#include <deque>
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LeoSatelliteRouteManager");
+
+NS_OBJECT_ENSURE_REGISTERED (LeoSatelliteRouteManager);
+
+const uint32_t LeoSatelliteRouteManager::UNREACHABLE;
+
+TypeId
+LeoSatelliteRouteManager::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LeoSatelliteRouteManager")
+    .SetParent<Object> ()
+    .SetGroupName ("LeoSatellite")
+    .AddConstructor<LeoSatelliteRouteManager> ()
+  ;
+  return tid;
+}
+
+LeoSatelliteRouteManager::LeoSatelliteRouteManager ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LeoSatelliteRouteManager::~LeoSatelliteRouteManager ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+LeoSatelliteRouteManager::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_nodes.clear ();
+  Object::DoDispose ();
+}
+
+uint32_t
+LeoSatelliteRouteManager::AddNode (Ptr<Node> node)
+{
+  NS_LOG_FUNCTION (this << node->GetId ());
+  NS_ASSERT_MSG (node->GetObject<Ipv4> () != 0, "Node " << node->GetId () << " has no Ipv4 stack");
+
+  if (node->GetId () >= m_nodeIndex.size ())
+  {
+    m_nodeIndex.resize (node->GetId () + 1, UNREACHABLE);
+  }
+  NS_ASSERT_MSG (m_nodeIndex[node->GetId ()] == UNREACHABLE, "Node " << node->GetId () << " added twice");
+
+  uint32_t index = m_nodes.size ();
+  m_nodeIndex[node->GetId ()] = index;
+  m_nodes.push_back (node);
+  m_adjacency.push_back (std::vector<uint32_t> ());
+  return index;
+}
+
+Ipv4Address
+LeoSatelliteRouteManager::GetInterfaceAddress (Ptr<Node> node, uint32_t interface)
+{
+  Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+  NS_ASSERT_MSG (ipv4->GetNAddresses (interface) > 0, "Interface " << interface << " of node " << node->GetId () << " has no address");
+  Ipv4Address address = ipv4->GetAddress (interface, 0).GetLocal ();
+  m_addressToNode[address] = GetNodeIndex (node);
+  return address;
+}
+
+uint32_t
+LeoSatelliteRouteManager::AddLink (Ptr<Node> a, uint32_t ifA, Ptr<Node> b, uint32_t ifB)
+{
+  NS_LOG_FUNCTION (this << a->GetId () << ifA << b->GetId () << ifB);
+  Link link;
+  link.nodeA = GetNodeIndex (a);
+  link.ifA = ifA;
+  link.addrA = GetInterfaceAddress (a, ifA);
+  link.nodeB = GetNodeIndex (b);
+  link.ifB = ifB;
+  link.addrB = GetInterfaceAddress (b, ifB);
+
+  uint32_t id = m_links.size ();
+  m_links.push_back (link);
+  m_adjacency[link.nodeA].push_back (id);
+  m_adjacency[link.nodeB].push_back (id);
+  return id;
+}
+
+void
+LeoSatelliteRouteManager::UpdateLink (uint32_t id, Ptr<Node> b, uint32_t ifB)
+{
+  NS_LOG_FUNCTION (this << id << b->GetId () << ifB);
+  NS_ASSERT (id < m_links.size ());
+  Link &link = m_links[id];
+  uint32_t nodeB = GetNodeIndex (b);
+
+  if (nodeB != link.nodeB)
+  {
+    std::vector<uint32_t> &oldAdjacency = m_adjacency[link.nodeB];
+    for (uint32_t i=0; i<oldAdjacency.size (); i++)
+    {
+      if (oldAdjacency[i] == id)
+      {
+        oldAdjacency.erase (oldAdjacency.begin () + i);
+        break;
+      }
+    }
+    m_adjacency[nodeB].push_back (id);
+
+    LinkChange change;
+    change.link = id;
+    change.oldNodeB = link.nodeB;
+    m_pending.push_back (change);
+  }
+
+  link.nodeB = nodeB;
+  link.ifB = ifB;
+  link.addrB = GetInterfaceAddress (b, ifB);
+}
+
+uint32_t
+LeoSatelliteRouteManager::Other (const Link &link, uint32_t node) const
+{
+  return (link.nodeA == node) ? link.nodeB : link.nodeA;
+}
+
+void
+LeoSatelliteRouteManager::BuildTree (uint32_t dst)
+{
+  uint32_t n = m_nodes.size ();
+  uint32_t *distance = &m_distance[dst*n];
+  uint32_t *nextLink = &m_nextLink[dst*n];
+  std::fill (distance, distance + n, UNREACHABLE);
+  std::fill (nextLink, nextLink + n, UNREACHABLE);
+
+  std::deque<uint32_t> queue;
+  distance[dst] = 0;
+  queue.push_back (dst);
+  while (!queue.empty ())
+  {
+    uint32_t node = queue.front ();
+    queue.pop_front ();
+    const std::vector<uint32_t> &links = m_adjacency[node];
+    for (uint32_t i=0; i<links.size (); i++)
+    {
+      uint32_t neighbour = Other (m_links[links[i]], node);
+      if (distance[neighbour] == UNREACHABLE)
+      {
+        distance[neighbour] = distance[node] + 1;
+        nextLink[neighbour] = links[i];
+        queue.push_back (neighbour);
+      }
+    }
+  }
+}
+
+void
+LeoSatelliteRouteManager::ComputeRoutes (void)
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t n = m_nodes.size ();
+  m_distance.assign (n*n, UNREACHABLE);
+  m_nextLink.assign (n*n, UNREACHABLE);
+  for (uint32_t dst=0; dst<n; dst++)
+  {
+    BuildTree (dst);
+  }
+  m_pending.clear ();
+}
+
+uint32_t
+LeoSatelliteRouteManager::UpdateRoutes (void)
+{
+  NS_LOG_FUNCTION (this << m_pending.size ());
+  uint32_t n = m_nodes.size ();
+  if (m_distance.size () != n*n)
+  {
+    ComputeRoutes ();
+    return n;
+  }
+
+  uint32_t rebuilt = 0;
+  for (uint32_t dst=0; dst<n && !m_pending.empty (); dst++)
+  {
+    const uint32_t *distance = &m_distance[dst*n];
+    const uint32_t *nextLink = &m_nextLink[dst*n];
+    bool affected = false;
+    for (uint32_t i=0; i<m_pending.size () && !affected; i++)
+    {
+      uint32_t id = m_pending[i].link;
+      const Link &link = m_links[id];
+      // the old link was part of the tree
+      affected = (nextLink[link.nodeA] == id) || (nextLink[m_pending[i].oldNodeB] == id);
+      // the new link shortens the tree: the old distances are no longer consistent across it
+      uint32_t distA = distance[link.nodeA];
+      uint32_t distB = distance[link.nodeB];
+      if (distA != distB)
+      {
+        affected |= (distA == UNREACHABLE) || (distB == UNREACHABLE) || (std::max (distA, distB) - std::min (distA, distB) > 1);
+      }
+    }
+    if (affected)
+    {
+      BuildTree (dst);
+      rebuilt++;
+    }
+  }
+  NS_LOG_LOGIC ("Rebuilt " << rebuilt << " of " << n << " trees for " << m_pending.size () << " changed links");
+  m_pending.clear ();
+  return rebuilt;
+}
+
+void
+LeoSatelliteRouteManager::GetPort (uint32_t id, uint32_t node, uint32_t &interface, Ipv4Address &gateway) const
+{
+  const Link &link = m_links[id];
+  if (link.nodeA == node)
+  {
+    interface = link.ifA;
+    gateway = link.addrB;
+  }
+  else
+  {
+    interface = link.ifB;
+    gateway = link.addrA;
+  }
+}
+
+bool
+LeoSatelliteRouteManager::GetNextHop (uint32_t src, uint32_t dst, uint32_t &interface, Ipv4Address &gateway) const
+{
+  uint32_t n = m_nodes.size ();
+  if (src == dst || m_nextLink.size () != n*n)
+  {
+    return false;
+  }
+  uint32_t id = m_nextLink[dst*n + src];
+  if (id == UNREACHABLE)
+  {
+    return false;
+  }
+  GetPort (id, src, interface, gateway);
+  return true;
+}
+
+bool
+LeoSatelliteRouteManager::LookupRoute (Ptr<Node> node, Ipv4Address dest, uint32_t &interface, Ipv4Address &gateway) const
+{
+  std::unordered_map<Ipv4Address, uint32_t, Ipv4AddressHash>::const_iterator it = m_addressToNode.find (dest);
+  if (it == m_addressToNode.end ())
+  {
+    return false;
+  }
+  if (node->GetId () >= m_nodeIndex.size () || m_nodeIndex[node->GetId ()] == UNREACHABLE)
+  {
+    return false;
+  }
+  return GetNextHop (m_nodeIndex[node->GetId ()], it->second, interface, gateway);
+}
+
+void
+LeoSatelliteRouteManager::PrintRoutes (Ptr<Node> node, std::ostream &os) const
+{
+  uint32_t n = m_nodes.size ();
+  uint32_t src = GetNodeIndex (node);
+  os << "Node            Gateway         Hops  Iface" << std::endl;
+  for (uint32_t dst=0; dst<n; dst++)
+  {
+    uint32_t interface;
+    Ipv4Address gateway;
+    if (GetNextHop (src, dst, interface, gateway))
+    {
+      std::ostringstream gw;
+      gw << gateway;
+      os << std::setiosflags (std::ios::left) << std::setw (16) << m_nodes[dst]->GetId ()
+         << std::setw (16) << gw.str () << std::setw (6) << GetDistance (src, dst) << interface << std::endl;
+    }
+  }
+}
+
+uint32_t
+LeoSatelliteRouteManager::GetNodeIndex (Ptr<Node> node) const
+{
+  NS_ASSERT_MSG (node->GetId () < m_nodeIndex.size () && m_nodeIndex[node->GetId ()] != UNREACHABLE,
+                 "Node " << node->GetId () << " is not part of the routing graph");
+  return m_nodeIndex[node->GetId ()];
+}
+
+uint32_t
+LeoSatelliteRouteManager::GetNNodes (void) const
+{
+  return m_nodes.size ();
+}
+
+uint32_t
+LeoSatelliteRouteManager::GetDistance (uint32_t src, uint32_t dst) const
+{
+  uint32_t n = m_nodes.size ();
+  NS_ASSERT (src < n && dst < n && m_distance.size () == n*n);
+  return m_distance[dst*n + src];
+}
+
+} // namespace ns3
@@ -0,0 +1,173 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * LEO Satellite Route Manager
+ * Keeps the link graph of the constellation and the shortest path trees towards every node,
+ * updating only the trees affected by links that changed partner
+ *
+ * ENSC 427: Communication Networks
+ * Spring 2020
+ * Team 11
+ */
+#ifndef LEO_SATELLITE_ROUTE_MANAGER_H
+#define LEO_SATELLITE_ROUTE_MANAGER_H
+
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/node.h"
+#include "ns3/ipv4-address.h"
+#include <vector>
+#include <ostream>
+#include <unordered_map>
+
+namespace ns3 {
+
+/**
+ * \ingroup leo-satellite
+ * \brief constellation-aware routing engine.
+ *
+ * Every link of the constellation is registered once as a pair of
+ * (node, interface) endpoints. A link keeps its first endpoint for its whole
+ * lifetime, its second endpoint can be re-pointed to another node when an
+ * inter-plane or ground link switches partner.
+ *
+ * Routes are hop-count shortest paths (the same metric used by global routing
+ * with default interface metrics), kept as one BFS tree per destination node.
+ * UpdateRoutes () only rebuilds the trees that one of the re-pointed links
+ * belonged to, or that one of the new links could shorten.
+ */
+class LeoSatelliteRouteManager : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  LeoSatelliteRouteManager ();
+  virtual ~LeoSatelliteRouteManager ();
+
+  /**
+   * \brief Add a node to the routing graph
+   * \param node the node, must have an Ipv4 stack installed
+   * \return the index of the node within the routing graph
+   */
+  uint32_t AddNode (Ptr<Node> node);
+
+  /**
+   * \brief Add a link between two interfaces
+   * \param a first endpoint of the link, never changes
+   * \param ifA Ipv4 interface index of the link on node a
+   * \param b second endpoint of the link
+   * \param ifB Ipv4 interface index of the link on node b
+   * \return the link id, to be used with UpdateLink ()
+   */
+  uint32_t AddLink (Ptr<Node> a, uint32_t ifA, Ptr<Node> b, uint32_t ifB);
+
+  /**
+   * \brief Re-point the second endpoint of a link
+   *
+   * The change is only recorded; routes are updated on the next call to UpdateRoutes ()
+   * \param link the link id returned by AddLink ()
+   * \param b new second endpoint of the link
+   * \param ifB Ipv4 interface index of the link on node b
+   */
+  void UpdateLink (uint32_t link, Ptr<Node> b, uint32_t ifB);
+
+  /**
+   * \brief Compute the routes towards every node from scratch
+   */
+  virtual void ComputeRoutes (void);
+
+  /**
+   * \brief Update the routes affected by the links changed since the last update
+   * \return the number of destination trees that had to be rebuilt
+   */
+  virtual uint32_t UpdateRoutes (void);
+
+  /**
+   * \brief Find the next hop from a node towards an address
+   * \param node the node forwarding the packet
+   * \param dest destination address
+   * \param interface output interface of the node
+   * \param gateway address of the next hop
+   * \return false if the address is unknown, local to the node or unreachable
+   */
+  bool LookupRoute (Ptr<Node> node, Ipv4Address dest, uint32_t &interface, Ipv4Address &gateway) const;
+
+  /**
+   * \brief Print the next hop of a node towards every other node
+   * \param node a node of the routing graph
+   * \param os output stream
+   */
+  void PrintRoutes (Ptr<Node> node, std::ostream &os) const;
+
+  /**
+   * \param node a node of the routing graph
+   * \return the index of the node within the routing graph
+   */
+  uint32_t GetNodeIndex (Ptr<Node> node) const;
+
+  /**
+   * \return the number of nodes in the routing graph
+   */
+  uint32_t GetNNodes (void) const;
+
+  /**
+   * \param src index of the source node
+   * \param dst index of the destination node
+   * \return the hop count from src to dst, UNREACHABLE if there is no path
+   */
+  virtual uint32_t GetDistance (uint32_t src, uint32_t dst) const;
+
+  static const uint32_t UNREACHABLE = 0xffffffff;
+
+protected:
+  virtual void DoDispose (void);
+
+  struct Link
+  {
+    uint32_t nodeA;
+    uint32_t ifA;
+    Ipv4Address addrA;
+    uint32_t nodeB;
+    uint32_t ifB;
+    Ipv4Address addrB;
+  };
+
+  struct LinkChange
+  {
+    uint32_t link;
+    uint32_t oldNodeB; // second endpoint before the link was re-pointed
+  };
+
+  /**
+   * \param src index of the node forwarding the packet
+   * \param dst index of the destination node
+   * \param interface output interface of src
+   * \param gateway address of the next hop
+   * \return false if dst is src or is unreachable
+   */
+  virtual bool GetNextHop (uint32_t src, uint32_t dst, uint32_t &interface, Ipv4Address &gateway) const;
+  void GetPort (uint32_t link, uint32_t node, uint32_t &interface, Ipv4Address &gateway) const; // local side of a link
+  uint32_t Other (const Link &link, uint32_t node) const;
+
+  std::vector<Link> m_links;
+  std::vector<std::vector<uint32_t> > m_adjacency; // routing graph index -> attached link ids
+  std::vector<LinkChange> m_pending; // links re-pointed since last update
+
+private:
+  Ipv4Address GetInterfaceAddress (Ptr<Node> node, uint32_t interface);
+  void BuildTree (uint32_t dst); // BFS from dst over the current links
+
+  std::vector<Ptr<Node> > m_nodes;
+  std::vector<uint32_t> m_nodeIndex; // ns-3 node id -> routing graph index
+  std::unordered_map<Ipv4Address, uint32_t, Ipv4AddressHash> m_addressToNode;
+  // BFS trees, one row of m_nodes.size () entries per destination
+  std::vector<uint32_t> m_distance; // hop count towards destination
+  std::vector<uint32_t> m_nextLink; // link to take towards destination
+};
+
+} // namespace ns3
+
+#endif /* LEO_SATELLITE_ROUTE_MANAGER_H */
@@ -0,0 +1,178 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * LEO Satellite Routing
+ * Ipv4 routing protocol forwarding packets along the routes kept by the LeoSatelliteRouteManager
+ *
+ * ENSC 427: Communication Networks
+ * Spring 2020
+ * Team 11
+ */
+
+#include "leo-satellite-routing.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/output-stream-wrapper.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LeoSatelliteRouting");
+
+NS_OBJECT_ENSURE_REGISTERED (LeoSatelliteRouting);
+
+TypeId
+LeoSatelliteRouting::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LeoSatelliteRouting")
+    .SetParent<Ipv4RoutingProtocol> ()
+    .SetGroupName ("LeoSatellite")
+    .AddConstructor<LeoSatelliteRouting> ()
+  ;
+  return tid;
+}
+
+LeoSatelliteRouting::LeoSatelliteRouting ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LeoSatelliteRouting::~LeoSatelliteRouting ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+LeoSatelliteRouting::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_ipv4 = 0;
+  m_manager = 0;
+  Ipv4RoutingProtocol::DoDispose ();
+}
+
+void
+LeoSatelliteRouting::SetRouteManager (Ptr<LeoSatelliteRouteManager> manager)
+{
+  NS_LOG_FUNCTION (this << manager);
+  m_manager = manager;
+}
+
+Ptr<Ipv4Route>
+LeoSatelliteRouting::Lookup (Ipv4Address dest, Ptr<NetDevice> oif) const
+{
+  uint32_t interface;
+  Ipv4Address gateway;
+  if (m_manager == 0 || !m_manager->LookupRoute (m_ipv4->GetObject<Node> (), dest, interface, gateway))
+  {
+    return 0;
+  }
+  if (oif != 0 && oif != m_ipv4->GetNetDevice (interface))
+  {
+    NS_LOG_LOGIC ("Route to " << dest << " does not leave through the requested device");
+    return 0;
+  }
+
+  Ptr<Ipv4Route> route = Create<Ipv4Route> ();
+  route->SetDestination (dest);
+  route->SetSource (m_ipv4->GetAddress (interface, 0).GetLocal ());
+  route->SetGateway (gateway);
+  route->SetOutputDevice (m_ipv4->GetNetDevice (interface));
+  return route;
+}
+
+Ptr<Ipv4Route>
+LeoSatelliteRouting::RouteOutput (Ptr<Packet> p, const Ipv4Header &header, Ptr<NetDevice> oif, Socket::SocketErrno &sockerr)
+{
+  NS_LOG_FUNCTION (this << p << header.GetDestination () << oif);
+  if (header.GetDestination ().IsMulticast ())
+  {
+    return 0; // Let other routing protocols try to handle this
+  }
+  Ptr<Ipv4Route> route = Lookup (header.GetDestination (), oif);
+  sockerr = (route != 0) ? Socket::ERROR_NOTERROR : Socket::ERROR_NOROUTETOHOST;
+  return route;
+}
+
+bool
+LeoSatelliteRouting::RouteInput (Ptr<const Packet> p, const Ipv4Header &header, Ptr<const NetDevice> idev,
+                                 UnicastForwardCallback ucb, MulticastForwardCallback mcb,
+                                 LocalDeliverCallback lcb, ErrorCallback ecb)
+{
+  NS_LOG_FUNCTION (this << p << header.GetDestination () << idev);
+  NS_ASSERT (m_ipv4->GetInterfaceForDevice (idev) >= 0);
+  uint32_t iif = m_ipv4->GetInterfaceForDevice (idev);
+
+  if (m_ipv4->IsDestinationAddress (header.GetDestination (), iif))
+  {
+    if (!lcb.IsNull ())
+    {
+      lcb (p, header, iif);
+      return true;
+    }
+    return false;
+  }
+  if (m_ipv4->IsForwarding (iif) == false)
+  {
+    ecb (p, header, Socket::ERROR_NOROUTETOHOST);
+    return true;
+  }
+  if (header.GetDestination ().IsMulticast ())
+  {
+    return false;
+  }
+
+  Ptr<Ipv4Route> route = Lookup (header.GetDestination ());
+  if (route == 0)
+  {
+    NS_LOG_LOGIC ("No route to " << header.GetDestination ());
+    return false; // Let other routing protocols try to handle this
+  }
+  ucb (route, p, header);
+  return true;
+}
+
+void
+LeoSatelliteRouting::NotifyInterfaceUp (uint32_t interface)
+{
+  // link changes are reported to the route manager by the constellation
+}
+
+void
+LeoSatelliteRouting::NotifyInterfaceDown (uint32_t interface)
+{
+}
+
+void
+LeoSatelliteRouting::NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address)
+{
+}
+
+void
+LeoSatelliteRouting::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress address)
+{
+}
+
+void
+LeoSatelliteRouting::SetIpv4 (Ptr<Ipv4> ipv4)
+{
+  NS_LOG_FUNCTION (this << ipv4);
+  NS_ASSERT (m_ipv4 == 0 && ipv4 != 0);
+  m_ipv4 = ipv4;
+}
+
+void
+LeoSatelliteRouting::PrintRoutingTable (Ptr<OutputStreamWrapper> stream, Time::Unit unit) const
+{
+  std::ostream* os = stream->GetStream ();
+  *os << "Node: " << m_ipv4->GetObject<Node> ()->GetId ()
+      << ", Time: " << Now ().As (unit)
+      << ", LeoSatelliteRouting table" << std::endl;
+  if (m_manager != 0)
+  {
+    m_manager->PrintRoutes (m_ipv4->GetObject<Node> (), *os);
+  }
+  *os << std::endl;
+}
+
+} // namespace ns3
@@ -0,0 +1,68 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * LEO Satellite Routing
+ * Ipv4 routing protocol forwarding packets along the routes kept by the LeoSatelliteRouteManager
+ *
+ * ENSC 427: Communication Networks
+ * Spring 2020
+ * Team 11
+ */
+#ifndef LEO_SATELLITE_ROUTING_H
+#define LEO_SATELLITE_ROUTING_H
+
+#include "ns3/ptr.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv4-routing-protocol.h"
+#include "leo-satellite-route-manager.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup leo-satellite
+ * \brief per node routing protocol of the constellation.
+ *
+ * Holds no routing table of its own, every lookup is answered by the
+ * LeoSatelliteRouteManager shared by all nodes of the constellation.
+ */
+class LeoSatelliteRouting : public Ipv4RoutingProtocol
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  LeoSatelliteRouting ();
+  virtual ~LeoSatelliteRouting ();
+
+  /**
+   * \param manager the route manager shared by the constellation
+   */
+  void SetRouteManager (Ptr<LeoSatelliteRouteManager> manager);
+
+  // From Ipv4RoutingProtocol
+  virtual Ptr<Ipv4Route> RouteOutput (Ptr<Packet> p, const Ipv4Header &header, Ptr<NetDevice> oif, Socket::SocketErrno &sockerr);
+  virtual bool RouteInput (Ptr<const Packet> p, const Ipv4Header &header, Ptr<const NetDevice> idev,
+                           UnicastForwardCallback ucb, MulticastForwardCallback mcb,
+                           LocalDeliverCallback lcb, ErrorCallback ecb);
+  virtual void NotifyInterfaceUp (uint32_t interface);
+  virtual void NotifyInterfaceDown (uint32_t interface);
+  virtual void NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address);
+  virtual void NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress address);
+  virtual void SetIpv4 (Ptr<Ipv4> ipv4);
+  virtual void PrintRoutingTable (Ptr<OutputStreamWrapper> stream, Time::Unit unit = Time::S) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  Ptr<Ipv4Route> Lookup (Ipv4Address dest, Ptr<NetDevice> oif = 0) const;
+
+  Ptr<Ipv4> m_ipv4;
+  Ptr<LeoSatelliteRouteManager> m_manager;
+};
+
+} // namespace ns3
+
+#endif /* LEO_SATELLITE_ROUTING_H */
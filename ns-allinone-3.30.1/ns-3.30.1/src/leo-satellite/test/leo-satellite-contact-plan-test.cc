@@ -0,0 +1,198 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * LEO Satellite Contact Plan Tests
+ * Checks the ground links looked up in the contact plan and the contact plan file
+ *
+ * ENSC 427: Communication Networks
+ * Spring 2020
+ * Team 11
+ */
+
+#include "ns3/test.h"
+#include "ns3/config.h"
+#include "ns3/enum.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+#include "ns3/leo-satellite-config.h"
+#include "ns3/leo-satellite-contact-plan.h"
+#include <fstream>
+
+using namespace ns3;
+
+/* Ground links looked up in the contact plan must be the ones computed on every
+   update, ground links sharing satellites included */
+class LeoSatelliteContactPlanLinksTestCase : public TestCase
+{
+public:
+  LeoSatelliteContactPlanLinksTestCase ();
+  virtual ~LeoSatelliteContactPlanLinksTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void GroundLink (uint32_t a, uint32_t b, double distance, Time delay, bool repointed);
+
+  /**
+   * \param duration length of the contact plan, 0 for none
+   * \return the satellite of every ground station on every update
+   */
+  std::vector<uint32_t> GetGroundLinks (Time duration);
+
+  std::vector<uint32_t> m_groundLinks;
+};
+
+LeoSatelliteContactPlanLinksTestCase::LeoSatelliteContactPlanLinksTestCase ()
+  : TestCase ("Ground links from the contact plan match the computed ones")
+{
+}
+
+LeoSatelliteContactPlanLinksTestCase::~LeoSatelliteContactPlanLinksTestCase ()
+{
+}
+
+void
+LeoSatelliteContactPlanLinksTestCase::GroundLink (uint32_t a, uint32_t b, double distance, Time delay, bool repointed)
+{
+  m_groundLinks.push_back (b);
+}
+
+std::vector<uint32_t>
+LeoSatelliteContactPlanLinksTestCase::GetGroundLinks (Time duration)
+{
+  std::string file_name = CreateTempDirFilename ("ground-stations");
+  std::ofstream file (file_name.c_str ());
+  file << "45, -170\n40, -160\n-30, -100\n0, 0\n60, 20\n-50, 120\n";
+  file.close ();
+
+  m_groundLinks.clear ();
+  Config::SetDefault ("ns3::LeoSatelliteConfig::Routing", EnumValue (LeoSatelliteConfig::INCREMENTAL_ROUTING));
+  Config::SetDefault ("ns3::LeoSatelliteConfig::GroundStationsFile", StringValue (file_name));
+  Config::SetDefault ("ns3::LeoSatelliteConfig::GroundLinksPerSatellite", UintegerValue (1));
+  Config::SetDefault ("ns3::LeoSatelliteConfig::ContactPlanDuration", TimeValue (duration));
+  Ptr<LeoSatelliteConfig> constellation = CreateObject<LeoSatelliteConfig> (3, 8, 1000.0);
+  constellation->TraceConnectWithoutContext ("GroundLink", MakeCallback (&LeoSatelliteContactPlanLinksTestCase::GroundLink, this));
+  // updates past the end of the contact plan fall back to the spatial index
+  for (uint32_t update=0; update<70; update++)
+  {
+    Simulator::Stop (Seconds (101.3));
+    Simulator::Run ();
+    constellation->UpdateLinks ();
+  }
+  NS_TEST_EXPECT_MSG_EQ ((constellation->GetContactPlan () != 0), duration.IsStrictlyPositive (), "Contact plan set up");
+  constellation = 0;
+  Simulator::Destroy ();
+  Config::Reset ();
+  return m_groundLinks;
+}
+
+void
+LeoSatelliteContactPlanLinksTestCase::DoRun (void)
+{
+  std::vector<uint32_t> computed = GetGroundLinks (Seconds (0));
+  std::vector<uint32_t> planned = GetGroundLinks (Seconds (6000));
+  NS_TEST_ASSERT_MSG_EQ (planned.size (), computed.size (), "Ground links traced");
+  NS_TEST_ASSERT_MSG_EQ (computed.size (), 70*6, "Every ground link is traced on every update");
+  for (uint32_t i=0; i<computed.size (); i++)
+  {
+    NS_TEST_EXPECT_MSG_EQ (planned[i], computed[i], "Ground link " << i%6 << " at update " << i/6);
+  }
+}
+
+/* A saved contact plan must be loaded back, mapped where possible, by a
+   constellation of the same scenario and recomputed by any other */
+class LeoSatelliteContactPlanFileTestCase : public TestCase
+{
+public:
+  LeoSatelliteContactPlanFileTestCase ();
+  virtual ~LeoSatelliteContactPlanFileTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LeoSatelliteContactPlanFileTestCase::LeoSatelliteContactPlanFileTestCase ()
+  : TestCase ("Contact plans are saved and loaded back for the same scenario only")
+{
+}
+
+LeoSatelliteContactPlanFileTestCase::~LeoSatelliteContactPlanFileTestCase ()
+{
+}
+
+void
+LeoSatelliteContactPlanFileTestCase::DoRun (void)
+{
+  std::string file_name = CreateTempDirFilename ("contact-plan");
+  Config::SetDefault ("ns3::LeoSatelliteConfig::ContactPlanDuration", TimeValue (Seconds (3000)));
+  Config::SetDefault ("ns3::LeoSatelliteConfig::ContactPlanFile", StringValue (file_name));
+  Ptr<LeoSatelliteConfig> constellation = CreateObject<LeoSatelliteConfig> (3, 8, 1000.0);
+  Ptr<LeoSatelliteContactPlan> computed = constellation->GetContactPlan ();
+  NS_TEST_ASSERT_MSG_EQ (computed->IsMapped (), false, "A computed contact plan is kept in memory");
+  NS_TEST_ASSERT_MSG_EQ (computed->GetNGroundStations (), 2, "Contacts of every ground station");
+  NS_TEST_ASSERT_MSG_EQ (computed->GetEnd (), Seconds (3000), "End of the contact plan");
+
+  Ptr<LeoSatelliteContactPlan> loaded = CreateObject<LeoSatelliteContactPlan> ();
+  NS_TEST_ASSERT_MSG_EQ (loaded->Load (file_name, 0), false, "Contact plans of other scenarios are not loaded");
+  Simulator::Destroy ();
+  Ptr<LeoSatelliteConfig> reloaded = CreateObject<LeoSatelliteConfig> (3, 8, 1000.0);
+  loaded = reloaded->GetContactPlan ();
+#if defined (__linux__)
+  NS_TEST_EXPECT_MSG_EQ (loaded->IsMapped (), true, "The contact plan file is mapped");
+#endif
+  NS_TEST_ASSERT_MSG_EQ (loaded->GetNGroundStations (), computed->GetNGroundStations (), "Ground stations loaded");
+  NS_TEST_ASSERT_MSG_EQ (loaded->GetNSatellites (), 24, "Satellites loaded");
+  for (uint32_t i=0; i<computed->GetNGroundStations (); i++)
+  {
+    NS_TEST_ASSERT_MSG_GT (computed->GetNContacts (i), 1, "Ground station " << i << " is handed over");
+    NS_TEST_ASSERT_MSG_EQ (loaded->GetNContacts (i), computed->GetNContacts (i), "Contacts of ground station " << i);
+    for (uint32_t j=0; j<computed->GetNContacts (i); j++)
+    {
+      const LeoSatelliteContactPlan::Contact &a = computed->GetContact (i, j);
+      const LeoSatelliteContactPlan::Contact &b = loaded->GetContact (i, j);
+      NS_TEST_EXPECT_MSG_EQ (b.start, a.start, "Start of contact " << j << " of ground station " << i);
+      NS_TEST_EXPECT_MSG_EQ (b.end, a.end, "End of contact " << j << " of ground station " << i);
+      NS_TEST_EXPECT_MSG_EQ (b.satellite, a.satellite, "Satellite of contact " << j << " of ground station " << i);
+    }
+  }
+
+  // lookups going back in time find the same contacts as a scan
+  for (uint32_t k=0; k<200; k++)
+  {
+    Time time = NanoSeconds ((k*7919 % 200)*Seconds (15).GetNanoSeconds ());
+    for (uint32_t i=0; i<loaded->GetNGroundStations (); i++)
+    {
+      uint32_t j = 0;
+      while (loaded->GetContact (i, j).end <= time.GetNanoSeconds ())
+        j++;
+      NS_TEST_EXPECT_MSG_EQ (loaded->GetSatellite (i, time), loaded->GetContact (i, j).satellite,
+                             "Ground station " << i << " at " << time.GetSeconds () << " s");
+    }
+  }
+  Simulator::Destroy ();
+
+  // another scenario recomputes and overwrites the file
+  Config::SetDefault ("ns3::LeoSatelliteConfig::GroundLinksPerSatellite", UintegerValue (1));
+  Ptr<LeoSatelliteConfig> other = CreateObject<LeoSatelliteConfig> (3, 8, 1000.0);
+  NS_TEST_EXPECT_MSG_EQ (other->GetContactPlan ()->IsMapped (), false, "The contact plan of another scenario is recomputed");
+
+  constellation = 0;
+  reloaded = 0;
+  other = 0;
+  Simulator::Destroy ();
+  Config::Reset ();
+}
+
+class LeoSatelliteContactPlanTestSuite : public TestSuite
+{
+public:
+  LeoSatelliteContactPlanTestSuite ();
+};
+
+LeoSatelliteContactPlanTestSuite::LeoSatelliteContactPlanTestSuite ()
+  : TestSuite ("leo-satellite-contact-plan", UNIT)
+{
+  AddTestCase (new LeoSatelliteContactPlanLinksTestCase, TestCase::QUICK);
+  AddTestCase (new LeoSatelliteContactPlanFileTestCase, TestCase::QUICK);
+}
+
+static LeoSatelliteContactPlanTestSuite leoSatelliteContactPlanTestSuite;
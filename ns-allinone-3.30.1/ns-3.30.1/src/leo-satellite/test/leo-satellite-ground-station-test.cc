@@ -0,0 +1,117 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * LEO Satellite Ground Station Tests
+ * Checks ground stations loaded from a file and their links to the constellation
+ *
+ * ENSC 427: Communication Networks
+ * Spring 2020
+ * Team 11
+ */
+
+#include "ns3/test.h"
+#include "ns3/config.h"
+#include "ns3/enum.h"
+#include "ns3/string.h"
+#include "ns3/simulator.h"
+#include "ns3/leo-satellite-config.h"
+#include "ns3/leo-satellite-route-manager.h"
+#include <fstream>
+
+using namespace ns3;
+
+/* Every ground station of the file must be placed at its position and stay
+   reachable from every other ground station while the satellites move */
+class LeoSatelliteGroundStationFileTestCase : public TestCase
+{
+public:
+  LeoSatelliteGroundStationFileTestCase ();
+  virtual ~LeoSatelliteGroundStationFileTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LeoSatelliteGroundStationFileTestCase::LeoSatelliteGroundStationFileTestCase ()
+  : TestCase ("Ground stations loaded from a file are connected to the constellation")
+{
+}
+
+LeoSatelliteGroundStationFileTestCase::~LeoSatelliteGroundStationFileTestCase ()
+{
+}
+
+void
+LeoSatelliteGroundStationFileTestCase::DoRun (void)
+{
+  std::vector<Vector> positions;
+  positions.push_back (Vector (49.28, -123.12, 0.07));
+  positions.push_back (Vector (-33.87, 151.21, 1.5));
+  positions.push_back (Vector (0, -180, 0));
+  positions.push_back (Vector (90, 0, 0));
+  positions.push_back (Vector (51.51, -0.13, 0));
+  positions.push_back (Vector (-54.8, -68.3, 0));
+
+  std::string file_name = CreateTempDirFilename ("ground-stations.csv");
+  std::ofstream file (file_name.c_str ());
+  file << "latitude,longitude,altitude" << std::endl;
+  file << "# comma separated" << std::endl;
+  for (uint32_t i=0; i<3; i++)
+  {
+    file << positions[i].x << "," << positions[i].y << "," << positions[i].z << std::endl;
+  }
+  file << std::endl << "# white space separated, without altitude" << std::endl;
+  for (uint32_t i=3; i<positions.size (); i++)
+  {
+    file << positions[i].x << " " << positions[i].y << std::endl;
+  }
+  file.close ();
+
+  Config::SetDefault ("ns3::LeoSatelliteConfig::Routing", EnumValue (LeoSatelliteConfig::INCREMENTAL_ROUTING));
+  Config::SetDefault ("ns3::LeoSatelliteConfig::GroundStationsFile", StringValue (file_name));
+  Ptr<LeoSatelliteConfig> constellation = CreateObject<LeoSatelliteConfig> (3, 8, 1500.0);
+  Ptr<LeoSatelliteRouteManager> manager = constellation->GetRouteManager ();
+
+  NS_TEST_ASSERT_MSG_EQ (constellation->ground_stations.GetN (), positions.size (), "Every ground station of the file is created");
+  NS_TEST_ASSERT_MSG_EQ (constellation->ground_station_interfaces.size (), positions.size (), "Every ground station has a network");
+  for (uint32_t i=0; i<positions.size (); i++)
+  {
+    Vector position = constellation->ground_stations.Get (i)->GetObject<MobilityModel> ()->GetPosition ();
+    NS_TEST_ASSERT_MSG_EQ_TOL (position.x, positions[i].x, 1e-9, "Wrong latitude of ground station " << i);
+    NS_TEST_ASSERT_MSG_EQ_TOL (position.y, positions[i].y, 1e-9, "Wrong longitude of ground station " << i);
+    NS_TEST_ASSERT_MSG_EQ_TOL (position.z, positions[i].z, 1e-9, "Wrong altitude of ground station " << i);
+  }
+
+  for (uint32_t epoch=0; epoch<6; epoch++)
+  {
+    for (uint32_t i=0; i<positions.size (); i++)
+    {
+      for (uint32_t j=0; j<positions.size (); j++)
+      {
+        uint32_t src = manager->GetNodeIndex (constellation->ground_stations.Get (i));
+        uint32_t dst = manager->GetNodeIndex (constellation->ground_stations.Get (j));
+        NS_TEST_ASSERT_MSG_NE (manager->GetDistance (src, dst), LeoSatelliteRouteManager::UNREACHABLE,
+                               "Epoch " << epoch << ": ground station " << j << " unreachable from " << i);
+      }
+    }
+    Simulator::Stop (Seconds (600));
+    Simulator::Run ();
+    constellation->UpdateLinks ();
+  }
+
+  Simulator::Destroy ();
+  Config::Reset ();
+}
+
+class LeoSatelliteGroundStationTestSuite : public TestSuite
+{
+public:
+  LeoSatelliteGroundStationTestSuite ();
+};
+
+LeoSatelliteGroundStationTestSuite::LeoSatelliteGroundStationTestSuite ()
+  : TestSuite ("leo-satellite-ground-station", UNIT)
+{
+  AddTestCase (new LeoSatelliteGroundStationFileTestCase, TestCase::QUICK);
+}
+
+static LeoSatelliteGroundStationTestSuite leoSatelliteGroundStationTestSuite;
@@ -0,0 +1,161 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * LEO Satellite Handover Tests
+ * Checks the link updates scheduled at the predicted handover instants
+ *
+ * ENSC 427: Communication Networks
+ * Spring 2020
+ * Team 11
+ */
+
+#include "ns3/test.h"
+#include "ns3/config.h"
+#include "ns3/enum.h"
+#include "ns3/boolean.h"
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+#include "ns3/leo-satellite-config.h"
+#include "ns3/leo-satellite-route-manager.h"
+
+using namespace ns3;
+
+/* With handovers scheduled by the constellation the links must always be up
+   to date: an extra UpdateLinks at any time must not change any route */
+class LeoSatelliteHandoverScheduleTestCase : public TestCase
+{
+public:
+  LeoSatelliteHandoverScheduleTestCase ();
+  virtual ~LeoSatelliteHandoverScheduleTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void CheckLinks (void);
+
+  Ptr<LeoSatelliteConfig> m_constellation;
+  uint32_t m_checks;
+};
+
+LeoSatelliteHandoverScheduleTestCase::LeoSatelliteHandoverScheduleTestCase ()
+  : TestCase ("Scheduled handovers keep the links up to date"),
+    m_checks (0)
+{
+}
+
+LeoSatelliteHandoverScheduleTestCase::~LeoSatelliteHandoverScheduleTestCase ()
+{
+}
+
+void
+LeoSatelliteHandoverScheduleTestCase::CheckLinks (void)
+{
+  Ptr<LeoSatelliteRouteManager> manager = m_constellation->GetRouteManager ();
+  uint32_t n = manager->GetNNodes ();
+  std::vector<uint32_t> scheduled;
+  for (uint32_t src=0; src<n; src++)
+  {
+    for (uint32_t dst=0; dst<n; dst++)
+    {
+      scheduled.push_back (manager->GetDistance (src, dst));
+    }
+  }
+
+  m_constellation->UpdateLinks ();
+  for (uint32_t src=0; src<n; src++)
+  {
+    for (uint32_t dst=0; dst<n; dst++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (scheduled[src*n + dst], manager->GetDistance (src, dst),
+                             "At " << Simulator::Now ().GetSeconds () << " s: links changed since the last handover");
+    }
+  }
+  m_checks++;
+}
+
+void
+LeoSatelliteHandoverScheduleTestCase::DoRun (void)
+{
+  Config::SetDefault ("ns3::LeoSatelliteConfig::Routing", EnumValue (LeoSatelliteConfig::INCREMENTAL_ROUTING));
+  Config::SetDefault ("ns3::LeoSatelliteConfig::ScheduleHandovers", BooleanValue (true));
+  m_constellation = CreateObject<LeoSatelliteConfig> (3, 8, 1000.0);
+
+  // there are handovers to schedule within an orbit
+  Time next = m_constellation->PredictNextHandover (Seconds (0), Seconds (6300));
+  NS_TEST_ASSERT_MSG_LT (next, Seconds (6300), "No handover predicted within an orbit");
+  Time after = m_constellation->PredictNextHandover (next, Seconds (6300));
+  NS_TEST_ASSERT_MSG_GT (after, next, "Handovers are predicted in order");
+
+  for (uint32_t i=0; i<60; i++)
+  {
+    Simulator::Schedule (Seconds (13.7 + 101.3*i), &LeoSatelliteHandoverScheduleTestCase::CheckLinks, this);
+  }
+  Simulator::Stop (Seconds (6100));
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_checks, 60, "Every check ran");
+
+  m_constellation = 0;
+  Simulator::Destroy ();
+  Config::Reset ();
+}
+
+/* A shorter search step finds the same link changes */
+class LeoSatelliteHandoverStepTestCase : public TestCase
+{
+public:
+  LeoSatelliteHandoverStepTestCase ();
+  virtual ~LeoSatelliteHandoverStepTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LeoSatelliteHandoverStepTestCase::LeoSatelliteHandoverStepTestCase ()
+  : TestCase ("A shorter handover step predicts the same handovers")
+{
+}
+
+LeoSatelliteHandoverStepTestCase::~LeoSatelliteHandoverStepTestCase ()
+{
+}
+
+void
+LeoSatelliteHandoverStepTestCase::DoRun (void)
+{
+  Config::SetDefault ("ns3::LeoSatelliteConfig::Routing", EnumValue (LeoSatelliteConfig::INCREMENTAL_ROUTING));
+  Ptr<LeoSatelliteConfig> constellation = CreateObject<LeoSatelliteConfig> (3, 8, 1000.0);
+  std::vector<Time> predicted;
+  Time next = Seconds (0);
+  for (uint32_t i=0; i<10; i++)
+  {
+    next = constellation->PredictNextHandover (next, Seconds (6300));
+    predicted.push_back (next);
+  }
+  constellation = 0;
+  Simulator::Destroy ();
+
+  Config::SetDefault ("ns3::LeoSatelliteConfig::HandoverStep", TimeValue (Seconds (1)));
+  constellation = CreateObject<LeoSatelliteConfig> (3, 8, 1000.0);
+  next = Seconds (0);
+  for (uint32_t i=0; i<predicted.size (); i++)
+  {
+    next = constellation->PredictNextHandover (next, Seconds (6300));
+    NS_TEST_ASSERT_MSG_EQ_TOL (next, predicted[i], MilliSeconds (1), "Handover " << i << " predicted at another time with a shorter step");
+  }
+  constellation = 0;
+  Simulator::Destroy ();
+  Config::Reset ();
+}
+
+class LeoSatelliteHandoverTestSuite : public TestSuite
+{
+public:
+  LeoSatelliteHandoverTestSuite ();
+};
+
+LeoSatelliteHandoverTestSuite::LeoSatelliteHandoverTestSuite ()
+  : TestSuite ("leo-satellite-handover", UNIT)
+{
+  AddTestCase (new LeoSatelliteHandoverScheduleTestCase, TestCase::QUICK);
+  AddTestCase (new LeoSatelliteHandoverStepTestCase, TestCase::QUICK);
+}
+
+static LeoSatelliteHandoverTestSuite leoSatelliteHandoverTestSuite;
@@ -0,0 +1,403 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * LEO Satellite ISL Tests
+ * Checks the re-pointable laser links between satellites and ground stations
+ *
+ * ENSC 427: Communication Networks
+ * Spring 2020
+ * Team 11
+ */
+
+#include "ns3/test.h"
+#include "ns3/config.h"
+#include "ns3/enum.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+#include "ns3/node-container.h"
+#include "ns3/node-list.h"
+#include "ns3/leo-satellite-config.h"
+#include "ns3/leo-satellite-isl-channel.h"
+#include "ns3/leo-satellite-isl-net-device.h"
+#include "ns3/leo-satellite-spatial-index.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/double.h"
+#include "ns3/integer.h"
+#include "ns3/pointer.h"
+#include <fstream>
+
+using namespace ns3;
+
+namespace ns3 {
+extern uint32_t currentNode; // satellite mobility initialization counter
+}
+
+/* A packet must only reach the device at the other end of the link when it
+   is sent, and re-pointing a link must take the new peer from its old link */
+class LeoSatelliteIslRepointTestCase : public TestCase
+{
+public:
+  LeoSatelliteIslRepointTestCase ();
+  virtual ~LeoSatelliteIslRepointTestCase ();
+
+private:
+  virtual void DoRun (void);
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from);
+  void Send (Ptr<NetDevice> device);
+  static void LinkChange (uint32_t *changes);
+
+  NodeContainer m_nodes;
+  std::vector<uint32_t> m_received; // packets received by every node
+  std::vector<uint32_t> m_linkChanges; // link change notifications of every node
+};
+
+LeoSatelliteIslRepointTestCase::LeoSatelliteIslRepointTestCase ()
+  : TestCase ("Packets follow the link to its current peer")
+{
+}
+
+LeoSatelliteIslRepointTestCase::~LeoSatelliteIslRepointTestCase ()
+{
+}
+
+bool
+LeoSatelliteIslRepointTestCase::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from)
+{
+  NS_TEST_EXPECT_MSG_EQ (protocol, 0x0800, "Protocol changed on the link");
+  NS_TEST_EXPECT_MSG_EQ (packet->GetSize (), 100, "Size changed on the link");
+  for (uint32_t i=0; i<m_nodes.GetN (); i++)
+  {
+    if (m_nodes.Get (i) == device->GetNode ())
+      m_received[i]++;
+  }
+  return true;
+}
+
+void
+LeoSatelliteIslRepointTestCase::Send (Ptr<NetDevice> device)
+{
+  device->Send (Create<Packet> (100), device->GetBroadcast (), 0x0800);
+}
+
+void
+LeoSatelliteIslRepointTestCase::LinkChange (uint32_t *changes)
+{
+  (*changes)++;
+}
+
+void
+LeoSatelliteIslRepointTestCase::DoRun (void)
+{
+  m_nodes.Create (4);
+  m_received.assign (4, 0);
+  m_linkChanges.assign (4, 0);
+  std::vector<Ptr<LeoSatelliteIslNetDevice> > devices;
+  for (uint32_t i=0; i<4; i++)
+  {
+    Ptr<LeoSatelliteIslNetDevice> device = CreateObject<LeoSatelliteIslNetDevice> ();
+    m_nodes.Get (i)->AddDevice (device);
+    device->SetReceiveCallback (MakeCallback (&LeoSatelliteIslRepointTestCase::Receive, this));
+    device->AddLinkChangeCallback (MakeBoundCallback (&LeoSatelliteIslRepointTestCase::LinkChange, &m_linkChanges[i]));
+    devices.push_back (device);
+  }
+
+  Ptr<LeoSatelliteIslChannel> first = CreateObject<LeoSatelliteIslChannel> ();
+  first->SetAttribute ("Delay", TimeValue (MilliSeconds (5)));
+  first->Connect (devices[0], devices[1]);
+  Ptr<LeoSatelliteIslChannel> second = CreateObject<LeoSatelliteIslChannel> ();
+  second->Connect (devices[3], devices[2]);
+  NS_TEST_ASSERT_MSG_EQ (devices[1]->IsLinkUp (), true, "Peer is linked");
+  NS_TEST_ASSERT_MSG_EQ (first->GetNDevices (), 2, "Both ends are on the channel");
+  for (uint32_t i=0; i<4; i++)
+  {
+    NS_TEST_ASSERT_MSG_EQ (m_linkChanges[i], 1, "Link of node " << i << " went up once");
+  }
+
+  // sent to node 1, which is still the peer when the packet arrives
+  Simulator::Schedule (Seconds (1), &LeoSatelliteIslRepointTestCase::Send, this, devices[0]);
+  // sent to node 1, re-pointed to node 2 during propagation: the packet still reaches node 1
+  Simulator::Schedule (Seconds (2), &LeoSatelliteIslRepointTestCase::Send, this, devices[0]);
+  Simulator::Schedule (Seconds (2) + MilliSeconds (1), &LeoSatelliteIslChannel::SetPeer, first, devices[2]);
+  // sent both ways between node 0 and node 2
+  Simulator::Schedule (Seconds (3), &LeoSatelliteIslRepointTestCase::Send, this, devices[0]);
+  Simulator::Schedule (Seconds (3), &LeoSatelliteIslRepointTestCase::Send, this, devices[2]);
+  // node 1 is not linked anymore, node 3 lost its peer to the first channel
+  Simulator::Schedule (Seconds (4), &LeoSatelliteIslRepointTestCase::Send, this, devices[1]);
+  Simulator::Schedule (Seconds (4), &LeoSatelliteIslRepointTestCase::Send, this, devices[3]);
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_received[0], 1, "Packets received by the fixed end");
+  NS_TEST_ASSERT_MSG_EQ (m_received[1], 2, "Packets received by the old peer");
+  NS_TEST_ASSERT_MSG_EQ (m_received[2], 1, "Packets received by the new peer");
+  NS_TEST_ASSERT_MSG_EQ (m_received[3], 0, "Packets received without peer");
+  NS_TEST_ASSERT_MSG_EQ (devices[1]->IsLinkUp (), false, "Old peer is not linked");
+  NS_TEST_ASSERT_MSG_EQ (devices[1]->GetChannel (), 0, "Old peer has no channel");
+  NS_TEST_ASSERT_MSG_EQ (devices[2]->GetChannel (), first, "New peer moved to the re-pointed channel");
+  NS_TEST_ASSERT_MSG_EQ (second->GetNDevices (), 1, "New peer left its previous channel");
+  NS_TEST_ASSERT_MSG_EQ (devices[3]->IsLinkUp (), false, "Fixed end without peer is not linked");
+  NS_TEST_ASSERT_MSG_EQ (m_linkChanges[0], 1, "Link of the fixed end stayed up while re-pointed");
+  NS_TEST_ASSERT_MSG_EQ (m_linkChanges[1], 2, "Link of the old peer went down");
+  NS_TEST_ASSERT_MSG_EQ (m_linkChanges[2], 3, "Link of the new peer went down and up again");
+  NS_TEST_ASSERT_MSG_EQ (m_linkChanges[3], 2, "Link of the fixed end that lost its peer went down");
+
+  m_nodes = NodeContainer ();
+  Simulator::Destroy ();
+}
+
+/* The number of devices of a satellite must not depend on the size of the
+   constellation or the number of ground stations, and a satellite must not
+   serve more ground stations than it has ground links */
+class LeoSatelliteIslGroundLinksTestCase : public TestCase
+{
+public:
+  LeoSatelliteIslGroundLinksTestCase ();
+  virtual ~LeoSatelliteIslGroundLinksTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \param perSatellite ground links of every satellite
+   * \param file_name ground stations file
+   * \return the satellite node serving every ground station
+   */
+  std::vector<uint32_t> GetServingSatellites (uint32_t perSatellite, std::string file_name);
+};
+
+LeoSatelliteIslGroundLinksTestCase::LeoSatelliteIslGroundLinksTestCase ()
+  : TestCase ("Satellites have a fixed number of devices and serve at most GroundLinksPerSatellite ground stations")
+{
+}
+
+LeoSatelliteIslGroundLinksTestCase::~LeoSatelliteIslGroundLinksTestCase ()
+{
+}
+
+std::vector<uint32_t>
+LeoSatelliteIslGroundLinksTestCase::GetServingSatellites (uint32_t perSatellite, std::string file_name)
+{
+  Config::SetDefault ("ns3::LeoSatelliteConfig::Routing", EnumValue (LeoSatelliteConfig::INCREMENTAL_ROUTING));
+  Config::SetDefault ("ns3::LeoSatelliteConfig::GroundStationsFile", StringValue (file_name));
+  Config::SetDefault ("ns3::LeoSatelliteConfig::GroundLinksPerSatellite", UintegerValue (perSatellite));
+  Ptr<LeoSatelliteConfig> constellation = CreateObject<LeoSatelliteConfig> (4, 10, 1000.0);
+
+  // loopback, two intra-plane links, two inter-plane links and the ground links
+  for (uint32_t i=0; i<NodeList::GetNNodes (); i++)
+  {
+    Ptr<Node> node = NodeList::GetNode (i);
+    if (node->GetObject<LeoSatelliteMobilityModel> () != 0)
+    {
+      NS_TEST_EXPECT_MSG_EQ (node->GetNDevices (), 5 + perSatellite, "Devices of satellite " << i);
+    }
+  }
+
+  std::vector<uint32_t> serving;
+  for (uint32_t i=0; i<constellation->ground_stations.GetN (); i++)
+  {
+    // device 0 is the loopback
+    Ptr<NetDevice> device = constellation->ground_stations.Get (i)->GetDevice (1);
+    NS_TEST_EXPECT_MSG_EQ (device->IsLinkUp (), true, "Ground station " << i << " is linked");
+    Ptr<LeoSatelliteIslChannel> channel = DynamicCast<LeoSatelliteIslChannel> (device->GetChannel ());
+    serving.push_back (channel->GetOther (DynamicCast<LeoSatelliteIslNetDevice> (device))->GetNode ()->GetId ());
+  }
+
+  Simulator::Destroy ();
+  Config::Reset ();
+  return serving;
+}
+
+void
+LeoSatelliteIslGroundLinksTestCase::DoRun (void)
+{
+  // three ground stations at the same place
+  std::string file_name = CreateTempDirFilename ("ground-stations.csv");
+  std::ofstream file (file_name.c_str ());
+  for (uint32_t i=0; i<3; i++)
+  {
+    file << "49.28,-123.12" << std::endl;
+  }
+  file.close ();
+
+  std::vector<uint32_t> shared = GetServingSatellites (4, file_name);
+  NS_TEST_ASSERT_MSG_EQ (shared[1], shared[0], "Ground stations share their closest satellite");
+  NS_TEST_ASSERT_MSG_EQ (shared[2], shared[0], "Ground stations share their closest satellite");
+
+  std::vector<uint32_t> single = GetServingSatellites (1, file_name);
+  NS_TEST_ASSERT_MSG_EQ (single[0], shared[0], "First ground station gets the closest satellite");
+  NS_TEST_ASSERT_MSG_NE (single[1], single[0], "Satellite serves a single ground station");
+  NS_TEST_ASSERT_MSG_NE (single[2], single[0], "Satellite serves a single ground station");
+  NS_TEST_ASSERT_MSG_NE (single[2], single[1], "Satellite serves a single ground station");
+}
+
+/* The propagation delay of every packet must follow the distance between the
+   two ends when it is sent, not a delay set when the link was last updated */
+class LeoSatelliteIslDelayTestCase : public TestCase
+{
+public:
+  LeoSatelliteIslDelayTestCase ();
+  virtual ~LeoSatelliteIslDelayTestCase ();
+
+private:
+  virtual void DoRun (void);
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from);
+  void Send (Ptr<NetDevice> device);
+
+  Ptr<MobilityModel> m_satellite;
+  Ptr<MobilityModel> m_groundStation;
+  Time m_sent; // time the last packet was sent
+  std::vector<double> m_delays; // propagation delay of every packet received [s]
+};
+
+LeoSatelliteIslDelayTestCase::LeoSatelliteIslDelayTestCase ()
+  : TestCase ("Propagation delay follows the positions of the two ends")
+{
+}
+
+LeoSatelliteIslDelayTestCase::~LeoSatelliteIslDelayTestCase ()
+{
+}
+
+bool
+LeoSatelliteIslDelayTestCase::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from)
+{
+  double expected = LeoSatelliteSpatialIndex::GetStraightLineDistance (m_satellite->GetPosition (),
+                                                                       m_groundStation->GetPosition ())*1000/299792458;
+  double delay = (Simulator::Now () - m_sent).GetSeconds ();
+  // the transmission time of 102 bytes at 5.36 Gbps is below 1 us, so is the distance covered meanwhile
+  NS_TEST_EXPECT_MSG_EQ_TOL (delay, expected, 1e-6, "Delay of the packet sent at " << m_sent.GetSeconds () << " s");
+  m_delays.push_back (delay);
+  return true;
+}
+
+void
+LeoSatelliteIslDelayTestCase::Send (Ptr<NetDevice> device)
+{
+  m_sent = Simulator::Now ();
+  device->Send (Create<Packet> (100), device->GetBroadcast (), 0x0800);
+}
+
+void
+LeoSatelliteIslDelayTestCase::DoRun (void)
+{
+  NodeContainer satellite;
+  satellite.Create (1);
+  currentNode = 0;
+  MobilityHelper satelliteMobility;
+  satelliteMobility.SetMobilityModel ("ns3::LeoSatelliteMobilityModel",
+                                      "NPerPlane", IntegerValue (8),
+                                      "NumberofPlanes", IntegerValue (3),
+                                      "Altitude", DoubleValue (1000.0),
+                                      "Time", DoubleValue (0.0),
+                                      "Ephemeris", PointerValue (0));
+  satelliteMobility.Install (satellite);
+  m_satellite = satellite.Get (0)->GetObject<MobilityModel> ();
+  m_satellite->SetPosition (Vector (0.0, 0.0, 0.0));
+
+  NodeContainer groundStation;
+  groundStation.Create (1);
+  MobilityHelper groundMobility;
+  groundMobility.SetMobilityModel ("ns3::GroundStationMobilityModel");
+  groundMobility.Install (groundStation);
+  m_groundStation = groundStation.Get (0)->GetObject<MobilityModel> ();
+  m_groundStation->SetPosition (Vector (10.0, 5.0, 0.0));
+
+  Ptr<LeoSatelliteIslNetDevice> satelliteDevice = CreateObject<LeoSatelliteIslNetDevice> ();
+  satellite.Get (0)->AddDevice (satelliteDevice);
+  Ptr<LeoSatelliteIslNetDevice> groundDevice = CreateObject<LeoSatelliteIslNetDevice> ();
+  groundStation.Get (0)->AddDevice (groundDevice);
+  groundDevice->SetReceiveCallback (MakeCallback (&LeoSatelliteIslDelayTestCase::Receive, this));
+  Ptr<LeoSatelliteIslChannel> channel = CreateObject<LeoSatelliteIslChannel> ();
+  channel->SetAttribute ("Delay", TimeValue (Seconds (1)));
+  channel->Connect (satelliteDevice, groundDevice);
+
+  // within one refresh interval, across refresh intervals and long after the link was set up,
+  // every packet is received before the next one is sent
+  double times[] = {1.0, 1.06, 1.5, 2.0, 60.0, 300.0};
+  for (uint32_t i=0; i<6; i++)
+  {
+    Simulator::Schedule (Seconds (times[i]), &LeoSatelliteIslDelayTestCase::Send, this, satelliteDevice);
+  }
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_delays.size (), 6, "Packets received");
+  NS_TEST_EXPECT_MSG_GT (std::abs (m_delays[5] - m_delays[0]), 1e-4, "Delay changes as the satellite moves");
+
+  satellite = NodeContainer ();
+  groundStation = NodeContainer ();
+  m_satellite = 0;
+  m_groundStation = 0;
+  Simulator::Destroy ();
+}
+
+/* Planes must be split across MPI ranks in contiguous blocks of the same size,
+   give or take one, and a single process must keep every node on system 0 */
+class LeoSatelliteIslPartitionTestCase : public TestCase
+{
+public:
+  LeoSatelliteIslPartitionTestCase ();
+  virtual ~LeoSatelliteIslPartitionTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LeoSatelliteIslPartitionTestCase::LeoSatelliteIslPartitionTestCase ()
+  : TestCase ("Planes are partitioned across ranks in contiguous balanced blocks")
+{
+}
+
+LeoSatelliteIslPartitionTestCase::~LeoSatelliteIslPartitionTestCase ()
+{
+}
+
+void
+LeoSatelliteIslPartitionTestCase::DoRun (void)
+{
+  for (uint32_t num_planes=1; num_planes<=24; num_planes++)
+  {
+    for (uint32_t ranks=1; ranks<=num_planes; ranks++)
+    {
+      std::vector<uint32_t> planes (ranks, 0);
+      uint32_t previous = 0;
+      for (uint32_t i=0; i<num_planes; i++)
+      {
+        uint32_t system_id = LeoSatelliteConfig::GetPlaneSystemId (i, num_planes, ranks);
+        NS_TEST_ASSERT_MSG_LT (system_id, ranks, "Plane " << i << " of " << num_planes << " on " << ranks << " ranks");
+        NS_TEST_ASSERT_MSG_EQ ((system_id == previous || system_id == previous + 1), true,
+                               "Planes of a rank are contiguous, plane " << i << " of " << num_planes << " on " << ranks << " ranks");
+        previous = system_id;
+        planes[system_id]++;
+      }
+      for (uint32_t r=0; r<ranks; r++)
+      {
+        NS_TEST_EXPECT_MSG_EQ ((planes[r] == num_planes/ranks || planes[r] == (num_planes + ranks - 1)/ranks), true,
+                               "Planes of rank " << r << " with " << num_planes << " planes on " << ranks << " ranks");
+      }
+    }
+  }
+
+  Ptr<LeoSatelliteConfig> constellation = CreateObject<LeoSatelliteConfig> (3, 8, 1000.0);
+  for (uint32_t i=0; i<NodeList::GetNNodes (); i++)
+  {
+    NS_TEST_EXPECT_MSG_EQ (NodeList::GetNode (i)->GetSystemId (), 0, "Node " << i << " is simulated by the single process");
+  }
+  constellation = 0;
+  Simulator::Destroy ();
+}
+
+class LeoSatelliteIslTestSuite : public TestSuite
+{
+public:
+  LeoSatelliteIslTestSuite ();
+};
+
+LeoSatelliteIslTestSuite::LeoSatelliteIslTestSuite ()
+  : TestSuite ("leo-satellite-isl", UNIT)
+{
+  AddTestCase (new LeoSatelliteIslRepointTestCase, TestCase::QUICK);
+  AddTestCase (new LeoSatelliteIslGroundLinksTestCase, TestCase::QUICK);
+  AddTestCase (new LeoSatelliteIslDelayTestCase, TestCase::QUICK);
+  AddTestCase (new LeoSatelliteIslPartitionTestCase, TestCase::QUICK);
+}
+
+static LeoSatelliteIslTestSuite leoSatelliteIslTestSuite;
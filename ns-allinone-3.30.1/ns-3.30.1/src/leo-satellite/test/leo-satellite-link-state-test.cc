@@ -0,0 +1,212 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * LEO Satellite Link State Tests
+ * Checks the link state trace sources and the link state file
+ *
+ * ENSC 427: Communication Networks
+ * Spring 2020
+ * Team 11
+ */
+
+#include "ns3/test.h"
+#include "ns3/config.h"
+#include "ns3/enum.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+#include "ns3/node-list.h"
+#include "ns3/ipv4.h"
+#include "ns3/leo-satellite-config.h"
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <set>
+
+using namespace ns3;
+
+/* Every inter-plane and ground link must be reported when it is set up and
+   on every update, both to the trace sources and to the link state file */
+class LeoSatelliteLinkStateTestCase : public TestCase
+{
+public:
+  /**
+   * \param format format of the link state file
+   */
+  LeoSatelliteLinkStateTestCase (LeoSatelliteConfig::LinkStateFormat format);
+  virtual ~LeoSatelliteLinkStateTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void InterPlaneLink (uint32_t a, uint32_t b, double distance, Time delay, bool repointed);
+  void GroundLink (uint32_t a, uint32_t b, double distance, Time delay, bool repointed);
+
+  LeoSatelliteConfig::LinkStateFormat m_format;
+  uint32_t m_interPlaneLinks; // inter-plane link states traced
+  uint32_t m_groundLinks; // ground link states traced
+  uint32_t m_repointed; // link states traced with a new satellite
+};
+
+LeoSatelliteLinkStateTestCase::LeoSatelliteLinkStateTestCase (LeoSatelliteConfig::LinkStateFormat format)
+  : TestCase (format == LeoSatelliteConfig::CSV_LINK_STATE ? "Link states are traced and written as CSV"
+                                                           : "Link states are traced and written as binary records"),
+    m_format (format),
+    m_interPlaneLinks (0),
+    m_groundLinks (0),
+    m_repointed (0)
+{
+}
+
+LeoSatelliteLinkStateTestCase::~LeoSatelliteLinkStateTestCase ()
+{
+}
+
+void
+LeoSatelliteLinkStateTestCase::InterPlaneLink (uint32_t a, uint32_t b, double distance, Time delay, bool repointed)
+{
+  NS_TEST_EXPECT_MSG_EQ_TOL (delay.GetSeconds (), distance*1000/299792458, 1e-9, "Delay of the link");
+  m_interPlaneLinks++;
+  m_repointed += repointed;
+}
+
+void
+LeoSatelliteLinkStateTestCase::GroundLink (uint32_t a, uint32_t b, double distance, Time delay, bool repointed)
+{
+  NS_TEST_EXPECT_MSG_LT (a, 2, "Ground station of the link");
+  m_groundLinks++;
+  m_repointed += repointed;
+}
+
+void
+LeoSatelliteLinkStateTestCase::DoRun (void)
+{
+  std::string file_name = CreateTempDirFilename ("link-state");
+  Config::SetDefault ("ns3::LeoSatelliteConfig::LinkStateFile", StringValue (file_name));
+  Config::SetDefault ("ns3::LeoSatelliteConfig::LinkStateFormat", EnumValue (m_format));
+  Ptr<LeoSatelliteConfig> constellation = CreateObject<LeoSatelliteConfig> (3, 8, 1000.0);
+  constellation->TraceConnectWithoutContext ("InterPlaneLink", MakeCallback (&LeoSatelliteLinkStateTestCase::InterPlaneLink, this));
+  constellation->TraceConnectWithoutContext ("GroundLink", MakeCallback (&LeoSatelliteLinkStateTestCase::GroundLink, this));
+
+  for (uint32_t update=0; update<5; update++)
+  {
+    Simulator::Stop (Seconds (300));
+    Simulator::Run ();
+    constellation->UpdateLinks ();
+  }
+  NS_TEST_ASSERT_MSG_EQ (m_interPlaneLinks, 5*3*8, "Every inter-plane link is traced on every update");
+  NS_TEST_ASSERT_MSG_EQ (m_groundLinks, 5*2, "Every ground link is traced on every update");
+  NS_TEST_ASSERT_MSG_GT (m_repointed, 0, "Links are re-pointed within 1500 s");
+
+  // the file also has the links set up by the constructor
+  uint32_t records = 0;
+  uint32_t repointed = 0;
+  std::ifstream file (file_name.c_str (), std::ios_base::in | std::ios_base::binary);
+  if (m_format == LeoSatelliteConfig::CSV_LINK_STATE)
+  {
+    std::string line;
+    std::getline (file, line);
+    NS_TEST_ASSERT_MSG_EQ (line, "time,link,a,b,distance,delay,repointed", "CSV header");
+    while (std::getline (file, line))
+    {
+      std::replace (line.begin (), line.end (), ',', ' ');
+      std::istringstream fields (line);
+      double time, distance, delay;
+      char link;
+      uint32_t a, b, flag;
+      NS_TEST_ASSERT_MSG_EQ (bool (fields >> time >> link >> a >> b >> distance >> delay >> flag), true, "CSV line " << line);
+      NS_TEST_EXPECT_MSG_EQ ((link == 'I' || link == 'G'), true, "Link type");
+      records++;
+      repointed += flag;
+    }
+  }
+  else
+  {
+    char record[34];
+    while (file.read (record, sizeof (record)))
+    {
+      NS_TEST_EXPECT_MSG_EQ ((record[8] == 'I' || record[8] == 'G'), true, "Link type");
+      records++;
+      repointed += record[9];
+    }
+  }
+  NS_TEST_ASSERT_MSG_EQ (records, 6*(3*8 + 2), "Every link state is written");
+  NS_TEST_ASSERT_MSG_EQ (repointed, m_repointed + 3*8 + 2, "Links set up by the constructor are new");
+
+  constellation = 0;
+  Simulator::Destroy ();
+  Config::Reset ();
+}
+
+/* Addresses are assigned without Ipv4AddressHelper: every interface must get its own
+   address, on the same network as the other end of its link */
+class LeoSatelliteLinkStateAddressTestCase : public TestCase
+{
+public:
+  LeoSatelliteLinkStateAddressTestCase ();
+  virtual ~LeoSatelliteLinkStateAddressTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LeoSatelliteLinkStateAddressTestCase::LeoSatelliteLinkStateAddressTestCase ()
+  : TestCase ("Every interface has its own address on the network of its link")
+{
+}
+
+LeoSatelliteLinkStateAddressTestCase::~LeoSatelliteLinkStateAddressTestCase ()
+{
+}
+
+void
+LeoSatelliteLinkStateAddressTestCase::DoRun (void)
+{
+  Config::SetDefault ("ns3::LeoSatelliteConfig::Routing", EnumValue (LeoSatelliteConfig::INCREMENTAL_ROUTING));
+  Ptr<LeoSatelliteConfig> constellation = CreateObject<LeoSatelliteConfig> (6, 12, 1000.0);
+
+  //satellite links have /24 networks, ground stations and ground links of satellites each their own /30 network
+  std::set<uint32_t> addresses;
+  uint32_t n_links = 0;
+  for (uint32_t n=0; n<NodeList::GetNNodes (); n++)
+  {
+    Ptr<Ipv4> ipv4 = NodeList::GetNode (n)->GetObject<Ipv4> ();
+    for (uint32_t i=1; ipv4 != 0 && i<ipv4->GetNInterfaces (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (ipv4->GetNAddresses (i), 1, "Interface " << i << " of node " << n << " has one address");
+      Ipv4InterfaceAddress address = ipv4->GetAddress (i, 0);
+      NS_TEST_ASSERT_MSG_EQ (addresses.insert (address.GetLocal ().Get ()).second, true, "Address " << address.GetLocal () << " assigned twice");
+
+      Ptr<NetDevice> device = ipv4->GetNetDevice (i);
+      Ptr<Channel> channel = device->GetChannel ();
+      if (channel == 0 || channel->GetNDevices () != 2 || address.GetMask () != Ipv4Mask ("255.255.255.0"))
+        continue;
+      Ptr<NetDevice> other = (channel->GetDevice (0) == device) ? channel->GetDevice (1) : channel->GetDevice (0);
+      Ptr<Ipv4> other_ipv4 = other->GetNode ()->GetObject<Ipv4> ();
+      Ipv4InterfaceAddress other_address = other_ipv4->GetAddress (other_ipv4->GetInterfaceForDevice (other), 0);
+      NS_TEST_ASSERT_MSG_EQ (address.GetLocal ().CombineMask (address.GetMask ()), other_address.GetLocal ().CombineMask (other_address.GetMask ()),
+                             "Ends " << address.GetLocal () << " and " << other_address.GetLocal () << " of a link on different networks");
+      n_links++;
+    }
+  }
+  //both ends of every intra-plane and inter-plane link
+  NS_TEST_ASSERT_MSG_EQ (n_links, 2*(6*12 + 6*12), "Satellite links found");
+
+  constellation = 0;
+  Simulator::Destroy ();
+  Config::Reset ();
+}
+
+class LeoSatelliteLinkStateTestSuite : public TestSuite
+{
+public:
+  LeoSatelliteLinkStateTestSuite ();
+};
+
+LeoSatelliteLinkStateTestSuite::LeoSatelliteLinkStateTestSuite ()
+  : TestSuite ("leo-satellite-link-state", UNIT)
+{
+  AddTestCase (new LeoSatelliteLinkStateTestCase (LeoSatelliteConfig::CSV_LINK_STATE), TestCase::QUICK);
+  AddTestCase (new LeoSatelliteLinkStateTestCase (LeoSatelliteConfig::BINARY_LINK_STATE), TestCase::QUICK);
+  AddTestCase (new LeoSatelliteLinkStateAddressTestCase, TestCase::QUICK);
+}
+
+static LeoSatelliteLinkStateTestSuite leoSatelliteLinkStateTestSuite;
@@ -0,0 +1,340 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * LEO Satellite Mobility Tests
+ * Checks the closed form propagation of the satellite mobility model
+ *
+ * ENSC 427: Communication Networks
+ * Spring 2020
+ * Team 11
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/double.h"
+#include "ns3/integer.h"
+#include "ns3/pointer.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/leo-satellite-mobility.h"
+#include "ns3/leo-satellite-ephemeris.h"
+#include "ns3/leo-satellite-orbits.h"
+#include <sstream>
+
+using namespace ns3;
+
+namespace ns3 {
+extern uint32_t currentNode; // satellite mobility initialization counter
+}
+
+static NodeContainer
+CreateSatellites (uint32_t n, Ptr<LeoSatelliteEphemeris> ephemeris = 0)
+{
+  NodeContainer satellites;
+  satellites.Create (n);
+  currentNode = 0;
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::LeoSatelliteMobilityModel",
+                             "NPerPlane", IntegerValue (8),
+                             "NumberofPlanes", IntegerValue (3),
+                             "Altitude", DoubleValue (1000.0),
+                             "Time", DoubleValue (Simulator::Now ().GetSeconds ()),
+                             "Ephemeris", PointerValue (ephemeris));
+  mobility.Install (satellites);
+  for (uint32_t i=0; i<n; i++)
+  {
+    satellites.Get (i)->GetObject<MobilityModel> ()->SetPosition (Vector (0.0, 0.0, 0.0));
+  }
+  return satellites;
+}
+
+/* Positions must not depend on which positions were queried before */
+class LeoSatelliteMobilityOrderTestCase : public TestCase
+{
+public:
+  LeoSatelliteMobilityOrderTestCase ();
+  virtual ~LeoSatelliteMobilityOrderTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void QueryPosition (Ptr<MobilityModel> mobility);
+};
+
+LeoSatelliteMobilityOrderTestCase::LeoSatelliteMobilityOrderTestCase ()
+  : TestCase ("Satellite positions do not depend on the order of the queries")
+{
+}
+
+LeoSatelliteMobilityOrderTestCase::~LeoSatelliteMobilityOrderTestCase ()
+{
+}
+
+void
+LeoSatelliteMobilityOrderTestCase::QueryPosition (Ptr<MobilityModel> mobility)
+{
+  mobility->GetPosition ();
+}
+
+void
+LeoSatelliteMobilityOrderTestCase::DoRun (void)
+{
+  // two constellations with the same initial positions
+  NodeContainer queried = CreateSatellites (12);
+  NodeContainer reference = CreateSatellites (12);
+
+  // positions of the first constellation are queried every 7 seconds
+  for (uint32_t t=7; t<6000; t+=7)
+  {
+    for (uint32_t i=0; i<queried.GetN (); i++)
+    {
+      Simulator::Schedule (Seconds (t), &LeoSatelliteMobilityOrderTestCase::QueryPosition, this,
+                           queried.Get (i)->GetObject<MobilityModel> ());
+    }
+  }
+  Simulator::Stop (Seconds (6000));
+  Simulator::Run ();
+
+  for (uint32_t i=0; i<queried.GetN (); i++)
+  {
+    Vector a = queried.Get (i)->GetObject<MobilityModel> ()->GetPosition ();
+    Vector b = reference.Get (i)->GetObject<MobilityModel> ()->GetPosition ();
+    NS_TEST_ASSERT_MSG_EQ_TOL (a.x, b.x, 1e-9, "Latitude of satellite " << i << " depends on earlier queries");
+    NS_TEST_ASSERT_MSG_EQ_TOL (a.y, b.y, 1e-9, "Longitude of satellite " << i << " depends on earlier queries");
+    NS_TEST_ASSERT_MSG_EQ_TOL (a.z, b.z, 1e-9, "Altitude of satellite " << i << " depends on earlier queries");
+  }
+
+  Simulator::Destroy ();
+}
+
+/* After half an orbit every satellite is mirrored across the equator on the other
+   side of the Earth, after a full orbit it is back at its initial position */
+class LeoSatelliteMobilityOrbitTestCase : public TestCase
+{
+public:
+  LeoSatelliteMobilityOrbitTestCase ();
+  virtual ~LeoSatelliteMobilityOrbitTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LeoSatelliteMobilityOrbitTestCase::LeoSatelliteMobilityOrbitTestCase ()
+  : TestCase ("Satellites cross the poles and complete their orbit")
+{
+}
+
+LeoSatelliteMobilityOrbitTestCase::~LeoSatelliteMobilityOrbitTestCase ()
+{
+}
+
+void
+LeoSatelliteMobilityOrbitTestCase::DoRun (void)
+{
+  NodeContainer satellites = CreateSatellites (12);
+  double G = 6.673e-11; // gravitational constant [Nm^2/kg^2]
+  double earthMass = 5.972e24; // mass of Earth [kg]
+  double radius = 6378.1 + 1000.0; // [km]
+  double speed = std::sqrt (G*earthMass/(radius*1000)); // [m/s]
+  double orbitalPeriod = 2*M_PI*radius/(speed/1000); // [s]
+
+  std::vector<Vector> initial;
+  for (uint32_t i=0; i<satellites.GetN (); i++)
+  {
+    initial.push_back (satellites.Get (i)->GetObject<MobilityModel> ()->GetPosition ());
+  }
+
+  Simulator::Stop (Seconds (orbitalPeriod/2));
+  Simulator::Run ();
+  for (uint32_t i=0; i<satellites.GetN (); i++)
+  {
+    Vector pos = satellites.Get (i)->GetObject<MobilityModel> ()->GetPosition ();
+    double longitude = (initial[i].y < 0) ? initial[i].y + 180 : initial[i].y - 180;
+    NS_TEST_ASSERT_MSG_EQ_TOL (pos.x, -initial[i].x, 1e-6, "Satellite " << i << " not mirrored after half an orbit");
+    NS_TEST_ASSERT_MSG_EQ_TOL (pos.y, longitude, 1e-6, "Satellite " << i << " not on the other side after half an orbit");
+  }
+
+  Simulator::Stop (Seconds (orbitalPeriod/2));
+  Simulator::Run ();
+  for (uint32_t i=0; i<satellites.GetN (); i++)
+  {
+    Vector pos = satellites.Get (i)->GetObject<MobilityModel> ()->GetPosition ();
+    NS_TEST_ASSERT_MSG_EQ_TOL (pos.x, initial[i].x, 1e-6, "Satellite " << i << " not back after a full orbit");
+    NS_TEST_ASSERT_MSG_EQ_TOL (pos.y, initial[i].y, 1e-6, "Satellite " << i << " not back after a full orbit");
+  }
+
+  Simulator::Destroy ();
+}
+
+/* Satellites sharing one ephemeris must be at the same positions as satellites
+   propagated on their own */
+class LeoSatelliteMobilityEphemerisTestCase : public TestCase
+{
+public:
+  LeoSatelliteMobilityEphemerisTestCase ();
+  virtual ~LeoSatelliteMobilityEphemerisTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LeoSatelliteMobilityEphemerisTestCase::LeoSatelliteMobilityEphemerisTestCase ()
+  : TestCase ("Satellites sharing an ephemeris match standalone satellites")
+{
+}
+
+LeoSatelliteMobilityEphemerisTestCase::~LeoSatelliteMobilityEphemerisTestCase ()
+{
+}
+
+void
+LeoSatelliteMobilityEphemerisTestCase::DoRun (void)
+{
+  Ptr<LeoSatelliteEphemeris> ephemeris = CreateObject<LeoSatelliteEphemeris> ();
+  NodeContainer shared = CreateSatellites (24, ephemeris);
+  NodeContainer standalone = CreateSatellites (24);
+  NS_TEST_ASSERT_MSG_EQ (ephemeris->GetN (), 24, "Every satellite is part of the shared ephemeris");
+
+  for (uint32_t epoch=0; epoch<20; epoch++)
+  {
+    for (uint32_t i=0; i<shared.GetN (); i++)
+    {
+      Vector a = shared.Get (i)->GetObject<MobilityModel> ()->GetPosition ();
+      Vector b = standalone.Get (i)->GetObject<MobilityModel> ()->GetPosition ();
+      NS_TEST_ASSERT_MSG_EQ_TOL (a.x, b.x, 1e-9, "Epoch " << epoch << ": wrong latitude of satellite " << i);
+      NS_TEST_ASSERT_MSG_EQ_TOL (a.y, b.y, 1e-9, "Epoch " << epoch << ": wrong longitude of satellite " << i);
+      NS_TEST_ASSERT_MSG_EQ_TOL (a.z, b.z, 1e-9, "Epoch " << epoch << ": wrong altitude of satellite " << i);
+    }
+    Simulator::Stop (Seconds (451));
+    Simulator::Run ();
+  }
+
+  Simulator::Destroy ();
+}
+
+/* Satellites of an inclined constellation must never pass the latitude of their
+   inclination, reach it once per orbit, and be where the ephemeris predicts */
+class LeoSatelliteMobilityInclinedTestCase : public TestCase
+{
+public:
+  LeoSatelliteMobilityInclinedTestCase ();
+  virtual ~LeoSatelliteMobilityInclinedTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LeoSatelliteMobilityInclinedTestCase::LeoSatelliteMobilityInclinedTestCase ()
+  : TestCase ("Walker-delta satellites stay within their inclination")
+{
+}
+
+LeoSatelliteMobilityInclinedTestCase::~LeoSatelliteMobilityInclinedTestCase ()
+{
+}
+
+void
+LeoSatelliteMobilityInclinedTestCase::DoRun (void)
+{
+  Ptr<LeoSatelliteEphemeris> ephemeris = CreateObject<LeoSatelliteEphemeris> ();
+  NodeContainer satellites = CreateSatellites (24, ephemeris);
+  std::vector<LeoSatelliteOrbit> orbits = LeoSatelliteOrbits::WalkerDelta (4, 6, 1, 53.0, 550.0, 0.0, true);
+  NS_TEST_ASSERT_MSG_EQ (orbits.size (), 24, "One orbit per satellite");
+  for (uint32_t i=0; i<satellites.GetN (); i++)
+  {
+    satellites.Get (i)->GetObject<LeoSatelliteMobilityModel> ()->SetOrbit (orbits[i]);
+  }
+  NS_TEST_ASSERT_MSG_EQ (ephemeris->GetN (), 24, "Orbits replace the polar layout in the ephemeris");
+
+  double period = 360/LeoSatelliteOrbits::GetAngularSpeed (550.0);
+  std::vector<double> highest (satellites.GetN (), 0);
+  for (uint32_t epoch=0; epoch<100; epoch++)
+  {
+    for (uint32_t i=0; i<satellites.GetN (); i++)
+    {
+      Ptr<LeoSatelliteMobilityModel> mobility = satellites.Get (i)->GetObject<LeoSatelliteMobilityModel> ();
+      Vector pos = mobility->GetPosition ();
+      Vector predicted = mobility->PropagatePosition (Simulator::Now ());
+      NS_TEST_ASSERT_MSG_EQ_TOL (pos.x, predicted.x, 1e-9, "Epoch " << epoch << ": wrong latitude of satellite " << i);
+      NS_TEST_ASSERT_MSG_EQ_TOL (pos.y, predicted.y, 1e-9, "Epoch " << epoch << ": wrong longitude of satellite " << i);
+      NS_TEST_ASSERT_MSG_EQ_TOL (pos.z, 550.0, 1e-9, "Epoch " << epoch << ": wrong altitude of satellite " << i);
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (std::abs (pos.x), 53.0 + 1e-9, "Epoch " << epoch << ": satellite " << i << " beyond its inclination");
+      NS_TEST_ASSERT_MSG_EQ ((pos.y >= -180 && pos.y < 180), true, "Epoch " << epoch << ": longitude of satellite " << i);
+      highest[i] = std::max (highest[i], std::abs (pos.x));
+    }
+    Simulator::Stop (Seconds (period/100));
+    Simulator::Run ();
+  }
+  for (uint32_t i=0; i<satellites.GetN (); i++)
+  {
+    NS_TEST_EXPECT_MSG_EQ_TOL (highest[i], 53.0, 0.5, "Satellite " << i << " does not reach its inclination");
+  }
+
+  Simulator::Destroy ();
+}
+
+/* Element sets must be parsed from their fixed columns, referred to the latest
+   epoch and grouped into planes by ascending node */
+class LeoSatelliteMobilityTleTestCase : public TestCase
+{
+public:
+  LeoSatelliteMobilityTleTestCase ();
+  virtual ~LeoSatelliteMobilityTleTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LeoSatelliteMobilityTleTestCase::LeoSatelliteMobilityTleTestCase ()
+  : TestCase ("Two-line element sets are read into planes")
+{
+}
+
+LeoSatelliteMobilityTleTestCase::~LeoSatelliteMobilityTleTestCase ()
+{
+}
+
+void
+LeoSatelliteMobilityTleTestCase::DoRun (void)
+{
+  std::istringstream tle ("ISS (ZARYA)\n"
+                          "1 25544U 98067A   20045.68587073  .00000950  00000-0  25302-4 0  9990\n"
+                          "2 25544  51.6443 242.0161 0004885 264.6060 207.3845 15.49165514212791\n"
+                          "1 25545U 98067B   20045.18587073  .00000950  00000-0  25302-4 0  9991\r\n"
+                          "2 25545  51.6443  62.0161 0004885 264.6060 107.3845 15.49165514212792\r\n");
+  std::vector<LeoSatelliteOrbit> orbits = LeoSatelliteOrbits::ReadTle (tle, 2, 1, 10.0, false);
+  NS_TEST_ASSERT_MSG_EQ (orbits.size (), 2, "One orbit per element set");
+
+  // the node at 62 degrees regresses west until the latest epoch, so the largest gap
+  // ends at the node at 242 degrees, which is the first plane
+  NS_TEST_EXPECT_MSG_EQ_TOL (orbits[0].phase, 264.6060 + 207.3845 - 360, 1e-9, "Argument of latitude");
+  NS_TEST_EXPECT_MSG_EQ_TOL (orbits[1].phase, 264.6060 + 107.3845 - 360, 1e-9, "Argument of latitude");
+  NS_TEST_EXPECT_MSG_EQ_TOL (orbits[0].epoch, 10.0, 1e-6, "The latest epoch is the reference");
+  NS_TEST_EXPECT_MSG_EQ_TOL (orbits[1].epoch, 10.0 - 43200, 1e-3, "Epoch of the older set");
+  for (uint32_t i=0; i<orbits.size (); i++)
+  {
+    NS_TEST_EXPECT_MSG_EQ_TOL (orbits[i].inclination, 51.6443, 1e-9, "Inclination");
+    NS_TEST_EXPECT_MSG_EQ_TOL (orbits[i].angularSpeed, 15.49165514*360/86400, 1e-12, "Mean motion");
+    NS_TEST_EXPECT_MSG_EQ_TOL (orbits[i].altitude, 420, 20, "Altitude from the mean motion");
+    NS_TEST_EXPECT_MSG_LT (orbits[i].nodeRate, 0, "Prograde orbits regress west");
+  }
+  // without rotation the Earth is frozen at the latest epoch, both nodes are measured from one meridian
+  NS_TEST_EXPECT_MSG_EQ_TOL (std::abs (orbits[1].ascendingLongitude - orbits[0].ascendingLongitude), 180, 1e-9,
+                             "Ascending nodes relative to the Earth");
+}
+
+class LeoSatelliteMobilityTestSuite : public TestSuite
+{
+public:
+  LeoSatelliteMobilityTestSuite ();
+};
+
+LeoSatelliteMobilityTestSuite::LeoSatelliteMobilityTestSuite ()
+  : TestSuite ("leo-satellite-mobility", UNIT)
+{
+  AddTestCase (new LeoSatelliteMobilityOrderTestCase, TestCase::QUICK);
+  AddTestCase (new LeoSatelliteMobilityOrbitTestCase, TestCase::QUICK);
+  AddTestCase (new LeoSatelliteMobilityEphemerisTestCase, TestCase::QUICK);
+  AddTestCase (new LeoSatelliteMobilityInclinedTestCase, TestCase::QUICK);
+  AddTestCase (new LeoSatelliteMobilityTleTestCase, TestCase::QUICK);
+}
+
+static LeoSatelliteMobilityTestSuite leoSatelliteMobilityTestSuite;
@@ -0,0 +1,197 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * LEO Satellite Routing Tests
+ * Checks the routes kept up to date by the constellation route manager
+ *
+ * ENSC 427: Communication Networks
+ * Spring 2020
+ * Team 11
+ */
+
+#include "ns3/test.h"
+#include "ns3/config.h"
+#include "ns3/enum.h"
+#include "ns3/simulator.h"
+#include "ns3/leo-satellite-config.h"
+#include "ns3/leo-satellite-route-manager.h"
+#include "ns3/node-list.h"
+#include "ns3/ipv4.h"
+#include <map>
+
+using namespace ns3;
+
+/* Routes updated incrementally after every link update must have the same
+   hop counts as routes computed from scratch over the same links */
+class LeoSatelliteIncrementalRoutingTestCase : public TestCase
+{
+public:
+  LeoSatelliteIncrementalRoutingTestCase ();
+  virtual ~LeoSatelliteIncrementalRoutingTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LeoSatelliteIncrementalRoutingTestCase::LeoSatelliteIncrementalRoutingTestCase ()
+  : TestCase ("Incremental route updates match a full recompute")
+{
+}
+
+LeoSatelliteIncrementalRoutingTestCase::~LeoSatelliteIncrementalRoutingTestCase ()
+{
+}
+
+void
+LeoSatelliteIncrementalRoutingTestCase::DoRun (void)
+{
+  Config::SetDefault ("ns3::LeoSatelliteConfig::Routing", EnumValue (LeoSatelliteConfig::INCREMENTAL_ROUTING));
+  Ptr<LeoSatelliteConfig> constellation = CreateObject<LeoSatelliteConfig> (3, 8, 2000.0);
+  Ptr<LeoSatelliteRouteManager> manager = constellation->GetRouteManager ();
+  NS_TEST_ASSERT_MSG_NE (manager, 0, "Incremental routing has no route manager");
+
+  uint32_t n = manager->GetNNodes ();
+  NS_TEST_ASSERT_MSG_EQ (n, 3*8 + 2, "Every satellite and ground station is part of the routing graph");
+
+  for (uint32_t epoch=0; epoch<10; epoch++)
+  {
+    Simulator::Stop (Seconds (300));
+    Simulator::Run ();
+    constellation->UpdateLinks ();
+
+    std::vector<uint32_t> incremental;
+    for (uint32_t src=0; src<n; src++)
+    {
+      for (uint32_t dst=0; dst<n; dst++)
+      {
+        incremental.push_back (manager->GetDistance (src, dst));
+      }
+    }
+
+    manager->ComputeRoutes ();
+    for (uint32_t src=0; src<n; src++)
+    {
+      for (uint32_t dst=0; dst<n; dst++)
+      {
+        NS_TEST_ASSERT_MSG_EQ (incremental[src*n + dst], manager->GetDistance (src, dst),
+                               "Epoch " << epoch << ": wrong hop count from " << src << " to " << dst);
+        NS_TEST_ASSERT_MSG_NE (incremental[src*n + dst], LeoSatelliteRouteManager::UNREACHABLE,
+                               "Epoch " << epoch << ": " << dst << " unreachable from " << src);
+      }
+    }
+  }
+
+  Simulator::Destroy ();
+  Config::Reset ();
+}
+
+/* Grid routing must give the same hop counts as shortest paths over the actual links,
+   and following its next hops must reach every destination in that many hops */
+class LeoSatelliteGridRoutingTestCase : public TestCase
+{
+public:
+  /**
+   * \param orbits orbits of the constellation, which decide how the seam is linked
+   */
+  LeoSatelliteGridRoutingTestCase (LeoSatelliteConfig::OrbitType orbits);
+  virtual ~LeoSatelliteGridRoutingTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  LeoSatelliteConfig::OrbitType m_orbits;
+};
+
+LeoSatelliteGridRoutingTestCase::LeoSatelliteGridRoutingTestCase (LeoSatelliteConfig::OrbitType orbits)
+  : TestCase (orbits == LeoSatelliteConfig::POLAR_ORBITS ? "Grid next hops follow shortest paths across a reversed seam"
+                                                         : "Grid next hops follow shortest paths across a Walker-delta seam"),
+    m_orbits (orbits)
+{
+}
+
+LeoSatelliteGridRoutingTestCase::~LeoSatelliteGridRoutingTestCase ()
+{
+}
+
+void
+LeoSatelliteGridRoutingTestCase::DoRun (void)
+{
+  uint32_t firstNode = NodeList::GetNNodes ();
+  Config::SetDefault ("ns3::LeoSatelliteConfig::Routing", EnumValue (LeoSatelliteConfig::GRID_ROUTING));
+  Config::SetDefault ("ns3::LeoSatelliteConfig::Orbits", EnumValue (m_orbits));
+  Ptr<LeoSatelliteConfig> grid = CreateObject<LeoSatelliteConfig> (5, 8, 1000.0);
+  uint32_t lastNode = NodeList::GetNNodes ();
+
+  Ptr<LeoSatelliteRouteManager> gridManager = grid->GetRouteManager ();
+  uint32_t n = gridManager->GetNNodes ();
+  NS_TEST_ASSERT_MSG_EQ (n, lastNode - firstNode, "Every node of the constellation is part of the routing graph");
+
+  std::map<Ipv4Address, Ptr<Node> > owner;
+  for (uint32_t i=firstNode; i<lastNode; i++)
+  {
+    Ptr<Ipv4> ipv4 = NodeList::GetNode (i)->GetObject<Ipv4> ();
+    for (uint32_t j=1; j<ipv4->GetNInterfaces (); j++)
+    {
+      owner[ipv4->GetAddress (j, 0).GetLocal ()] = NodeList::GetNode (i);
+    }
+  }
+
+  for (uint32_t epoch=0; epoch<8; epoch++)
+  {
+    // shortest path trees over the same links as reference
+    gridManager->LeoSatelliteRouteManager::ComputeRoutes ();
+    for (uint32_t src=0; src<n; src++)
+    {
+      for (uint32_t dst=0; dst<n; dst++)
+      {
+        NS_TEST_ASSERT_MSG_EQ (gridManager->GetDistance (src, dst), gridManager->LeoSatelliteRouteManager::GetDistance (src, dst),
+                               "Epoch " << epoch << ": wrong hop count from " << src << " to " << dst);
+      }
+    }
+
+    for (uint32_t i=firstNode; i<lastNode; i++)
+    {
+      for (uint32_t j=firstNode; j<lastNode; j++)
+      {
+        Ptr<Node> node = NodeList::GetNode (i);
+        Ptr<Node> destination = NodeList::GetNode (j);
+        Ipv4Address address = destination->GetObject<Ipv4> ()->GetAddress (1, 0).GetLocal ();
+        uint32_t hops = 0;
+        while (node != destination && hops <= n)
+        {
+          uint32_t interface;
+          Ipv4Address gateway;
+          NS_TEST_ASSERT_MSG_EQ (gridManager->LookupRoute (node, address, interface, gateway), true,
+                                 "Epoch " << epoch << ": no route from node " << node->GetId () << " to " << address);
+          node = owner[gateway];
+          hops++;
+        }
+        NS_TEST_ASSERT_MSG_EQ (hops, gridManager->GetDistance (gridManager->GetNodeIndex (NodeList::GetNode (i)),
+                                                               gridManager->GetNodeIndex (destination)),
+                               "Epoch " << epoch << ": path from node " << i << " to node " << j << " is not the shortest");
+      }
+    }
+
+    Simulator::Stop (Seconds (500));
+    Simulator::Run ();
+    grid->UpdateLinks ();
+  }
+
+  Simulator::Destroy ();
+  Config::Reset ();
+}
+
+class LeoSatelliteRoutingTestSuite : public TestSuite
+{
+public:
+  LeoSatelliteRoutingTestSuite ();
+};
+
+LeoSatelliteRoutingTestSuite::LeoSatelliteRoutingTestSuite ()
+  : TestSuite ("leo-satellite-routing", UNIT)
+{
+  AddTestCase (new LeoSatelliteIncrementalRoutingTestCase, TestCase::QUICK);
+  AddTestCase (new LeoSatelliteGridRoutingTestCase (LeoSatelliteConfig::POLAR_ORBITS), TestCase::QUICK);
+  AddTestCase (new LeoSatelliteGridRoutingTestCase (LeoSatelliteConfig::WALKER_DELTA_ORBITS), TestCase::QUICK);
+}
+
+static LeoSatelliteRoutingTestSuite leoSatelliteRoutingTestSuite;
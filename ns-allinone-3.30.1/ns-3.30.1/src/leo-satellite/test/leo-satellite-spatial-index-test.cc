@@ -0,0 +1,122 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * LEO Satellite Spatial Index Tests
+ * Checks the nearest satellite lookups against a scan of every satellite
+ *
+ * ENSC 427: Communication Networks
+ * Spring 2020
+ * Team 11
+ */
+
+#include "ns3/test.h"
+#include "ns3/double.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/leo-satellite-spatial-index.h"
+
+using namespace ns3;
+
+/* The nearest satellite found through the index must be the one found by
+   scanning the whole constellation, also after satellites changed cell */
+class LeoSatelliteSpatialIndexNearestTestCase : public TestCase
+{
+public:
+  LeoSatelliteSpatialIndexNearestTestCase (double cellSize);
+  virtual ~LeoSatelliteSpatialIndexNearestTestCase ();
+
+private:
+  virtual void DoRun (void);
+  double m_cellSize;
+};
+
+LeoSatelliteSpatialIndexNearestTestCase::LeoSatelliteSpatialIndexNearestTestCase (double cellSize)
+  : TestCase ("Nearest satellite matches a full scan with cells of " + std::to_string (cellSize) + " degrees"),
+    m_cellSize (cellSize)
+{
+}
+
+LeoSatelliteSpatialIndexNearestTestCase::~LeoSatelliteSpatialIndexNearestTestCase ()
+{
+}
+
+void
+LeoSatelliteSpatialIndexNearestTestCase::DoRun (void)
+{
+  Ptr<UniformRandomVariable> latitude = CreateObject<UniformRandomVariable> ();
+  latitude->SetAttribute ("Min", DoubleValue (-90));
+  latitude->SetAttribute ("Max", DoubleValue (90));
+  latitude->SetStream (1);
+  Ptr<UniformRandomVariable> longitude = CreateObject<UniformRandomVariable> ();
+  longitude->SetAttribute ("Min", DoubleValue (-180));
+  longitude->SetAttribute ("Max", DoubleValue (180));
+  longitude->SetStream (2);
+
+  Ptr<LeoSatelliteSpatialIndex> index = CreateObject<LeoSatelliteSpatialIndex> ();
+  index->SetAttribute ("CellSize", DoubleValue (m_cellSize));
+  NS_TEST_ASSERT_MSG_EQ (index->FindNearest (Vector (0, 0, 0)), LeoSatelliteSpatialIndex::NONE, "Empty index has no nearest satellite");
+
+  std::vector<Vector> satellites (300);
+  for (uint32_t i=0; i<satellites.size (); i++)
+  {
+    satellites[i] = Vector (latitude->GetValue (), longitude->GetValue (), 1000);
+  }
+
+  for (uint32_t epoch=0; epoch<5; epoch++)
+  {
+    uint32_t moved = index->Update (satellites);
+    NS_TEST_ASSERT_MSG_EQ (index->GetN (), satellites.size (), "Every satellite is part of the index");
+    if (epoch == 0)
+    {
+      NS_TEST_ASSERT_MSG_EQ (moved, satellites.size (), "Every satellite is placed on the first update");
+    }
+
+    // ground positions everywhere, including the poles and the date line
+    std::vector<Vector> ground;
+    ground.push_back (Vector (90, 0, 0));
+    ground.push_back (Vector (-90, 0, 0));
+    ground.push_back (Vector (0, -180, 0));
+    ground.push_back (Vector (45, 180, 0));
+    for (uint32_t i=0; i<200; i++)
+    {
+      ground.push_back (Vector (latitude->GetValue (), longitude->GetValue (), 0));
+    }
+
+    for (uint32_t g=0; g<ground.size (); g++)
+    {
+      uint32_t nearest = 0;
+      for (uint32_t i=1; i<satellites.size (); i++)
+      {
+        if (LeoSatelliteSpatialIndex::GetCentralAngle (ground[g], satellites[i])
+            < LeoSatelliteSpatialIndex::GetCentralAngle (ground[g], satellites[nearest]))
+        {
+          nearest = i;
+        }
+      }
+      uint32_t found = index->FindNearest (ground[g]);
+      NS_TEST_ASSERT_MSG_EQ_TOL (LeoSatelliteSpatialIndex::GetCentralAngle (ground[g], satellites[found]),
+                                 LeoSatelliteSpatialIndex::GetCentralAngle (ground[g], satellites[nearest]), 1e-9,
+                                 "Epoch " << epoch << ": satellite " << found << " is not the nearest to " << ground[g]);
+    }
+
+    // move a third of the satellites
+    for (uint32_t i=epoch%3; i<satellites.size (); i+=3)
+    {
+      satellites[i] = Vector (latitude->GetValue (), longitude->GetValue (), 1000);
+    }
+  }
+}
+
+class LeoSatelliteSpatialIndexTestSuite : public TestSuite
+{
+public:
+  LeoSatelliteSpatialIndexTestSuite ();
+};
+
+LeoSatelliteSpatialIndexTestSuite::LeoSatelliteSpatialIndexTestSuite ()
+  : TestSuite ("leo-satellite-spatial-index", UNIT)
+{
+  AddTestCase (new LeoSatelliteSpatialIndexNearestTestCase (10), TestCase::QUICK);
+  AddTestCase (new LeoSatelliteSpatialIndexNearestTestCase (1), TestCase::QUICK);
+  AddTestCase (new LeoSatelliteSpatialIndexNearestTestCase (45), TestCase::QUICK);
+}
+
+static LeoSatelliteSpatialIndexTestSuite leoSatelliteSpatialIndexTestSuite;
@@ -0,0 +1,226 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+#include "ns3/core-module.h"
+#include "ns3/packet.h"
+#include "ns3/mac48-address.h"
+#include "ns3/satellite-phy-rx-carrier-per-frame.h"
+#include "ns3/satellite-signal-parameters.h"
+#include "ns3/satellite-crdsa-replica-tag.h"
+#include "ns3/satellite-enums.h"
+
+/**
+ * \file sat-crdsa-sic-benchmark.cc
+ * \ingroup satellite
+ * \brief Benchmark of the CRDSA successive interference cancellation.
+ *
+ * Frames of 3 replicas per UT at a load of 0.5 UTs per slot are processed with a
+ * doubling number of UTs, and the processing time per frame is printed, e.g.:
+ *
+ *     $ ./waf --run="sat-crdsa-sic-benchmark --maxUts=16000"
+ *
+ * The time per UT stays roughly constant when the processing is linear in the number of UTs.
+ */
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("sat-crdsa-sic-benchmark");
+
+namespace {
+
+double
+GetBenchmarkBandwidthHz (SatEnums::ChannelType_t channelType, uint32_t carrierId, SatEnums::CarrierBandwidthType_t bandwidthType)
+{
+  return 1e6;
+}
+
+double
+GetBenchmarkSinr (double sinr)
+{
+  return sinr;
+}
+
+} // anonymous namespace
+
+/**
+ * \ingroup satellite
+ * \brief CRDSA carrier feeding frames of UTs in random slots to the frame processing directly.
+ */
+class SatCrdsaSicBenchmarkCarrier : public SatPhyRxCarrierPerFrame
+{
+public:
+  SatCrdsaSicBenchmarkCarrier (Ptr<SatPhyRxCarrierConf> carrierConf);
+
+  /**
+   * Add a frame of numOfUts UTs sending numOfReplicas replicas each in distinct random
+   * slots of numOfSlots slots, the interference of a replica is the power of the other UTs in its slot.
+   */
+  void AddFrame (uint32_t numOfUts, uint16_t numOfSlots, uint32_t numOfReplicas, Ptr<UniformRandomVariable> unif);
+
+  /**
+   * Process the frame.
+   * \return number of payloads received without error
+   */
+  uint32_t Process ();
+};
+
+SatCrdsaSicBenchmarkCarrier::SatCrdsaSicBenchmarkCarrier (Ptr<SatPhyRxCarrierConf> carrierConf)
+  : SatPhyRxCarrierPerFrame (0, carrierConf, true)
+{
+}
+
+void
+SatCrdsaSicBenchmarkCarrier::AddFrame (uint32_t numOfUts, uint16_t numOfSlots, uint32_t numOfReplicas, Ptr<UniformRandomVariable> unif)
+{
+  const double rxPowerW = 1e-12;
+  std::vector<std::vector<uint16_t> > frame (numOfUts);
+  std::vector<double> slotPowerW (numOfSlots, 0.0);
+
+  for (uint32_t ut = 0; ut < numOfUts; ut++)
+    {
+      while (frame[ut].size () < numOfReplicas)
+        {
+          uint16_t slot = unif->GetInteger (0, numOfSlots - 1);
+
+          if (std::find (frame[ut].begin (), frame[ut].end (), slot) == frame[ut].end ())
+            {
+              frame[ut].push_back (slot);
+              slotPowerW[slot] += rxPowerW;
+            }
+        }
+    }
+
+  for (uint32_t ut = 0; ut < numOfUts; ut++)
+    {
+      Ptr<Packet> payload = Create<Packet> (100);
+      Mac48Address sourceAddress = Mac48Address::Allocate ();
+
+      for (uint32_t i = 0; i < numOfReplicas; i++)
+        {
+          SatCrdsaReplicaTag replicaTag;
+          replicaTag.AddSlotId (frame[ut][i]);
+          for (uint32_t j = 0; j < numOfReplicas; j++)
+            {
+              if (j != i)
+                {
+                  replicaTag.AddSlotId (frame[ut][j]);
+                }
+            }
+
+          Ptr<Packet> packet = payload->Copy ();
+          packet->AddPacketTag (replicaTag);
+
+          Ptr<SatSignalParameters> rxParams = Create<SatSignalParameters> ();
+          rxParams->m_packetsInBurst.push_back (packet);
+          rxParams->m_txInfo.packetType = SatEnums::PACKET_TYPE_CRDSA;
+          rxParams->m_txInfo.crdsaUniquePacketId = ut;
+          rxParams->m_rxPower_W = 1e-10;
+          rxParams->m_ifPower_W = 0.0;
+          rxParams->m_rxPowerInSatellite_W = rxPowerW;
+          rxParams->m_ifPowerInSatellite_W = slotPowerW[frame[ut][i]] - rxPowerW;
+          rxParams->m_rxNoisePowerInSatellite_W = 1e-14;
+          rxParams->m_rxAciIfPowerInSatellite_W = 0.0;
+          rxParams->m_rxExtNoisePowerInSatellite_W = 0.0;
+          rxParams->m_sinrCalculate = MakeCallback (&GetBenchmarkSinr);
+
+          SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s params;
+          params.rxParams = rxParams;
+          params.sourceAddress = sourceAddress;
+          params.destAddress = Mac48Address::GetBroadcast ();
+          params.hasCollision = false;
+          params.packetHasBeenProcessed = false;
+
+          AddCrdsaPacket (params);
+        }
+    }
+}
+
+uint32_t
+SatCrdsaSicBenchmarkCarrier::Process ()
+{
+  std::vector<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s> results = ProcessFrame ();
+  uint32_t numOfReceived = 0;
+
+  for (uint32_t i = 0; i < results.size (); i++)
+    {
+      numOfReceived += results[i].phyError ? 0 : 1;
+    }
+  return numOfReceived;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t minUts = 1000;
+  uint32_t maxUts = 16000;
+  uint32_t utsPerRun = 64000;
+
+  CommandLine cmd;
+  cmd.AddValue ("minUts", "Number of UTs of the smallest frame", minUts);
+  cmd.AddValue ("maxUts", "Number of UTs of the largest frame, the number of UTs doubles from the smallest one", maxUts);
+  cmd.AddValue ("utsPerRun", "Number of UTs processed for every frame size, in as many frames as needed", utsPerRun);
+  cmd.Parse (argc, argv);
+
+  NS_ABORT_MSG_IF (minUts == 0 || 2 * maxUts > 0xffff, "Number of UTs must be between 1 and 32767");
+
+  /// strict collision detection and no errors, i.e. a packet is received when it is alone in its slot
+  SatPhyRxCarrierConf::RxCarrierCreateParams_s params = SatPhyRxCarrierConf::RxCarrierCreateParams_s ();
+  params.m_rxTemperatureK = 290.0;
+  params.m_errorModel = SatPhyRxCarrierConf::EM_NONE;
+  params.m_daIfModel = SatPhyRxCarrierConf::IF_CONSTANT;
+  params.m_raIfModel = SatPhyRxCarrierConf::IF_CONSTANT;
+  params.m_chType = SatEnums::RETURN_FEEDER_CH;
+  params.m_bwConverter = MakeCallback (&GetBenchmarkBandwidthHz);
+  params.m_carrierCount = 1;
+  params.m_raCollisionModel = SatPhyRxCarrierConf::RA_COLLISION_ALWAYS_DROP_ALL_COLLIDING_PACKETS;
+  params.m_randomAccessModel = SatEnums::RA_MODEL_CRDSA;
+
+  Ptr<SatPhyRxCarrierConf> carrierConf = CreateObject<SatPhyRxCarrierConf> (params);
+  carrierConf->SetSinrCalculatorCb (MakeCallback (&GetBenchmarkSinr));
+  Ptr<SatCrdsaSicBenchmarkCarrier> carrier = CreateObject<SatCrdsaSicBenchmarkCarrier> (carrierConf);
+
+  Ptr<UniformRandomVariable> unif = CreateObject<UniformRandomVariable> ();
+  unif->SetStream (1);
+
+  for (uint32_t numOfUts = minUts; numOfUts <= maxUts; numOfUts *= 2)
+    {
+      uint32_t numOfFrames = std::max (utsPerRun / numOfUts, uint32_t (1));
+      int64_t elapsedMs = 0;
+      uint32_t numOfReceived = 0;
+
+      for (uint32_t i = 0; i < numOfFrames; i++)
+        {
+          carrier->AddFrame (numOfUts, 2 * numOfUts, 3, unif);
+
+          SystemWallClockMs clock;
+          clock.Start ();
+          numOfReceived = carrier->Process ();
+          elapsedMs += clock.End ();
+        }
+
+      std::cout << "CRDSA SIC: " << numOfUts << " UTs, " << 3 * numOfUts << " replicas in " << 2 * numOfUts
+                << " slots, " << numOfReceived << " received, "
+                << double (elapsedMs) / numOfFrames << " ms per frame, "
+                << 1000.0 * elapsedMs / (numOfFrames * numOfUts) << " us per UT" << std::endl;
+    }
+
+  carrier->Dispose ();
+  Simulator::Destroy ();
+  return 0;
+}
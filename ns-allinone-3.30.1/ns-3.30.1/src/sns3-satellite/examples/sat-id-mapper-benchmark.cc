@@ -0,0 +1,163 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <iostream>
+#include <map>
+#include <vector>
+#include "ns3/core-module.h"
+#include "ns3/mac48-address.h"
+#include "ns3/satellite-id-mapper.h"
+
+/**
+ * \file sat-id-mapper-benchmark.cc
+ * \ingroup satellite
+ * \brief Benchmark of the MAC address lookups of the ID mapper.
+ *
+ * UT, beam and GW IDs are attached to a growing number of UT MAC addresses, and the
+ * time per lookup of each ID in random UT order is printed next to the time with a
+ * std::map of the addresses, e.g.:
+ *
+ *     $ ./waf --run="sat-id-mapper-benchmark --maxUts=160000"
+ *
+ * The time per lookup stays roughly constant when the lookups do not depend on the number of UTs.
+ */
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("sat-id-mapper-benchmark");
+
+namespace {
+
+/// Number of beams the UTs are spread over
+const uint32_t NUM_OF_BEAMS = 72;
+
+/// Number of GWs the UTs are spread over
+const uint32_t NUM_OF_GWS = 5;
+
+/**
+ * Time the lookups of IDs with a getter of the ID mapper.
+ * \param mapper ID mapper
+ * \param getter getter of the ID mapper
+ * \param utMacs MAC addresses of the UTs
+ * \param order indices of the looked up UTs
+ * \param sum sum of the looked up IDs
+ * \return time in ms
+ */
+int64_t
+TimeMapperLookups (Ptr<SatIdMapper> mapper, int32_t (SatIdMapper::*getter) (Address) const,
+                   const std::vector<Address> &utMacs, const std::vector<uint32_t> &order, int64_t &sum)
+{
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < order.size (); i++)
+    {
+      sum += ((*mapper).*getter) (utMacs[order[i]]);
+    }
+  return clock.End ();
+}
+
+/**
+ * Time the lookups of IDs with a map of addresses.
+ * \param ids IDs of the addresses
+ * \param utMacs MAC addresses of the UTs
+ * \param order indices of the looked up UTs
+ * \param sum sum of the looked up IDs
+ * \return time in ms
+ */
+int64_t
+TimeMapLookups (const std::map<Address, uint32_t> &ids,
+                const std::vector<Address> &utMacs, const std::vector<uint32_t> &order, int64_t &sum)
+{
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < order.size (); i++)
+    {
+      sum += ids.find (utMacs[order[i]])->second;
+    }
+  return clock.End ();
+}
+
+} // anonymous namespace
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t minUts = 10000;
+  uint32_t maxUts = 160000;
+  uint32_t numOfLookups = 4000000;
+
+  CommandLine cmd;
+  cmd.AddValue ("minUts", "Number of UTs of the smallest run", minUts);
+  cmd.AddValue ("maxUts", "Number of UTs of the largest run, the number of UTs doubles from the smallest one", maxUts);
+  cmd.AddValue ("numOfLookups", "Number of lookups of each ID for every number of UTs", numOfLookups);
+  cmd.Parse (argc, argv);
+
+  NS_ABORT_MSG_IF (minUts == 0 || minUts > maxUts, "Number of UTs of the smallest run must be between 1 and maxUts");
+
+  Ptr<UniformRandomVariable> unif = CreateObject<UniformRandomVariable> ();
+  unif->SetStream (1);
+
+  const char *idNames[3] = {"UT", "beam", "GW"};
+  int32_t (SatIdMapper::*getters[3]) (Address) const = {&SatIdMapper::GetUtIdWithMac,
+                                                       &SatIdMapper::GetBeamIdWithMac,
+                                                       &SatIdMapper::GetGwIdWithMac};
+
+  for (uint32_t numOfUts = minUts; numOfUts <= maxUts; numOfUts *= 2)
+    {
+      Ptr<SatIdMapper> mapper = CreateObject<SatIdMapper> ();
+      std::map<Address, uint32_t> ids[3];
+      std::vector<Address> utMacs;
+
+      for (uint32_t i = 0; i < numOfUts; i++)
+        {
+          utMacs.push_back (Mac48Address::Allocate ());
+
+          ids[0][utMacs[i]] = mapper->AttachMacToUtId (utMacs[i]);
+
+          ids[1][utMacs[i]] = i % NUM_OF_BEAMS + 1;
+          mapper->AttachMacToBeamId (utMacs[i], ids[1][utMacs[i]]);
+
+          ids[2][utMacs[i]] = i % NUM_OF_GWS + 1;
+          mapper->AttachMacToGwId (utMacs[i], ids[2][utMacs[i]]);
+        }
+
+      std::vector<uint32_t> order (numOfLookups);
+
+      for (uint32_t i = 0; i < numOfLookups; i++)
+        {
+          order[i] = unif->GetInteger (0, numOfUts - 1);
+        }
+
+      for (uint32_t k = 0; k < 3; k++)
+        {
+          int64_t mapperSum = 0;
+          int64_t mapSum = 0;
+          int64_t mapperMs = TimeMapperLookups (mapper, getters[k], utMacs, order, mapperSum);
+          int64_t mapMs = TimeMapLookups (ids[k], utMacs, order, mapSum);
+
+          NS_ABORT_MSG_IF (mapperSum != mapSum, idNames[k] << " IDs of the ID mapper differ from the attached ones");
+
+          std::cout << "ID mapper: " << numOfUts << " UTs, " << idNames[k] << " ID "
+                    << 1e6 * mapperMs / numOfLookups << " ns per lookup, "
+                    << 1e6 * mapMs / numOfLookups << " ns per lookup with a map of addresses" << std::endl;
+        }
+
+      mapper->Dispose ();
+    }
+
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,71 @@
+#!/usr/bin/env python
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License version 2 as
+# published by the Free Software Foundation;
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+#
+
+"""Convert output traces written in the binary format of
+SatOutputFileStreamDoubleContainer into tab separated text, one row per line,
+like the traces written in the text format.
+
+Usage: readBinaryTrace.py TRACE_FILE [OUTPUT_FILE]
+"""
+
+import struct
+import sys
+
+MAGIC = b'SATTRACE'
+VERSION = 1
+
+
+def read_rows(trace):
+    """Yield the rows of a binary trace file object as tuples of floats."""
+    if trace.read(len(MAGIC)) != MAGIC:
+        raise ValueError('not a binary satellite trace')
+    version, values_in_row = struct.unpack('=II', trace.read(8))
+    if version != VERSION:
+        raise ValueError('unsupported version %d' % version)
+
+    while True:
+        block_header = trace.read(8)
+        if not block_header:
+            return
+        if len(block_header) != 8:
+            raise ValueError('truncated block')
+        rows = struct.unpack('=II', block_header)[0]
+        size = 8 * rows * values_in_row
+        data = trace.read(size)
+        if len(data) != size:
+            raise ValueError('truncated block')
+        values = struct.unpack('=%dd' % (rows * values_in_row), data)
+        # values of a block are stored column after column
+        for i in range(rows):
+            yield values[i::rows]
+
+
+def main(argv):
+    if len(argv) not in (2, 3):
+        sys.stderr.write(__doc__)
+        return 1
+
+    output = open(argv[2], 'w') if len(argv) == 3 else sys.stdout
+    with open(argv[1], 'rb') as trace:
+        for row in read_rows(trace):
+            output.write('\t'.join('%.6g' % value for value in row) + '\n')
+    if output is not sys.stdout:
+        output.close()
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
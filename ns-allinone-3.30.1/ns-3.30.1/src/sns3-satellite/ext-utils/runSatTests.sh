@@ -29,17 +29,23 @@ cd ../../../;
 ./test.py -s sat-arq-seqno-test --fullness=TAKES_FOREVER
 ./test.py -s sat-arq-test --fullness=TAKES_FOREVER
 ./test.py -s sat-channel-estimation-error-test --fullness=TAKES_FOREVER
+./test.py -s sat-channel-test --fullness=TAKES_FOREVER
 ./test.py -s sat-cno-estimator-unit-test --fullness=TAKES_FOREVER
 ./test.py -s sat-cra-test --fullness=TAKES_FOREVER
+./test.py -s sat-crdsa-sic-test --fullness=TAKES_FOREVER
 ./test.py -s sat-ctrl-msg-container-unit-test --fullness=TAKES_FOREVER
 ./test.py -s sat-fading-external-input-trace-test --fullness=TAKES_FOREVER
 ./test.py -s sat-frame-allocator-test --fullness=TAKES_FOREVER
 ./test.py -s sat-fsl-test --fullness=TAKES_FOREVER
+./test.py -s sat-fwd-link-scheduler-test --fullness=TAKES_FOREVER
 ./test.py -s geo-coordinate-test --fullness=TAKES_FOREVER
 ./test.py -s sat-gse-test --fullness=TAKES_FOREVER
+./test.py -s sat-gw-llc-test --fullness=TAKES_FOREVER
+./test.py -s sat-id-mapper-test --fullness=TAKES_FOREVER
 ./test.py -s sat-if-unit-test --fullness=TAKES_FOREVER
 ./test.py -s sat-link-results-test --fullness=TAKES_FOREVER
 ./test.py -s sat-mobility-observer-test --fullness=TAKES_FOREVER
+./test.py -s sat-output-fstream-test --fullness=TAKES_FOREVER
 ./test.py -s sat-perf-mem --fullness=TAKES_FOREVER
 ./test.py -s sat-periodic-control-message-test --fullness=TAKES_FOREVER
 ./test.py -s sat-per-packet-if-test --fullness=TAKES_FOREVER
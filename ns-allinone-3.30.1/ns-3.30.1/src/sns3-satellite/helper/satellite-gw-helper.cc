@@ -357,6 +357,9 @@ SatGwHelper::Install (Ptr<Node> n, uint32_t gwId, uint32_t beamId, Ptr<SatChanne
   fdwLinkScheduler->SetTxOpportunityCallback (MakeCallback (&SatGwLlc::NotifyTxOpportunity, llc));
   fdwLinkScheduler->SetSchedContextCallback (MakeCallback (&SatLlc::GetSchedulingContexts, llc));
 
+  // Attach the scheduling object update of SatFwdLinkScheduler to the LLC encapsulators
+  llc->SetBufferChangedCallback (MakeCallback (&SatFwdLinkScheduler::UpdateSchedulingObject, fdwLinkScheduler));
+
   // set scheduler to Mac
   mac->SetAttribute ("Scheduler", PointerValue (fdwLinkScheduler));
 
@@ -19,6 +19,8 @@
  */
 
 #include <sstream>
+#include <cmath>
+#include <vector>
 #include "ns3/log.h"
 #include "satellite-antenna-gain-pattern-container.h"
 #include "ns3/singleton.h"
@@ -67,6 +69,34 @@ SatAntennaGainPatternContainer::SatAntennaGainPatternContainer ()
           NS_FATAL_ERROR (this << " an antenna pattern for beam " << i << " already exists!");
         }
     }
+
+  Ptr<SatAntennaGainPattern> firstPattern = m_antennaPatternMap.at (1);
+  bool sameGrid (true);
+
+  for (uint32_t i = 2; i <= NUMBER_OF_BEAMS; ++i)
+    {
+      sameGrid = sameGrid && firstPattern->HasSameGrid (m_antennaPatternMap.at (i));
+    }
+
+  if (sameGrid)
+    {
+      uint32_t numOfGridPoints = firstPattern->GetNumOfGridPoints ();
+      m_beamGains.resize (numOfGridPoints * NUMBER_OF_BEAMS);
+
+      for (uint32_t i = 1; i <= NUMBER_OF_BEAMS; ++i)
+        {
+          Ptr<SatAntennaGainPattern> gainPattern = m_antennaPatternMap.at (i);
+
+          for (uint32_t j = 0; j < numOfGridPoints; ++j)
+            {
+              m_beamGains[j * NUMBER_OF_BEAMS + i - 1] = gainPattern->GetGridGain_lin (j);
+            }
+        }
+    }
+  else
+    {
+      NS_LOG_INFO (this << " antenna patterns are not sampled on the same grid");
+    }
 }
 
 Ptr<SatAntennaGainPattern>
@@ -91,10 +121,13 @@ SatAntennaGainPatternContainer::GetBestBeamId (GeoCoordinate coord) const
 
   double bestGain (-100.0);
   uint32_t bestId (0);
+  std::vector<double> gains;
+
+  GetAntennaGains_lin (coord, gains);
 
   for (uint32_t i = 1; i <= NUMBER_OF_BEAMS; ++i)
     {
-      double gain = m_antennaPatternMap.at (i)->GetAntennaGain_lin (coord);
+      double gain = gains[i - 1];
 
       // The antenna pattern has returned a NAN gain. This means
       // that this position is not valid. Return 0, which is not a valid beam id.
@@ -112,4 +145,48 @@ SatAntennaGainPatternContainer::GetBestBeamId (GeoCoordinate coord) const
   return bestId;
 }
 
+void
+SatAntennaGainPatternContainer::GetAntennaGains_lin (GeoCoordinate coord, std::vector<double> &gains) const
+{
+  NS_LOG_FUNCTION (this << coord.GetLatitude () << coord.GetLongitude ());
+
+  gains.resize (NUMBER_OF_BEAMS);
+
+  if (m_beamGains.empty ())
+    {
+      for (uint32_t i = 1; i <= NUMBER_OF_BEAMS; ++i)
+        {
+          gains[i - 1] = m_antennaPatternMap.at (i)->GetAntennaGain_lin (coord);
+        }
+      return;
+    }
+
+  SatAntennaGainPattern::interpolationPoint_s point = m_antennaPatternMap.at (1)->GetInterpolationPoint (coord);
+  uint32_t rowLength = m_antennaPatternMap.at (1)->GetNumOfLongitudes () * NUMBER_OF_BEAMS;
+
+  // Gains of all beams at the corners of the grid box
+  const double *G11 = &m_beamGains[point.gridIndex * NUMBER_OF_BEAMS];
+  const double *G12 = G11 + NUMBER_OF_BEAMS;
+  const double *G21 = G11 + rowLength;
+  const double *G22 = G21 + NUMBER_OF_BEAMS;
+  double *gain = &gains[0];
+
+  // Same interpolation as SatAntennaGainPattern::GetAntennaGain_lin, without branches
+  // so that the compiler may vectorize it over the beams
+  for (uint32_t i = 0; i < NUMBER_OF_BEAMS; ++i)
+    {
+      gain[i] = point.upperLatShare * (point.upperLonShare * G11[i] + point.lowerLonShare * G12[i])
+        + point.lowerLatShare * (point.upperLonShare * G21[i] + point.lowerLonShare * G22[i]);
+    }
+
+  // NaN of any grid point propagates to the interpolated gain
+  for (uint32_t i = 0; i < NUMBER_OF_BEAMS; ++i)
+    {
+      if (std::isnan (gain[i]))
+        {
+          NS_FATAL_ERROR (this << ", some value(s) of the interpolated grid point(s) of beam " << i + 1 << " is/are NAN!");
+        }
+    }
+}
+
 } // namespace ns3
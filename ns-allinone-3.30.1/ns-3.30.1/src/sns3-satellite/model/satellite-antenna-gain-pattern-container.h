@@ -36,6 +36,11 @@ namespace ns3 {
  * Each antenna gain pattern is stored in a separate class
  * SatAntennaGainPattern. The best beam may be chosen based on
  * the antenna patterns by using GetBestBeamId for a given position.
+ *
+ * When all the patterns are sampled on the same grid, their gains are
+ * also stored interleaved, the gains of all beams for a grid point next to
+ * each other, so that the gains of all beams for a position are interpolated
+ * with the same weights in one pass over contiguous memory.
  */
 class SatAntennaGainPatternContainer : public Object
 {
@@ -75,6 +80,13 @@ public:
    */
   uint32_t GetBestBeamId (GeoCoordinate coord) const;
 
+  /**
+   * \brief Get the antenna gains of all beams in a specified geo coordinate
+   * \param coord Geo coordinate
+   * \param gains Gains in linear format, the gain of beam id i at i - 1
+   */
+  void GetAntennaGains_lin (GeoCoordinate coord, std::vector<double> &gains) const;
+
 private:
   /**
    * \brief Definition of number of beams (72-beam reference scenario).
@@ -88,6 +100,13 @@ private:
    */
   std::map< uint32_t, Ptr<SatAntennaGainPattern> > m_antennaPatternMap;
 
+  /**
+   * Gains of all beams in linear format, the gain of beam id i at grid point
+   * j is at j * NUMBER_OF_BEAMS + i - 1. Empty if the patterns are not sampled
+   * on the same grid.
+   */
+  std::vector<double> m_beamGains;
+
 };
 
 } // namespace ns3
@@ -23,6 +23,7 @@
 #include "ns3/double.h"
 #include "ns3/log.h"
 #include "satellite-utils.h"
+#include "satellite-mobility-model.h"
 #include "satellite-antenna-gain-pattern.h"
 
 NS_LOG_COMPONENT_DEFINE ("SatAntennaGainPattern");
@@ -58,6 +59,7 @@ SatAntennaGainPattern::GetInstanceTypeId (void) const
 
 SatAntennaGainPattern::SatAntennaGainPattern ()
   : m_antennaPattern (),
+    m_gainCache (),
     m_validPositions (),
     m_minAcceptableAntennaGainInDb (40.0),
     m_uniformRandomVariable (),
@@ -107,8 +109,8 @@ void SatAntennaGainPattern::ReadAntennaPatternFromFile (std::string filePathName
         }
     }
 
-  // Row vector containing all the gain values for a certain latitude
-  std::vector<double> rowVector;
+  // Number of gain values read for the current latitude
+  uint32_t rowLength (0);
 
   // Start conditions
   double lat, lon, gainDouble;
@@ -176,28 +178,26 @@ void SatAntennaGainPattern::ReadAntennaPatternFromFile (std::string filePathName
         }
 
       // If this is the first gain entry
-      if (rowVector.empty ())
+      if (m_antennaPattern.empty ())
         {
           m_minLat = lat;
           m_minLon = lon;
-          rowVector.push_back (gainDouble);
         }
-      // We are still in the same row (= latitude)
-      else if (lat == m_maxLat)
+      // Latitude changed, the previous row has to be complete
+      else if (lat != m_maxLat)
         {
-          rowVector.push_back (gainDouble);
-        }
-      // Latitude changed
-      // - Store the vector
-      // - Clean-up
-      // - Start from another row
-      else
-        {
-          m_antennaPattern.push_back (rowVector);
-          rowVector.clear ();
-          rowVector.push_back (gainDouble);
+          if (rowLength != m_longitudes.size ())
+            {
+              NS_FATAL_ERROR ("SatAntennaGainPattern::ReadAntennaPatternFromFile - latitude " << m_maxLat << " has " << rowLength <<
+                              " longitudes instead of " << m_longitudes.size ());
+            }
+          rowLength = 0;
         }
 
+      // The interpolation is done in linear domain, NaN values stay NaN
+      m_antennaPattern.push_back (SatUtils::DbToLinear (gainDouble));
+      rowLength++;
+
       // Update the maximum values
       m_maxLat = lat;
       m_maxLon = lon;
@@ -206,12 +206,9 @@ void SatAntennaGainPattern::ReadAntennaPatternFromFile (std::string filePathName
       *ifs >> lat >> lon >> gainString;
     }
 
-  // At this point, the last row should not be stored, since the storing
-  // happens every time the row changes. I.e. the last row is stored here!
-  NS_ASSERT ( rowVector.size () == m_longitudes.size ());
-
-  m_antennaPattern.push_back (rowVector);
-  rowVector.clear ();
+  // The rows are checked every time the row changes, i.e. the last row is checked here!
+  NS_ASSERT ( rowLength == m_longitudes.size ());
+  NS_ASSERT ( m_antennaPattern.size () == m_latitudes.size () * m_longitudes.size ());
 
   ifs->close ();
   delete ifs;
@@ -272,10 +269,9 @@ GeoCoordinate SatAntennaGainPattern::GetValidRandomPosition () const
 }
 
 
-double SatAntennaGainPattern::GetAntennaGain_lin (GeoCoordinate coord) const
+SatAntennaGainPattern::interpolationPoint_s
+SatAntennaGainPattern::GetInterpolationPoint (GeoCoordinate coord) const
 {
-  NS_LOG_FUNCTION (this << coord.GetLatitude () << coord.GetLongitude ());
-
   // Get the requested position {latitude, longitude}
   double latitude = coord.GetLatitude ();
   double longitude = coord.GetLongitude ();
@@ -289,20 +285,12 @@ double SatAntennaGainPattern::GetAntennaGain_lin (GeoCoordinate coord) const
       NS_FATAL_ERROR (this << " given latitude and longitude out of range!");
     }
 
-  // Calculate the minimum grid point {minLatIndex, minLonIndex} for the given {latitude, longitude} point
+  // Calculate the minimum grid point {minLatIndex, minLonIndex} for the given {latitude, longitude} point.
+  // A point on the maximum latitude or longitude is interpolated in the last grid box.
   uint32_t minLatIndex = (uint32_t)(std::floor (std::abs (latitude - m_minLat) / m_latInterval));
   uint32_t minLonIndex = (uint32_t)(std::floor (std::abs (longitude - m_minLon) / m_lonInterval));
-
-  // All the values within the grid box has to be valid! If UT is placed (or
-  // is moving outside) the valid simulation area, the simulation will crash
-  // to a fatal error.
-  if (std::isnan (m_antennaPattern[minLatIndex][minLonIndex])
-      || std::isnan (m_antennaPattern[minLatIndex][minLonIndex + 1])
-      || std::isnan (m_antennaPattern[minLatIndex + 1][minLonIndex])
-      || std::isnan (m_antennaPattern[minLatIndex + 1][minLonIndex + 1]))
-    {
-      NS_FATAL_ERROR (this << ", some value(s) of the interpolated grid point(s) is/are NAN!");
-    }
+  minLatIndex = std::min<uint32_t> (minLatIndex, m_latitudes.size () - 2);
+  minLonIndex = std::min<uint32_t> (minLonIndex, m_longitudes.size () - 2);
 
   /**
    * 4-point bilinear interpolation
@@ -310,47 +298,97 @@ double SatAntennaGainPattern::GetAntennaGain_lin (GeoCoordinate coord) const
    * R(x,y2) = (x2 - x)/(x2 - x1) * Q(x1,y2)) + (x - x1)/(x2 - x1) * Q(x2,y2);
    * R = (y2 - y)/(y2 - y1) * R(x,y1) + (y - y1)/(y2 - y1) * R(x,y2);
    */
+  interpolationPoint_s point;
+  point.gridIndex = minLatIndex * m_longitudes.size () + minLonIndex;
+  point.upperLonShare = (m_longitudes[minLonIndex + 1] - longitude) / m_lonInterval;
+  point.lowerLonShare = (longitude - m_longitudes[minLonIndex]) / m_lonInterval;
+  point.upperLatShare = (m_latitudes[minLatIndex + 1] - latitude) / m_latInterval;
+  point.lowerLatShare = (latitude - m_latitudes[minLatIndex]) / m_latInterval;
+
+  return point;
+}
 
-  // Longitude direction with latitude minLatIndex
-  double upperLonShare = (m_longitudes[minLonIndex + 1] - longitude) / m_lonInterval;
-  double lowerLonShare = (longitude - m_longitudes[minLonIndex]) / m_lonInterval;
+double SatAntennaGainPattern::GetAntennaGain_lin (GeoCoordinate coord) const
+{
+  NS_LOG_FUNCTION (this << coord.GetLatitude () << coord.GetLongitude ());
+
+  interpolationPoint_s point = GetInterpolationPoint (coord);
 
-  // Change the gains to linear values , because the interpolation is done in linear domain.
-  double G11 = SatUtils::DbToLinear ( m_antennaPattern[minLatIndex][minLonIndex] );
-  double G12 = SatUtils::DbToLinear ( m_antennaPattern[minLatIndex][minLonIndex + 1] );
-  double G21 = SatUtils::DbToLinear ( m_antennaPattern[minLatIndex + 1][minLonIndex] );
-  double G22 = SatUtils::DbToLinear ( m_antennaPattern[minLatIndex + 1][minLonIndex + 1] );
+  // Gains of the grid box, already in linear format
+  const double *lower = &m_antennaPattern[point.gridIndex];
+  const double *upper = lower + m_longitudes.size ();
+
+  // All the values within the grid box has to be valid! If UT is placed (or
+  // is moving outside) the valid simulation area, the simulation will crash
+  // to a fatal error.
+  if (std::isnan (lower[0]) || std::isnan (lower[1]) || std::isnan (upper[0]) || std::isnan (upper[1]))
+    {
+      NS_FATAL_ERROR (this << ", some value(s) of the interpolated grid point(s) is/are NAN!");
+    }
 
   // Longitude direction with latitude minLatIndex
-  double valLatLower = upperLonShare * G11 + lowerLonShare * G12;
+  double valLatLower = point.upperLonShare * lower[0] + point.lowerLonShare * lower[1];
 
   // Longitude direction with latitude minLatIndex+1
-  double valLatUpper = upperLonShare * G21 + lowerLonShare * G22;
+  double valLatUpper = point.upperLonShare * upper[0] + point.lowerLonShare * upper[1];
 
   // Latitude direction with longitude "longitude"
-  double gain = ((m_latitudes[minLatIndex + 1] - latitude) / m_latInterval) * valLatLower +
-    ((latitude - m_latitudes[minLatIndex]) / m_latInterval) * valLatUpper;
-
-  /*
-  std::cout << "minLonIndex = " << minLonIndex <<
-      ", minLatIndex = " << minLatIndex <<
-      ", m_lonInterval = " << m_lonInterval <<
-      ", m_LatInterval = " << m_latInterval <<
-      ", x1 = " << m_longitudes[minLonIndex] <<
-      ", y1 = " << m_latitudes[minLatIndex] <<
-      ", x2 = " << m_longitudes[minLonIndex+1] <<
-      ", y2 = " << m_latitudes[minLatIndex+1] <<
-      ", G(x1,y1) = " << m_antennaPattern[minLatIndex][minLonIndex] <<
-      ", G(x1,y2) = " << m_antennaPattern[minLatIndex+1][minLonIndex] <<
-      ", G(x2,y1) = " << m_antennaPattern[minLatIndex][minLonIndex+1] <<
-      ", G(x2,y2) = " << m_antennaPattern[minLatIndex+1][minLonIndex+1] <<
-      ", x = " << longitude <<
-      ", y = " << latitude <<
-      ", interpolated gain: " << gain << std::endl;
-   */
+  double gain = point.upperLatShare * valLatLower + point.lowerLatShare * valLatUpper;
+
   return gain;
 }
 
+double SatAntennaGainPattern::GetAntennaGain_lin (Ptr<SatMobilityModel> mobility) const
+{
+  NS_LOG_FUNCTION (this << mobility);
+
+  GeoCoordinate coord = mobility->GetGeoPosition ();
+  std::map<const SatMobilityModel *, cachedGain_s>::iterator it = m_gainCache.find (PeekPointer (mobility));
+
+  // The gain is valid as long as the mobility model has not moved
+  if (it != m_gainCache.end ()
+      && it->second.latitude == coord.GetLatitude ()
+      && it->second.longitude == coord.GetLongitude ())
+    {
+      return it->second.gain;
+    }
+
+  cachedGain_s entry;
+  entry.latitude = coord.GetLatitude ();
+  entry.longitude = coord.GetLongitude ();
+  entry.gain = GetAntennaGain_lin (coord);
+  m_gainCache[PeekPointer (mobility)] = entry;
+
+  return entry.gain;
+}
+
+uint32_t
+SatAntennaGainPattern::GetNumOfLongitudes () const
+{
+  return m_longitudes.size ();
+}
+
+uint32_t
+SatAntennaGainPattern::GetNumOfGridPoints () const
+{
+  return m_antennaPattern.size ();
+}
 
+double
+SatAntennaGainPattern::GetGridGain_lin (uint32_t gridIndex) const
+{
+  NS_ASSERT (gridIndex < m_antennaPattern.size ());
+
+  return m_antennaPattern[gridIndex];
+}
+
+bool
+SatAntennaGainPattern::HasSameGrid (Ptr<const SatAntennaGainPattern> pattern) const
+{
+  return m_latitudes == pattern->m_latitudes
+         && m_longitudes == pattern->m_longitudes
+         && m_latInterval == pattern->m_latInterval
+         && m_lonInterval == pattern->m_lonInterval;
+}
 
 } // namespace ns3
@@ -23,27 +23,33 @@
 
 #include <vector>
 #include <fstream>
+#include <map>
 #include "ns3/random-variable-stream.h"
 #include "ns3/object.h"
 #include "geo-coordinate.h"
 
 namespace ns3 {
 
+class SatMobilityModel;
+
 /**
  * \ingroup satellite
  * \brief SatAntennaGainPattern class holds the antenna gain pattern data
  * for a one single spot-beam. In initialization phase, the gain pattern
  * is read from a file to a container. Current implementation assumes
  * that the antenna pattern is using a constant longitude-latitude grid of
- * samples. This assumption is made to enable fast look-ups from the container
- * (= vector<vector<double>>).
+ * samples. This assumption is made to enable fast look-ups from the container,
+ * a flat latitude-major vector of the gains converted to linear format when the
+ * file is read.
  *
  * Antenna gain patter is used also for spot-beam selection. In initialization phase
  * a valid positions list is constructed based on a minimum accepted antenna gain set
  * as an attribute. This approach is selected to speed up the random UT positioning.
  *
  * Antenna gain value for a given longitude and latitude position is calculated by
- * using 4-point bilinear interpolation.
+ * using 4-point bilinear interpolation. The gains of the positions of mobility
+ * models are cached, an entry is used as long as the mobility model is at the
+ * position the gain was calculated for.
  */
 class SatAntennaGainPattern : public Object
 {
@@ -81,6 +87,60 @@ public:
    */
   double GetAntennaGain_lin (GeoCoordinate coord) const;
 
+  /**
+   * \brief Get the antenna gain value at the current position of a mobility model.
+   * The gain is calculated only when the position has changed since the last call
+   * with the same mobility model.
+   * \param mobility Mobility model
+   * \return The gain value in linear format
+   */
+  double GetAntennaGain_lin (Ptr<SatMobilityModel> mobility) const;
+
+  /**
+   * \brief Grid point and bilinear interpolation weights of a {latitude, longitude} point
+   */
+  typedef struct
+  {
+    uint32_t gridIndex;       ///< index of the lower left corner of the grid box in the flat grid
+    double upperLonShare;     ///< weight of the lower longitude of the grid box
+    double lowerLonShare;     ///< weight of the upper longitude of the grid box
+    double upperLatShare;     ///< weight of the lower latitude of the grid box
+    double lowerLatShare;     ///< weight of the upper latitude of the grid box
+  } interpolationPoint_s;
+
+  /**
+   * \brief Get the grid box and interpolation weights of a {latitude, longitude} point
+   * \param coord Geo coordinate inside the pattern
+   * \return Interpolation point
+   */
+  interpolationPoint_s GetInterpolationPoint (GeoCoordinate coord) const;
+
+  /**
+   * \brief Get the number of longitudes in a row of the flat grid
+   * \return Number of longitudes
+   */
+  uint32_t GetNumOfLongitudes () const;
+
+  /**
+   * \brief Get the number of points of the flat grid
+   * \return Number of grid points
+   */
+  uint32_t GetNumOfGridPoints () const;
+
+  /**
+   * \brief Get the gain of a point of the flat grid
+   * \param gridIndex Index of the grid point, latitude-major
+   * \return The gain value in linear format, NaN if not valid
+   */
+  double GetGridGain_lin (uint32_t gridIndex) const;
+
+  /**
+   * \brief Check whether another pattern is sampled on the same grid
+   * \param pattern Antenna gain pattern
+   * \return true if the latitudes and longitudes of the grids are identical
+   */
+  bool HasSameGrid (Ptr<const SatAntennaGainPattern> pattern) const;
+
   /**
    * \brief Get a valid random position under this spot-beam coverage.
    * \return A valid random GeoCoordinate
@@ -95,11 +155,27 @@ private:
   void ReadAntennaPatternFromFile (std::string filePathName);
 
   /**
-   * Container for the antenna pattern from one spot-beam
-   * - Outer vector holds gain values for all latitudes
-   * - Inner vector holds gain values for all longitudes for a certain latitude
+   * Container for the antenna pattern from one spot-beam in linear format. The
+   * gain of latitude i and longitude j is at i * m_longitudes.size () + j.
+   */
+  std::vector<double> m_antennaPattern;
+
+  /**
+   * \brief Cached gain of a position
+   */
+  typedef struct
+  {
+    double latitude;
+    double longitude;
+    double gain;
+  } cachedGain_s;
+
+  /**
+   * Gains of the last positions of the mobility models. The models are only used
+   * as keys: an entry is checked against the position, so an entry left by a
+   * destroyed model is harmless to a new model at the same address.
    */
-  std::vector< std::vector <double> > m_antennaPattern;
+  mutable std::map<const SatMobilityModel *, cachedGain_s> m_gainCache;
 
   /**
    * Container for valid positions
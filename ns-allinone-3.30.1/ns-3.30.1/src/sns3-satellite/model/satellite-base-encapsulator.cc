@@ -79,6 +79,7 @@ SatBaseEncapsulator::DoDispose ()
     }
   m_rxCallback.Nullify ();
   m_ctrlCallback.Nullify ();
+  m_bufferChangedCallback.Nullify ();
 }
 
 void
@@ -104,6 +105,8 @@ SatBaseEncapsulator::EnquePdu (Ptr<Packet> p, Mac48Address dest)
       NS_LOG_INFO ("Packet is dropped!");
     }
 
+  NotifyBufferChanged ();
+
   NS_LOG_INFO ("NumPackets = " << m_txQueue->GetNPackets () );
   NS_LOG_INFO ("NumBytes = " << m_txQueue->GetNBytes ());
 }
@@ -154,6 +157,8 @@ SatBaseEncapsulator::NotifyTxOpportunity (uint32_t bytes, uint32_t &bytesLeft, u
         {
           nextMinTxO = 0;
         }
+
+      NotifyBufferChanged ();
     }
 
   return packet;
@@ -228,6 +233,39 @@ SatBaseEncapsulator::SetCtrlMsgCallback (SatBaseEncapsulator::SendCtrlCallback c
   m_ctrlCallback = cb;
 }
 
+void
+SatBaseEncapsulator::SetBufferChangedCallback (SatBaseEncapsulator::BufferChangedCallback cb)
+{
+  NS_LOG_FUNCTION (this << &cb);
+
+  m_bufferChangedCallback = cb;
+}
+
+void
+SatBaseEncapsulator::NotifyBufferChanged ()
+{
+  NS_LOG_FUNCTION (this);
+
+  if (!m_bufferChangedCallback.IsNull ())
+    {
+      uint32_t bytes = GetTxBufferSizeInBytes ();
+      uint32_t minTxOpportunity = 0;
+      Time holTimestamp = Time::Max ();
+
+      if (bytes > 0)
+        {
+          minTxOpportunity = GetMinTxOpportunityInBytes ();
+        }
+
+      if (!m_txQueue->IsEmpty ())
+        {
+          holTimestamp = Simulator::Now () - GetHolDelay ();
+        }
+
+      m_bufferChangedCallback (m_destAddress, m_flowId, bytes, minTxOpportunity, holTimestamp);
+    }
+}
+
 void
 SatBaseEncapsulator::SetQueue (Ptr<SatQueue> queue)
 {
@@ -96,6 +96,17 @@ public:
    */
   typedef Callback<bool, Ptr<SatControlMessage>, const Address& > SendCtrlCallback;
 
+  /**
+   * Callback to notify that the buffered data of the encapsulator has changed.
+   * \param Mac48Address Destination MAC address
+   * \param uint8_t Flow identifier
+   * \param uint32_t Buffered bytes
+   * \param uint32_t Minimum Tx opportunity in bytes, zero if nothing is buffered
+   * \param Time Arrival time of the head-of-line packet, Time::Max () if the
+   *        queue is empty
+   */
+  typedef Callback<void, Mac48Address, uint8_t, uint32_t, uint32_t, Time> BufferChangedCallback;
+
   /**
    * Set the used queue from outside
    * \param queue Transmission queue
@@ -120,6 +131,14 @@ public:
    */
   void SetCtrlMsgCallback (SatBaseEncapsulator::SendCtrlCallback cb);
 
+  /**
+   * Method to set buffer changed callback. The callback is invoked
+   * whenever the buffered bytes, the minimum Tx opportunity or the
+   * head-of-line packet of the encapsulator may have changed.
+   * \param cb callback to notify the buffer changes.
+   */
+  void SetBufferChangedCallback (SatBaseEncapsulator::BufferChangedCallback cb);
+
   /**
    * Enqueue a packet to txBuffer.
    * \param p To be buffered packet
@@ -172,6 +191,12 @@ public:
   virtual uint32_t GetMinTxOpportunityInBytes () const;
 
 protected:
+  /**
+   * Notify the current buffer status with the buffer changed callback,
+   * if the callback has been set.
+   */
+  void NotifyBufferChanged ();
+
   /**
    * Source and destination mac addresses. Used to tag the Frame PDU
    * so that lower layers are capable of passing the packet to the
@@ -200,6 +225,11 @@ protected:
   */
   SendCtrlCallback m_ctrlCallback;
 
+  /**
+   * Callback to notify the buffer changes.
+   */
+  BufferChangedCallback m_bufferChangedCallback;
+
 };
 
 
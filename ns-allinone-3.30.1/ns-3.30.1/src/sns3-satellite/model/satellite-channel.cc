@@ -47,9 +47,19 @@ namespace ns3 {
 
 NS_OBJECT_ENSURE_REGISTERED (SatChannel);
 
+/// Whether two positions are exactly the same
+static bool
+IsSamePosition (const Vector &a, const Vector &b)
+{
+  return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
 SatChannel::SatChannel ()
   : m_fwdMode (SatChannel::ALL_BEAMS),
     m_phyRxContainer (),
+    m_beamRxIndex (),
+    m_addressRxIndex (),
+    m_rxIndexValid (false),
     m_channelType (SatEnums::UNKNOWN_CH),
     m_carrierFreqConverter (),
     m_freqId (),
@@ -65,7 +75,9 @@ SatChannel::SatChannel ()
      */
     m_enableRxPowerOutputTrace (false),
     m_enableFadingOutputTrace (false),
-    m_enableExternalFadingInputTrace (false)
+    m_enableExternalFadingInputTrace (false),
+    m_enableLinkBudgetCache (true),
+    m_linkBudgets ()
 {
   NS_LOG_FUNCTION (this);
 }
@@ -80,6 +92,10 @@ SatChannel::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
   m_phyRxContainer.clear ();
+  m_beamRxIndex.clear ();
+  m_addressRxIndex.clear ();
+  m_rxIndexValid = false;
+  m_linkBudgets.clear ();
   m_propagationDelay = 0;
   Channel::DoDispose ();
 }
@@ -105,6 +121,11 @@ SatChannel::GetTypeId (void)
                     BooleanValue (false),
                     MakeBooleanAccessor (&SatChannel::m_enableExternalFadingInputTrace),
                     MakeBooleanChecker ())
+    .AddAttribute ( "EnableLinkBudgetCache",
+                    "Enable caching of antenna gains, free space loss and external fading trace of the links between bursts.",
+                    BooleanValue (true),
+                    MakeBooleanAccessor (&SatChannel::m_enableLinkBudgetCache),
+                    MakeBooleanChecker ())
     .AddAttribute ("RxPowerCalculationMode",
                    "Rx Power calculation mode",
                    EnumValue (SatEnums::RX_PWR_CALCULATION),
@@ -127,6 +148,7 @@ SatChannel::AddRx (Ptr<SatPhyRx> phyRx)
 {
   NS_LOG_FUNCTION (this << phyRx);
   m_phyRxContainer.push_back (phyRx);
+  m_rxIndexValid = false;
 }
 
 void
@@ -139,7 +161,57 @@ SatChannel::RemoveRx (Ptr<SatPhyRx> phyRx)
   if (phyIter != m_phyRxContainer.end ()) // == vector.end() means the element was not found
     {
       m_phyRxContainer.erase (phyIter);
+      m_rxIndexValid = false;
+
+      for (LinkBudgetMap_t::iterator it = m_linkBudgets.begin (); it != m_linkBudgets.end (); )
+        {
+          if (it->first.first.second == phyRx)
+            {
+              m_linkBudgets.erase (it++);
+            }
+          else
+            {
+              ++it;
+            }
+        }
+    }
+}
+
+const std::vector<uint32_t> &
+SatChannel::GetBeamRx (uint32_t beamId)
+{
+  NS_LOG_FUNCTION (this << beamId);
+
+  if (!m_rxIndexValid)
+    {
+      UpdateRxIndex ();
+    }
+
+  RxIndexBeamMap_t::const_iterator beamRx = m_beamRxIndex.find (beamId);
+  if (beamRx == m_beamRxIndex.end ())
+    {
+      static const std::vector<uint32_t> noRx;
+      return noRx;
+    }
+
+  return beamRx->second;
+}
+
+void
+SatChannel::UpdateRxIndex ()
+{
+  NS_LOG_FUNCTION (this);
+
+  m_beamRxIndex.clear ();
+  m_addressRxIndex.clear ();
+
+  for (uint32_t i = 0; i < m_phyRxContainer.size (); i++)
+    {
+      m_beamRxIndex[m_phyRxContainer[i]->GetBeamId ()].push_back (i);
+      m_addressRxIndex[m_phyRxContainer[i]->GetAddress ()].push_back (i);
     }
+
+  m_rxIndexValid = true;
 }
 
 void
@@ -158,60 +230,85 @@ SatChannel::StartTx (Ptr<SatSignalParameters> txParams)
     */
     case SatChannel::ONLY_DEST_NODE:
       {
-        // For all receivers
-        for (PhyRxContainer::const_iterator rxPhyIterator = m_phyRxContainer.begin ();
-             rxPhyIterator != m_phyRxContainer.end ();
-             ++rxPhyIterator)
+        const std::vector<uint32_t> &beamRx = GetBeamRx (txParams->m_beamId);
+
+        switch (m_channelType)
           {
-            // If the same beam
-            if ( (*rxPhyIterator)->GetBeamId () == txParams->m_beamId )
-              {
-                switch (m_channelType)
-                  {
-                  // If the destination is satellite
-                  case SatEnums::FORWARD_FEEDER_CH:
-                  case SatEnums::RETURN_USER_CH:
+          // If the destination is satellite
+          case SatEnums::FORWARD_FEEDER_CH:
+          case SatEnums::RETURN_USER_CH:
+            {
+              // The packet burst is passed on to the satellite receivers of the beam
+              for (std::vector<uint32_t>::const_iterator it = beamRx.begin (); it != beamRx.end (); ++it)
+                {
+                  ScheduleRx (txParams, m_phyRxContainer[*it]);
+                }
+              break;
+            }
+          // If the destination is terrestrial node
+          case SatEnums::FORWARD_USER_CH:
+          case SatEnums::RETURN_FEEDER_CH:
+            {
+              // Go through the packets and collect the receivers of their destination
+              // addresses by peeking the MAC tag. A broadcast or group destination is
+              // received by all the receivers of the beam.
+              std::vector<uint32_t> destRx;
+              bool allRx = false;
+              SatSignalParameters::PacketsInBurst_t::const_iterator it = txParams->m_packetsInBurst.begin ();
+              for (; it != txParams->m_packetsInBurst.end () && !allRx; ++it )
+                {
+                  SatMacTag macTag;
+                  bool mSuccess = (*it)->PeekPacketTag (macTag);
+                  if (!mSuccess)
                     {
-                      // The packet burst is passed on to the satellite receiver
-                      ScheduleRx (txParams, *rxPhyIterator);
-                      break;
+                      NS_FATAL_ERROR ("MAC tag was not found from the packet!");
                     }
-                  // If the destination is terrestrial node
-                  case SatEnums::FORWARD_USER_CH:
-                  case SatEnums::RETURN_FEEDER_CH:
-                    {
-                      // Go through the packets and check their destination address by peeking the MAC tag
-                      SatSignalParameters::PacketsInBurst_t::const_iterator it = txParams->m_packetsInBurst.begin ();
-                      for (; it != txParams->m_packetsInBurst.end (); ++it )
-                        {
-                          SatMacTag macTag;
-                          bool mSuccess = (*it)->PeekPacketTag (macTag);
-                          if (!mSuccess)
-                            {
-                              NS_FATAL_ERROR ("MAC tag was not found from the packet!");
-                            }
 
-                          Mac48Address dest = macTag.GetDestAddress ();
+                  Mac48Address dest = macTag.GetDestAddress ();
 
-                          // If the packet destination is the same as the receiver MAC
-                          if (dest == (*rxPhyIterator)->GetAddress () || dest.IsBroadcast () || dest.IsGroup ())
+                  if (dest.IsBroadcast () || dest.IsGroup ())
+                    {
+                      allRx = true;
+                    }
+                  else
+                    {
+                      RxIndexMap_t::const_iterator addressRx = m_addressRxIndex.find (dest);
+                      if (addressRx != m_addressRxIndex.end ())
+                        {
+                          for (std::vector<uint32_t>::const_iterator i = addressRx->second.begin (); i != addressRx->second.end (); ++i)
                             {
-                              ScheduleRx (txParams, *rxPhyIterator);
-
-                              // Remember to break the packet loop, so that the transmission
-                              // is not received several times!
-                              break;
+                              if (m_phyRxContainer[*i]->GetBeamId () == txParams->m_beamId)
+                                {
+                                  destRx.push_back (*i);
+                                }
                             }
                         }
-                      break;
-                    }
-                  default:
-                    {
-                      NS_FATAL_ERROR ("Unsupported channel type!");
-                      break;
                     }
-                  }
-              }
+                }
+
+              if (allRx)
+                {
+                  destRx = beamRx;
+                }
+              else
+                {
+                  // Each receiver receives the transmission only once, in the order
+                  // the receivers were added to the channel
+                  std::sort (destRx.begin (), destRx.end ());
+                  destRx.erase (std::unique (destRx.begin (), destRx.end ()), destRx.end ());
+                }
+
+              for (std::vector<uint32_t>::const_iterator i = destRx.begin (); i != destRx.end (); ++i)
+                {
+                  ScheduleRx (txParams, m_phyRxContainer[*i]);
+                }
+              break;
+            }
+          default:
+            {
+              NS_FATAL_ERROR ("Unsupported channel type!");
+              break;
+            }
           }
         break;
       }
@@ -222,15 +319,10 @@ SatChannel::StartTx (Ptr<SatSignalParameters> txParams)
     */
     case SatChannel::ONLY_DEST_BEAM:
       {
-        for (PhyRxContainer::const_iterator rxPhyIterator = m_phyRxContainer.begin ();
-             rxPhyIterator != m_phyRxContainer.end ();
-             ++rxPhyIterator)
+        const std::vector<uint32_t> &beamRx = GetBeamRx (txParams->m_beamId);
+        for (std::vector<uint32_t>::const_iterator it = beamRx.begin (); it != beamRx.end (); ++it)
           {
-            // If the same beam
-            if ( (*rxPhyIterator)->GetBeamId () == txParams->m_beamId )
-              {
-                ScheduleRx (txParams, *rxPhyIterator);
-              }
+            ScheduleRx (txParams, m_phyRxContainer[*it]);
           }
         break;
       }
@@ -268,8 +360,23 @@ SatChannel::ScheduleRx (Ptr<SatSignalParameters> txParams, Ptr<SatPhyRx> receive
   Ptr<MobilityModel> senderMobility = txParams->m_phyTx->GetMobility ();
   Ptr<MobilityModel> receiverMobility = receiver->GetMobility ();
 
-  NS_LOG_INFO ("copying signal parameters " << txParams);
-  Ptr<SatSignalParameters> rxParams = txParams->Copy ();
+  /**
+   * Only the receivers in the beam of the transmission may receive the packets,
+   * the receivers of other beams see the transmission only as interference and
+   * never modify the packets. Thus, the packets are copied only for the receivers
+   * in the same beam and shared with all the other ones.
+   */
+  Ptr<SatSignalParameters> rxParams;
+  if (receiver->GetBeamId () == txParams->m_beamId)
+    {
+      NS_LOG_INFO ("copying signal parameters " << txParams);
+      rxParams = txParams->Copy ();
+    }
+  else
+    {
+      NS_LOG_INFO ("copying signal parameters " << txParams << " for interference");
+      rxParams = txParams->CopyForInterference ();
+    }
 
   if (m_propagationDelay)
     {
@@ -339,7 +446,15 @@ SatChannel::StartRx (Ptr<SatSignalParameters> rxParams, Ptr<SatPhyRx> phyRx)
     {
     case SatEnums::RX_PWR_CALCULATION:
       {
-        DoRxPowerCalculation (rxParams, phyRx);
+        if (m_enableLinkBudgetCache)
+          {
+            DoRxPowerCalculation (rxParams, phyRx, GetLinkBudget (rxParams, phyRx));
+          }
+        else
+          {
+            linkBudget_s linkBudget = linkBudget_s ();
+            DoRxPowerCalculation (rxParams, phyRx, linkBudget);
+          }
 
         if (m_enableRxPowerOutputTrace)
           {
@@ -375,24 +490,31 @@ SatChannel::DoRxPowerOutputTrace (Ptr<SatSignalParameters> rxParams, Ptr<SatPhyR
                 ", carrierId: " << rxParams->m_carrierId <<
                 ", channelType: " << SatEnums::GetChannelTypeName (m_channelType));
 
-  std::vector<double> tempVector;
-  tempVector.push_back (Now ().GetSeconds ());
-
-  // Output the Rx power density (W / Hz)
-  tempVector.push_back (rxParams->m_rxPower_W / carrierBandwidthHz);
+  Ptr<SatOutputFileStreamDoubleContainer> traceContainer;
 
+  // the container is kept by the PHY of the UT or GW end of the link, so it is looked up only once
   switch (m_channelType)
     {
     case SatEnums::RETURN_FEEDER_CH:
     case SatEnums::FORWARD_USER_CH:
       {
-        Singleton<SatRxPowerOutputTraceContainer>::Get ()->AddToContainer (std::make_pair (phyRx->GetDevice ()->GetAddress (), m_channelType), tempVector);
+        traceContainer = phyRx->GetRxPowerTraceContainer ();
+        if (traceContainer == NULL || !traceContainer->IsWritable ())
+          {
+            traceContainer = Singleton<SatRxPowerOutputTraceContainer>::Get ()->GetNodeContainer (std::make_pair (phyRx->GetDevice ()->GetAddress (), m_channelType));
+            phyRx->SetRxPowerTraceContainer (traceContainer);
+          }
         break;
       }
     case SatEnums::FORWARD_FEEDER_CH:
     case SatEnums::RETURN_USER_CH:
       {
-        Singleton<SatRxPowerOutputTraceContainer>::Get ()->AddToContainer (std::make_pair (GetSourceAddress (rxParams), m_channelType), tempVector);
+        traceContainer = rxParams->m_phyTx->GetRxPowerTraceContainer ();
+        if (traceContainer == NULL || !traceContainer->IsWritable ())
+          {
+            traceContainer = Singleton<SatRxPowerOutputTraceContainer>::Get ()->GetNodeContainer (std::make_pair (GetSourceAddress (rxParams), m_channelType));
+            rxParams->m_phyTx->SetRxPowerTraceContainer (traceContainer);
+          }
         break;
       }
     default:
@@ -401,6 +523,13 @@ SatChannel::DoRxPowerOutputTrace (Ptr<SatSignalParameters> rxParams, Ptr<SatPhyR
         break;
       }
     }
+
+  if (traceContainer != NULL)
+    {
+      // Output the Rx power density (W / Hz)
+      double sample[SatBaseTraceContainer::RX_POWER_TRACE_DEFAULT_NUMBER_OF_COLUMNS] = {Now ().GetSeconds (), rxParams->m_rxPower_W / carrierBandwidthHz};
+      traceContainer->AddToContainer (sample, SatBaseTraceContainer::RX_POWER_TRACE_DEFAULT_NUMBER_OF_COLUMNS);
+    }
 }
 
 void
@@ -452,22 +581,31 @@ SatChannel::DoFadingOutputTrace (Ptr<SatSignalParameters> rxParams, Ptr<SatPhyRx
 {
   NS_LOG_FUNCTION (this << rxParams << phyRx << fadingValue);
 
-  std::vector<double> tempVector;
-  tempVector.push_back (Now ().GetSeconds ());
-  tempVector.push_back (fadingValue);
+  Ptr<SatOutputFileStreamDoubleContainer> traceContainer;
 
+  // the container is kept by the PHY of the UT or GW end of the link, so it is looked up only once
   switch (m_channelType)
     {
     case SatEnums::RETURN_FEEDER_CH:
     case SatEnums::FORWARD_USER_CH:
       {
-        Singleton<SatFadingOutputTraceContainer>::Get ()->AddToContainer (std::make_pair (phyRx->GetDevice ()->GetAddress (), m_channelType), tempVector);
+        traceContainer = phyRx->GetFadingTraceContainer ();
+        if (traceContainer == NULL || !traceContainer->IsWritable ())
+          {
+            traceContainer = Singleton<SatFadingOutputTraceContainer>::Get ()->GetNodeContainer (std::make_pair (phyRx->GetDevice ()->GetAddress (), m_channelType));
+            phyRx->SetFadingTraceContainer (traceContainer);
+          }
         break;
       }
     case SatEnums::FORWARD_FEEDER_CH:
     case SatEnums::RETURN_USER_CH:
       {
-        Singleton<SatFadingOutputTraceContainer>::Get ()->AddToContainer (std::make_pair (GetSourceAddress (rxParams), m_channelType), tempVector);
+        traceContainer = rxParams->m_phyTx->GetFadingTraceContainer ();
+        if (traceContainer == NULL || !traceContainer->IsWritable ())
+          {
+            traceContainer = Singleton<SatFadingOutputTraceContainer>::Get ()->GetNodeContainer (std::make_pair (GetSourceAddress (rxParams), m_channelType));
+            rxParams->m_phyTx->SetFadingTraceContainer (traceContainer);
+          }
         break;
       }
     default:
@@ -476,18 +614,55 @@ SatChannel::DoFadingOutputTrace (Ptr<SatSignalParameters> rxParams, Ptr<SatPhyRx
         break;
       }
     }
+
+  if (traceContainer != NULL)
+    {
+      double sample[SatBaseTraceContainer::FADING_TRACE_DEFAULT_NUMBER_OF_COLUMNS] = {Now ().GetSeconds (), fadingValue};
+      traceContainer->AddToContainer (sample, SatBaseTraceContainer::FADING_TRACE_DEFAULT_NUMBER_OF_COLUMNS);
+    }
+}
+
+SatChannel::linkBudget_s &
+SatChannel::GetLinkBudget (Ptr<SatSignalParameters> rxParams, Ptr<SatPhyRx> phyRx)
+{
+  NS_LOG_FUNCTION (this << rxParams << phyRx);
+
+  LinkBudgetKey_t key (std::make_pair (rxParams->m_phyTx, phyRx), rxParams->m_carrierId);
+  LinkBudgetMap_t::iterator it = m_linkBudgets.find (key);
+
+  if (it == m_linkBudgets.end ())
+    {
+      it = m_linkBudgets.insert (std::make_pair (key, linkBudget_s ())).first;
+    }
+
+  return it->second;
 }
 
 void
-SatChannel::DoRxPowerCalculation (Ptr<SatSignalParameters> rxParams, Ptr<SatPhyRx> phyRx)
+SatChannel::DoRxPowerCalculation (Ptr<SatSignalParameters> rxParams, Ptr<SatPhyRx> phyRx, linkBudget_s &linkBudget)
 {
   NS_LOG_FUNCTION (this << rxParams << phyRx);
 
   Ptr<MobilityModel> txMobility = rxParams->m_phyTx->GetMobility ();
   Ptr<MobilityModel> rxMobility = phyRx->GetMobility ();
 
-  double txAntennaGain_W = 0.0;
-  double rxAntennaGain_W = 0.0;
+  bool linkBudgetValid = false;
+
+  if (m_enableLinkBudgetCache)
+    {
+      Vector txPosition = txMobility->GetPosition ();
+      Vector rxPosition = rxMobility->GetPosition ();
+
+      linkBudgetValid = linkBudget.calculated
+        && linkBudget.carrierFreq_hz == rxParams->m_carrierFreq_hz
+        && IsSamePosition (linkBudget.txPosition, txPosition)
+        && IsSamePosition (linkBudget.rxPosition, rxPosition);
+
+      linkBudget.txPosition = txPosition;
+      linkBudget.rxPosition = rxPosition;
+      linkBudget.carrierFreq_hz = rxParams->m_carrierFreq_hz;
+    }
+
   double markovFading = 0.0;
   double extFading = 1.0;
 
@@ -497,16 +672,22 @@ SatChannel::DoRxPowerCalculation (Ptr<SatSignalParameters> rxParams, Ptr<SatPhyR
     case SatEnums::RETURN_FEEDER_CH:
     case SatEnums::FORWARD_USER_CH:
       {
-        txAntennaGain_W = rxParams->m_phyTx->GetAntennaGain (rxMobility);
-        rxAntennaGain_W = phyRx->GetAntennaGain (rxMobility);
+        if (!linkBudgetValid)
+          {
+            linkBudget.txAntennaGain_W = rxParams->m_phyTx->GetAntennaGain (rxMobility);
+            linkBudget.rxAntennaGain_W = phyRx->GetAntennaGain (rxMobility);
+          }
         markovFading = phyRx->GetFadingValue (phyRx->GetDevice ()->GetAddress (), m_channelType);
         break;
       }
     case SatEnums::RETURN_USER_CH:
     case SatEnums::FORWARD_FEEDER_CH:
       {
-        txAntennaGain_W = rxParams->m_phyTx->GetAntennaGain (txMobility);
-        rxAntennaGain_W = phyRx->GetAntennaGain (txMobility);
+        if (!linkBudgetValid)
+          {
+            linkBudget.txAntennaGain_W = rxParams->m_phyTx->GetAntennaGain (txMobility);
+            linkBudget.rxAntennaGain_W = phyRx->GetAntennaGain (txMobility);
+          }
         markovFading = rxParams->m_phyTx->GetFadingValue (GetSourceAddress (rxParams), m_channelType);
         break;
       }
@@ -517,15 +698,26 @@ SatChannel::DoRxPowerCalculation (Ptr<SatSignalParameters> rxParams, Ptr<SatPhyR
       }
     }
 
+  if (!linkBudgetValid)
+    {
+      linkBudget.fsl = m_freeSpaceLoss->GetFsl (txMobility, rxMobility, rxParams->m_carrierFreq_hz);
+      linkBudget.calculated = m_enableLinkBudgetCache;
+    }
+
   /**
    * Get the external (weather) fading trace value from the external
    * fading container. The external fading is considered to be loss, thus
    * it is taken into account at the end of the function by dividing in
-   * linear format.
+   * linear format. The trace of a link stays the same, only its value
+   * changes with time.
    */
   if (m_enableExternalFadingInputTrace)
     {
-      extFading = GetExternalFadingTrace (rxParams, phyRx);
+      if (linkBudget.extFadingTrace == 0 || !m_enableLinkBudgetCache)
+        {
+          linkBudget.extFadingTrace = GetExternalFadingInputTrace (rxParams, phyRx);
+        }
+      extFading = linkBudget.extFadingTrace->GetFading ();
     }
 
   /**
@@ -539,8 +731,8 @@ SatChannel::DoRxPowerCalculation (Ptr<SatSignalParameters> rxParams, Ptr<SatPhyR
     }
 
   // get (calculate) free space loss and RX power and set it to RX params
-  double rxPower_W = (rxParams->m_txPower_W * txAntennaGain_W) / m_freeSpaceLoss->GetFsl (txMobility, rxMobility, rxParams->m_carrierFreq_hz);
-  rxParams->m_rxPower_W = rxPower_W * rxAntennaGain_W / phyRx->GetLosses () * markovFading / extFading;
+  double rxPower_W = (rxParams->m_txPower_W * linkBudget.txAntennaGain_W) / linkBudget.fsl;
+  rxParams->m_rxPower_W = rxPower_W * linkBudget.rxAntennaGain_W / phyRx->GetLosses () * markovFading / extFading;
 }
 
 double
@@ -548,6 +740,14 @@ SatChannel::GetExternalFadingTrace (Ptr<SatSignalParameters> rxParams, Ptr<SatPh
 {
   NS_LOG_FUNCTION (this << rxParams << phyRx);
 
+  return GetExternalFadingInputTrace (rxParams, phyRx)->GetFading ();
+}
+
+Ptr<SatFadingExternalInputTrace>
+SatChannel::GetExternalFadingInputTrace (Ptr<SatSignalParameters> rxParams, Ptr<SatPhyRx> phyRx)
+{
+  NS_LOG_FUNCTION (this << rxParams << phyRx);
+
   int32_t nodeId;
   Ptr<MobilityModel> mobility;
 
@@ -579,17 +779,17 @@ SatChannel::GetExternalFadingTrace (Ptr<SatSignalParameters> rxParams, Ptr<SatPh
       }
     default:
       {
-        NS_FATAL_ERROR ("SatChannel::GetExternalFadingTrace - Invalid channel type");
+        NS_FATAL_ERROR ("SatChannel::GetExternalFadingInputTrace - Invalid channel type");
         break;
       }
     }
 
   if (nodeId < 0)
     {
-      NS_FATAL_ERROR ("SatChannel::GetExternalFadingTrace - Invalid node ID");
+      NS_FATAL_ERROR ("SatChannel::GetExternalFadingInputTrace - Invalid node ID");
     }
 
-  return (Singleton<SatFadingExternalInputTraceContainer>::Get ()->GetFadingTrace ((uint32_t)nodeId, m_channelType, mobility))->GetFading ();
+  return Singleton<SatFadingExternalInputTraceContainer>::Get ()->GetFadingTrace ((uint32_t)nodeId, m_channelType, mobility);
 }
 
 /// TODO get rid of source MAC address peeking
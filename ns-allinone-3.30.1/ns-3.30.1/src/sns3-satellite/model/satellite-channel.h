@@ -22,11 +22,16 @@
 #ifndef SATELLITE_CHANNEL_H
 #define SATELLITE_CHANNEL_H
 
+#include <map>
+#include <vector>
+
 #include "ns3/object.h"
 #include "ns3/nstime.h"
 #include "ns3/channel.h"
 #include "ns3/traced-callback.h"
 #include "ns3/propagation-delay-model.h"
+#include "ns3/mac48-address.h"
+#include "ns3/vector.h"
 #include "satellite-signal-parameters.h"
 #include "satellite-free-space-loss.h"
 #include "satellite-phy-rx.h"
@@ -36,6 +41,9 @@
 
 namespace ns3 {
 
+class SatPhyTx;
+class SatFadingExternalInputTrace;
+
 /**
  * \ingroup satellite
  *
@@ -199,6 +207,36 @@ private:
    */
   PhyRxContainer m_phyRxContainer;
 
+  /**
+   * Define type RxIndexBeamMap_t, beam ID to the positions of its receivers
+   * in m_phyRxContainer
+   */
+  typedef std::map<uint32_t, std::vector<uint32_t> > RxIndexBeamMap_t;
+
+  /**
+   * Define type RxIndexMap_t, MAC address to the positions of its receivers
+   * in m_phyRxContainer
+   */
+  typedef std::map<Mac48Address, std::vector<uint32_t> > RxIndexMap_t;
+
+  /**
+   * \brief Receivers of every beam, in the order they were added to the channel
+   */
+  RxIndexBeamMap_t m_beamRxIndex;
+
+  /**
+   * \brief Receivers of every MAC address, in the order they were added to the channel
+   */
+  RxIndexMap_t m_addressRxIndex;
+
+  /**
+   * \brief Whether m_beamRxIndex and m_addressRxIndex match m_phyRxContainer.
+   * The indices are rebuilt on the first transmission after a receiver is added
+   * or removed, since the beam ID and address of a receiver are set only after
+   * it has been added.
+   */
+  bool m_rxIndexValid;
+
   /**
    * \brief Type of the channel
    */
@@ -249,11 +287,62 @@ private:
    */
   bool m_enableExternalFadingInputTrace;
 
+  /**
+   * \brief Defines whether the link budgets of the links are cached or not
+   */
+  bool m_enableLinkBudgetCache;
+
+  /**
+   * \brief Struct for the parts of the Rx power of a link which depend only
+   * on the positions of the transmitter and the receiver and the carrier
+   */
+  typedef struct
+  {
+    bool calculated;
+    Vector txPosition;
+    Vector rxPosition;
+    double carrierFreq_hz;
+    double txAntennaGain_W;
+    double rxAntennaGain_W;
+    double fsl;
+    Ptr<SatFadingExternalInputTrace> extFadingTrace;
+  } linkBudget_s;
+
+  /**
+   * Define type LinkBudgetKey_t, transmitter, receiver and carrier ID of a link.
+   * The key holds the ends, so a new PHY cannot be given the address of a
+   * deleted one and match its link budget.
+   */
+  typedef std::pair<std::pair<Ptr<SatPhyTx>, Ptr<SatPhyRx> >, uint32_t> LinkBudgetKey_t;
+
+  /**
+   * Define type LinkBudgetMap_t
+   */
+  typedef std::map<LinkBudgetKey_t, linkBudget_s> LinkBudgetMap_t;
+
+  /**
+   * \brief Link budgets of the links, valid as long as both ends stay where
+   * they were when the link budget was calculated and the cache is enabled
+   */
+  LinkBudgetMap_t m_linkBudgets;
+
   /**
    * Dispose SatChannel.
    */
   virtual void DoDispose ();
 
+  /**
+   * \brief Get the receivers of a beam, rebuilding the receiver indices if needed
+   * \param beamId Beam ID
+   * \return positions of the receivers of the beam in m_phyRxContainer
+   */
+  const std::vector<uint32_t> & GetBeamRx (uint32_t beamId);
+
+  /**
+   * \brief Rebuild the beam and MAC address indices of the receivers
+   */
+  void UpdateRxIndex ();
+
   /**
    * \brief Used internally to schedule the StartRx method call after the propagation delay.
    * \param rxParams Parameters of the signal being received
@@ -291,12 +380,21 @@ private:
    */
   void DoFadingOutputTrace (Ptr<SatSignalParameters> rxParams, Ptr<SatPhyRx> phyRx, double fadingValue);
 
+  /**
+   * \brief Function for getting the link budget of a link, adding it if needed
+   * \param rxParams Rx parameters
+   * \param phyRx The receiver SatPhyRx entity
+   * \return link budget of the link
+   */
+  linkBudget_s & GetLinkBudget (Ptr<SatSignalParameters> rxParams, Ptr<SatPhyRx> phyRx);
+
   /**
    * \brief Function for calculating the Rx power
    * \param rxParams Rx parameters
    * \param phyRx The receiver SatPhyRx entity
+   * \param linkBudget link budget of the link
    */
-  void DoRxPowerCalculation (Ptr<SatSignalParameters> rxParams, Ptr<SatPhyRx> phyRx);
+  void DoRxPowerCalculation (Ptr<SatSignalParameters> rxParams, Ptr<SatPhyRx> phyRx, linkBudget_s &linkBudget);
 
   /**
    * \brief Function for getting the external source fading value
@@ -306,6 +404,14 @@ private:
    */
   double GetExternalFadingTrace (Ptr<SatSignalParameters> rxParams, Ptr<SatPhyRx> phyRx);
 
+  /**
+   * \brief Function for getting the external source fading trace of a link
+   * \param rxParams Rx parameters
+   * \param phyRx The receiver SatPhyRx entity
+   * \return fading trace of the UT or GW end of the link
+   */
+  Ptr<SatFadingExternalInputTrace> GetExternalFadingInputTrace (Ptr<SatSignalParameters> rxParams, Ptr<SatPhyRx> phyRx);
+
   /**
    * \brief Function for getting the source MAC address from Rx parameters
    * \param rxParams Rx parameters
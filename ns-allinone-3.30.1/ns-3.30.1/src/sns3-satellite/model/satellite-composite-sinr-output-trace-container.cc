@@ -140,6 +140,14 @@ SatCompositeSinrOutputTraceContainer::FindNode (key_t key)
   return iter->second;
 }
 
+Ptr<SatOutputFileStreamDoubleContainer>
+SatCompositeSinrOutputTraceContainer::GetNodeContainer (key_t key)
+{
+  NS_LOG_FUNCTION (this);
+
+  return FindNode (key);
+}
+
 void
 SatCompositeSinrOutputTraceContainer::WriteToFile ()
 {
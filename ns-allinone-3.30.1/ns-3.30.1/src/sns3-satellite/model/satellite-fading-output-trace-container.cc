@@ -140,6 +140,14 @@ SatFadingOutputTraceContainer::FindNode (key_t key)
   return iter->second;
 }
 
+Ptr<SatOutputFileStreamDoubleContainer>
+SatFadingOutputTraceContainer::GetNodeContainer (key_t key)
+{
+  NS_LOG_FUNCTION (this);
+
+  return FindNode (key);
+}
+
 void
 SatFadingOutputTraceContainer::WriteToFile ()
 {
@@ -150,6 +150,12 @@ SatFwdLinkScheduler::GetTypeId (void)
                     PointerValue (),
                     MakePointerAccessor (&SatFwdLinkScheduler::m_bbFrameContainer),
                     MakePointerChecker<SatBbFrameContainer> ())
+    .AddAttribute ("IncrementalSchedulingObjects",
+                   "Maintain the scheduling objects in a heap updated from the buffer changes "
+                   "of the LLC encapsulators instead of getting and sorting them from LLC in every scheduling round.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&SatFwdLinkScheduler::m_incrementalSchedulingObjects),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -157,7 +163,8 @@ SatFwdLinkScheduler::GetTypeId (void)
 SatFwdLinkScheduler::SatFwdLinkScheduler ()
   : m_additionalSortCriteria (SatFwdLinkScheduler::NO_SORT),
     m_cnoEstimatorMode (SatCnoEstimator::LAST),
-    m_carrierBandwidthInHz (0.0)
+    m_carrierBandwidthInHz (0.0),
+    m_incrementalSchedulingObjects (true)
 {
   NS_LOG_FUNCTION (this);
   NS_FATAL_ERROR ("Default constructor for SatFwdLinkScheduler not supported");
@@ -168,7 +175,8 @@ SatFwdLinkScheduler::SatFwdLinkScheduler (Ptr<SatBbFrameConf> conf, Mac48Address
     m_bbFrameConf (conf),
     m_additionalSortCriteria (SatFwdLinkScheduler::NO_SORT),
     m_cnoEstimatorMode (SatCnoEstimator::LAST),
-    m_carrierBandwidthInHz (carrierBandwidthInHz)
+    m_carrierBandwidthInHz (carrierBandwidthInHz),
+    m_incrementalSchedulingObjects (true)
 {
   NS_LOG_FUNCTION (this);
 
@@ -197,6 +205,10 @@ SatFwdLinkScheduler::DoDispose ()
   m_txOpportunityCallback.Nullify ();
   m_bbFrameContainer = NULL;
   m_cnoEstimatorContainer.clear ();
+  m_schedulingObjects.clear ();
+  m_schedulingObjectIndices.clear ();
+  m_schedulingObjectHeap.clear ();
+  m_takenSchedulingObjects.clear ();
 }
 
 void
@@ -283,6 +295,62 @@ SatFwdLinkScheduler::CnoInfoUpdated (Mac48Address utAddress, double cnoEstimate)
   it->second->AddSample (cnoEstimate);
 }
 
+void
+SatFwdLinkScheduler::UpdateSchedulingObject (Mac48Address utAddress, uint8_t flowId, uint32_t bytes, uint32_t minTxOpportunity, Time holTimestamp)
+{
+  NS_LOG_FUNCTION (this << utAddress << (uint32_t) flowId << bytes << minTxOpportunity << holTimestamp);
+
+  if ( m_incrementalSchedulingObjects == false )
+    {
+      return;
+    }
+
+  std::pair<SchedulingObjectIndexMap_t::iterator, bool> result =
+    m_schedulingObjectIndices.insert (std::make_pair (std::make_pair (utAddress, flowId), m_schedulingObjects.size ()));
+
+  if ( result.second )
+    {
+      schedulingObject_s newObject;
+      newObject.macAddress = utAddress;
+      newObject.flowId = flowId;
+      newObject.heapIndex = NOT_IN_HEAP;
+      newObject.taken = false;
+      m_schedulingObjects.push_back (newObject);
+    }
+
+  uint32_t index = result.first->second;
+  schedulingObject_s &object = m_schedulingObjects[index];
+
+  object.bufferedBytes = bytes;
+  object.minTxOpportunity = minTxOpportunity;
+  object.holTimestamp = holTimestamp;
+
+  // object taken in the ongoing scheduling round is put back to heap at the end of the round
+  if ( object.taken )
+    {
+      return;
+    }
+
+  if ( object.heapIndex == NOT_IN_HEAP )
+    {
+      if ( bytes > 0 )
+        {
+          object.heapIndex = m_schedulingObjectHeap.size ();
+          m_schedulingObjectHeap.push_back (index);
+          SiftUp (object.heapIndex);
+        }
+    }
+  else if ( bytes > 0 )
+    {
+      SiftUp (object.heapIndex);
+      SiftDown (object.heapIndex);
+    }
+  else
+    {
+      RemoveFromHeap (object.heapIndex);
+    }
+}
+
 Time
 SatFwdLinkScheduler::GetDefaultFrameDuration () const
 {
@@ -306,53 +374,79 @@ SatFwdLinkScheduler::ScheduleBbFrames ()
 {
   NS_LOG_FUNCTION (this);
 
-  // Get scheduling objects from LLC
-  std::vector< Ptr<SatSchedulingObject> > so;
-  GetSchedulingObjects (so);
-
-  for ( std::vector< Ptr<SatSchedulingObject> >::const_iterator it = so.begin ();
-        ( it != so.end () ) && ( m_bbFrameContainer->GetTotalDuration () < m_schedulingStopThresholdTime ); it++ )
+  if ( m_incrementalSchedulingObjects )
     {
-      uint32_t currentObBytes = (*it)->GetBufferedBytes ();
-      uint32_t currentObMinReqBytes = (*it)->GetMinTxOpportunityInBytes ();
-      uint8_t flowId = (*it)->GetFlowId ();
-      SatEnums::SatModcod_t modcod = m_bbFrameContainer->GetModcod ( flowId, GetSchedulingObjectCno (*it));
+      /**
+       * Take the scheduling objects from the heap in the order they would
+       * have after sorting. Objects taken are kept out of the heap until the end
+       * of the round, so that each object is scheduled at most once per round.
+       */
+      while ( ( m_schedulingObjectHeap.empty () == false )
+              && ( m_bbFrameContainer->GetTotalDuration () < m_schedulingStopThresholdTime ) )
+        {
+          ScheduleSchedulingObject (TakeSchedulingObject ());
+        }
 
-      uint32_t frameBytes = m_bbFrameContainer->GetBytesLeftInTailFrame (flowId, modcod);
+      ReturnTakenSchedulingObjects ();
+    }
+  else
+    {
+      // Get scheduling objects from LLC
+      std::vector< Ptr<SatSchedulingObject> > so;
+      GetSchedulingObjects (so);
 
-      while ( ( (m_bbFrameContainer->GetTotalDuration () < m_schedulingStopThresholdTime ))
-              && (currentObBytes > 0) )
+      for ( std::vector< Ptr<SatSchedulingObject> >::const_iterator it = so.begin ();
+            ( it != so.end () ) && ( m_bbFrameContainer->GetTotalDuration () < m_schedulingStopThresholdTime ); it++ )
         {
-          if ( frameBytes < currentObMinReqBytes)
-            {
-              frameBytes = m_bbFrameContainer->GetMaxFramePayloadInBytes (flowId, modcod);
+          ScheduleSchedulingObject (*it);
+        }
+    }
+}
 
-              // if frame bytes still too small, we must have too long control message, so let's crash
-              if ( frameBytes < currentObMinReqBytes )
-                {
-                  NS_FATAL_ERROR ("Control package too probably too long!!!");
-                }
-            }
+void
+SatFwdLinkScheduler::ScheduleSchedulingObject (Ptr<SatSchedulingObject> so)
+{
+  NS_LOG_FUNCTION (this << so);
 
-          Ptr<Packet> p = m_txOpportunityCallback (frameBytes, (*it)->GetMacAddress (), flowId, currentObBytes, currentObMinReqBytes);
+  uint32_t currentObBytes = so->GetBufferedBytes ();
+  uint32_t currentObMinReqBytes = so->GetMinTxOpportunityInBytes ();
+  uint8_t flowId = so->GetFlowId ();
+  SatEnums::SatModcod_t modcod = m_bbFrameContainer->GetModcod ( flowId, GetSchedulingObjectCno (so));
 
-          if ( p )
-            {
-              m_bbFrameContainer->AddData (flowId, modcod, p);
-              frameBytes = m_bbFrameContainer->GetBytesLeftInTailFrame (flowId, modcod);
-            }
-          else if ( m_bbFrameContainer->GetMaxFramePayloadInBytes (flowId, modcod ) != m_bbFrameContainer->GetBytesLeftInTailFrame (flowId, modcod))
-            {
-              frameBytes = m_bbFrameContainer->GetMaxFramePayloadInBytes (flowId, modcod);
-            }
-          else
+  uint32_t frameBytes = m_bbFrameContainer->GetBytesLeftInTailFrame (flowId, modcod);
+
+  while ( ( (m_bbFrameContainer->GetTotalDuration () < m_schedulingStopThresholdTime ))
+          && (currentObBytes > 0) )
+    {
+      if ( frameBytes < currentObMinReqBytes)
+        {
+          frameBytes = m_bbFrameContainer->GetMaxFramePayloadInBytes (flowId, modcod);
+
+          // if frame bytes still too small, we must have too long control message, so let's crash
+          if ( frameBytes < currentObMinReqBytes )
             {
-              NS_FATAL_ERROR ("Packet does not fit in empty BB Frame. Control package too long or fragmentation problem in user package!!!");
+              NS_FATAL_ERROR ("Control package too probably too long!!!");
             }
         }
 
-      m_bbFrameContainer->MergeBbFrames (m_carrierBandwidthInHz);
+      Ptr<Packet> p = m_txOpportunityCallback (frameBytes, so->GetMacAddress (), flowId, currentObBytes, currentObMinReqBytes);
+
+      if ( p )
+        {
+          m_bbFrameContainer->AddData (flowId, modcod, p);
+          frameBytes = m_bbFrameContainer->GetBytesLeftInTailFrame (flowId, modcod);
+        }
+      else if ( m_bbFrameContainer->GetMaxFramePayloadInBytes (flowId, modcod ) != m_bbFrameContainer->GetBytesLeftInTailFrame (flowId, modcod))
+        {
+          frameBytes = m_bbFrameContainer->GetMaxFramePayloadInBytes (flowId, modcod);
+        }
+      else
+        {
+          NS_FATAL_ERROR ("Packet does not fit in empty BB Frame. Control package too long or fragmentation problem in user package!!!");
+        }
     }
+
+  m_bbFrameContainer->MergeBbFrames (m_carrierBandwidthInHz);
 }
 
 void
@@ -406,6 +500,163 @@ SatFwdLinkScheduler::SortSchedulingObjects (std::vector< Ptr<SatSchedulingObject
     }
 }
 
+bool
+SatFwdLinkScheduler::IsScheduledBefore (uint32_t index1, uint32_t index2) const
+{
+  const schedulingObject_s &obj1 = m_schedulingObjects[index1];
+  const schedulingObject_s &obj2 = m_schedulingObjects[index2];
+
+  if ( obj1.flowId != obj2.flowId )
+    {
+      return ( obj1.flowId < obj2.flowId );
+    }
+
+  switch (m_additionalSortCriteria)
+    {
+    case SatFwdLinkScheduler::NO_SORT:
+      break;
+
+    // earlier head-of-line arrival means longer HOL delay
+    case SatFwdLinkScheduler::BUFFERING_DELAY_SORT:
+      if ( obj1.holTimestamp != obj2.holTimestamp )
+        {
+          return ( obj1.holTimestamp < obj2.holTimestamp );
+        }
+      break;
+
+    case SatFwdLinkScheduler::BUFFERING_LOAD_SORT:
+      if ( obj1.bufferedBytes != obj2.bufferedBytes )
+        {
+          return ( obj1.bufferedBytes > obj2.bufferedBytes );
+        }
+      break;
+
+    default:
+      NS_FATAL_ERROR ("Not supported sorting criteria!!!");
+      break;
+    }
+
+  return ( obj1.macAddress < obj2.macAddress );
+}
+
+void
+SatFwdLinkScheduler::SiftUp (uint32_t heapIndex)
+{
+  uint32_t index = m_schedulingObjectHeap[heapIndex];
+
+  while ( heapIndex > 0 )
+    {
+      uint32_t parentHeapIndex = ( heapIndex - 1 ) / 2;
+      uint32_t parentIndex = m_schedulingObjectHeap[parentHeapIndex];
+
+      if ( IsScheduledBefore (index, parentIndex) == false )
+        {
+          break;
+        }
+
+      m_schedulingObjectHeap[heapIndex] = parentIndex;
+      m_schedulingObjects[parentIndex].heapIndex = heapIndex;
+      heapIndex = parentHeapIndex;
+    }
+
+  m_schedulingObjectHeap[heapIndex] = index;
+  m_schedulingObjects[index].heapIndex = heapIndex;
+}
+
+void
+SatFwdLinkScheduler::SiftDown (uint32_t heapIndex)
+{
+  uint32_t index = m_schedulingObjectHeap[heapIndex];
+  uint32_t heapSize = m_schedulingObjectHeap.size ();
+
+  while ( ( 2 * heapIndex + 1 ) < heapSize )
+    {
+      uint32_t childHeapIndex = 2 * heapIndex + 1;
+
+      if ( ( ( childHeapIndex + 1 ) < heapSize )
+           && IsScheduledBefore (m_schedulingObjectHeap[childHeapIndex + 1], m_schedulingObjectHeap[childHeapIndex]) )
+        {
+          childHeapIndex++;
+        }
+
+      uint32_t childIndex = m_schedulingObjectHeap[childHeapIndex];
+
+      if ( IsScheduledBefore (childIndex, index) == false )
+        {
+          break;
+        }
+
+      m_schedulingObjectHeap[heapIndex] = childIndex;
+      m_schedulingObjects[childIndex].heapIndex = heapIndex;
+      heapIndex = childHeapIndex;
+    }
+
+  m_schedulingObjectHeap[heapIndex] = index;
+  m_schedulingObjects[index].heapIndex = heapIndex;
+}
+
+void
+SatFwdLinkScheduler::RemoveFromHeap (uint32_t heapIndex)
+{
+  m_schedulingObjects[m_schedulingObjectHeap[heapIndex]].heapIndex = NOT_IN_HEAP;
+
+  uint32_t lastIndex = m_schedulingObjectHeap.back ();
+  m_schedulingObjectHeap.pop_back ();
+
+  // fill the gap with the last object, unless the removed one was the last
+  if ( heapIndex < m_schedulingObjectHeap.size () )
+    {
+      m_schedulingObjectHeap[heapIndex] = lastIndex;
+      m_schedulingObjects[lastIndex].heapIndex = heapIndex;
+      SiftUp (heapIndex);
+      SiftDown (m_schedulingObjects[lastIndex].heapIndex);
+    }
+}
+
+Ptr<SatSchedulingObject>
+SatFwdLinkScheduler::TakeSchedulingObject ()
+{
+  NS_LOG_FUNCTION (this);
+
+  uint32_t index = m_schedulingObjectHeap.front ();
+  RemoveFromHeap (0);
+
+  schedulingObject_s &object = m_schedulingObjects[index];
+  object.taken = true;
+  m_takenSchedulingObjects.push_back (index);
+
+  Time holDelay (Seconds (0.0));
+
+  if ( object.holTimestamp != Time::Max () )
+    {
+      holDelay = Simulator::Now () - object.holTimestamp;
+    }
+
+  return Create<SatSchedulingObject> (object.macAddress, object.bufferedBytes, object.minTxOpportunity, holDelay, object.flowId);
+}
+
+void
+SatFwdLinkScheduler::ReturnTakenSchedulingObjects ()
+{
+  NS_LOG_FUNCTION (this);
+
+  for ( std::vector<uint32_t>::const_iterator it = m_takenSchedulingObjects.begin ();
+        it != m_takenSchedulingObjects.end (); it++ )
+    {
+      schedulingObject_s &object = m_schedulingObjects[*it];
+      object.taken = false;
+
+      if ( object.bufferedBytes > 0 )
+        {
+          object.heapIndex = m_schedulingObjectHeap.size ();
+          m_schedulingObjectHeap.push_back (*it);
+          SiftUp (object.heapIndex);
+        }
+    }
+
+  m_takenSchedulingObjects.clear ();
+}
+
 bool
 SatFwdLinkScheduler::CnoMatchWithFrame (double cno, Ptr<SatBbFrame> frame) const
 {
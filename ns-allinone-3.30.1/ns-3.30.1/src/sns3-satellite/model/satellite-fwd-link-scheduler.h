@@ -53,7 +53,8 @@ namespace ns3 {
  *        it utilizes BB frame container given as attribute.
  *
  *        SatFwdLinkScheduler communicated through callback functions to request scheduling objects and
- *        notifying TX opportunities.
+ *        notifying TX opportunities. By default the scheduling objects are not requested, but kept up to
+ *        date in an indexed heap from the buffer change notifications of the LLC encapsulators.
  *
  *        GW MAC requests frames from scheduler through method GetNextFrame.
  *
@@ -180,6 +181,18 @@ public:
    */
   void CnoInfoUpdated (Mac48Address utAddress, double cnoEstimate);
 
+  /**
+   * Called when the buffered data of an LLC encapsulator has changed. Updates
+   * the scheduling object of the encapsulator in place.
+   *
+   * \param utAddress Address of the UT of the encapsulator.
+   * \param flowId Flow identifier of the encapsulator.
+   * \param bytes Buffered bytes of the encapsulator.
+   * \param minTxOpportunity Minimum Tx opportunity in bytes.
+   * \param holTimestamp Arrival time of the head-of-line packet, Time::Max () if none.
+   */
+  void UpdateSchedulingObject (Mac48Address utAddress, uint8_t flowId, uint32_t bytes, uint32_t minTxOpportunity, Time holTimestamp);
+
   /**
    * \brief Return the BB frame duration of the default frame format, i.e.
    * default MODCOD and NORMAL frame type. This is used by the GW MAC to
@@ -191,6 +204,27 @@ public:
 private:
   typedef std::map<Mac48Address, Ptr<SatCnoEstimator> > CnoEstimatorMap_t;
 
+  /**
+   * Index of a scheduling object, which is not in the heap.
+   */
+  static const uint32_t NOT_IN_HEAP = 0xFFFFFFFF;
+
+  /**
+   * Scheduling object of one LLC encapsulator maintained by the scheduler.
+   */
+  typedef struct
+  {
+    Mac48Address  macAddress;
+    uint8_t       flowId;
+    uint32_t      bufferedBytes;
+    uint32_t      minTxOpportunity;
+    Time          holTimestamp;
+    uint32_t      heapIndex;
+    bool          taken;
+  } schedulingObject_s;
+
+  typedef std::map<std::pair<Mac48Address, uint8_t>, uint32_t> SchedulingObjectIndexMap_t;
+
   SatFwdLinkScheduler& operator = (const SatFwdLinkScheduler &);
   SatFwdLinkScheduler (const SatFwdLinkScheduler &);
 
@@ -204,6 +238,13 @@ private:
    */
   void ScheduleBbFrames ();
 
+  /**
+   * Schedule the buffered data of a scheduling object to BB Frames.
+   *
+   * \param so Scheduling object to schedule
+   */
+  void ScheduleSchedulingObject (Ptr<SatSchedulingObject> so);
+
   /**
    * Check if given estimated C/N0 match with given frame.
    *
@@ -240,6 +281,51 @@ private:
    */
   void SortSchedulingObjects (std::vector< Ptr<SatSchedulingObject> >& so);
 
+  /**
+   * Compares two maintained scheduling objects according to configured sorting
+   * criteria. Ties are broken by the MAC address to make the order total.
+   *
+   * \param index1 Index of the first object
+   * \param index2 Index of the second object
+   * \return true if the first object is to be scheduled before the second one
+   */
+  bool IsScheduledBefore (uint32_t index1, uint32_t index2) const;
+
+  /**
+   * Move a scheduling object up in the heap until its parent is scheduled before it.
+   *
+   * \param heapIndex Index of the object in the heap
+   */
+  void SiftUp (uint32_t heapIndex);
+
+  /**
+   * Move a scheduling object down in the heap until it is scheduled before its children.
+   *
+   * \param heapIndex Index of the object in the heap
+   */
+  void SiftDown (uint32_t heapIndex);
+
+  /**
+   * Remove a scheduling object from the heap.
+   *
+   * \param heapIndex Index of the object in the heap
+   */
+  void RemoveFromHeap (uint32_t heapIndex);
+
+  /**
+   * Take the scheduling object to be scheduled first out of the heap for the
+   * rest of the scheduling round.
+   *
+   * \return Scheduling object taken
+   */
+  Ptr<SatSchedulingObject> TakeSchedulingObject ();
+
+  /**
+   * Put the scheduling objects taken in the scheduling round with buffered
+   * data back to the heap.
+   */
+  void ReturnTakenSchedulingObjects ();
+
   /**
    * Create estimator for the UT according to set attributes.
    * \return pointer to created estimator
@@ -324,6 +410,33 @@ private:
    */
   double m_carrierBandwidthInHz;
 
+  /**
+   * Flag indicating if the scheduling objects are maintained incrementally from
+   * the buffer change notifications or got from LLC in every scheduling round.
+   */
+  bool m_incrementalSchedulingObjects;
+
+  /**
+   * Scheduling objects of the encapsulators notified so far.
+   */
+  std::vector<schedulingObject_s> m_schedulingObjects;
+
+  /**
+   * Index of the scheduling object per UT address and flow identifier.
+   */
+  SchedulingObjectIndexMap_t m_schedulingObjectIndices;
+
+  /**
+   * Heap of the indices of the scheduling objects with buffered data, the
+   * object to be scheduled first at the top.
+   */
+  std::vector<uint32_t> m_schedulingObjectHeap;
+
+  /**
+   * Indices of the scheduling objects taken in the current scheduling round.
+   */
+  std::vector<uint32_t> m_takenSchedulingObjects;
+
 };
 
 } // namespace ns3
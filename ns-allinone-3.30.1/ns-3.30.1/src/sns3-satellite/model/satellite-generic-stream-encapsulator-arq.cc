@@ -220,6 +220,8 @@ SatGenericStreamEncapsulatorArq::NotifyTxOpportunity (uint32_t bytes, uint32_t &
 
           NS_LOG_INFO ("GW: << " << m_sourceAddress << " sent a retransmission packet of size: " << context->m_pdu->GetSize () << " with seqNo: " << (uint32_t)(context->m_seqNo) << " flowId: " << (uint32_t)(m_flowId) << " at: " << Now ().GetSeconds ());
 
+          NotifyBufferChanged ();
+
           Ptr<Packet> copy = context->m_pdu->Copy ();
           return copy;
         }
@@ -283,6 +285,8 @@ SatGenericStreamEncapsulatorArq::NotifyTxOpportunity (uint32_t bytes, uint32_t &
         }
     }
 
+  NotifyBufferChanged ();
+
   // Update bytes lefts
   bytesLeft = GetTxBufferSizeInBytes ();
 
@@ -327,6 +331,8 @@ SatGenericStreamEncapsulatorArq::ArqReTxTimerExpired (uint8_t seqNo)
           // Do clean-up
           CleanUp (seqNo);
         }
+
+      NotifyBufferChanged ();
     }
   else
     {
@@ -380,6 +386,8 @@ SatGenericStreamEncapsulatorArq::ReceiveAck (Ptr<SatArqAckMessage> ack)
 
   // Do clean-up
   CleanUp (ack->GetSequenceNumber ());
+
+  NotifyBufferChanged ();
 }
 
 
@@ -118,6 +118,8 @@ SatGenericStreamEncapsulator::EnquePdu (Ptr<Packet> p, Mac48Address /*dest*/)
       NS_LOG_INFO ("Packet is dropped!");
     }
 
+  NotifyBufferChanged ();
+
   NS_LOG_INFO ("NumPackets = " << m_txQueue->GetNPackets () );
   NS_LOG_INFO ("NumBytes = " << m_txQueue->GetNBytes ());
 }
@@ -159,6 +161,8 @@ SatGenericStreamEncapsulator::NotifyTxOpportunity (uint32_t bytes, uint32_t &byt
         }
     }
 
+  NotifyBufferChanged ();
+
   // Update bytes lefts
   bytesLeft = GetTxBufferSizeInBytes ();
 
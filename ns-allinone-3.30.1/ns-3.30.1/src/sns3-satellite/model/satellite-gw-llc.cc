@@ -62,7 +62,11 @@ SatGwLlc::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
 
+  // Queues are emptied when the encapsulators are disposed, so the traces referring
+  // to the counters are disconnected before that
+  DisconnectUtEncaps ();
   SatLlc::DoDispose ();
+  m_utEncaps.clear ();
 }
 
 
@@ -72,12 +76,11 @@ SatGwLlc::NotifyTxOpportunity (uint32_t bytes, Mac48Address utAddr, uint8_t flow
   NS_LOG_FUNCTION (this << utAddr << bytes << (uint32_t) flowId);
 
   Ptr<Packet> packet;
-  Ptr<EncapKey> key = Create<EncapKey> (m_nodeInfo->GetMacAddress (), utAddr, flowId);
-  EncapContainer_t::iterator it = m_encaps.find (key);
+  Ptr<SatBaseEncapsulator> encap = GetUtEncap (utAddr, flowId);
 
-  if (it != m_encaps.end ())
+  if (encap)
     {
-      packet = it->second->NotifyTxOpportunity (bytes, bytesLeft, nextMinTxO);
+      packet = encap->NotifyTxOpportunity (bytes, bytesLeft, nextMinTxO);
 
       if (packet)
         {
@@ -121,6 +124,7 @@ SatGwLlc::CreateEncap (Ptr<EncapKey> key)
 
   Ptr<SatQueue> queue = CreateObject<SatQueue> (key->m_flowId);
   gwEncap->SetQueue (queue);
+  gwEncap->SetBufferChangedCallback (m_bufferChangedCallback);
 
   NS_LOG_INFO ("Create encapsulator with key (" << key->m_source << ", " << key->m_destination << ", " << (uint32_t) key->m_flowId << ")");
 
@@ -130,6 +134,8 @@ SatGwLlc::CreateEncap (Ptr<EncapKey> key)
     {
       NS_FATAL_ERROR ("Insert to map with key (" << key->m_source << ", " << key->m_destination << ", " << (uint32_t) key->m_flowId << ") failed!");
     }
+
+  AddUtEncap (key->m_destination, key->m_flowId, gwEncap);
 }
 
 void
@@ -187,26 +193,114 @@ void SatGwLlc::GetSchedulingContexts (std::vector< Ptr<SatSchedulingObject> > &
     }
 }
 
+void
+SatGwLlc::AddEncap (Mac48Address source, Mac48Address dest, uint8_t flowId, Ptr<SatBaseEncapsulator> enc)
+{
+  NS_LOG_FUNCTION (this << source << dest << (uint32_t) flowId);
+
+  SatLlc::AddEncap (source, dest, flowId, enc);
+  AddUtEncap (dest, flowId, enc);
+}
+
+void
+SatGwLlc::AddUtEncap (Mac48Address utAddress, uint8_t flowId, Ptr<SatBaseEncapsulator> encap)
+{
+  NS_LOG_FUNCTION (this << utAddress << (uint32_t) flowId);
+
+  Ptr<SatQueue> queue = encap->GetQueue ();
+  NS_ASSERT (queue != 0);
+
+  UtEncapContainer_t::iterator it = m_utEncaps.find (utAddress);
+
+  if (it == m_utEncaps.end ())
+    {
+      utEncaps_s utEncaps;
+      utEncaps.nBytes = 0;
+      utEncaps.nPackets = 0;
+      it = m_utEncaps.insert (std::make_pair (utAddress, utEncaps)).first;
+    }
+
+  if (it->second.encaps.size () <= flowId)
+    {
+      it->second.encaps.resize (flowId + 1);
+    }
+  it->second.encaps[flowId] = encap;
+  it->second.nBytes += queue->GetNBytes ();
+  it->second.nPackets += queue->GetNPackets ();
+
+  // References to the elements of an unordered map stay valid when it rehashes,
+  // only iterators are invalidated, so the queue traces may refer to the entry
+  queue->TraceConnectWithoutContext ("Enqueue", MakeBoundCallback (&SatGwLlc::PacketQueued, &it->second));
+  queue->TraceConnectWithoutContext ("PushFront", MakeBoundCallback (&SatGwLlc::PacketQueued, &it->second));
+  queue->TraceConnectWithoutContext ("Dequeue", MakeBoundCallback (&SatGwLlc::PacketDequeued, &it->second));
+}
+
+Ptr<SatBaseEncapsulator>
+SatGwLlc::GetUtEncap (Mac48Address utAddress, uint8_t flowId) const
+{
+  NS_LOG_FUNCTION (this << utAddress << (uint32_t) flowId);
+
+  UtEncapContainer_t::const_iterator it = m_utEncaps.find (utAddress);
+
+  if (it != m_utEncaps.end () && flowId < it->second.encaps.size ())
+    {
+      return it->second.encaps[flowId];
+    }
+
+  return 0;
+}
+
+void
+SatGwLlc::DisconnectUtEncaps ()
+{
+  NS_LOG_FUNCTION (this);
+
+  for (UtEncapContainer_t::iterator it = m_utEncaps.begin (); it != m_utEncaps.end (); ++it)
+    {
+      for (uint32_t i = 0; i < it->second.encaps.size (); i++)
+        {
+          if (it->second.encaps[i] == 0)
+            {
+              continue;
+            }
+
+          Ptr<SatQueue> queue = it->second.encaps[i]->GetQueue ();
+          queue->TraceDisconnectWithoutContext ("Enqueue", MakeBoundCallback (&SatGwLlc::PacketQueued, &it->second));
+          queue->TraceDisconnectWithoutContext ("PushFront", MakeBoundCallback (&SatGwLlc::PacketQueued, &it->second));
+          queue->TraceDisconnectWithoutContext ("Dequeue", MakeBoundCallback (&SatGwLlc::PacketDequeued, &it->second));
+        }
+    }
+}
+
+void
+SatGwLlc::PacketQueued (utEncaps_s *utEncaps, Ptr<const Packet> packet)
+{
+  utEncaps->nBytes += packet->GetSize ();
+  utEncaps->nPackets++;
+}
+
+void
+SatGwLlc::PacketDequeued (utEncaps_s *utEncaps, Ptr<const Packet> packet)
+{
+  NS_ASSERT (utEncaps->nBytes >= packet->GetSize () && utEncaps->nPackets > 0);
+
+  utEncaps->nBytes -= packet->GetSize ();
+  utEncaps->nPackets--;
+}
+
 uint32_t
 SatGwLlc::GetNBytesInQueue (Mac48Address utAddress) const
 {
   NS_LOG_FUNCTION (this << utAddress);
 
-  uint32_t sum = 0;
+  UtEncapContainer_t::const_iterator it = m_utEncaps.find (utAddress);
 
-  for (EncapContainer_t::const_iterator it = m_encaps.begin ();
-       it != m_encaps.end (); ++it)
+  if (it != m_utEncaps.end ())
     {
-      if (it->first->m_destination == utAddress)
-        {
-          NS_ASSERT (it->second != 0);
-          Ptr<SatQueue> queue = it->second->GetQueue ();
-          NS_ASSERT (queue != 0);
-          sum += queue->GetNBytes ();
-        }
+      return it->second.nBytes;
     }
 
-  return sum;
+  return 0;
 }
 
 uint32_t
@@ -214,21 +308,14 @@ SatGwLlc::GetNPacketsInQueue (Mac48Address utAddress) const
 {
   NS_LOG_FUNCTION (this << utAddress);
 
-  uint32_t sum = 0;
+  UtEncapContainer_t::const_iterator it = m_utEncaps.find (utAddress);
 
-  for (EncapContainer_t::const_iterator it = m_encaps.begin ();
-       it != m_encaps.end (); ++it)
+  if (it != m_utEncaps.end ())
     {
-      if (it->first->m_destination == utAddress)
-        {
-          NS_ASSERT (it->second != 0);
-          Ptr<SatQueue> queue = it->second->GetQueue ();
-          NS_ASSERT (queue != 0);
-          sum += queue->GetNPackets ();
-        }
+      return it->second.nPackets;
     }
 
-  return sum;
+  return 0;
 }
 
 } // namespace ns3
@@ -21,8 +21,10 @@
 #ifndef SATELLITE_GW_LLC_H_
 #define SATELLITE_GW_LLC_H_
 
+#include <unordered_map>
 #include "ns3/ptr.h"
 #include "satellite-llc.h"
+#include "satellite-utils.h"
 
 namespace ns3 {
 
@@ -75,10 +77,21 @@ public:
    */
   virtual void GetSchedulingContexts (std::vector< Ptr<SatSchedulingObject> > & output) const;
 
+  /**
+   * \brief Add an encapsulator entry for the LLC. This is called from the helpers
+   * at initialization phase.
+   * \param source Source MAC address
+   * \param dest Destination MAC address
+   * \param flowId Flow id of this encapsulator queue
+   * \param enc Encapsulator pointer
+   */
+  virtual void AddEncap (Mac48Address source, Mac48Address dest, uint8_t flowId, Ptr<SatBaseEncapsulator> enc);
+
   /**
    * \brief Get the number of (new) bytes at LLC queue for a certain UT. Method
    * checks only the SatQueue for packets, thus it does not count possible
-   * packets buffered at the encapsulator (e.g. in case of ARQ).
+   * packets buffered at the encapsulator (e.g. in case of ARQ). The bytes are
+   * counted per UT while the packets are enqueued and dequeued.
    * \param utAddress the MAC address that identifies a particular UT node.
    * \return Number of bytes currently queued in the encapsulator(s)
    *         associated with the UT.
@@ -88,7 +101,8 @@ public:
   /**
    * \brief Get the number of (new) packets at LLC queues for a certain UT. Method
    * checks only the SatQueue for packets, thus it does not count possible
-   * packets buffered at the encapsulator (e.g. in case of ARQ).
+   * packets buffered at the encapsulator (e.g. in case of ARQ). The packets are
+   * counted per UT while they are enqueued and dequeued.
    * \param utAddress the MAC address that identifies a particular UT node.
    * \return Number of packets currently queued in the encapsulator(s)
    *         associated with the UT.
@@ -114,6 +128,66 @@ protected:
    */
   virtual void CreateDecap (Ptr<EncapKey> key);
 
+private:
+  /**
+   * Encapsulators of one UT indexed by their flow identifiers, zero for the flows
+   * without encapsulator, and the number of bytes and packets in their queues.
+   */
+  typedef struct
+  {
+    std::vector<Ptr<SatBaseEncapsulator> > encaps;
+    uint32_t nBytes;
+    uint32_t nPackets;
+  } utEncaps_s;
+
+  /**
+   * Key = UT MAC address
+   * Value = encapsulators of the UT
+   */
+  typedef std::unordered_map<Mac48Address, utEncaps_s, SatUtils::Mac48AddressHash> UtEncapContainer_t;
+
+  /**
+   * \brief Add an encapsulator to the encapsulators of its UT and start counting
+   * the bytes and packets in its queue.
+   * \param utAddress MAC address of the UT
+   * \param flowId Flow identifier
+   * \param encap Encapsulator
+   */
+  void AddUtEncap (Mac48Address utAddress, uint8_t flowId, Ptr<SatBaseEncapsulator> encap);
+
+  /**
+   * \brief Get an encapsulator of a UT.
+   * \param utAddress MAC address of the UT
+   * \param flowId Flow identifier
+   * \return Encapsulator, or zero if not found
+   */
+  Ptr<SatBaseEncapsulator> GetUtEncap (Mac48Address utAddress, uint8_t flowId) const;
+
+  /**
+   * \brief Count a packet added to the queue of an encapsulator of a UT.
+   * \param utEncaps Encapsulators of the UT
+   * \param packet Packet added
+   */
+  static void PacketQueued (utEncaps_s *utEncaps, Ptr<const Packet> packet);
+
+  /**
+   * \brief Count a packet removed from the queue of an encapsulator of a UT.
+   * \param utEncaps Encapsulators of the UT
+   * \param packet Packet removed
+   */
+  static void PacketDequeued (utEncaps_s *utEncaps, Ptr<const Packet> packet);
+
+  /**
+   * \brief Stop counting the bytes and packets in the queues of the encapsulators
+   * of the UTs.
+   */
+  void DisconnectUtEncaps ();
+
+  /**
+   * Encapsulators per UT
+   */
+  UtEncapContainer_t m_utEncaps;
+
 };
 
 } // namespace ns3
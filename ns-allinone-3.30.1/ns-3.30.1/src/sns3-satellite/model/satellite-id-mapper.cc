@@ -22,8 +22,11 @@
 #include <ns3/log.h>
 #include <ns3/node.h>
 #include <ns3/address.h>
+#include <ns3/mac48-address.h>
 #include <ns3/satellite-net-device.h>
+#include <ns3/satellite-utils.h>
 #include <sstream>
+#include <algorithm>
 
 NS_LOG_COMPONENT_DEFINE ("SatIdMapper");
 
@@ -77,53 +80,145 @@ SatIdMapper::Reset ()
       PrintTraceMap ();
     }
 
-  // Trace ID maps
+  m_macIds.clear ();
+  m_mac48Keys.clear ();
+  m_mac48Indices.clear ();
+  m_otherMacIndices.clear ();
 
-  if (!m_macToTraceIdMap.empty ())
+  m_traceIdIndex = 1;
+  m_utIdIndex = 1;
+  m_utUserIdIndex = 1;
+  m_gwUserIdIndex = 1;
+
+  m_enableMapPrint = false;
+}
+
+bool
+SatIdMapper::GetMac48Key (const Address &mac, uint64_t &key)
+{
+  if (!Mac48Address::IsMatchingType (mac))
     {
-      m_macToTraceIdMap.clear ();
+      return false;
     }
-  m_traceIdIndex = 1;
 
-  // UT ID maps
+  uint8_t buffer[Address::MAX_SIZE];
+  mac.CopyTo (buffer);
 
-  if (!m_macToUtIdMap.empty ())
+  key = 0;
+  for (uint32_t i = 0; i < 6; i++)
     {
-      m_macToUtIdMap.clear ();
+      key = (key << 8) | buffer[i];
     }
-  m_utIdIndex = 1;
+  key++;
+
+  return true;
+}
 
-  // UT user ID maps
+uint32_t
+SatIdMapper::FindMac48Slot (uint64_t key) const
+{
+  // the table size is a power of two, so the slots are probed linearly with a mask
+  uint32_t mask = m_mac48Keys.size () - 1;
+  uint32_t slot = SatUtils::HashKey (key) & mask;
 
-  if (!m_macToUtUserIdMap.empty ())
+  while (m_mac48Keys[slot] != 0 && m_mac48Keys[slot] != key)
     {
-      m_macToUtUserIdMap.clear ();
+      slot = (slot + 1) & mask;
     }
-  m_utUserIdIndex = 1;
 
-  // Beam ID maps
+  return slot;
+}
+
+const SatIdMapper::macIds_s *
+SatIdMapper::FindMac (const Address &mac) const
+{
+  uint64_t key;
 
-  if (!m_macToBeamIdMap.empty ())
+  if (GetMac48Key (mac, key))
     {
-      m_macToBeamIdMap.clear ();
+      if (m_mac48Keys.empty ())
+        {
+          return NULL;
+        }
+
+      uint32_t slot = FindMac48Slot (key);
+
+      if (m_mac48Keys[slot] == 0)
+        {
+          return NULL;
+        }
+
+      return &m_macIds[m_mac48Indices[slot]];
+    }
+
+  std::map<Address, uint32_t>::const_iterator iter = m_otherMacIndices.find (mac);
+
+  if (iter == m_otherMacIndices.end ())
+    {
+      return NULL;
     }
 
-  // GW ID maps
+  return &m_macIds[iter->second];
+}
 
-  if (!m_macToGwIdMap.empty ())
+SatIdMapper::macIds_s &
+SatIdMapper::FindOrAddMac (const Address &mac)
+{
+  macIds_s newIds;
+  newIds.mac = mac;
+  newIds.traceId = -1;
+  newIds.utId = -1;
+  newIds.utUserId = -1;
+  newIds.beamId = -1;
+  newIds.gwId = -1;
+  newIds.gwUserId = -1;
+
+  uint64_t key;
+
+  if (GetMac48Key (mac, key))
     {
-      m_macToGwIdMap.clear ();
+      // keep the table at most half full, rehashing the keys into a table of double size
+      if (2 * (m_macIds.size () - m_otherMacIndices.size () + 1) > m_mac48Keys.size ())
+        {
+          std::size_t size = std::max<std::size_t> (64, 2 * m_mac48Keys.size ());
+          std::vector<uint64_t> oldKeys (size, 0);
+          std::vector<uint32_t> oldIndices (size, 0);
+
+          // swap the empty table in, the old one is left in oldKeys and oldIndices
+          oldKeys.swap (m_mac48Keys);
+          oldIndices.swap (m_mac48Indices);
+
+          for (uint32_t i = 0; i < oldKeys.size (); i++)
+            {
+              if (oldKeys[i] != 0)
+                {
+                  uint32_t slot = FindMac48Slot (oldKeys[i]);
+                  m_mac48Keys[slot] = oldKeys[i];
+                  m_mac48Indices[slot] = oldIndices[i];
+                }
+            }
+        }
+
+      uint32_t slot = FindMac48Slot (key);
+
+      if (m_mac48Keys[slot] == 0)
+        {
+          m_mac48Keys[slot] = key;
+          m_mac48Indices[slot] = m_macIds.size ();
+          m_macIds.push_back (newIds);
+        }
+
+      return m_macIds[m_mac48Indices[slot]];
     }
 
-  // GW user ID maps
+  std::pair<std::map<Address, uint32_t>::iterator, bool> result = m_otherMacIndices.insert (std::make_pair (mac, m_macIds.size ()));
 
-  if (!m_macToGwUserIdMap.empty ())
+  if (result.second)
     {
-      m_macToGwUserIdMap.clear ();
+      m_macIds.push_back (newIds);
     }
-  m_gwUserIdIndex = 1;
 
-  m_enableMapPrint = false;
+  return m_macIds[result.first->second];
 }
 
 // ATTACH TO MAPS
@@ -134,13 +229,15 @@ SatIdMapper::AttachMacToTraceId (Address mac)
   NS_LOG_FUNCTION (this);
 
   const uint32_t ret = m_traceIdIndex;
-  std::pair < std::map<Address, uint32_t>::iterator, bool> resultMacToTraceId = m_macToTraceIdMap.insert (std::make_pair (mac, m_traceIdIndex));
+  macIds_s &ids = FindOrAddMac (mac);
 
-  if (resultMacToTraceId.second == false)
+  if (ids.traceId >= 0)
     {
       NS_FATAL_ERROR ("SatIdMapper::AttachMacToTraceId - MAC to Trace ID failed");
     }
 
+  ids.traceId = m_traceIdIndex;
+
   NS_LOG_INFO ("SatIdMapper::AttachMacToTraceId - Added MAC " << mac << " with Trace ID " << m_traceIdIndex);
 
   m_traceIdIndex++;
@@ -153,13 +250,15 @@ SatIdMapper::AttachMacToUtId (Address mac)
   NS_LOG_FUNCTION (this);
 
   const uint32_t ret = m_utIdIndex;
-  std::pair < std::map<Address, uint32_t>::iterator, bool> resultMacToUtId = m_macToUtIdMap.insert (std::make_pair (mac, m_utIdIndex));
+  macIds_s &ids = FindOrAddMac (mac);
 
-  if (resultMacToUtId.second == false)
+  if (ids.utId >= 0)
     {
       NS_FATAL_ERROR ("SatIdMapper::AttachMacToUtId - MAC to UT ID failed");
     }
 
+  ids.utId = m_utIdIndex;
+
   NS_LOG_INFO ("SatIdMapper::AttachMacToUtId - Added MAC " << mac << " with UT ID " << m_utIdIndex);
 
   m_utIdIndex++;
@@ -172,13 +271,15 @@ SatIdMapper::AttachMacToUtUserId (Address mac)
   NS_LOG_FUNCTION (this);
 
   const uint32_t ret = m_utUserIdIndex;
-  std::pair < std::map<Address, uint32_t>::iterator, bool> resultMacToUtUserId = m_macToUtUserIdMap.insert (std::make_pair (mac, m_utUserIdIndex));
+  macIds_s &ids = FindOrAddMac (mac);
 
-  if (resultMacToUtUserId.second == false)
+  if (ids.utUserId >= 0)
     {
       NS_FATAL_ERROR ("SatIdMapper::AttachMacToUtUserId - MAC to UT user ID failed");
     }
 
+  ids.utUserId = m_utUserIdIndex;
+
   NS_LOG_INFO ("SatIdMapper::AttachMacToUtUserId - Added MAC " << mac << " with UT user ID " << m_utUserIdIndex);
 
   m_utUserIdIndex++;
@@ -190,13 +291,15 @@ SatIdMapper::AttachMacToBeamId (Address mac, uint32_t beamId)
 {
   NS_LOG_FUNCTION (this);
 
-  std::pair < std::map<Address, uint32_t>::iterator, bool> resultMacToBeamId = m_macToBeamIdMap.insert (std::make_pair (mac, beamId));
+  macIds_s &ids = FindOrAddMac (mac);
 
-  if (resultMacToBeamId.second == false)
+  if (ids.beamId >= 0)
     {
       NS_FATAL_ERROR ("SatIdMapper::AttachMacToBeamId - MAC to beam ID failed");
     }
 
+  ids.beamId = beamId;
+
   NS_LOG_INFO ("SatIdMapper::AttachMacToBeamId - Added MAC " << mac << " with beam ID " << beamId);
 }
 
@@ -205,13 +308,15 @@ SatIdMapper::AttachMacToGwId (Address mac, uint32_t gwId)
 {
   NS_LOG_FUNCTION (this);
 
-  std::pair < std::map<Address, uint32_t>::iterator, bool> resultMacToGwId = m_macToGwIdMap.insert (std::make_pair (mac, gwId));
+  macIds_s &ids = FindOrAddMac (mac);
 
-  if (resultMacToGwId.second == false)
+  if (ids.gwId >= 0)
     {
       NS_FATAL_ERROR ("SatIdMapper::AttachMacToGwId - MAC to GW ID failed");
     }
 
+  ids.gwId = gwId;
+
   NS_LOG_INFO ("SatIdMapper::AttachMacToGwId - Added MAC " << mac << " with GW ID " << gwId);
 }
 
@@ -221,13 +326,15 @@ SatIdMapper::AttachMacToGwUserId (Address mac)
   NS_LOG_FUNCTION (this);
 
   const uint32_t ret = m_gwUserIdIndex;
-  std::pair < std::map<Address, uint32_t>::iterator, bool> resultMacToGwUserId = m_macToGwUserIdMap.insert (std::make_pair (mac, m_gwUserIdIndex));
+  macIds_s &ids = FindOrAddMac (mac);
 
-  if (resultMacToGwUserId.second == false)
+  if (ids.gwUserId >= 0)
     {
       NS_FATAL_ERROR ("SatIdMapper::AttachMacToGwUserId - MAC to GW user ID failed");
     }
 
+  ids.gwUserId = m_gwUserIdIndex;
+
   NS_LOG_INFO ("SatIdMapper::AttachMacToGwUserId - Added MAC " << mac << " with GW user ID " << m_gwUserIdIndex);
 
   m_gwUserIdIndex++;
@@ -241,14 +348,14 @@ SatIdMapper::GetTraceIdWithMac (Address mac) const
 {
   NS_LOG_FUNCTION (this);
 
-  std::map<Address, uint32_t>::const_iterator iter = m_macToTraceIdMap.find (mac);
+  const macIds_s *ids = FindMac (mac);
 
-  if (iter == m_macToTraceIdMap.end ())
+  if (ids == NULL)
     {
       return -1;
     }
 
-  return iter->second;
+  return ids->traceId;
 }
 
 int32_t
@@ -256,14 +363,14 @@ SatIdMapper::GetUtIdWithMac (Address mac) const
 {
   NS_LOG_FUNCTION (this);
 
-  std::map<Address, uint32_t>::const_iterator iter = m_macToUtIdMap.find (mac);
+  const macIds_s *ids = FindMac (mac);
 
-  if (iter == m_macToUtIdMap.end ())
+  if (ids == NULL)
     {
       return -1;
     }
 
-  return iter->second;
+  return ids->utId;
 }
 
 int32_t
@@ -271,14 +378,14 @@ SatIdMapper::GetUtUserIdWithMac (Address mac) const
 {
   NS_LOG_FUNCTION (this);
 
-  std::map<Address, uint32_t>::const_iterator iter = m_macToUtUserIdMap.find (mac);
+  const macIds_s *ids = FindMac (mac);
 
-  if (iter == m_macToUtUserIdMap.end ())
+  if (ids == NULL)
     {
       return -1;
     }
 
-  return iter->second;
+  return ids->utUserId;
 }
 
 int32_t
@@ -286,14 +393,14 @@ SatIdMapper::GetBeamIdWithMac (Address mac) const
 {
   NS_LOG_FUNCTION (this);
 
-  std::map<Address, uint32_t>::const_iterator iter = m_macToBeamIdMap.find (mac);
+  const macIds_s *ids = FindMac (mac);
 
-  if (iter == m_macToBeamIdMap.end ())
+  if (ids == NULL)
     {
       return -1;
     }
 
-  return iter->second;
+  return ids->beamId;
 }
 
 int32_t
@@ -301,14 +408,14 @@ SatIdMapper::GetGwIdWithMac (Address mac) const
 {
   NS_LOG_FUNCTION (this);
 
-  std::map<Address, uint32_t>::const_iterator iter = m_macToGwIdMap.find (mac);
+  const macIds_s *ids = FindMac (mac);
 
-  if (iter == m_macToGwIdMap.end ())
+  if (ids == NULL)
     {
       return -1;
     }
 
-  return iter->second;
+  return ids->gwId;
 }
 
 int32_t
@@ -316,14 +423,14 @@ SatIdMapper::GetGwUserIdWithMac (Address mac) const
 {
   NS_LOG_FUNCTION (this);
 
-  std::map<Address, uint32_t>::const_iterator iter = m_macToGwUserIdMap.find (mac);
+  const macIds_s *ids = FindMac (mac);
 
-  if (iter == m_macToGwUserIdMap.end ())
+  if (ids == NULL)
     {
       return -1;
     }
 
-  return iter->second;
+  return ids->gwUserId;
 }
 
 // NODE GETTERS
@@ -454,36 +561,33 @@ SatIdMapper::GetMacInfo (Address mac) const
 
   out << mac << " ";
 
-  std::map<Address, uint32_t>::const_iterator iterTrace = m_macToTraceIdMap.find (mac);
+  const macIds_s *ids = FindMac (mac);
 
-  if (!(iterTrace == m_macToTraceIdMap.end ()))
+  if (ids != NULL)
     {
-      out << "trace ID: " << iterTrace->second << " ";
-      isInMap = true;
-    }
-
-  std::map<Address, uint32_t>::const_iterator iterBeam = m_macToBeamIdMap.find (mac);
-
-  if (!(iterBeam == m_macToBeamIdMap.end ()))
-    {
-      out << "beam ID: " << iterBeam->second << " ";
-      isInMap = true;
-    }
-
-  std::map<Address, uint32_t>::const_iterator iterUt = m_macToUtIdMap.find (mac);
+      if (ids->traceId >= 0)
+        {
+          out << "trace ID: " << ids->traceId << " ";
+          isInMap = true;
+        }
 
-  if (!(iterUt == m_macToUtIdMap.end ()))
-    {
-      out << "UT ID: " << iterUt->second << " ";
-      isInMap = true;
-    }
+      if (ids->beamId >= 0)
+        {
+          out << "beam ID: " << ids->beamId << " ";
+          isInMap = true;
+        }
 
-  std::map<Address, uint32_t>::const_iterator iterGw = m_macToGwIdMap.find (mac);
+      if (ids->utId >= 0)
+        {
+          out << "UT ID: " << ids->utId << " ";
+          isInMap = true;
+        }
 
-  if (!(iterGw == m_macToGwIdMap.end ()))
-    {
-      out << "GW ID: " << iterGw->second << " ";
-      isInMap = true;
+      if (ids->gwId >= 0)
+        {
+          out << "GW ID: " << ids->gwId << " ";
+          isInMap = true;
+        }
     }
 
   std::string infoString = out.str ();
@@ -503,11 +607,22 @@ SatIdMapper::PrintTraceMap () const
 {
   NS_LOG_FUNCTION (this);
 
-  std::map<Address, uint32_t>::const_iterator iter;
+  // print in the address order
+  std::vector<Address> traceMacs;
+
+  for (uint32_t i = 0; i < m_macIds.size (); i++)
+    {
+      if (m_macIds[i].traceId >= 0)
+        {
+          traceMacs.push_back (m_macIds[i].mac);
+        }
+    }
+
+  std::sort (traceMacs.begin (), traceMacs.end ());
 
-  for (iter = m_macToTraceIdMap.begin (); iter != m_macToTraceIdMap.end (); ++iter)
+  for (uint32_t i = 0; i < traceMacs.size (); i++)
     {
-      std::cout << GetMacInfo (iter->first) << std::endl;
+      std::cout << GetMacInfo (traceMacs[i]) << std::endl;
     }
 }
 
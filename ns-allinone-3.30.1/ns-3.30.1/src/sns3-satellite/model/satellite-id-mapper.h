@@ -21,13 +21,14 @@
 #define SATELLITE_ID_MAPPER_H
 
 #include <ns3/object.h>
+#include <ns3/address.h>
 #include <map>
+#include <vector>
 
 namespace ns3 {
 
 
 class Node;
-class Address;
 
 /**
  * \ingroup satellite
@@ -36,6 +37,11 @@ class Address;
  * MAC-address to UT/GW/user/beam ID. These IDs can be obtained with
  * MAC-address by using the provided functions. It is also possible to
  * obtain the MAC-address with node.
+ *
+ * All the IDs of a MAC address are kept in one entry. MAC48 addresses are
+ * found from their entries with an open addressing hash table keyed by the
+ * 48 bits of the address, so that the IDs are got in constant time whatever
+ * the number of UTs.
  */
 class SatIdMapper : public Object
 {
@@ -225,34 +231,71 @@ private:
   uint32_t m_gwUserIdIndex;
 
   /**
-   * \brief Map for MAC to trace ID conversion
+   * \brief Struct for the IDs of a MAC address, -1 for the IDs the address
+   * has not been attached to
+   */
+  typedef struct
+  {
+    Address mac;
+    int32_t traceId;
+    int32_t utId;
+    int32_t utUserId;
+    int32_t beamId;
+    int32_t gwId;
+    int32_t gwUserId;
+  } macIds_s;
+
+  /**
+   * \brief IDs of the attached MAC addresses, in the order the addresses were
+   * first attached
+   */
+  std::vector<macIds_s> m_macIds;
+
+  /**
+   * \brief Slots of the hash table of the MAC48 addresses, the 48 bits of the
+   * address plus one or zero for an empty slot
    */
-  std::map <Address, uint32_t> m_macToTraceIdMap;
+  std::vector<uint64_t> m_mac48Keys;
 
   /**
-   * \brief Map for MAC to UT ID conversion
+   * \brief Positions in m_macIds of the addresses in the slots of m_mac48Keys
    */
-  std::map <Address, uint32_t> m_macToUtIdMap;
+  std::vector<uint32_t> m_mac48Indices;
 
   /**
-   * \brief Map for MAC to UT user ID conversion
+   * \brief Positions in m_macIds of the addresses other than MAC48 addresses
    */
-  std::map <Address, uint32_t> m_macToUtUserIdMap;
+  std::map <Address, uint32_t> m_otherMacIndices;
 
   /**
-   * \brief Map for MAC to beam ID conversion
+   * \brief Function for getting the hash table key of a MAC48 address
+   * \param mac MAC address
+   * \param key the 48 bits of the address plus one
+   * \return false if the address is not a MAC48 address
    */
-  std::map <Address, uint32_t> m_macToBeamIdMap;
+  static bool GetMac48Key (const Address &mac, uint64_t &key);
 
   /**
-   * \brief Map for MAC to GW ID conversion
+   * \brief Function for getting the hash table slot of a key
+   * \param key key
+   * \return the slot of the key, or the empty slot where it would be added
    */
-  std::map <Address, uint32_t> m_macToGwIdMap;
+  uint32_t FindMac48Slot (uint64_t key) const;
 
   /**
-   * \brief Map for MAC to GW user ID conversion
+   * \brief Function for getting the IDs of a MAC address
+   * \param mac MAC address
+   * \return the IDs of the address, NULL if it has not been attached
+   */
+  const macIds_s * FindMac (const Address &mac) const;
+
+  /**
+   * \brief Function for getting the IDs of a MAC address, adding the
+   * address if it has not been attached
+   * \param mac MAC address
+   * \return the IDs of the address
    */
-  std::map <Address, uint32_t> m_macToGwUserIdMap;
+  macIds_s & FindOrAddMac (const Address &mac);
 
   /**
    * \brief Is map printing enabled or not
@@ -140,6 +140,14 @@ SatInterferenceOutputTraceContainer::FindNode (key_t key)
   return iter->second;
 }
 
+Ptr<SatOutputFileStreamDoubleContainer>
+SatInterferenceOutputTraceContainer::GetNodeContainer (key_t key)
+{
+  NS_LOG_FUNCTION (this);
+
+  return FindNode (key);
+}
+
 void
 SatInterferenceOutputTraceContainer::WriteToFile ()
 {
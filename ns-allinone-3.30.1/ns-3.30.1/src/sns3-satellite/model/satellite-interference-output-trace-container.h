@@ -80,6 +80,15 @@ public:
    */
   void AddToContainer (key_t key, std::vector<double> newItem);
 
+  /**
+   * \brief Get the container matching the key, so that the values of the
+   * node can be added to it without looking it up again. The container
+   * stays valid as long as IsWritable returns true for it.
+   * \param key key
+   * \return matching container, NULL if the node has not been mapped to IDs
+   */
+  Ptr<SatOutputFileStreamDoubleContainer> GetNodeContainer (key_t key);
+
   /**
    * Function for enabling / disabling figure output
    * \param enableFigureOutput
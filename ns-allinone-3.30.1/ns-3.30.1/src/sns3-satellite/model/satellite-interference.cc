@@ -31,7 +31,8 @@ SatInterference::InterferenceChangeEvent::InterferenceChangeEvent (uint32_t id,
     m_endTime (m_startTime + rxDuration),
     m_rxPower (rxPower),
     m_id (id),
-    m_satEarthStationAddress (satEarthStationAddress)
+    m_satEarthStationAddress (satEarthStationAddress),
+    m_traceContainer ()
 {
 }
 SatInterference::InterferenceChangeEvent::~InterferenceChangeEvent ()
@@ -85,6 +86,22 @@ SatInterference::InterferenceChangeEvent::GetSatEarthStationAddress () const
 
   return m_satEarthStationAddress;
 }
+
+void
+SatInterference::InterferenceChangeEvent::SetTraceContainer (Ptr<SatOutputFileStreamDoubleContainer> traceContainer)
+{
+  NS_LOG_FUNCTION (this);
+
+  m_traceContainer = traceContainer;
+}
+
+Ptr<SatOutputFileStreamDoubleContainer>
+SatInterference::InterferenceChangeEvent::GetTraceContainer () const
+{
+  NS_LOG_FUNCTION (this);
+
+  return m_traceContainer;
+}
 /****************************************************************
  *       The actual SatInterference
  ****************************************************************/
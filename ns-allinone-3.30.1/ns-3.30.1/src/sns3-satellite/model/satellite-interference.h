@@ -25,6 +25,7 @@
 #include "ns3/simple-ref-count.h"
 #include "ns3/nstime.h"
 #include "ns3/mac48-address.h"
+#include "ns3/satellite-output-fstream-double-container.h"
 
 namespace ns3 {
 
@@ -85,12 +86,23 @@ public:
       */
     Address GetSatEarthStationAddress (void) const;
 
+    /**
+      * \param traceContainer Interference trace container of the earth station
+      */
+    void SetTraceContainer (Ptr<SatOutputFileStreamDoubleContainer> traceContainer);
+
+    /**
+      * \return Interference trace container of the earth station, NULL if not set
+      */
+    Ptr<SatOutputFileStreamDoubleContainer> GetTraceContainer (void) const;
+
 private:
     Time m_startTime;
     Time m_endTime;
     double m_rxPower;
     uint32_t m_id;
     Address m_satEarthStationAddress;
+    Ptr<SatOutputFileStreamDoubleContainer> m_traceContainer;
   };
 
   /**
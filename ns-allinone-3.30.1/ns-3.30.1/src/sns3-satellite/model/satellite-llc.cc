@@ -83,6 +83,7 @@ SatLlc::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
   m_rxCallback.Nullify ();
+  m_bufferChangedCallback.Nullify ();
 
   EncapContainer_t::iterator it;
 
@@ -277,6 +278,8 @@ SatLlc::AddEncap (Mac48Address source, Mac48Address dest, uint8_t flowId, Ptr<Sa
     {
       NS_LOG_INFO ("Add encapsulator with key (" << source << ", " << dest << ", " << (uint32_t) flowId << ")");
 
+      enc->SetBufferChangedCallback (m_bufferChangedCallback);
+
       std::pair<EncapContainer_t::iterator, bool> result = m_encaps.insert (std::make_pair (key, enc));
       if (result.second == false)
         {
@@ -414,6 +417,20 @@ SatLlc::SetCtrlMsgCallback (SatBaseEncapsulator::SendCtrlCallback cb)
   m_sendCtrlCallback = cb;
 }
 
+void
+SatLlc::SetBufferChangedCallback (SatBaseEncapsulator::BufferChangedCallback cb)
+{
+  NS_LOG_FUNCTION (this << &cb);
+
+  m_bufferChangedCallback = cb;
+
+  for (EncapContainer_t::iterator it = m_encaps.begin ();
+       it != m_encaps.end (); ++it)
+    {
+      it->second->SetBufferChangedCallback (cb);
+    }
+}
+
 void
 SatLlc::SetGwAddress (Mac48Address address)
 {
@@ -217,7 +217,7 @@ public:
    * \param flowId Flow id of this encapsulator queue
    * \param enc Encapsulator pointer
    */
-  void AddEncap (Mac48Address source, Mac48Address dest, uint8_t flowId, Ptr<SatBaseEncapsulator> enc);
+  virtual void AddEncap (Mac48Address source, Mac48Address dest, uint8_t flowId, Ptr<SatBaseEncapsulator> enc);
 
   /**
    * \brief Add an decapsulator entry for the LLC. This is called from the helpers
@@ -299,6 +299,13 @@ public:
    */
   void SetCtrlMsgCallback (SatBaseEncapsulator::SendCtrlCallback cb);
 
+  /**
+   * \brief Set the buffer changed callback to the current and to the later
+   * created encapsulators.
+   * \param cb callback to notify the buffer changes of the encapsulators.
+   */
+  void SetBufferChangedCallback (SatBaseEncapsulator::BufferChangedCallback cb);
+
   /**
    * \brief Set the GW address
    * \param address GW MAC address
@@ -397,6 +404,13 @@ protected:
   */
   SatBaseEncapsulator::SendCtrlCallback m_sendCtrlCallback;
 
+  /**
+   * Callback to notify the buffer changes. Note, that this is not
+   * actually used by the LLC but the encapsulators. It is just
+   * stored here.
+  */
+  SatBaseEncapsulator::BufferChangedCallback m_bufferChangedCallback;
+
 };
 
 } // namespace ns3
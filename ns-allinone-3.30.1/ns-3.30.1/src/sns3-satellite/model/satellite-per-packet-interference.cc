@@ -50,9 +50,12 @@ SatPerPacketInterference::GetInstanceTypeId (void) const
 
 SatPerPacketInterference::SatPerPacketInterference ()
   : m_residualPowerW (0.0),
+    m_residualTimedPowerW (0.0),
+    m_timeBase (),
     m_rxing (false),
     m_nextEventId (0),
     m_enableTraceOutput (false),
+    m_traceContainers (),
     m_channelType (),
     m_rxBandwidth_Hz ()
 {
@@ -61,9 +64,12 @@ SatPerPacketInterference::SatPerPacketInterference ()
 
 SatPerPacketInterference::SatPerPacketInterference (SatEnums::ChannelType_t channelType, double rxBandwidthHz)
   : m_residualPowerW (0.0),
+    m_residualTimedPowerW (0.0),
+    m_timeBase (),
     m_rxing (false),
     m_nextEventId (0),
     m_enableTraceOutput (true),
+    m_traceContainers (),
     m_channelType (channelType),
     m_rxBandwidth_Hz (rxBandwidthHz)
 {
@@ -94,26 +100,19 @@ SatPerPacketInterference::DoAdd (Time duration, double power, Address rxAddress)
 
   NS_LOG_INFO ( "Add change: Duration= " << duration << ", Power= " << power << ", Time: " << now );
 
-  // do update and clean-ups, if we are not receiving
-  if (!m_rxing)
+  if (m_enableTraceOutput)
     {
-      InterferenceChanges::iterator nowIterator = m_interferenceChanges.upper_bound (now);
-
-      for (InterferenceChanges::iterator i = m_interferenceChanges.begin (); i != nowIterator; i++)
-        {
-          NS_LOG_INFO ( "Change to erase: Time= " << i->first << ", Id= " << i->second.first << ", PowerValue= " << i->second.second);
-
-          m_residualPowerW += i->second.second;
-
-          NS_LOG_INFO ( "First power after erase: " << m_residualPowerW);
-        }
-      m_interferenceChanges.erase (m_interferenceChanges.begin (), nowIterator);
+      event->SetTraceContainer (GetTraceContainer (rxAddress));
     }
 
-  NS_LOG_INFO ( "Change count before addition: " << m_interferenceChanges.size () );
+  // do update and clean-ups, also while receiving
+  CommitChanges (now);
+  ReclaimChanges (now);
+
+  NS_LOG_INFO ( "Change count before addition: " << m_interferenceChanges.size () << " pending, " << m_pastChanges.size () << " past" );
 
   // if no changes in future, first power should be zero
-  if ( m_interferenceChanges.size () == 0 )
+  if ( m_interferenceChanges.empty () && m_pastChanges.empty () )
     {
       if ( ( m_residualPowerW != 0 ) && std::fabs (m_residualPowerW) < std::numeric_limits<long double>::epsilon () )
         {
@@ -126,7 +125,7 @@ SatPerPacketInterference::DoAdd (Time duration, double power, Address rxAddress)
   m_interferenceChanges.insert (std::make_pair (now, InterferenceChange (event->GetId (), power)));
   m_interferenceChanges.insert (std::make_pair (event->GetEndTime (), InterferenceChange (event->GetId (), -power)));
 
-  NS_LOG_INFO ( "Change count after addition: " << m_interferenceChanges.size () );
+  NS_LOG_INFO ( "Change count after addition: " << m_interferenceChanges.size () << " pending" );
 
   if ( m_residualPowerW < 0 )
     {
@@ -147,56 +146,44 @@ SatPerPacketInterference::DoCalculate (Ptr<SatInterference::InterferenceChangeEv
       NS_FATAL_ERROR ("Receiving is not set on!!!");
     }
 
-  double ifPowerW = m_residualPowerW;
-  double rxDuration = event->GetDuration ().GetDouble ();
-  double rxEndTime = event->GetEndTime ().GetDouble ();
-  bool ownStartReached = false;
+  NS_ASSERT_MSG (Now () >= event->GetEndTime (), "Interference calculated before the end of receiving");
 
-  NS_LOG_INFO ( "Calculate: IfPower (W)= " << ifPowerW << ", Duration= " << event->GetDuration () <<
-                 ", StartTime= " << event->GetStartTime () << ", EndTime= " << event->GetEndTime () );
+  CommitChanges (Now ());
 
-  InterferenceChanges::iterator currentItem = m_interferenceChanges.begin ();
+  double rxDuration = event->GetDuration ().GetDouble ();
+  double rxEndTime = (event->GetEndTime () - m_timeBase).GetDouble ();
 
-  // calculate power values until own "stop" event found (own negative power event)
-  while ( (currentItem != m_interferenceChanges.end ())
-          && !( (event->GetId () == currentItem->second.first) && (event->GetRxPower () == -currentItem->second.second)) )
-    {
-      if (event->GetId () == currentItem->second.first)
-        {
-          // stop increasing power value fully, when own 'start' event is reached
-          // needed to support multiple simultaneous receiving (currently not supported)
-          // own event is not updated to ifPower
-          ownStartReached = true;
-        }
-      else if (ownStartReached)
-        {
-          // increase/decrease interference power with relative part of duration of power change in list
-          double itemTime = currentItem->first.GetDouble ();
-          ifPowerW += ((rxEndTime - itemTime) / rxDuration) * currentItem->second.second;
+  NS_LOG_INFO ( "Calculate: Duration= " << event->GetDuration () <<
+                 ", StartTime= " << event->GetStartTime () << ", EndTime= " << event->GetEndTime () );
 
-          NS_LOG_INFO ( "Update (partial): ID: " << currentItem->second.first << ", Power (W)= " << currentItem->second.second <<
-                         ", Time= " << currentItem->first << ", DeltaTime= " << (rxEndTime - itemTime) );
+  std::size_t startIndex = FindPastChange (event->GetStartTime ());
+  std::size_t endIndex = FindPastChange (event->GetEndTime ());
 
-          NS_LOG_INFO ( "IfPower after update: " << ifPowerW );
-        }
-      else
-        {
-          // increase/decrease interference power with full power change in list
-          ifPowerW += currentItem->second.second;
+  /**
+   * Power changes before own start are counted fully, power changes during the receiving
+   * with the relative part of the receiving duration they are on, i.e.
+   * sum of power * (end - time) / duration = (end * sum of power - sum of power * time) / duration.
+   * Own start is one of the changes during the receiving with relative part 1, own end is
+   * not, since it is at the end of receiving.
+   */
+  long double powerChangesW = GetPowerSum (endIndex) - GetPowerSum (startIndex);
+  long double timedPowerChangesW = GetTimedPowerSum (endIndex) - GetTimedPowerSum (startIndex);
 
-          NS_LOG_INFO ( "Update (full): ID: " << currentItem->second.first << ", Power (W)= " << currentItem->second.second );
-          NS_LOG_INFO ( "IfPower after update: " << ifPowerW );
-        }
+  double ifPowerW = GetPowerSum (startIndex)
+    + (rxEndTime * powerChangesW - timedPowerChangesW) / rxDuration
+    - event->GetRxPower ();
 
-      currentItem++;
-    }
+  NS_LOG_INFO ( "IfPower (W)= " << ifPowerW << ", changes during receiving: " << endIndex - startIndex );
 
   if (m_enableTraceOutput)
     {
-      std::vector<double> tempVector;
-      tempVector.push_back (Now ().GetSeconds ());
-      tempVector.push_back (ifPowerW / m_rxBandwidth_Hz);
-      Singleton<SatInterferenceOutputTraceContainer>::Get ()->AddToContainer (std::make_pair (event->GetSatEarthStationAddress (), m_channelType), tempVector);
+      Ptr<SatOutputFileStreamDoubleContainer> traceContainer = event->GetTraceContainer ();
+
+      if (traceContainer != NULL && traceContainer->IsWritable ())
+        {
+          double sample[SatBaseTraceContainer::INTF_TRACE_DEFAULT_NUMBER_OF_COLUMNS] = {Now ().GetSeconds (), ifPowerW / m_rxBandwidth_Hz};
+          traceContainer->AddToContainer (sample, SatBaseTraceContainer::INTF_TRACE_DEFAULT_NUMBER_OF_COLUMNS);
+        }
     }
 
   return ifPowerW;
@@ -208,8 +195,11 @@ SatPerPacketInterference::DoReset (void)
   NS_LOG_FUNCTION (this);
 
   m_interferenceChanges.clear ();
+  m_pastChanges.clear ();
+  m_traceContainers.clear ();
   m_rxing = false;
   m_residualPowerW = 0.0;
+  m_residualTimedPowerW = 0.0;
 }
 
 void
@@ -217,9 +207,10 @@ SatPerPacketInterference::DoNotifyRxStart (Ptr<SatInterference::InterferenceChan
 {
   NS_LOG_FUNCTION (this);
 
-  std::pair<std::set<uint32_t>::iterator, bool> result = m_rxEventIds.insert (event->GetId ());
+  std::pair<std::map<uint32_t, Time>::iterator, bool> result = m_rxEventIds.insert (std::make_pair (event->GetId (), event->GetStartTime ()));
 
   NS_ASSERT (result.second);
+  NS_ASSERT (m_pastChanges.empty () || m_pastChanges.front ().time <= event->GetStartTime ());
   m_rxing = true;
 }
 
@@ -234,6 +225,108 @@ SatPerPacketInterference::DoNotifyRxEnd (Ptr<SatInterference::InterferenceChange
     {
       m_rxing = false;
     }
+
+  ReclaimChanges (Now ());
+}
+
+void
+SatPerPacketInterference::CommitChanges (Time now)
+{
+  NS_LOG_FUNCTION (this << now);
+
+  InterferenceChanges::iterator nowIterator = m_interferenceChanges.upper_bound (now);
+
+  for (InterferenceChanges::iterator i = m_interferenceChanges.begin (); i != nowIterator; i++)
+    {
+      if (m_pastChanges.empty ())
+        {
+          m_timeBase = i->first;
+        }
+
+      PastInterferenceChange change;
+      change.time = i->first;
+      change.powerSumW = GetPowerSum (m_pastChanges.size ()) + i->second.second;
+      change.timedPowerSumW = GetTimedPowerSum (m_pastChanges.size ())
+        + i->second.second * (i->first - m_timeBase).GetDouble ();
+      m_pastChanges.push_back (change);
+    }
+
+  m_interferenceChanges.erase (m_interferenceChanges.begin (), nowIterator);
+}
+
+void
+SatPerPacketInterference::ReclaimChanges (Time now)
+{
+  NS_LOG_FUNCTION (this << now);
+
+  // changes before the oldest ongoing receiving are only needed as a sum
+  Time oldestRxStart = m_rxEventIds.empty () ? now : std::min (now, m_rxEventIds.begin ()->second);
+
+  while (!m_pastChanges.empty () && m_pastChanges.front ().time < oldestRxStart)
+    {
+      m_residualPowerW = m_pastChanges.front ().powerSumW;
+      m_residualTimedPowerW = m_pastChanges.front ().timedPowerSumW;
+      m_pastChanges.pop_front ();
+    }
+
+  if (m_pastChanges.empty ())
+    {
+      m_residualTimedPowerW = 0.0;
+    }
+}
+
+Ptr<SatOutputFileStreamDoubleContainer>
+SatPerPacketInterference::GetTraceContainer (Address address)
+{
+  NS_LOG_FUNCTION (this << address);
+
+  std::map<Address, Ptr<SatOutputFileStreamDoubleContainer> >::iterator iter = m_traceContainers.find (address);
+
+  if (iter == m_traceContainers.end ())
+    {
+      iter = m_traceContainers.insert (std::make_pair (address, Ptr<SatOutputFileStreamDoubleContainer> ())).first;
+    }
+
+  if (iter->second == NULL || !iter->second->IsWritable ())
+    {
+      iter->second = Singleton<SatInterferenceOutputTraceContainer>::Get ()->GetNodeContainer (std::make_pair (address, m_channelType));
+    }
+
+  return iter->second;
+}
+
+long double
+SatPerPacketInterference::GetPowerSum (std::size_t index) const
+{
+  return index == 0 ? m_residualPowerW : m_pastChanges[index - 1].powerSumW;
+}
+
+long double
+SatPerPacketInterference::GetTimedPowerSum (std::size_t index) const
+{
+  return index == 0 ? m_residualTimedPowerW : m_pastChanges[index - 1].timedPowerSumW;
+}
+
+std::size_t
+SatPerPacketInterference::FindPastChange (Time time) const
+{
+  std::size_t low = 0;
+  std::size_t high = m_pastChanges.size ();
+
+  while (low < high)
+    {
+      std::size_t middle = low + (high - low) / 2;
+      if (m_pastChanges[middle].time < time)
+        {
+          low = middle + 1;
+        }
+      else
+        {
+          high = middle;
+        }
+    }
+
+  return low;
 }
 
 void
@@ -22,7 +22,7 @@
 #define SATELLITE_PER_PACKET_INTERFERENCE_H
 
 #include <map>
-#include <set>
+#include <deque>
 #include "satellite-interference.h"
 #include "satellite-interference-output-trace-container.h"
 #include "satellite-enums.h"
@@ -34,6 +34,14 @@ namespace ns3 {
  * \brief Packet by packet interference. Interference is calculated
  * separately for each packet by listening to all transmissions within
  * the same SatChannel.
+ *
+ * Power changes of the transmissions are kept in two parts. Changes in the
+ * future are pending in a time ordered map. Changes in the past are moved to
+ * a time ordered list with prefix sums of the power changes and of the power
+ * changes weighted by their time, so the interference of a reception ending
+ * now is found by two binary searches, whatever the number of changes. The
+ * changes before the start of the oldest ongoing reception are not needed
+ * any more and are folded into the residual power.
  */
 class SatPerPacketInterference : public SatInterference
 {
@@ -128,6 +136,59 @@ private:
    */
   typedef std::multimap <Time, InterferenceChange > InterferenceChanges;
 
+  /**
+   * \brief Past power change with the prefix sums up to and including it
+   */
+  typedef struct
+  {
+    Time time;
+    long double powerSumW;        // sum of the power changes
+    long double timedPowerSumW;   // sum of the power changes weighted by their time since m_timeBase
+  } PastInterferenceChange;
+
+  /**
+   * \brief Move the pending power changes up to the given time to the past changes.
+   * \param now Current time
+   */
+  void CommitChanges (Time now);
+
+  /**
+   * \brief Fold the past power changes not needed by any ongoing reception into the
+   * residual power.
+   * \param now Current time
+   */
+  void ReclaimChanges (Time now);
+
+  /**
+   * \brief Get the interference trace container of an earth station, resolving
+   * it from the trace container singleton only when not resolved yet or written.
+   * \param address Earth station address
+   * \return trace container, NULL if the earth station is not traced
+   */
+  Ptr<SatOutputFileStreamDoubleContainer> GetTraceContainer (Address address);
+
+  /**
+   * \brief Get the sum of the power changes before a past change, residual power included.
+   * \param index Index of the past change
+   * \return sum of the power changes
+   */
+  long double GetPowerSum (std::size_t index) const;
+
+  /**
+   * \brief Get the sum of the power changes before a past change weighted by their time
+   * since m_timeBase.
+   * \param index Index of the past change
+   * \return sum of the weighted power changes
+   */
+  long double GetTimedPowerSum (std::size_t index) const;
+
+  /**
+   * \brief Get the index of the first past power change at or after a time.
+   * \param time Time
+   * \return index in m_pastChanges
+   */
+  std::size_t FindPastChange (Time time) const;
+
   /**
    *
    * \param o
@@ -142,21 +203,39 @@ private:
   SatPerPacketInterference &operator = (const SatPerPacketInterference &o);
 
   /**
-   * \brief interference change list
+   * \brief pending interference change list, changes after the current time
    */
   InterferenceChanges m_interferenceChanges;
 
   /**
-   * \brief notified interference event IDs
+   * \brief past interference changes with prefix sums, in time order
    */
-  std::set <uint32_t> m_rxEventIds;
+  std::deque<PastInterferenceChange> m_pastChanges;
+
+  /**
+   * \brief notified interference event IDs with the start time of their receiving.
+   * IDs are given in time order, so the first one is the oldest ongoing reception.
+   */
+  std::map <uint32_t, Time> m_rxEventIds;
 
   /**
    * \brief Residual power value for interference.
-   * Sum of negative values in list m_changes, which positive value is not in list.
+   * Sum of the power changes folded out of the past change list.
    */
   long double m_residualPowerW;
 
+  /**
+   * \brief Time weighted sum of the power changes folded out of the past change list
+   * since it was last empty, base of its weighted prefix sums.
+   */
+  long double m_residualTimedPowerW;
+
+  /**
+   * \brief Time the weighted power changes are relative to, time of the first change
+   * added to the past change list since it was last empty.
+   */
+  Time m_timeBase;
+
   /**
    * \brief flag to indicate that at least one receiving is on
    */
@@ -172,6 +251,12 @@ private:
    */
   bool m_enableTraceOutput;
 
+  /**
+   * \brief Trace output containers of the earth stations seen by the receiver,
+   * resolved once per earth station and handed to its interference events
+   */
+  std::map<Address, Ptr<SatOutputFileStreamDoubleContainer> > m_traceContainers;
+
   /**
    *
    */
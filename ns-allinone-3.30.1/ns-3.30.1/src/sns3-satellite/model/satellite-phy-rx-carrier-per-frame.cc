@@ -25,6 +25,9 @@
 #include "satellite-phy-rx-carrier-per-frame.h"
 
 #include <algorithm>
+#include <functional>
+#include <map>
+#include <set>
 #include <ostream>
 #include <limits>
 #include <utility>
@@ -102,18 +105,8 @@ void
 SatPhyRxCarrierPerFrame::DoDispose ()
 {
 	SatPhyRxCarrierPerSlot::DoDispose ();
-  std::map<uint32_t,std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s> >::iterator iter;
-
-  for (iter = m_crdsaPacketContainer.begin (); iter != m_crdsaPacketContainer.end (); iter++)
-    {
-      std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s>::iterator iterList;
-      for (iterList = iter->second.begin (); iterList != iter->second.end (); iterList++)
-        {
-          iterList->rxParams = NULL;
-        }
-      iter->second.clear ();
-    }
   m_crdsaPacketContainer.clear ();
+  m_crdsaFrameGraph = crdsaFrameGraph_s ();
 }
 
 void
@@ -245,34 +238,21 @@ SatPhyRxCarrierPerFrame::UpdateRandomAccessLoad ()
 {
 	NS_LOG_FUNCTION (this);
 
-  std::vector<uint64_t> uniquePacketIds;
+  std::set<uint64_t> uniquePacketIds;
   uint32_t uniqueCrdsaBytes (0);
 
 	// Go through all the received CRDSA packets
-  std::map<uint32_t,std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s> >::iterator iter;
+  std::vector<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s>::iterator iter;
 	for (iter = m_crdsaPacketContainer.begin (); iter != m_crdsaPacketContainer.end (); iter++)
 	  {
-	    // Go through all the packets received in the same slot id
-      std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s>::iterator iterList;
-      for (iterList = iter->second.begin (); iterList != iter->second.end (); iterList++)
-        {
-          // It is sufficient to check the first packet Uid
-          uint64_t uid = iterList->rxParams->m_packetsInBurst.front ()->GetUid();
-
-          // Check if we have already counted the bytes of this transmission
-          std::vector<uint64_t>::iterator it = std::find (uniquePacketIds.begin (),
-                                                          uniquePacketIds.end (),
-                                                          uid);
-          // Not found -> is unique
-          if (it == uniquePacketIds.end ())
-            {
-              // Push this to accounted unique transmissions vector
-              uniquePacketIds.push_back (uid);
+      // It is sufficient to check the first packet Uid
+      uint64_t uid = iter->rxParams->m_packetsInBurst.front ()->GetUid();
 
-              // Update the load with FEC block size!
-              uniqueCrdsaBytes += iterList->rxParams->m_txInfo.fecBlockSizeInBytes;
-            }
-          // else, do nothing, i.e. this is a replica
+      // Count the bytes of this transmission only once, the other packets are replicas
+      if (uniquePacketIds.insert (uid).second)
+        {
+          // Update the load with FEC block size!
+          uniqueCrdsaBytes += iter->rxParams->m_txInfo.fecBlockSizeInBytes;
         }
 	  }
 
@@ -376,20 +356,7 @@ SatPhyRxCarrierPerFrame::AddCrdsaPacket (SatPhyRxCarrierPerFrame::crdsaPacketRxP
       NS_FATAL_ERROR ("SatPhyRxCarrierPerFrame::AddCrdsaPacket - CRDSA reception with 0 packets");
     }
 
-  std::map<uint32_t, std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s> >::iterator result;
-
-  result = m_crdsaPacketContainer.find (crdsaPacketParams.ownSlotId);
-
-  if (result == m_crdsaPacketContainer.end ())
-    {
-      std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s> tempList;
-      tempList.push_back (crdsaPacketParams);
-      m_crdsaPacketContainer.insert (std::make_pair (crdsaPacketParams.ownSlotId, tempList));
-    }
-  else
-    {
-      result->second.push_back (crdsaPacketParams);
-    }
+  m_crdsaPacketContainer.push_back (crdsaPacketParams);
 
   NS_LOG_INFO ("SatPhyRxCarrierPerFrame::AddCrdsaPacket - Packet in slot " << crdsaPacketParams.ownSlotId << " was added to the CRDSA packet container");
 
@@ -399,145 +366,190 @@ SatPhyRxCarrierPerFrame::AddCrdsaPacket (SatPhyRxCarrierPerFrame::crdsaPacketRxP
     }
 }
 
-std::vector<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s>
-SatPhyRxCarrierPerFrame::ProcessFrame ()
+void
+SatPhyRxCarrierPerFrame::BuildFrameGraph ()
 {
   NS_LOG_FUNCTION (this);
 
-  NS_LOG_INFO ("SatPhyRxCarrier::ProcessFrame - Time: " << Now ().GetSeconds ());
+  crdsaFrameGraph_s &graph = m_crdsaFrameGraph;
 
-  std::map<uint32_t,std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s> >::iterator iter;
-  std::vector<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s> combinedPacketsForFrame;
-  SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s processedPacket;
+  /// packets of the same slot are stored next to each other, in reception order
+  std::stable_sort (m_crdsaPacketContainer.begin (), m_crdsaPacketContainer.end (), CompareCrdsaSlotId);
 
-  bool nothingToProcess = true;
+  uint32_t numOfPackets = m_crdsaPacketContainer.size ();
 
-  NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessFrame - Packets to process: " << m_crdsaPacketContainer.size ());
+  graph.slotOfPacket.assign (numOfPackets, 0);
+  graph.isInFrame.assign (numOfPackets, true);
+  graph.payloadOfPacket.assign (numOfPackets, 0);
+  graph.slotFirst.clear ();
+  graph.packetsLeftInSlot.clear ();
+
+  for (uint32_t i = 0; i < numOfPackets; i++)
+    {
+      if (i == 0 || m_crdsaPacketContainer[i].ownSlotId != m_crdsaPacketContainer[i - 1].ownSlotId)
+        {
+          graph.slotFirst.push_back (i);
+          graph.packetsLeftInSlot.push_back (0);
+        }
+      graph.slotOfPacket[i] = graph.slotFirst.size () - 1;
+      graph.packetsLeftInSlot.back ()++;
+    }
+  graph.slotFirst.push_back (numOfPackets);
+
+  /// replicas of a payload have the same source and the same set of slots
+  std::map<std::pair<Mac48Address, std::vector<uint16_t> >, uint32_t> payloads;
+  std::map<std::pair<Mac48Address, uint16_t>, uint32_t> payloadsInSlots;
+  std::vector<uint16_t> slotIds;
 
-  do
+  for (uint32_t i = 0; i < numOfPackets; i++)
     {
-      NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessFrame - Searching for the next successfully received packet");
+      const SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s &packet = m_crdsaPacketContainer[i];
 
-      /// reset the flag
-      nothingToProcess = true;
+      slotIds.assign (packet.slotIdsForOtherReplicas.begin (), packet.slotIdsForOtherReplicas.end ());
+      slotIds.push_back (packet.ownSlotId);
+      std::sort (slotIds.begin (), slotIds.end ());
 
-      /// go through the packets
-      for (iter = m_crdsaPacketContainer.begin (); iter != m_crdsaPacketContainer.end (); iter++)
+      uint32_t payload = payloads.insert (std::make_pair (std::make_pair (packet.sourceAddress, slotIds), payloads.size ())).first->second;
+      graph.payloadOfPacket[i] = payload;
+
+      /// sanity check
+      std::pair<std::map<std::pair<Mac48Address, uint16_t>, uint32_t>::iterator, bool> result =
+        payloadsInSlots.insert (std::make_pair (std::make_pair (packet.sourceAddress, packet.ownSlotId), payload));
+
+      if (!result.second && result.first->second != payload)
         {
-          NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessFrame - Iterating slot: " << iter->first);
+          NS_FATAL_ERROR ("SatPhyRxCarrierPerFrame::BuildFrameGraph - Partially overlapping CRDSA slots");
+        }
+    }
 
-          if (iter->second.size () < 1)
-            {
-              NS_FATAL_ERROR ("SatPhyRxCarrierPerFrame::ProcessFrame - This should not happen");
-            }
+  /// the first index of a payload is counted up to its end, then down to its start while the packets are stored
+  graph.payloadFirst.assign (payloads.size () + 1, 0);
 
-          std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s>::iterator iterList;
+  for (uint32_t i = 0; i < numOfPackets; i++)
+    {
+      graph.payloadFirst[graph.payloadOfPacket[i]]++;
+    }
 
-          for (iterList = iter->second.begin (); iterList != iter->second.end (); iterList++)
-            {
-              NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessFrame - Iterating packet in slot: " << iterList->ownSlotId);
+  for (uint32_t u = 1; u < graph.payloadFirst.size (); u++)
+    {
+      graph.payloadFirst[u] += graph.payloadFirst[u - 1];
+    }
 
-              if (!iterList->packetHasBeenProcessed)
-                {
-                  NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessFrame - Found a packet ready for processing");
+  graph.payloadPackets.resize (numOfPackets);
 
-                  /// process the received packet
-                  *iterList = ProcessReceivedCrdsaPacket (*iterList, iter->second.size ());
+  for (uint32_t i = numOfPackets; i > 0; i--)
+    {
+      graph.payloadPackets[--graph.payloadFirst[graph.payloadOfPacket[i - 1]]] = i - 1;
+    }
 
-                  NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessFrame - Packet error: " << iterList->phyError);
+  /// in ascending order, which is a valid min-heap
+  graph.packetsToProcess.resize (numOfPackets);
 
-                  /// packet successfully received
-                  if (!iterList->phyError)
-                    {
-                      NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessFrame - Packet successfully received, breaking the slot iteration");
+  for (uint32_t i = 0; i < numOfPackets; i++)
+    {
+      graph.packetsToProcess[i] = i;
+    }
+
+  NS_LOG_INFO ("SatPhyRxCarrierPerFrame::BuildFrameGraph - Packets: " << numOfPackets
+               << ", slots: " << graph.packetsLeftInSlot.size ()
+               << ", unique payloads: " << payloads.size ());
+}
 
-                      nothingToProcess = false;
+std::vector<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s>
+SatPhyRxCarrierPerFrame::ProcessFrame ()
+{
+  NS_LOG_FUNCTION (this);
 
-                      /// save packet for processing outside the loop
-                      processedPacket = *iterList;
+  NS_LOG_INFO ("SatPhyRxCarrier::ProcessFrame - Time: " << Now ().GetSeconds ());
 
-                      /// remove the successfully received packet from the container
-                      iter->second.erase (iterList);
+  std::vector<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s> combinedPacketsForFrame;
+  crdsaFrameGraph_s &graph = m_crdsaFrameGraph;
 
-                      /// eliminate the interference caused by this packet to other packets in this slot
-                      EliminateInterference (iter,processedPacket);
+  NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessFrame - Packets to process: " << m_crdsaPacketContainer.size ());
 
-                      /// break the cycle
-                      break;
-                    }
-                }
-              else
-                {
-                  NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessFrame - This packet has already been processed");
-                }
-            }
+  BuildFrameGraph ();
 
-          /// successfully received packet found
-          if (!nothingToProcess)
-            {
-              NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessFrame - Packet successfully received, breaking the container iteration");
-              break;
-            }
+  /**
+   * The packet processed next is always the first packet of the frame which has not
+   * been processed since the last change of its slot. Packets are pushed to the heap
+   * when they are released for re-processing, entries of removed and already
+   * processed packets are skipped.
+   */
+  std::greater<uint32_t> isLater;
+
+  while (!graph.packetsToProcess.empty ())
+    {
+      std::pop_heap (graph.packetsToProcess.begin (), graph.packetsToProcess.end (), isLater);
+      uint32_t i = graph.packetsToProcess.back ();
+      graph.packetsToProcess.pop_back ();
+
+      SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s &packet = m_crdsaPacketContainer[i];
+
+      if (!graph.isInFrame[i] || packet.packetHasBeenProcessed)
+        {
+          continue;
         }
 
-      if (!nothingToProcess)
+      uint32_t slot = graph.slotOfPacket[i];
+
+      NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessFrame - Found a packet ready for processing in slot: " << packet.ownSlotId);
+
+      /// process the received packet
+      packet = ProcessReceivedCrdsaPacket (packet, graph.packetsLeftInSlot[slot]);
+
+      NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessFrame - Packet error: " << packet.phyError);
+
+      /// packet successfully received
+      if (!packet.phyError)
         {
           NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessFrame - Packet successfully received, processing the replicas");
 
+          /// remove the successfully received packet from its slot
+          RemoveCrdsaPacket (i);
+
+          /// eliminate the interference caused by this packet to other packets in this slot
+          EliminateInterference (slot, packet);
+
           /// find and remove replicas of the received packet
-          FindAndRemoveReplicas (processedPacket);
+          FindAndRemoveReplicas (i);
 
           /// save the the received packet
-          combinedPacketsForFrame.push_back (processedPacket);
+          combinedPacketsForFrame.push_back (packet);
         }
     }
-  while (!nothingToProcess);
 
-  NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessFrame - All successfully received packets processed, packets left in container: " << m_crdsaPacketContainer.size ());
+  NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessFrame - All successfully received packets processed, packets left in container: "
+               << m_crdsaPacketContainer.size () - combinedPacketsForFrame.size ());
 
-  do
+  for (uint32_t i = 0; i < m_crdsaPacketContainer.size (); i++)
     {
-      /// go through the packets
-      iter = m_crdsaPacketContainer.begin ();
-
-      if (iter != m_crdsaPacketContainer.end ())
+      if (!graph.isInFrame[i])
         {
-          std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s>::iterator iterList = iter->second.begin ();
+          continue;
+        }
 
-          if (iterList != iter->second.end ())
-            {
-              NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessFrame - Processing unsuccessfully received packet in slot: " << iterList->ownSlotId
-                           << " packet phy error: " << iterList->phyError
-                           << " packet has been processed: " << iterList->packetHasBeenProcessed);
+      SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s &packet = m_crdsaPacketContainer[i];
 
-              if (!iterList->packetHasBeenProcessed || !iterList->phyError)
-                {
-                  NS_FATAL_ERROR ("SatPhyRxCarrierPerFrame::ProcessFrame - All successfully received packets should have been processed by now");
-                }
+      NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessFrame - Processing unsuccessfully received packet in slot: " << packet.ownSlotId
+                   << " packet phy error: " << packet.phyError
+                   << " packet has been processed: " << packet.packetHasBeenProcessed);
 
-              /// find and remove replicas of the received packet
-              FindAndRemoveReplicas (*iterList);
+      if (!packet.packetHasBeenProcessed || !packet.phyError)
+        {
+          NS_FATAL_ERROR ("SatPhyRxCarrierPerFrame::ProcessFrame - All successfully received packets should have been processed by now");
+        }
 
-              /// save the the received packet
-              combinedPacketsForFrame.push_back (*iterList);
+      /// remove the packet from its slot
+      RemoveCrdsaPacket (i);
 
-              /// remove the packet from the container
-              iter->second.erase (iterList);
+      /// find and remove replicas of the received packet
+      FindAndRemoveReplicas (i);
 
-              /// remove the empty slot container
-              if (iter->second.empty ())
-                {
-                  m_crdsaPacketContainer.erase (iter);
-                }
-            }
-          else
-            {
-              /// remove the empty slot container
-              m_crdsaPacketContainer.erase (iter);
-            }
-        }
+      /// save the the received packet
+      combinedPacketsForFrame.push_back (packet);
     }
-  while (!m_crdsaPacketContainer.empty ());
+
+  m_crdsaPacketContainer.clear ();
 
   NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessFrame - Container processed, packets left: " << m_crdsaPacketContainer.size ());
 
@@ -628,42 +640,44 @@ SatPhyRxCarrierPerFrame::ProcessReceivedCrdsaPacket (SatPhyRxCarrierPerFrame::cr
 }
 
 void
-SatPhyRxCarrierPerFrame::FindAndRemoveReplicas (SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s packet)
+SatPhyRxCarrierPerFrame::RemoveCrdsaPacket (uint32_t packet)
 {
-  NS_LOG_FUNCTION (this);
-  NS_LOG_INFO ("SatPhyRxCarrier::FindAndRemoveReplicas - Time: " << Now ().GetSeconds ());
+  NS_LOG_FUNCTION (this << packet);
 
-  for (uint32_t i = 0; i < packet.slotIdsForOtherReplicas.size (); i++)
-    {
-      NS_LOG_INFO ("SatPhyRxCarrier::FindAndRemoveReplicas - Processing replica in slot: " << packet.slotIdsForOtherReplicas[i]);
+  NS_ASSERT (m_crdsaFrameGraph.isInFrame[packet]);
 
-      /// get the vector of packets for processing
-      std::map<uint32_t,std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s> >::iterator iter;
-      iter = m_crdsaPacketContainer.find (packet.slotIdsForOtherReplicas[i]);
+  m_crdsaFrameGraph.isInFrame[packet] = false;
+  m_crdsaFrameGraph.packetsLeftInSlot[m_crdsaFrameGraph.slotOfPacket[packet]]--;
+}
 
-      if (iter == m_crdsaPacketContainer.end ())
-        {
-          NS_FATAL_ERROR ("SatPhyRxCarrier::FindAndRemoveReplicas - This should not happen");
-        }
+void
+SatPhyRxCarrierPerFrame::FindAndRemoveReplicas (uint32_t packet)
+{
+  NS_LOG_FUNCTION (this << packet);
+  NS_LOG_INFO ("SatPhyRxCarrier::FindAndRemoveReplicas - Time: " << Now ().GetSeconds ());
 
-      std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s>::iterator iterList;
-      SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s removedPacket;
+  const crdsaFrameGraph_s &graph = m_crdsaFrameGraph;
+  const SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s &params = m_crdsaPacketContainer[packet];
+  uint32_t payload = graph.payloadOfPacket[packet];
+
+  for (uint32_t i = 0; i < params.slotIdsForOtherReplicas.size (); i++)
+    {
+      NS_LOG_INFO ("SatPhyRxCarrier::FindAndRemoveReplicas - Processing replica in slot: " << params.slotIdsForOtherReplicas[i]);
 
+      uint32_t removedPacket = 0;
       bool replicaFound = false;
 
-      for (iterList = iter->second.begin (); iterList != iter->second.end (); )
+      /// the replicas are the packets of the same payload, i.e. same UT & same slots
+      for (uint32_t j = graph.payloadFirst[payload]; j < graph.payloadFirst[payload + 1]; j++)
         {
-          /// check for the same UT & same slots
-          if (IsReplica (packet, iterList))
+          uint32_t replica = graph.payloadPackets[j];
+
+          if (graph.isInFrame[replica] && m_crdsaPacketContainer[replica].ownSlotId == params.slotIdsForOtherReplicas[i])
             {
               /// replica found for removal
               replicaFound = true;
-              removedPacket = *iterList;
-              iter->second.erase (iterList++);
-            }
-          else
-            {
-              ++iterList;
+              removedPacket = replica;
+              RemoveCrdsaPacket (replica);
             }
         }
 
@@ -672,151 +686,75 @@ SatPhyRxCarrierPerFrame::FindAndRemoveReplicas (SatPhyRxCarrierPerFrame::crdsaPa
           NS_FATAL_ERROR ("SatPhyRxCarrier::FindAndRemoveReplicas - Replica not found");
         }
 
-      if (!packet.phyError)
+      if (!params.phyError)
         {
-          EliminateInterference (iter, removedPacket);
+          EliminateInterference (graph.slotOfPacket[removedPacket], m_crdsaPacketContainer[removedPacket]);
         }
     }
 }
 
 void
-SatPhyRxCarrierPerFrame::EliminateInterference (
-		std::map<uint32_t,std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s> >::iterator iter,
-		SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s processedPacket)
+SatPhyRxCarrierPerFrame::EliminateInterference (uint32_t slot, const SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s &processedPacket)
 {
-  NS_LOG_FUNCTION (this);
+  NS_LOG_FUNCTION (this << slot);
   NS_LOG_INFO ("SatPhyRxCarrierPerFrame::EliminateInterference");
 
-  if (iter->second.empty ())
+  crdsaFrameGraph_s &graph = m_crdsaFrameGraph;
+
+  if (graph.packetsLeftInSlot[slot] == 0)
     {
-      NS_LOG_INFO ("SatPhyRxCarrierPerFrame::EliminateInterference - No other packets in this slot, erasing the slot container");
-      m_crdsaPacketContainer.erase (iter);
+      NS_LOG_INFO ("SatPhyRxCarrierPerFrame::EliminateInterference - No other packets in this slot");
+      return;
     }
-  else
-    {
-      std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s>::iterator iterList;
 
-      for (iterList = iter->second.begin (); iterList != iter->second.end (); iterList++)
+  for (uint32_t i = graph.slotFirst[slot]; i < graph.slotFirst[slot + 1]; i++)
+    {
+      if (!graph.isInFrame[i])
         {
-          /// release packets in this slot for re-processing
-          iterList->packetHasBeenProcessed = false;
-
-          NS_LOG_INFO ("SatPhyRxCarrierPerFrame::EliminateInterference- BEFORE INTERFERENCE ELIMINATION, RX sat: " << iterList->rxParams->m_rxPowerInSatellite_W <<
-                       " IF sat: " << iterList->rxParams->m_ifPowerInSatellite_W <<
-                       " RX gnd: " << iterList->rxParams->m_rxPower_W <<
-                       " IF gnd: " << iterList->rxParams->m_ifPower_W);
-
-          /// Reduce interference power for the colliding packets. Note, that the interference is
-          /// eliminated only from the user link interference power at the satellite! The intra-beam
-          /// interference is not handled in the return feeder link so that the intra-beam interference
-          /// is not taken into account twice!
-          /// TODO A more novel way to eliminate partially overlapping interference should be considered!
-          /// In addition, as the interference values are extremely small, the use of long double (instead
-          /// of double) should be considered to improve the accuracy.
-
-          iterList->rxParams->m_ifPowerInSatellite_W -= processedPacket.rxParams->m_rxPowerInSatellite_W;
-
-          if (std::abs (iterList->rxParams->m_ifPowerInSatellite_W) < std::numeric_limits<double>::epsilon ())
-            {
-              iterList->rxParams->m_ifPowerInSatellite_W = 0;
-            }
-
-          if (iterList->rxParams->m_ifPower_W < 0 || iterList->rxParams->m_ifPowerInSatellite_W < 0)
-            {
-              NS_FATAL_ERROR ("SatPhyRxCarrierPerFrame::EliminateInterference - Negative interference");
-            }
-
-          NS_LOG_INFO ("SatPhyRxCarrierPerFrame::EliminateInterference- AFTER INTERFERENCE ELIMINATION, RX sat: " <<
-          							iterList->rxParams->m_rxPowerInSatellite_W <<
-                       " IF sat: " << iterList->rxParams->m_ifPowerInSatellite_W <<
-                       " RX gnd: " << iterList->rxParams->m_rxPower_W <<
-                       " IF gnd: " << iterList->rxParams->m_ifPower_W);
+          continue;
         }
-    }
-}
-
-bool
-SatPhyRxCarrierPerFrame::IsReplica (SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s packet,
-																std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s>::iterator iter)
-{
-  NS_LOG_FUNCTION (this);
-  NS_LOG_INFO ("SatPhyRxCarrier::IsReplica - Time: " << Now ().GetSeconds ());
-
-  NS_LOG_INFO ("SatPhyRxCarrier::IsReplica - Checking the source addresses");
 
-  bool isReplica = false;
+      SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s &packet = m_crdsaPacketContainer[i];
 
-  if (iter->sourceAddress == packet.sourceAddress)
-    {
-      NS_LOG_INFO ("SatPhyRxCarrier::IsReplica - Same source addresses, checking slot IDs");
-
-      if (HaveSameSlotIds (packet, iter))
+      /// release packets in this slot for re-processing
+      if (packet.packetHasBeenProcessed)
         {
-          NS_LOG_INFO ("SatPhyRxCarrier::IsReplica - Same slot IDs, replica found");
-          isReplica = true;
+          packet.packetHasBeenProcessed = false;
+          graph.packetsToProcess.push_back (i);
+          std::push_heap (graph.packetsToProcess.begin (), graph.packetsToProcess.end (), std::greater<uint32_t> ());
         }
-    }
-  return isReplica;
-}
-
-bool
-SatPhyRxCarrierPerFrame::HaveSameSlotIds (SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s packet,
-                                          std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s>::iterator iter)
-{
-  NS_LOG_FUNCTION (this);
-  NS_LOG_INFO ("SatPhyRxCarrierUt::HaveSameSlotIds - Time: " << Now ().GetSeconds ());
-
-  std::set<uint16_t> firstSet;
-  std::set<uint16_t> secondSet;
-  std::set<uint16_t>::iterator firstSetIterator;
-  std::set<uint16_t>::iterator secondSetIterator;
-  bool haveSameSlotIds = true;
 
-  firstSet.insert (packet.ownSlotId);
-  secondSet.insert (iter->ownSlotId);
+      NS_LOG_INFO ("SatPhyRxCarrierPerFrame::EliminateInterference- BEFORE INTERFERENCE ELIMINATION, RX sat: " << packet.rxParams->m_rxPowerInSatellite_W <<
+                   " IF sat: " << packet.rxParams->m_ifPowerInSatellite_W <<
+                   " RX gnd: " << packet.rxParams->m_rxPower_W <<
+                   " IF gnd: " << packet.rxParams->m_ifPower_W);
 
-  /// sanity check
-  if (iter->slotIdsForOtherReplicas.size () != packet.slotIdsForOtherReplicas.size ())
-    {
-      NS_FATAL_ERROR ("SatPhyRxCarrierUt::HaveSameSlotIds - The amount of replicas does not match");
-    }
-
-  NS_LOG_INFO ("SatPhyRxCarrierUt::HaveSameSlotIds - Comparing slot IDs");
+      /// Reduce interference power for the colliding packets. Note, that the interference is
+      /// eliminated only from the user link interference power at the satellite! The intra-beam
+      /// interference is not handled in the return feeder link so that the intra-beam interference
+      /// is not taken into account twice!
+      /// TODO A more novel way to eliminate partially overlapping interference should be considered!
+      /// In addition, as the interference values are extremely small, the use of long double (instead
+      /// of double) should be considered to improve the accuracy.
 
-  /// form sets
-  for (uint32_t i = 0; i < iter->slotIdsForOtherReplicas.size (); i++)
-    {
-      firstSet.insert (packet.slotIdsForOtherReplicas[i]);
-      secondSet.insert (iter->slotIdsForOtherReplicas[i]);
-    }
+      packet.rxParams->m_ifPowerInSatellite_W -= processedPacket.rxParams->m_rxPowerInSatellite_W;
 
-  uint32_t numOfMatchingSlots = 0;
-
-  /// compare sets
-  for (firstSetIterator = firstSet.begin (); firstSetIterator != firstSet.end (); firstSetIterator++)
-    {
-      secondSetIterator = secondSet.find (*firstSetIterator);
-
-      if (secondSetIterator == secondSet.end ())
+      if (std::abs (packet.rxParams->m_ifPowerInSatellite_W) < std::numeric_limits<double>::epsilon ())
         {
-          haveSameSlotIds = false;
+          packet.rxParams->m_ifPowerInSatellite_W = 0;
         }
-      else
+
+      if (packet.rxParams->m_ifPower_W < 0 || packet.rxParams->m_ifPowerInSatellite_W < 0)
         {
-          numOfMatchingSlots++;
+          NS_FATAL_ERROR ("SatPhyRxCarrierPerFrame::EliminateInterference - Negative interference");
         }
-    }
-
-  NS_LOG_INFO ("SatPhyRxCarrier::HaveSameSlotIds - Are slot IDs identical: " << haveSameSlotIds
-               << ", number of matching slots: " << numOfMatchingSlots);
 
-  /// sanity check
-  if (!haveSameSlotIds && numOfMatchingSlots > 0)
-    {
-      NS_FATAL_ERROR ("SatPhyRxCarrier::HaveSameSlotIds - Partially overlapping CRDSA slots");
+      NS_LOG_INFO ("SatPhyRxCarrierPerFrame::EliminateInterference- AFTER INTERFERENCE ELIMINATION, RX sat: " <<
+                   packet.rxParams->m_rxPowerInSatellite_W <<
+                   " IF sat: " << packet.rxParams->m_ifPowerInSatellite_W <<
+                   " RX gnd: " << packet.rxParams->m_rxPower_W <<
+                   " IF gnd: " << packet.rxParams->m_ifPower_W);
     }
-
-  return haveSameSlotIds;
 }
 
 bool
@@ -826,5 +764,12 @@ SatPhyRxCarrierPerFrame::CompareCrdsaPacketId (SatPhyRxCarrierPerFrame::crdsaPac
   return (bool) (obj1.rxParams->m_txInfo.crdsaUniquePacketId < obj2.rxParams->m_txInfo.crdsaUniquePacketId);
 }
 
+bool
+SatPhyRxCarrierPerFrame::CompareCrdsaSlotId (const SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s &obj1,
+                                             const SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s &obj2)
+{
+  return obj1.ownSlotId < obj2.ownSlotId;
+}
+
 
 }
@@ -91,6 +91,15 @@ public:
   static bool CompareCrdsaPacketId (SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s obj1,
   		SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s obj2);
 
+  /**
+   * \brief Function for comparing the slots of CRDSA packets
+   * \param obj1 Comparison object 1
+   * \param obj2 Comparison object 2
+   * \return Comparison result
+   */
+  static bool CompareCrdsaSlotId (const SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s &obj1,
+                                  const SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s &obj2);
+
   /**
    * \brief Function for initializing the frame end scheduling
    */
@@ -116,21 +125,63 @@ protected:
 	 */
   virtual void DoDispose ();
 
+  /**
+   * \brief Function for storing the received CRDSA packets
+   * \param Rx parameters of the packet
+   */
+  void AddCrdsaPacket (SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s crdsaPacketParams);
+
+  /**
+   * \brief Function for processing the CRDSA frame
+   *
+   * The packets of the frame are decoded by successive interference cancellation:
+   * a correctly received packet is removed from its slot together with its replicas,
+   * and the interference it caused is eliminated from the packets left in those
+   * slots, which are then processed again. Packets are always processed in the
+   * order of their slots and of their reception within a slot.
+   *
+   * \return Processed packets
+   */
+  std::vector<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s> ProcessFrame ();
+
 private:
 
   /**
-   * \brief Function for eliminating the interference to other packets in the slot from the correctly received packet
-   * \param iter Packets in the slot
-   * \param processedPacket Correctly received processed packet
+   * \brief Packets of a CRDSA frame as a graph of slots and unique payloads.
+   *
+   * The graph is stored in flat arrays indexed by the position of the packets in
+   * the container, which is sorted by slot when the frame is processed. The arrays
+   * are kept between frames to reuse their storage.
    */
-  void EliminateInterference (std::map<uint32_t,std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s> >::iterator iter,
-  		SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s processedPacket);
+  typedef struct
+  {
+    std::vector<uint32_t> slotOfPacket;         ///< slot of every packet
+    std::vector<uint32_t> slotFirst;            ///< packets of slot s are [slotFirst[s], slotFirst[s + 1])
+    std::vector<uint32_t> packetsLeftInSlot;    ///< packets not yet removed from every slot
+    std::vector<bool> isInFrame;                ///< packet has not been removed from its slot
+    std::vector<uint32_t> payloadOfPacket;      ///< unique payload (source and slots) of every packet
+    std::vector<uint32_t> payloadFirst;         ///< packets of payload u are payloadPackets[payloadFirst[u] .. payloadFirst[u + 1])
+    std::vector<uint32_t> payloadPackets;       ///< packets of every payload, in container order
+    std::vector<uint32_t> packetsToProcess;     ///< min-heap of packets waiting to be (re)processed, may contain stale entries
+  } crdsaFrameGraph_s;
 
   /**
-   * \brief Function for storing the received CRDSA packets
-   * \param Rx parameters of the packet
+   * \brief Function for building the graph of the packets in the container
    */
-  void AddCrdsaPacket (SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s crdsaPacketParams);
+  void BuildFrameGraph ();
+
+  /**
+   * \brief Function for removing a packet from its slot
+   * \param packet Index of the packet in the container
+   */
+  void RemoveCrdsaPacket (uint32_t packet);
+
+  /**
+   * \brief Function for eliminating the interference to other packets in the slot from the correctly received packet
+   * \param slot Slot of the packets in the frame graph
+   * \param processedPacket Correctly received processed packet
+   */
+  void EliminateInterference (uint32_t slot, const SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s &processedPacket);
 
   /**
    * \brief `CrdsaReplicaRx` trace source.
@@ -157,35 +208,11 @@ private:
    */
   TracedCallback<uint32_t, const Address &, bool> m_crdsaUniquePayloadRxTrace;
 
-  /**
-   * \brief Function for processing the CRDSA frame
-   * \return Processed packets
-   */
-  std::vector<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s> ProcessFrame ();
-
   /**
    * \brief Function for finding and removing the replicas of the CRDSA packet
-   * \param packet CRDSA packet
-   */
-  void FindAndRemoveReplicas (SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s packet);
-
-  /**
-   * \brief Function for identifying whether the packet is a replica of another packet
-   * \param packet Packet
-   * \param iter A packet in certain slot
-   * \return Is the packet a replica
+   * \param packet Index of the CRDSA packet in the container
    */
-  bool IsReplica (SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s packet,
-  		std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s>::iterator iter);
-
-  /**
-   * \brief Function for checking do the packets have identical slots
-   * \param packet Packet
-   * \param iter A packet in certain slot
-   * \return Have the packets identical slots
-   */
-  bool HaveSameSlotIds (SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s packet,
-  		std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s>::iterator iter);
+  void FindAndRemoveReplicas (uint32_t packet);
 
   /**
    * \brief Function for calculating the normalized offered random access load
@@ -218,9 +245,14 @@ private:
 
 
   /**
-   * \brief CRDSA packet container
+   * \brief CRDSA packet container, packets of the frame in reception order
+   */
+  std::vector<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s> m_crdsaPacketContainer;
+
+  /**
+   * \brief Graph of the packets in the container while the frame is processed
    */
-  std::map<uint32_t, std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s> > m_crdsaPacketContainer;
+  crdsaFrameGraph_s m_crdsaFrameGraph;
 
   /**
    * \brief Has the frame end scheduling been initialized
@@ -56,6 +56,7 @@ SatPhyRxCarrier::SatPhyRxCarrier (uint32_t carrierId, Ptr<SatPhyRxCarrierConf> c
     m_receivingDedicatedAccess (false),
     m_satInterference (),
     m_enableCompositeSinrOutputTrace (false),
+    m_compositeSinrTraceContainer (),
     m_numOfOngoingRx (0),
     m_rxPacketCounter (0)
 {
@@ -199,6 +200,7 @@ SatPhyRxCarrier::DoDispose ()
   m_avgNormalizedOfferedLoadCallback.Nullify ();
   m_satInterference = NULL;
   m_uniformVariable = NULL;
+  m_compositeSinrTraceContainer = NULL;
 
   Object::DoDispose ();
 }
@@ -355,11 +357,16 @@ SatPhyRxCarrier::DoCompositeSinrOutputTrace (double cSinr)
   NS_LOG_FUNCTION (this);
   NS_LOG_INFO ("SatPhyRxCarrier::DoCompositeSinrOutputTrace");
 
-  std::vector<double> tempVector;
-  tempVector.push_back (Now ().GetSeconds ());
-  tempVector.push_back (cSinr);
+  if (m_compositeSinrTraceContainer == NULL || !m_compositeSinrTraceContainer->IsWritable ())
+    {
+      m_compositeSinrTraceContainer = Singleton<SatCompositeSinrOutputTraceContainer>::Get ()->GetNodeContainer (std::make_pair (GetOwnAddress (), GetChannelType ()));
+    }
 
-  Singleton<SatCompositeSinrOutputTraceContainer>::Get ()->AddToContainer (std::make_pair (GetOwnAddress (), GetChannelType ()), tempVector);
+  if (m_compositeSinrTraceContainer != NULL)
+    {
+      double sample[SatBaseTraceContainer::CSINR_TRACE_DEFAULT_NUMBER_OF_COLUMNS] = {Now ().GetSeconds (), cSinr};
+      m_compositeSinrTraceContainer->AddToContainer (sample, SatBaseTraceContainer::CSINR_TRACE_DEFAULT_NUMBER_OF_COLUMNS);
+    }
 }
 
 
@@ -32,6 +32,7 @@
 #include <ns3/satellite-phy.h>
 #include <ns3/satellite-phy-rx.h>
 #include <ns3/satellite-phy-rx-carrier-conf.h>
+#include <ns3/satellite-output-fstream-double-container.h>
 #include <vector>
 #include <map>
 #include <list>
@@ -518,6 +519,7 @@ private:
   bool m_receivingDedicatedAccess; 							//< Is the carrier receiving a dedicated access packet
   Ptr<SatInterference> m_satInterference; 			//< Interference model
   bool m_enableCompositeSinrOutputTrace;				//< Enable composite SINR output tracing
+  Ptr<SatOutputFileStreamDoubleContainer> m_compositeSinrTraceContainer; //< Composite SINR output trace container of the carrier
 
   /**
    * \brief Contains information about how many ongoing Rx events there are
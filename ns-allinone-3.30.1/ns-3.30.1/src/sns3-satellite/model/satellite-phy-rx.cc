@@ -45,7 +45,9 @@ SatPhyRx::SatPhyRx ()
   : m_beamId (),
     m_maxAntennaGain (),
     m_antennaLoss (),
-    m_defaultFadingValue ()
+    m_defaultFadingValue (),
+    m_rxPowerTraceContainer (),
+    m_fadingTraceContainer ()
 {
   NS_LOG_FUNCTION (this);
 }
@@ -62,6 +64,8 @@ void SatPhyRx::DoDispose ()
   m_device = 0;
   m_fadingContainer = 0;
   m_rxCarriers.clear ();
+  m_rxPowerTraceContainer = 0;
+  m_fadingTraceContainer = 0;
   Object::DoDispose ();
 }
 
@@ -116,7 +120,7 @@ SatPhyRx::GetAntennaGain (Ptr<MobilityModel> mobility)
   if (m_antennaGainPattern)
     {
       Ptr<SatMobilityModel> m = DynamicCast<SatMobilityModel> (mobility);
-      gain_W = m_antennaGainPattern->GetAntennaGain_lin (m->GetGeoPosition ());
+      gain_W = m_antennaGainPattern->GetAntennaGain_lin (m);
     }
 
   /**
@@ -376,6 +380,34 @@ SatPhyRx::GetBeamId () const
   return m_beamId;
 }
 
+void
+SatPhyRx::SetRxPowerTraceContainer (Ptr<SatOutputFileStreamDoubleContainer> container)
+{
+  NS_LOG_FUNCTION (this << container);
+  m_rxPowerTraceContainer = container;
+}
+
+Ptr<SatOutputFileStreamDoubleContainer>
+SatPhyRx::GetRxPowerTraceContainer () const
+{
+  NS_LOG_FUNCTION (this);
+  return m_rxPowerTraceContainer;
+}
+
+void
+SatPhyRx::SetFadingTraceContainer (Ptr<SatOutputFileStreamDoubleContainer> container)
+{
+  NS_LOG_FUNCTION (this << container);
+  m_fadingTraceContainer = container;
+}
+
+Ptr<SatOutputFileStreamDoubleContainer>
+SatPhyRx::GetFadingTraceContainer () const
+{
+  NS_LOG_FUNCTION (this);
+  return m_fadingTraceContainer;
+}
+
 void
 SatPhyRx::StartRx (Ptr<SatSignalParameters> rxParams)
 {
@@ -29,6 +29,7 @@
 #include "satellite-antenna-gain-pattern.h"
 #include "satellite-mobility-model.h"
 #include "satellite-base-fading.h"
+#include "ns3/satellite-output-fstream-double-container.h"
 #include "ns3/satellite-frame-conf.h"
 
 namespace ns3 {
@@ -213,6 +214,30 @@ public:
    */
   void BeginFrameEndScheduling ();
 
+  /**
+   * \brief Set the Rx power output trace container of the earth station of this PHY
+   * \param container trace container
+   */
+  void SetRxPowerTraceContainer (Ptr<SatOutputFileStreamDoubleContainer> container);
+
+  /**
+   * \brief Get the Rx power output trace container of the earth station of this PHY
+   * \return trace container, NULL if not set
+   */
+  Ptr<SatOutputFileStreamDoubleContainer> GetRxPowerTraceContainer () const;
+
+  /**
+   * \brief Set the fading output trace container of the earth station of this PHY
+   * \param container trace container
+   */
+  void SetFadingTraceContainer (Ptr<SatOutputFileStreamDoubleContainer> container);
+
+  /**
+   * \brief Get the fading output trace container of the earth station of this PHY
+   * \return trace container, NULL if not set
+   */
+  Ptr<SatOutputFileStreamDoubleContainer> GetFadingTraceContainer () const;
+
 private:
   Ptr<MobilityModel> m_mobility;
   Ptr<NetDevice> m_device;
@@ -247,6 +272,16 @@ private:
    * \brief Default fading value
    */
   double m_defaultFadingValue;
+
+  /**
+   * \brief Rx power output trace container, resolved by SatChannel on the first sample
+   */
+  Ptr<SatOutputFileStreamDoubleContainer> m_rxPowerTraceContainer;
+
+  /**
+   * \brief Fading output trace container, resolved by SatChannel on the first sample
+   */
+  Ptr<SatOutputFileStreamDoubleContainer> m_fadingTraceContainer;
 };
 
 
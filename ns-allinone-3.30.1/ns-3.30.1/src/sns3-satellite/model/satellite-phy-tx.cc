@@ -47,7 +47,9 @@ SatPhyTx::SatPhyTx ()
     m_state (IDLE),
     m_beamId (),
     m_txMode (),
-    m_defaultFadingValue ()
+    m_defaultFadingValue (),
+    m_rxPowerTraceContainer (),
+    m_fadingTraceContainer ()
 {
   NS_LOG_FUNCTION (this);
 }
@@ -64,6 +66,8 @@ void SatPhyTx::DoDispose ()
   m_channel = 0;
   m_mobility = 0;
   m_fadingContainer = 0;
+  m_rxPowerTraceContainer = 0;
+  m_fadingTraceContainer = 0;
   Object::DoDispose ();
 }
 
@@ -118,7 +122,7 @@ SatPhyTx::GetAntennaGain (Ptr<MobilityModel> mobility)
   if (m_antennaGainPattern)
     {
       Ptr<SatMobilityModel> m = DynamicCast<SatMobilityModel> (mobility);
-      gain_W = m_antennaGainPattern->GetAntennaGain_lin (m->GetGeoPosition ());
+      gain_W = m_antennaGainPattern->GetAntennaGain_lin (m);
     }
 
   /**
@@ -279,4 +283,32 @@ SatPhyTx::SetBeamId (uint32_t beamId)
   m_beamId = beamId;
 }
 
+void
+SatPhyTx::SetRxPowerTraceContainer (Ptr<SatOutputFileStreamDoubleContainer> container)
+{
+  NS_LOG_FUNCTION (this << container);
+  m_rxPowerTraceContainer = container;
+}
+
+Ptr<SatOutputFileStreamDoubleContainer>
+SatPhyTx::GetRxPowerTraceContainer () const
+{
+  NS_LOG_FUNCTION (this);
+  return m_rxPowerTraceContainer;
+}
+
+void
+SatPhyTx::SetFadingTraceContainer (Ptr<SatOutputFileStreamDoubleContainer> container)
+{
+  NS_LOG_FUNCTION (this << container);
+  m_fadingTraceContainer = container;
+}
+
+Ptr<SatOutputFileStreamDoubleContainer>
+SatPhyTx::GetFadingTraceContainer () const
+{
+  NS_LOG_FUNCTION (this);
+  return m_fadingTraceContainer;
+}
+
 } // namespace ns3
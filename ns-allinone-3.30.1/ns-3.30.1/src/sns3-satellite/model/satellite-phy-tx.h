@@ -32,6 +32,7 @@
 #include "satellite-antenna-gain-pattern.h"
 #include "satellite-mobility-model.h"
 #include "satellite-base-fading.h"
+#include "ns3/satellite-output-fstream-double-container.h"
 
 namespace ns3 {
 
@@ -141,6 +142,30 @@ public:
    */
   void SetBeamId (uint32_t beamId);
 
+  /**
+   * \brief Set the Rx power output trace container of the earth station of this PHY
+   * \param container trace container
+   */
+  void SetRxPowerTraceContainer (Ptr<SatOutputFileStreamDoubleContainer> container);
+
+  /**
+   * \brief Get the Rx power output trace container of the earth station of this PHY
+   * \return trace container, NULL if not set
+   */
+  Ptr<SatOutputFileStreamDoubleContainer> GetRxPowerTraceContainer () const;
+
+  /**
+   * \brief Set the fading output trace container of the earth station of this PHY
+   * \param container trace container
+   */
+  void SetFadingTraceContainer (Ptr<SatOutputFileStreamDoubleContainer> container);
+
+  /**
+   * \brief Get the fading output trace container of the earth station of this PHY
+   * \return trace container, NULL if not set
+   */
+  Ptr<SatOutputFileStreamDoubleContainer> GetFadingTraceContainer () const;
+
 private:
   void ChangeState (State newState);
   void EndTx ();
@@ -171,6 +196,16 @@ private:
    * \brief Default fading value
    */
   double m_defaultFadingValue;
+
+  /**
+   * \brief Rx power output trace container, resolved by SatChannel on the first sample
+   */
+  Ptr<SatOutputFileStreamDoubleContainer> m_rxPowerTraceContainer;
+
+  /**
+   * \brief Fading output trace container, resolved by SatChannel on the first sample
+   */
+  Ptr<SatOutputFileStreamDoubleContainer> m_fadingTraceContainer;
 };
 
 
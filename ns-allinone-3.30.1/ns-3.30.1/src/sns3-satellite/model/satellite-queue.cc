@@ -57,6 +57,10 @@ TypeId SatQueue::GetTypeId (void)
                      "Drop a packet stored in the queue.",
                      MakeTraceSourceAccessor (&SatQueue::m_traceDrop),
                      "ns3::Packet::TracedCallback")
+    .AddTraceSource ("PushFront",
+                     "Push a fragmented packet back to the front of the queue.",
+                     MakeTraceSourceAccessor (&SatQueue::m_tracePushFront),
+                     "ns3::Packet::TracedCallback")
   ;
 
   return tid;
@@ -239,6 +243,8 @@ SatQueue::PushFront (Ptr<Packet> p)
   m_nBytes += p->GetSize ();
 
   m_nDequeBytesSinceReset -= p->GetSize ();
+
+  m_tracePushFront (p);
 }
 
 void
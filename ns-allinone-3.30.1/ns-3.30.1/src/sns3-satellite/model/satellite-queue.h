@@ -282,6 +282,7 @@ private:
   TracedCallback<Ptr<const Packet> > m_traceEnqueue;
   TracedCallback<Ptr<const Packet> > m_traceDequeue;
   TracedCallback<Ptr<const Packet> > m_traceDrop;
+  TracedCallback<Ptr<const Packet> > m_tracePushFront;
 };
 
 
@@ -140,6 +140,14 @@ SatRxPowerOutputTraceContainer::FindNode (key_t key)
   return iter->second;
 }
 
+Ptr<SatOutputFileStreamDoubleContainer>
+SatRxPowerOutputTraceContainer::GetNodeContainer (key_t key)
+{
+  NS_LOG_FUNCTION (this);
+
+  return FindNode (key);
+}
+
 void
 SatRxPowerOutputTraceContainer::WriteToFile ()
 {
@@ -50,10 +50,23 @@ SatSignalParameters::SatSignalParameters ()
 }
 
 SatSignalParameters::SatSignalParameters ( const SatSignalParameters& p )
+  : SatSignalParameters (p, true)
 {
-  for ( PacketsInBurst_t::const_iterator i = p.m_packetsInBurst.begin (); i != p.m_packetsInBurst.end (); i++  )
+}
+
+SatSignalParameters::SatSignalParameters ( const SatSignalParameters& p, bool copyPackets )
+{
+  if (copyPackets)
     {
-      m_packetsInBurst.push_back ((*i)->Copy ());
+      m_packetsInBurst.reserve (p.m_packetsInBurst.size ());
+      for ( PacketsInBurst_t::const_iterator i = p.m_packetsInBurst.begin (); i != p.m_packetsInBurst.end (); i++  )
+        {
+          m_packetsInBurst.push_back ((*i)->Copy ());
+        }
+    }
+  else
+    {
+      m_packetsInBurst = p.m_packetsInBurst;
     }
 
   m_beamId = p.m_beamId;
@@ -89,6 +102,15 @@ SatSignalParameters::Copy ()
   return p;
 }
 
+Ptr<SatSignalParameters>
+SatSignalParameters::CopyForInterference ()
+{
+  NS_LOG_FUNCTION (this);
+
+  Ptr<SatSignalParameters> p (new SatSignalParameters (*this, false), false);
+  return p;
+}
+
 TypeId
 SatSignalParameters::GetTypeId (void)
 {
@@ -72,6 +72,15 @@ public:
 
   Ptr<SatSignalParameters> Copy ();
 
+  /**
+   * \brief Copy the parameters for a receiver which only sees the transmission
+   * as co-channel interference. The packets in burst are shared with this
+   * instance instead of being copied, so they may be peeked at, but they shall
+   * not be modified through the returned copy.
+   * \return copy of the parameters sharing the packets in burst
+   */
+  Ptr<SatSignalParameters> CopyForInterference ();
+
   /**
    * \brief Get the type ID
    * \return the object TypeId
@@ -173,6 +182,14 @@ public:
    * Callback for SINR calculation
    */
   Callback<double, double> m_sinrCalculate;
+
+private:
+  /**
+   * \brief Copy constructor
+   * \param p parameters to copy
+   * \param copyPackets true to copy the packets in burst, false to share them
+   */
+  SatSignalParameters (const SatSignalParameters& p, bool copyPackets);
 };
 
 
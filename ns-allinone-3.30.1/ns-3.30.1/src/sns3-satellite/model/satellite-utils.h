@@ -395,6 +395,42 @@ public:
     return y0 + relY;
   }
 
+  /**
+   * \brief Mix the bits of a 64 bit key into a hash value, the lowest bits of
+   * the result may be used as the slot of a hash table of power of two size.
+   * \param key Key
+   * \return Hash value
+   */
+  static inline uint32_t HashKey (uint64_t key)
+  {
+    uint64_t hash = key * 0x9E3779B97F4A7C15ULL;
+    return hash ^ (hash >> 32);
+  }
+
+  /**
+   * \brief Hash function object of MAC48 addresses, for unordered containers
+   * keyed by the addresses.
+   */
+  struct Mac48AddressHash
+  {
+    /**
+     * \param mac MAC address
+     * \return Hash value of the 48 bits of the address
+     */
+    std::size_t operator () (const Mac48Address &mac) const
+    {
+      uint8_t buffer[6];
+      mac.CopyTo (buffer);
+
+      uint64_t key = 0;
+      for (uint32_t i = 0; i < 6; i++)
+        {
+          key = (key << 8) | buffer[i];
+        }
+      return HashKey (key);
+    }
+  };
+
 private:
   /**
    * Destructor
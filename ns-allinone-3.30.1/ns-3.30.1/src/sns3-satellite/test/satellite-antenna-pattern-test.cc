@@ -23,8 +23,11 @@
 #include "ns3/simulator.h"
 #include "../model/satellite-antenna-gain-pattern.h"
 #include "../model/satellite-antenna-gain-pattern-container.h"
+#include "../model/satellite-constant-position-mobility-model.h"
+#include "../model/satellite-utils.h"
 #include "ns3/singleton.h"
 #include "../utils/satellite-env-variables.h"
+#include <fstream>
 
 using namespace ns3;
 
@@ -117,9 +120,102 @@ SatAntennaPatternTestCase::DoRun (void)
       NS_TEST_ASSERT_MSG_EQ ( bestBeamId, expectedBeamIds[i], "Not expected best spot-beam id");
     }
 
+  // Check that the gains of all beams in one call match the gains of the patterns
+  std::vector<double> gains;
+  for ( uint32_t i = 0; i < coordinates.size (); ++i)
+    {
+      gpContainer.GetAntennaGains_lin (coordinates[i], gains);
+
+      for ( uint32_t j = 0; j < gains.size (); ++j)
+        {
+          gain = gpContainer.GetAntennaGainPattern (j + 1)->GetAntennaGain_lin (coordinates[i]);
+          NS_TEST_ASSERT_MSG_EQ_TOL ( gains[j], gain, gain * 1e-12, "Gain of beam " << j + 1 << " not as in its pattern");
+        }
+    }
+
   Singleton<SatEnvVariables>::Get ()->DoDispose ();
 }
 
+/**
+ * \ingroup satellite
+ * \brief Satellite antenna pattern grid test case implementation.
+ *
+ * This case reads a small antenna gain pattern and compares the interpolated
+ * gains to the expected ones, also when cached for the position of a mobility
+ * model which is then moved.
+ */
+class SatAntennaPatternGridTestCase : public TestCase
+{
+public:
+  SatAntennaPatternGridTestCase ();
+  virtual ~SatAntennaPatternGridTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+SatAntennaPatternGridTestCase::SatAntennaPatternGridTestCase ()
+  : TestCase ("Test satellite antenna gain pattern grid and gain cache.")
+{
+}
+
+SatAntennaPatternGridTestCase::~SatAntennaPatternGridTestCase ()
+{
+}
+
+void
+SatAntennaPatternGridTestCase::DoRun (void)
+{
+  // 3 latitudes times 4 longitudes with a NaN in the corner, gain = lat + lon [dB]
+  std::string fileName = CreateTempDirFilename ("antenna-gain-pattern.txt");
+  std::ofstream file (fileName.c_str ());
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      for (uint32_t j = 0; j < 4; ++j)
+        {
+          double lat = 40.0 + 0.5 * i;
+          double lon = 10.0 + 0.25 * j;
+          if (i == 2 && j == 3)
+            {
+              file << lat << " " << lon << " NaN" << std::endl;
+            }
+          else
+            {
+              file << lat << " " << lon << " " << lat + lon << std::endl;
+            }
+        }
+    }
+  file.close ();
+
+  Ptr<SatAntennaGainPattern> gainPattern = CreateObject<SatAntennaGainPattern> (fileName);
+
+  NS_TEST_ASSERT_MSG_EQ (gainPattern->GetNumOfLongitudes (), 4, "Longitudes of the grid");
+  NS_TEST_ASSERT_MSG_EQ (gainPattern->GetNumOfGridPoints (), 12, "Points of the grid");
+  NS_TEST_ASSERT_MSG_EQ (gainPattern->HasSameGrid (gainPattern), true, "Grid of the pattern itself");
+
+  // Grid points, including the maximum latitude
+  NS_TEST_ASSERT_MSG_EQ_TOL (gainPattern->GetAntennaGain_lin (GeoCoordinate (40.5, 10.25, 0.0)),
+                             SatUtils::DbToLinear (50.75), 1e-6, "Gain of a grid point");
+  NS_TEST_ASSERT_MSG_EQ_TOL (gainPattern->GetAntennaGain_lin (GeoCoordinate (41.0, 10.0, 0.0)),
+                             SatUtils::DbToLinear (51.0), 1e-6, "Gain of a grid point on the maximum latitude");
+
+  // Center of a grid box, interpolated in linear domain
+  double expected = (SatUtils::DbToLinear (50.0) + SatUtils::DbToLinear (50.25)
+                     + SatUtils::DbToLinear (50.5) + SatUtils::DbToLinear (50.75)) / 4;
+  NS_TEST_ASSERT_MSG_EQ_TOL (gainPattern->GetAntennaGain_lin (GeoCoordinate (40.25, 10.125, 0.0)),
+                             expected, expected * 1e-12, "Gain of the center of a grid box");
+
+  // Cached gain follows the mobility model
+  Ptr<SatConstantPositionMobilityModel> mobility = CreateObject<SatConstantPositionMobilityModel> ();
+  mobility->SetGeoPosition (GeoCoordinate (40.25, 10.125, 0.0));
+  NS_TEST_ASSERT_MSG_EQ_TOL (gainPattern->GetAntennaGain_lin (mobility), expected, expected * 1e-12, "Gain of the mobility model");
+  NS_TEST_ASSERT_MSG_EQ_TOL (gainPattern->GetAntennaGain_lin (mobility), expected, expected * 1e-12, "Cached gain of the mobility model");
+
+  mobility->SetGeoPosition (GeoCoordinate (40.0, 10.5, 0.0));
+  NS_TEST_ASSERT_MSG_EQ_TOL (gainPattern->GetAntennaGain_lin (mobility), SatUtils::DbToLinear (50.5), 1e-6,
+                             "Gain of the moved mobility model");
+}
+
 /**
  * \ingroup satellite
  * \brief Satellite antenna pattern test suite
@@ -134,6 +230,7 @@ SatAntennaPatternTestSuite::SatAntennaPatternTestSuite ()
   : TestSuite ("sat-antenna-gain-pattern-test", UNIT)
 {
   AddTestCase (new SatAntennaPatternTestCase, TestCase::QUICK);
+  AddTestCase (new SatAntennaPatternGridTestCase, TestCase::QUICK);
 }
 
 // Do allocate an instance of this TestSuite
@@ -0,0 +1,511 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file satellite-channel-test.cc
+ * \ingroup satellite
+ * \brief Test cases to unit test the link budget cache of the satellite channel.
+ */
+
+#include <vector>
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/enum.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/mac48-address.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/propagation-delay-model.h"
+#include "../model/satellite-channel.h"
+#include "../model/satellite-phy-tx.h"
+#include "../model/satellite-phy-rx.h"
+#include "../model/satellite-phy-rx-carrier-conf.h"
+#include "../model/satellite-signal-parameters.h"
+#include "../model/satellite-free-space-loss.h"
+#include "../model/satellite-node-info.h"
+#include "../model/satellite-mac-tag.h"
+#include "../model/satellite-utils.h"
+#include "../model/satellite-enums.h"
+
+using namespace ns3;
+
+namespace {
+
+/// Bandwidth of the test carrier in Hz
+double
+GetTestBandwidthHz (SatEnums::ChannelType_t channelType, uint32_t carrierId, SatEnums::CarrierBandwidthType_t bandwidthType)
+{
+  return 1e6;
+}
+
+/// SINR calculator of the test carrier, no additional interference
+double
+GetTestSinr (double sinr)
+{
+  return sinr;
+}
+
+/// Maximum antenna gain of the satellite receiver in dB
+const double SAT_ANTENNA_GAIN_DB = 50.0;
+
+} // anonymous namespace
+
+/**
+ * \ingroup satellite
+ * \brief Base of the test cases of the link budget cache of the satellite channel.
+ * Creates a feeder uplink channel and a satellite receiver of one carrier, and sends
+ * bursts of GW transmitters to it.
+ */
+class SatChannelLinkBudgetTestBase : public TestCase
+{
+public:
+  SatChannelLinkBudgetTestBase (std::string name);
+  virtual ~SatChannelLinkBudgetTestBase ();
+
+protected:
+  /**
+   * Create the channel with the satellite receiver.
+   * \param enableCache Whether the link budget cache is enabled
+   */
+  void CreateChannel (bool enableCache);
+
+  /**
+   * Dispose the channel and the simulator.
+   */
+  void DestroyChannel ();
+
+  /**
+   * Create a GW transmitter attached to the channel.
+   * \param antennaGainDb Maximum antenna gain in dB
+   * \return transmitter
+   */
+  Ptr<SatPhyTx> CreateTx (double antennaGainDb);
+
+  /**
+   * Send a burst from a transmitter and receive it.
+   * \param phyTx Transmitter
+   * \return received power in W
+   */
+  double SendBurst (Ptr<SatPhyTx> phyTx);
+
+  /**
+   * Send bursts from a transmitter with the same link, after the GW and the
+   * satellite have moved, after the carrier frequency has changed, and after
+   * everything has returned to the first burst.
+   * \param phyTx Transmitter
+   * \param antennaGainDb Maximum antenna gain of the transmitter in dB
+   * \param rxPowerW Received powers of the bursts in W
+   * \param expectedRxPowerW Powers of the bursts calculated from the link in W
+   */
+  void SendMovingBursts (Ptr<SatPhyTx> phyTx, double antennaGainDb,
+                         std::vector<double> &rxPowerW, std::vector<double> &expectedRxPowerW);
+
+  /**
+   * Calculate the received power of a burst of 1 W from the current positions
+   * and carrier frequency.
+   * \param antennaGainDb Maximum antenna gain of the transmitter in dB
+   * \return received power in W
+   */
+  double GetExpectedRxPowerW (double antennaGainDb) const;
+
+  /**
+   * Frequency converter of the channel.
+   * \return current center frequency of the test carrier in Hz
+   */
+  double GetFrequencyHz (SatEnums::ChannelType_t channelType, uint32_t freqId, uint32_t carrierId);
+
+  /**
+   * Receive callback of the satellite receiver.
+   * \param rxParams Parameters of the received burst
+   * \param phyError Reception error
+   */
+  void Receive (Ptr<SatSignalParameters> rxParams, bool phyError);
+
+  Ptr<SatChannel> m_channel;
+  Ptr<SatFreeSpaceLoss> m_freeSpaceLoss;
+  Ptr<MobilityModel> m_gwMobility;
+  Ptr<MobilityModel> m_satMobility;
+  Mac48Address m_gwMac;
+  double m_frequencyHz;
+  std::vector<double> m_rxPowerW;
+};
+
+SatChannelLinkBudgetTestBase::SatChannelLinkBudgetTestBase (std::string name)
+  : TestCase (name),
+    m_frequencyHz (28e9)
+{
+}
+
+SatChannelLinkBudgetTestBase::~SatChannelLinkBudgetTestBase ()
+{
+}
+
+void
+SatChannelLinkBudgetTestBase::CreateChannel (bool enableCache)
+{
+  m_frequencyHz = 28e9;
+  m_rxPowerW.clear ();
+  m_freeSpaceLoss = CreateObject<SatFreeSpaceLoss> ();
+
+  m_channel = CreateObject<SatChannel> ();
+  m_channel->SetAttribute ("EnableLinkBudgetCache", BooleanValue (enableCache));
+  m_channel->SetAttribute ("ForwardingMode", EnumValue (SatChannel::ONLY_DEST_BEAM));
+  m_channel->SetChannelType (SatEnums::FORWARD_FEEDER_CH);
+  m_channel->SetFrequencyConverter (MakeCallback (&SatChannelLinkBudgetTestBase::GetFrequencyHz, this));
+  m_channel->SetBandwidthConverter (MakeCallback (&GetTestBandwidthHz));
+  m_channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  m_channel->SetFreeSpaceLoss (m_freeSpaceLoss);
+
+  m_gwMac = Mac48Address::Allocate ();
+  m_gwMobility = CreateObject<ConstantPositionMobilityModel> ();
+  m_gwMobility->SetPosition (Vector (0.0, 0.0, 0.0));
+
+  m_satMobility = CreateObject<ConstantPositionMobilityModel> ();
+  m_satMobility->SetPosition (Vector (1.0, 1.0, 35786000.0));
+
+  SatPhyRxCarrierConf::RxCarrierCreateParams_s params = SatPhyRxCarrierConf::RxCarrierCreateParams_s ();
+  params.m_rxTemperatureK = 290.0;
+  params.m_errorModel = SatPhyRxCarrierConf::EM_NONE;
+  params.m_daIfModel = SatPhyRxCarrierConf::IF_CONSTANT;
+  params.m_raIfModel = SatPhyRxCarrierConf::IF_CONSTANT;
+  params.m_chType = SatEnums::FORWARD_FEEDER_CH;
+  params.m_bwConverter = MakeCallback (&GetTestBandwidthHz);
+  params.m_carrierCount = 1;
+
+  Ptr<SatPhyRxCarrierConf> carrierConf = CreateObject<SatPhyRxCarrierConf> (params);
+  carrierConf->SetSinrCalculatorCb (MakeCallback (&GetTestSinr));
+
+  Ptr<Node> satNode = CreateObject<Node> ();
+  Ptr<SimpleNetDevice> satDevice = CreateObject<SimpleNetDevice> ();
+  satNode->AddDevice (satDevice);
+
+  Ptr<SatPhyRx> phyRx = CreateObject<SatPhyRx> ();
+  phyRx->SetDevice (satDevice);
+  phyRx->SetMobility (m_satMobility);
+  phyRx->SetMaxAntennaGain_Db (SAT_ANTENNA_GAIN_DB);
+  phyRx->SetAntennaLoss_Db (0.0);
+  phyRx->ConfigurePhyRxCarriers (carrierConf, NULL);
+  phyRx->SetNodeInfo (Create<SatNodeInfo> (SatEnums::NT_SAT, satNode->GetId (), Mac48Address::Allocate ()));
+  phyRx->SetBeamId (1);
+  phyRx->SetReceiveCallback (MakeCallback (&SatChannelLinkBudgetTestBase::Receive, this));
+  m_channel->AddRx (phyRx);
+}
+
+void
+SatChannelLinkBudgetTestBase::DestroyChannel ()
+{
+  m_channel->Dispose ();
+  m_channel = 0;
+  m_freeSpaceLoss = 0;
+  m_gwMobility = 0;
+  m_satMobility = 0;
+  Simulator::Destroy ();
+}
+
+Ptr<SatPhyTx>
+SatChannelLinkBudgetTestBase::CreateTx (double antennaGainDb)
+{
+  Ptr<SatPhyTx> phyTx = CreateObject<SatPhyTx> ();
+  phyTx->SetChannel (m_channel);
+  phyTx->SetMobility (m_gwMobility);
+  phyTx->SetMaxAntennaGain_Db (antennaGainDb);
+  phyTx->SetDefaultFadingValue (1.0);
+  return phyTx;
+}
+
+double
+SatChannelLinkBudgetTestBase::SendBurst (Ptr<SatPhyTx> phyTx)
+{
+  SatMacTag macTag;
+  macTag.SetSourceAddress (m_gwMac);
+  macTag.SetDestAddress (Mac48Address::GetBroadcast ());
+
+  Ptr<Packet> packet = Create<Packet> (100);
+  packet->AddPacketTag (macTag);
+
+  Ptr<SatSignalParameters> txParams = Create<SatSignalParameters> ();
+  txParams->m_packetsInBurst.push_back (packet);
+  txParams->m_beamId = 1;
+  txParams->m_carrierId = 0;
+  txParams->m_duration = MicroSeconds (100);
+  txParams->m_txPower_W = 1.0;
+  txParams->m_phyTx = phyTx;
+  txParams->m_txInfo.packetType = SatEnums::PACKET_TYPE_DEDICATED_ACCESS;
+
+  m_channel->StartTx (txParams);
+  Simulator::Run ();
+
+  return m_rxPowerW.empty () ? 0.0 : m_rxPowerW.back ();
+}
+
+void
+SatChannelLinkBudgetTestBase::SendMovingBursts (Ptr<SatPhyTx> phyTx, double antennaGainDb,
+                                                std::vector<double> &rxPowerW, std::vector<double> &expectedRxPowerW)
+{
+  Vector gwPosition = m_gwMobility->GetPosition ();
+  Vector satPosition = m_satMobility->GetPosition ();
+  double frequencyHz = m_frequencyHz;
+
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      switch (i)
+        {
+        case 2:
+          {
+            m_gwMobility->SetPosition (Vector (gwPosition.x + 0.5, gwPosition.y, gwPosition.z));
+            break;
+          }
+        case 3:
+          {
+            m_satMobility->SetPosition (Vector (satPosition.x, satPosition.y + 2.0, satPosition.z));
+            break;
+          }
+        case 4:
+          {
+            m_frequencyHz = 2 * frequencyHz;
+            break;
+          }
+        case 5:
+          {
+            m_gwMobility->SetPosition (gwPosition);
+            m_satMobility->SetPosition (satPosition);
+            m_frequencyHz = frequencyHz;
+            break;
+          }
+        default:
+          {
+            break;
+          }
+        }
+
+      rxPowerW.push_back (SendBurst (phyTx));
+      expectedRxPowerW.push_back (GetExpectedRxPowerW (antennaGainDb));
+    }
+}
+
+double
+SatChannelLinkBudgetTestBase::GetExpectedRxPowerW (double antennaGainDb) const
+{
+  return SatUtils::DbToLinear (antennaGainDb + SAT_ANTENNA_GAIN_DB)
+         / m_freeSpaceLoss->GetFsl (m_gwMobility, m_satMobility, m_frequencyHz);
+}
+
+double
+SatChannelLinkBudgetTestBase::GetFrequencyHz (SatEnums::ChannelType_t channelType, uint32_t freqId, uint32_t carrierId)
+{
+  return m_frequencyHz;
+}
+
+void
+SatChannelLinkBudgetTestBase::Receive (Ptr<SatSignalParameters> rxParams, bool phyError)
+{
+  m_rxPowerW.push_back (rxParams->m_rxPower_W);
+}
+
+/**
+ * \ingroup satellite
+ * \brief Test case to unit test that the link budget cache of the satellite channel
+ * is not reused by a new transmitter.
+ *
+ *  1.  Create a feeder uplink channel with the link budget cache enabled and a
+ *      satellite receiver of one carrier.
+ *  2.  Send two bursts from a GW transmitter, dispose the transmitter and send a
+ *      burst from a new one at the same position with 10 dB more antenna gain.
+ *
+ *  Expected result:
+ *   The bursts of the first transmitter are received with the same power. The burst
+ *   of the new transmitter is received with 10 dB more power, i.e. it does not reuse
+ *   the cached link budget of the first one, even if it was given its address.
+ */
+class SatChannelLinkBudgetCacheTestCase : public SatChannelLinkBudgetTestBase
+{
+public:
+  SatChannelLinkBudgetCacheTestCase ();
+  virtual ~SatChannelLinkBudgetCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+SatChannelLinkBudgetCacheTestCase::SatChannelLinkBudgetCacheTestCase ()
+  : SatChannelLinkBudgetTestBase ("Test that the link budget cache of the channel is not reused by a new transmitter.")
+{
+}
+
+SatChannelLinkBudgetCacheTestCase::~SatChannelLinkBudgetCacheTestCase ()
+{
+}
+
+void
+SatChannelLinkBudgetCacheTestCase::DoRun (void)
+{
+  CreateChannel (true);
+
+  Ptr<SatPhyTx> phyTx = CreateTx (60.0);
+  double firstRxPowerW = SendBurst (phyTx);
+  double cachedRxPowerW = SendBurst (phyTx);
+
+  NS_TEST_ASSERT_MSG_EQ (m_rxPowerW.size (), 2, "Bursts of the first transmitter not received");
+  NS_TEST_ASSERT_MSG_GT (firstRxPowerW, 0.0, "No Rx power of the first transmitter");
+  NS_TEST_ASSERT_MSG_EQ_TOL (cachedRxPowerW / firstRxPowerW, 1.0, 1e-9, "Cached link budget changed the Rx power");
+
+  // the new transmitter may get the memory of the disposed one
+  phyTx->Dispose ();
+  phyTx = 0;
+
+  Ptr<SatPhyTx> newPhyTx = CreateTx (70.0);
+  double newRxPowerW = SendBurst (newPhyTx);
+
+  NS_TEST_ASSERT_MSG_EQ (m_rxPowerW.size (), 3, "Burst of the new transmitter not received");
+  NS_TEST_ASSERT_MSG_EQ_TOL (SatUtils::LinearToDb (newRxPowerW / firstRxPowerW), 10.0, 1e-6,
+                             "New transmitter reused the link budget of the disposed one");
+
+  DestroyChannel ();
+}
+
+/**
+ * \ingroup satellite
+ * \brief Test case to unit test that the link budget cache of the satellite channel
+ * is recalculated when the link changes.
+ *
+ *  1.  Create a feeder uplink channel with the link budget cache enabled and a
+ *      satellite receiver of one carrier.
+ *  2.  Send two bursts from a GW transmitter, then a burst after the GW has moved,
+ *      after the satellite has moved, after the carrier frequency has changed, and
+ *      after the GW, the satellite and the frequency have returned to the first burst.
+ *
+ *  Expected result:
+ *   Every burst is received with the power calculated from the free space loss of
+ *   the positions and the frequency at the time of the burst.
+ */
+class SatChannelLinkBudgetUpdateTestCase : public SatChannelLinkBudgetTestBase
+{
+public:
+  SatChannelLinkBudgetUpdateTestCase ();
+  virtual ~SatChannelLinkBudgetUpdateTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+SatChannelLinkBudgetUpdateTestCase::SatChannelLinkBudgetUpdateTestCase ()
+  : SatChannelLinkBudgetTestBase ("Test that the link budget cache of the channel is recalculated when the link changes.")
+{
+}
+
+SatChannelLinkBudgetUpdateTestCase::~SatChannelLinkBudgetUpdateTestCase ()
+{
+}
+
+void
+SatChannelLinkBudgetUpdateTestCase::DoRun (void)
+{
+  CreateChannel (true);
+
+  std::vector<double> rxPowerW;
+  std::vector<double> expectedRxPowerW;
+  SendMovingBursts (CreateTx (60.0), 60.0, rxPowerW, expectedRxPowerW);
+
+  NS_TEST_ASSERT_MSG_EQ (m_rxPowerW.size (), expectedRxPowerW.size (), "Bursts not received");
+
+  for (uint32_t i = 0; i < expectedRxPowerW.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ_TOL (rxPowerW[i] / expectedRxPowerW[i], 1.0, 1e-9, "Unexpected Rx power of burst " << i);
+
+      if (i >= 2)
+        {
+          NS_TEST_ASSERT_MSG_NE (expectedRxPowerW[i], expectedRxPowerW[i - 1], "Link of burst " << i << " did not change");
+        }
+    }
+
+  DestroyChannel ();
+}
+
+/**
+ * \ingroup satellite
+ * \brief Test case to unit test that the link budget cache of the satellite channel
+ * does not change the received powers.
+ *
+ *  1.  Send bursts of changing links, as in SatChannelLinkBudgetUpdateTestCase, with
+ *      the link budget cache enabled.
+ *  2.  Send the same bursts with the link budget cache disabled.
+ *
+ *  Expected result:
+ *   The bursts are received with bit-identical powers with and without the cache.
+ */
+class SatChannelLinkBudgetUncachedTestCase : public SatChannelLinkBudgetTestBase
+{
+public:
+  SatChannelLinkBudgetUncachedTestCase ();
+  virtual ~SatChannelLinkBudgetUncachedTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+SatChannelLinkBudgetUncachedTestCase::SatChannelLinkBudgetUncachedTestCase ()
+  : SatChannelLinkBudgetTestBase ("Test that the link budget cache of the channel does not change the Rx powers.")
+{
+}
+
+SatChannelLinkBudgetUncachedTestCase::~SatChannelLinkBudgetUncachedTestCase ()
+{
+}
+
+void
+SatChannelLinkBudgetUncachedTestCase::DoRun (void)
+{
+  std::vector<double> rxPowerW[2];
+  std::vector<double> expectedRxPowerW[2];
+
+  for (uint32_t k = 0; k < 2; k++)
+    {
+      CreateChannel (k == 0);
+      SendMovingBursts (CreateTx (60.0), 60.0, rxPowerW[k], expectedRxPowerW[k]);
+      DestroyChannel ();
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (rxPowerW[0].size (), rxPowerW[1].size (), "Bursts not received");
+
+  for (uint32_t i = 0; i < rxPowerW[0].size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (rxPowerW[0][i], rxPowerW[1][i], "Rx power of burst " << i << " differs with the cache");
+    }
+}
+
+/**
+ * \ingroup satellite
+ * \brief Test suite for the satellite channel.
+ */
+class SatChannelTestSuite : public TestSuite
+{
+public:
+  SatChannelTestSuite ();
+};
+
+SatChannelTestSuite::SatChannelTestSuite ()
+  : TestSuite ("sat-channel-test", UNIT)
+{
+  AddTestCase (new SatChannelLinkBudgetCacheTestCase, TestCase::QUICK);
+  AddTestCase (new SatChannelLinkBudgetUpdateTestCase, TestCase::QUICK);
+  AddTestCase (new SatChannelLinkBudgetUncachedTestCase, TestCase::QUICK);
+}
+
+// Do allocate an instance of this TestSuite
+static SatChannelTestSuite satChannelTestSuite;
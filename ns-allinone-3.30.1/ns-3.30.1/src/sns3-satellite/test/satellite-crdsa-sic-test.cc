@@ -0,0 +1,440 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file satellite-crdsa-sic-test.cc
+ * \ingroup satellite
+ * \brief Test cases to unit test the CRDSA successive interference cancellation.
+ */
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/mac48-address.h"
+#include "ns3/random-variable-stream.h"
+#include "../model/satellite-phy-rx-carrier-per-frame.h"
+#include "../model/satellite-signal-parameters.h"
+#include "../model/satellite-crdsa-replica-tag.h"
+#include "../model/satellite-enums.h"
+#include <algorithm>
+#include <list>
+#include <map>
+#include <set>
+#include <vector>
+
+using namespace ns3;
+
+namespace {
+
+/// Bandwidth of the test carrier in Hz
+double
+GetTestBandwidthHz (SatEnums::ChannelType_t channelType, uint32_t carrierId, SatEnums::CarrierBandwidthType_t bandwidthType)
+{
+  return 1e6;
+}
+
+/// SINR calculator of the test carrier, no additional interference
+double
+GetTestSinr (double sinr)
+{
+  return sinr;
+}
+
+/// Slots of the replicas of every UT of a CRDSA frame
+typedef std::vector<std::vector<uint16_t> > CrdsaFrame_t;
+
+/**
+ * Create a frame of numOfUts UTs sending numOfReplicas replicas each in
+ * distinct random slots of numOfSlots slots.
+ */
+CrdsaFrame_t
+CreateCrdsaFrame (uint32_t numOfUts, uint16_t numOfSlots, uint32_t numOfReplicas, Ptr<UniformRandomVariable> unif)
+{
+  CrdsaFrame_t frame (numOfUts);
+
+  for (uint32_t ut = 0; ut < numOfUts; ut++)
+    {
+      while (frame[ut].size () < numOfReplicas)
+        {
+          uint16_t slot = unif->GetInteger (0, numOfSlots - 1);
+
+          if (std::find (frame[ut].begin (), frame[ut].end (), slot) == frame[ut].end ())
+            {
+              frame[ut].push_back (slot);
+            }
+        }
+    }
+  return frame;
+}
+
+/**
+ * Decode a frame by peeling: a UT alone in a slot is decoded and its replicas are
+ * removed from all slots, until no slot has a single UT left.
+ * \return decoded flag of every UT
+ */
+std::vector<bool>
+PeelCrdsaFrame (const CrdsaFrame_t &frame)
+{
+  std::vector<bool> decoded (frame.size (), false);
+  bool progress = true;
+
+  while (progress)
+    {
+      progress = false;
+      std::map<uint16_t, std::vector<uint32_t> > slots;
+
+      for (uint32_t ut = 0; ut < frame.size (); ut++)
+        {
+          for (uint32_t i = 0; i < frame[ut].size () && !decoded[ut]; i++)
+            {
+              slots[frame[ut][i]].push_back (ut);
+            }
+        }
+
+      std::map<uint16_t, std::vector<uint32_t> >::const_iterator iter;
+      for (iter = slots.begin (); iter != slots.end (); iter++)
+        {
+          if (iter->second.size () == 1 && !decoded[iter->second.front ()])
+            {
+              decoded[iter->second.front ()] = true;
+              progress = true;
+            }
+        }
+    }
+  return decoded;
+}
+
+/**
+ * Decode a frame like the frame processing before the peeling decoder: the slots are scanned
+ * from the first one for the first unprocessed packet, which is received when it is alone in
+ * its slot. A received UT is removed from all its slots, releasing the other packets of those
+ * slots for processing, and the scan restarts. The UTs left are then taken in the order of
+ * their first remaining slot.
+ * \param numOfDecoded number of UTs received
+ * \return UTs in the order of their processed payloads
+ */
+std::vector<uint32_t>
+RestartScanCrdsaFrame (const CrdsaFrame_t &frame, uint32_t &numOfDecoded)
+{
+  /// UT and processed flag of the packets of every slot, in reception order
+  typedef std::list<std::pair<uint32_t, bool> > SlotPackets_t;
+  std::map<uint16_t, SlotPackets_t> slots;
+  std::vector<uint32_t> order;
+
+  for (uint32_t ut = 0; ut < frame.size (); ut++)
+    {
+      for (uint32_t i = 0; i < frame[ut].size (); i++)
+        {
+          slots[frame[ut][i]].push_back (std::make_pair (ut, false));
+        }
+    }
+
+  for (bool removeReceived = true; !slots.empty (); )
+    {
+      uint32_t ut = 0;
+      bool found = false;
+
+      if (removeReceived)
+        {
+          std::map<uint16_t, SlotPackets_t>::iterator iter;
+          for (iter = slots.begin (); iter != slots.end () && !found; iter++)
+            {
+              SlotPackets_t::iterator packet;
+              for (packet = iter->second.begin (); packet != iter->second.end () && !found; packet++)
+                {
+                  if (!packet->second)
+                    {
+                      packet->second = true;
+                      found = iter->second.size () == 1;
+                      ut = packet->first;
+                    }
+                }
+            }
+          removeReceived = found;
+        }
+      if (!found)
+        {
+          /// no packet received anymore
+          ut = slots.begin ()->second.front ().first;
+        }
+
+      for (uint32_t i = 0; i < frame[ut].size (); i++)
+        {
+          SlotPackets_t &packets = slots[frame[ut][i]];
+          SlotPackets_t::iterator packet = packets.begin ();
+
+          while (packet != packets.end ())
+            {
+              if (packet->first == ut)
+                {
+                  packet = packets.erase (packet);
+                }
+              else
+                {
+                  packet->second = packet->second && !found;
+                  packet++;
+                }
+            }
+          if (packets.empty ())
+            {
+              slots.erase (frame[ut][i]);
+            }
+        }
+      order.push_back (ut);
+      numOfDecoded += found ? 1 : 0;
+    }
+  return order;
+}
+
+} // anonymous namespace
+
+/**
+ * \ingroup satellite
+ * \brief CRDSA carrier feeding frames to the frame processing directly.
+ */
+class SatCrdsaSicTestCarrier : public SatPhyRxCarrierPerFrame
+{
+public:
+  SatCrdsaSicTestCarrier (Ptr<SatPhyRxCarrierConf> carrierConf);
+
+  /**
+   * Add the replicas of every UT of a frame, the received power of UT u at the satellite is
+   * (u + 1) * rxPowerW, its interference the sum of the powers of the other UTs in its slot
+   */
+  void AddFrame (const CrdsaFrame_t &frame, double rxPowerW);
+
+  /**
+   * Process the frame.
+   * \return processed unique payloads
+   */
+  std::vector<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s> Process ();
+
+  static const double NOISE_POWER_W;
+};
+
+const double SatCrdsaSicTestCarrier::NOISE_POWER_W = 1e-14;
+
+SatCrdsaSicTestCarrier::SatCrdsaSicTestCarrier (Ptr<SatPhyRxCarrierConf> carrierConf)
+  : SatPhyRxCarrierPerFrame (0, carrierConf, true)
+{
+}
+
+void
+SatCrdsaSicTestCarrier::AddFrame (const CrdsaFrame_t &frame, double rxPowerW)
+{
+  std::map<uint16_t, double> slotPowerW;
+
+  for (uint32_t ut = 0; ut < frame.size (); ut++)
+    {
+      for (uint32_t i = 0; i < frame[ut].size (); i++)
+        {
+          slotPowerW[frame[ut][i]] += (ut + 1) * rxPowerW;
+        }
+    }
+
+  for (uint32_t ut = 0; ut < frame.size (); ut++)
+    {
+      Ptr<Packet> payload = Create<Packet> (100);
+      Mac48Address sourceAddress = Mac48Address::Allocate ();
+
+      for (uint32_t i = 0; i < frame[ut].size (); i++)
+        {
+          /// own slot first, like the replica tags of the UT MAC
+          SatCrdsaReplicaTag replicaTag;
+          replicaTag.AddSlotId (frame[ut][i]);
+          for (uint32_t j = 0; j < frame[ut].size (); j++)
+            {
+              if (j != i)
+                {
+                  replicaTag.AddSlotId (frame[ut][j]);
+                }
+            }
+
+          Ptr<Packet> packet = payload->Copy ();
+          packet->AddPacketTag (replicaTag);
+
+          Ptr<SatSignalParameters> rxParams = Create<SatSignalParameters> ();
+          rxParams->m_packetsInBurst.push_back (packet);
+          rxParams->m_txInfo.packetType = SatEnums::PACKET_TYPE_CRDSA;
+          rxParams->m_txInfo.crdsaUniquePacketId = ut;
+          rxParams->m_rxPower_W = 1e-10;
+          rxParams->m_ifPower_W = 0.0;
+          rxParams->m_rxPowerInSatellite_W = (ut + 1) * rxPowerW;
+          rxParams->m_ifPowerInSatellite_W = slotPowerW[frame[ut][i]] - rxParams->m_rxPowerInSatellite_W;
+          rxParams->m_rxNoisePowerInSatellite_W = NOISE_POWER_W;
+          rxParams->m_rxAciIfPowerInSatellite_W = 0.0;
+          rxParams->m_rxExtNoisePowerInSatellite_W = 0.0;
+          rxParams->m_sinrCalculate = MakeCallback (&GetTestSinr);
+
+          SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s params;
+          params.rxParams = rxParams;
+          params.sourceAddress = sourceAddress;
+          params.destAddress = Mac48Address::GetBroadcast ();
+          params.hasCollision = false;
+          params.packetHasBeenProcessed = false;
+
+          AddCrdsaPacket (params);
+        }
+    }
+}
+
+std::vector<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s>
+SatCrdsaSicTestCarrier::Process ()
+{
+  return ProcessFrame ();
+}
+
+/**
+ * Create a CRDSA test carrier with strict collision detection and no errors, i.e.
+ * a packet is received when it is alone in its slot.
+ */
+static Ptr<SatCrdsaSicTestCarrier>
+CreateCrdsaSicTestCarrier ()
+{
+  SatPhyRxCarrierConf::RxCarrierCreateParams_s params = SatPhyRxCarrierConf::RxCarrierCreateParams_s ();
+  params.m_rxTemperatureK = 290.0;
+  params.m_errorModel = SatPhyRxCarrierConf::EM_NONE;
+  params.m_daIfModel = SatPhyRxCarrierConf::IF_CONSTANT;
+  params.m_raIfModel = SatPhyRxCarrierConf::IF_CONSTANT;
+  params.m_chType = SatEnums::RETURN_FEEDER_CH;
+  params.m_bwConverter = MakeCallback (&GetTestBandwidthHz);
+  params.m_carrierCount = 1;
+  params.m_raCollisionModel = SatPhyRxCarrierConf::RA_COLLISION_ALWAYS_DROP_ALL_COLLIDING_PACKETS;
+  params.m_randomAccessModel = SatEnums::RA_MODEL_CRDSA;
+
+  Ptr<SatPhyRxCarrierConf> carrierConf = CreateObject<SatPhyRxCarrierConf> (params);
+  carrierConf->SetSinrCalculatorCb (MakeCallback (&GetTestSinr));
+
+  return CreateObject<SatCrdsaSicTestCarrier> (carrierConf);
+}
+
+/**
+ * \ingroup satellite
+ * \brief Test case to unit test the CRDSA successive interference cancellation.
+ *
+ *  1.  Create random CRDSA frames of 2 and 3 replicas per UT at loads below and above the peeling threshold.
+ *  2.  Process the frames with strict collision detection, i.e. a packet is received when it is alone in its slot.
+ *  3.  Decode the same frames by peeling slots of a single UT, and by restarting the scan of the
+ *      slots after every received packet like the frame processing before the peeling decoder.
+ *
+ *  Expected result:
+ *   Every UT has exactly one processed payload, received without error if and only if the UT was peeled.
+ *   The payloads are in the order of the restart scan, the received ones first.
+ *   The interference of the other UTs has been eliminated from the received payloads.
+ */
+class SatCrdsaSicTestCase : public TestCase
+{
+public:
+  SatCrdsaSicTestCase ();
+  virtual ~SatCrdsaSicTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+SatCrdsaSicTestCase::SatCrdsaSicTestCase ()
+  : TestCase ("Test CRDSA successive interference cancellation against slot peeling.")
+{
+}
+
+SatCrdsaSicTestCase::~SatCrdsaSicTestCase ()
+{
+}
+
+void
+SatCrdsaSicTestCase::DoRun (void)
+{
+  const double rxPowerW = 1e-12;
+  Ptr<SatCrdsaSicTestCarrier> carrier = CreateCrdsaSicTestCarrier ();
+  uint32_t numOfDecodedFrames = 0;
+  uint32_t numOfUndecodedFrames = 0;
+
+  Ptr<UniformRandomVariable> unif = CreateObject<UniformRandomVariable> ();
+  unif->SetStream (1);
+
+  for (uint32_t frameId = 1; frameId <= 40; frameId++)
+    {
+      uint32_t numOfReplicas = 2 + frameId % 2;
+      uint32_t numOfUts = 10 + frameId * 3;
+      CrdsaFrame_t frame = CreateCrdsaFrame (numOfUts, 100, numOfReplicas, unif);
+      std::vector<bool> decoded = PeelCrdsaFrame (frame);
+      uint32_t numOfDecoded = 0;
+      std::vector<uint32_t> order = RestartScanCrdsaFrame (frame, numOfDecoded);
+
+      carrier->AddFrame (frame, rxPowerW);
+      std::vector<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s> results = carrier->Process ();
+
+      NS_TEST_ASSERT_MSG_EQ (results.size (), numOfUts, "One payload of every UT in frame " << frameId);
+
+      std::set<uint32_t> uts;
+      bool allDecoded = true;
+
+      for (uint32_t i = 0; i < results.size (); i++)
+        {
+          uint32_t ut = results[i].rxParams->m_txInfo.crdsaUniquePacketId;
+          uts.insert (ut);
+          allDecoded = allDecoded && decoded[ut];
+
+          NS_TEST_ASSERT_MSG_EQ (ut, order[i], "Payload " << i << " in the order of the restart scan in frame " << frameId);
+          NS_TEST_ASSERT_MSG_EQ (results[i].phyError, (i >= numOfDecoded), "Received payloads first in frame " << frameId);
+
+          NS_TEST_ASSERT_MSG_EQ (results[i].phyError, !decoded[ut], "Reception of UT " << ut << " in frame " << frameId);
+          NS_TEST_ASSERT_MSG_EQ (results[i].packetHasBeenProcessed, true, "UT " << ut << " processed in frame " << frameId);
+
+          if (!results[i].phyError)
+            {
+              NS_TEST_ASSERT_MSG_EQ_TOL (results[i].rxParams->m_ifPowerInSatellite_W / rxPowerW, 0.0, 1e-6,
+                                         "Interference eliminated for UT " << ut << " in frame " << frameId);
+            }
+        }
+      NS_TEST_ASSERT_MSG_EQ (uts.size (), numOfUts, "Payloads of distinct UTs in frame " << frameId);
+
+      if (allDecoded)
+        {
+          numOfDecodedFrames++;
+        }
+      else
+        {
+          numOfUndecodedFrames++;
+        }
+    }
+
+  // the frames cover both complete and incomplete decoding
+  NS_TEST_ASSERT_MSG_GT (numOfDecodedFrames, 0, "Completely decoded frames");
+  NS_TEST_ASSERT_MSG_GT (numOfUndecodedFrames, 0, "Partially decoded frames");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup satellite
+ * \brief Test suite for the CRDSA successive interference cancellation.
+ */
+class SatCrdsaSicTestSuite : public TestSuite
+{
+public:
+  SatCrdsaSicTestSuite ();
+};
+
+SatCrdsaSicTestSuite::SatCrdsaSicTestSuite ()
+  : TestSuite ("sat-crdsa-sic-test", UNIT)
+{
+  AddTestCase (new SatCrdsaSicTestCase, TestCase::QUICK);
+}
+
+// Do allocate an instance of this TestSuite
+static SatCrdsaSicTestSuite satCrdsaSicTestSuite;
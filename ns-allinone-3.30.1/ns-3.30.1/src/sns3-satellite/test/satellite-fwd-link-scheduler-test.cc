@@ -0,0 +1,459 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file satellite-fwd-link-scheduler-test.cc
+ * \ingroup satellite
+ * \brief Test cases to unit test the scheduling order of the forward link scheduler.
+ */
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/enum.h"
+#include "ns3/mac48-address.h"
+#include "ns3/random-variable-stream.h"
+#include "../model/satellite-fwd-link-scheduler.h"
+#include "../model/satellite-scheduling-object.h"
+#include "ns3/satellite-bbframe-conf.h"
+#include <algorithm>
+#include <map>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup satellite
+ * \brief Buffers of the flows towards the UTs, in place of the GW LLC and its
+ * encapsulators in the tests of the forward link scheduler.
+ */
+class SatFwdLinkSchedulerTestBuffers : public SimpleRefCount<SatFwdLinkSchedulerTestBuffers>
+{
+public:
+  typedef std::pair<Mac48Address, uint8_t> FlowKey_t;
+
+  typedef struct
+  {
+    uint32_t bufferedBytes;
+    Time holTimestamp;
+  } flowBuffer_s;
+
+  typedef std::map<FlowKey_t, flowBuffer_s> FlowBufferMap_t;
+
+  static const uint32_t MIN_TX_OPPORTUNITY = 50;
+  static const uint32_t MAX_PDU_SIZE = 2000;
+
+  /**
+   * Constructor
+   * \param scheduler Scheduler to notify the buffer changes
+   */
+  SatFwdLinkSchedulerTestBuffers (Ptr<SatFwdLinkScheduler> scheduler);
+
+  /**
+   * Add bytes to the buffer of a flow.
+   * \param address UT address
+   * \param flowId Flow identifier
+   * \param bytes Bytes to add
+   * \param holTimestamp Arrival time of the bytes
+   */
+  void Enque (Mac48Address address, uint8_t flowId, uint32_t bytes, Time holTimestamp);
+
+  /**
+   * Get the scheduling objects of the backlogged flows.
+   * \param output Scheduling objects
+   */
+  void GetSchedulingContexts (std::vector< Ptr<SatSchedulingObject> > & output);
+
+  /**
+   * Take bytes from the buffer of a flow.
+   * \param bytes Tx opportunity in bytes
+   * \param utAddr UT address
+   * \param flowId Flow identifier
+   * \param bytesLeft Bytes left in the buffer
+   * \param nextMinTxO Minimum Tx opportunity
+   * \return Packet of the bytes taken
+   */
+  Ptr<Packet> NotifyTxOpportunity (uint32_t bytes, Mac48Address utAddr, uint8_t flowId, uint32_t &bytesLeft, uint32_t &nextMinTxO);
+
+  FlowBufferMap_t m_buffers;
+  std::vector<FlowKey_t> m_txOpportunities;
+
+private:
+  void NotifyBufferChanged (const FlowKey_t &key);
+
+  Ptr<SatFwdLinkScheduler> m_scheduler;
+};
+
+SatFwdLinkSchedulerTestBuffers::SatFwdLinkSchedulerTestBuffers (Ptr<SatFwdLinkScheduler> scheduler)
+  : m_scheduler (scheduler)
+{
+  scheduler->SetTxOpportunityCallback (MakeCallback (&SatFwdLinkSchedulerTestBuffers::NotifyTxOpportunity, this));
+  scheduler->SetSchedContextCallback (MakeCallback (&SatFwdLinkSchedulerTestBuffers::GetSchedulingContexts, this));
+}
+
+void
+SatFwdLinkSchedulerTestBuffers::Enque (Mac48Address address, uint8_t flowId, uint32_t bytes, Time holTimestamp)
+{
+  FlowKey_t key = std::make_pair (address, flowId);
+  FlowBufferMap_t::iterator it = m_buffers.find (key);
+
+  if (it == m_buffers.end ())
+    {
+      flowBuffer_s buffer = { 0, holTimestamp };
+      it = m_buffers.insert (std::make_pair (key, buffer)).first;
+    }
+  else if (it->second.bufferedBytes == 0)
+    {
+      it->second.holTimestamp = holTimestamp;
+    }
+
+  it->second.bufferedBytes += bytes;
+  NotifyBufferChanged (key);
+}
+
+void
+SatFwdLinkSchedulerTestBuffers::GetSchedulingContexts (std::vector< Ptr<SatSchedulingObject> > & output)
+{
+  for (FlowBufferMap_t::const_iterator it = m_buffers.begin (); it != m_buffers.end (); ++it)
+    {
+      if (it->second.bufferedBytes > 0)
+        {
+          output.push_back (Create<SatSchedulingObject> (it->first.first, it->second.bufferedBytes, MIN_TX_OPPORTUNITY,
+                                                         Simulator::Now () - it->second.holTimestamp, it->first.second));
+        }
+    }
+}
+
+Ptr<Packet>
+SatFwdLinkSchedulerTestBuffers::NotifyTxOpportunity (uint32_t bytes, Mac48Address utAddr, uint8_t flowId, uint32_t &bytesLeft, uint32_t &nextMinTxO)
+{
+  FlowKey_t key = std::make_pair (utAddr, flowId);
+  flowBuffer_s &buffer = m_buffers[key];
+  uint32_t packetBytes = std::min (bytes, buffer.bufferedBytes);
+
+  if (packetBytes > MAX_PDU_SIZE)
+    {
+      packetBytes = MAX_PDU_SIZE;
+    }
+
+  m_txOpportunities.push_back (key);
+  buffer.bufferedBytes -= packetBytes;
+  bytesLeft = buffer.bufferedBytes;
+  nextMinTxO = MIN_TX_OPPORTUNITY;
+  NotifyBufferChanged (key);
+
+  return Create<Packet> (packetBytes);
+}
+
+void
+SatFwdLinkSchedulerTestBuffers::NotifyBufferChanged (const FlowKey_t &key)
+{
+  const flowBuffer_s &buffer = m_buffers[key];
+
+  if (buffer.bufferedBytes > 0)
+    {
+      m_scheduler->UpdateSchedulingObject (key.first, key.second, buffer.bufferedBytes, MIN_TX_OPPORTUNITY, buffer.holTimestamp);
+    }
+  else
+    {
+      m_scheduler->UpdateSchedulingObject (key.first, key.second, 0, 0, Time::Max ());
+    }
+}
+
+/**
+ * Create a forward link scheduler for the tests.
+ * \param criteria Additional sorting criteria
+ * \param incremental Maintain the scheduling objects incrementally
+ * \return Scheduler
+ */
+static Ptr<SatFwdLinkScheduler>
+CreateTestScheduler (SatFwdLinkScheduler::ScheduleSortingCriteria_t criteria, bool incremental)
+{
+  Ptr<SatBbFrameConf> bbFrameConf = CreateObject<SatBbFrameConf> (93750000.0);
+  Ptr<SatFwdLinkScheduler> scheduler = CreateObject<SatFwdLinkScheduler> (bbFrameConf, Mac48Address::Allocate (), 125000000.0);
+  scheduler->SetAttribute ("AdditionalSortCriteria", EnumValue (criteria));
+  scheduler->SetAttribute ("IncrementalSchedulingObjects", BooleanValue (incremental));
+
+  return scheduler;
+}
+
+/**
+ * \ingroup satellite
+ * \brief Test case to unit test the scheduling order of the scheduling objects
+ * maintained incrementally from the buffer changes.
+ *
+ *  1.  Create a scheduler with the given sorting criteria and buffers of 3 flows of 8 UTs.
+ *  2.  Get frames from the scheduler while adding data to the flows in between.
+ *  3.  Sort the flows backlogged before every scheduling round according to the criteria.
+ *
+ *  Expected result:
+ *   In every scheduling round the flows are served in the sorted order, without
+ *   skipping any flow until the frames are full.
+ */
+class SatFwdLinkSchedulerOrderTestCase : public TestCase
+{
+public:
+  SatFwdLinkSchedulerOrderTestCase (SatFwdLinkScheduler::ScheduleSortingCriteria_t criteria, std::string name);
+  virtual ~SatFwdLinkSchedulerOrderTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  SatFwdLinkScheduler::ScheduleSortingCriteria_t m_criteria;
+};
+
+SatFwdLinkSchedulerOrderTestCase::SatFwdLinkSchedulerOrderTestCase (SatFwdLinkScheduler::ScheduleSortingCriteria_t criteria, std::string name)
+  : TestCase ("Test scheduling order of forward link scheduler with " + name + "."),
+    m_criteria (criteria)
+{
+}
+
+SatFwdLinkSchedulerOrderTestCase::~SatFwdLinkSchedulerOrderTestCase ()
+{
+}
+
+void
+SatFwdLinkSchedulerOrderTestCase::DoRun (void)
+{
+  typedef SatFwdLinkSchedulerTestBuffers::FlowKey_t FlowKey_t;
+  typedef SatFwdLinkSchedulerTestBuffers::FlowBufferMap_t FlowBufferMap_t;
+
+  Ptr<SatFwdLinkScheduler> scheduler = CreateTestScheduler (m_criteria, true);
+  Ptr<SatFwdLinkSchedulerTestBuffers> buffers = Create<SatFwdLinkSchedulerTestBuffers> (scheduler);
+
+  std::vector<Mac48Address> utMacs;
+  for (uint32_t i = 0; i < 8; i++)
+    {
+      utMacs.push_back (Mac48Address::Allocate ());
+    }
+
+  Ptr<UniformRandomVariable> unif = CreateObject<UniformRandomVariable> ();
+  unif->SetStream (1);
+
+  int64_t arrivalMs = -100000;
+  uint32_t numOfRounds = 0;
+
+  for (uint32_t i = 0; i < 400; i++)
+    {
+      // add data to some of the flows, loads and arrival times repeating to get ties too
+      for (uint32_t j = 0; j < 3; j++)
+        {
+          arrivalMs += unif->GetInteger (0, 1);
+          uint32_t ut = unif->GetInteger (0, 7);
+          uint8_t flowId = unif->GetInteger (1, 3);
+          uint32_t bytes = 20000 * unif->GetInteger (1, 8);
+          buffers->Enque (utMacs[ut], flowId, bytes, MilliSeconds (arrivalMs));
+        }
+
+      std::vector<std::pair<FlowKey_t, SatFwdLinkSchedulerTestBuffers::flowBuffer_s> > backlog;
+      for (FlowBufferMap_t::const_iterator it = buffers->m_buffers.begin (); it != buffers->m_buffers.end (); ++it)
+        {
+          if (it->second.bufferedBytes > 0)
+            {
+              backlog.push_back (*it);
+            }
+        }
+
+      uint32_t firstTxOpportunity = buffers->m_txOpportunities.size ();
+
+      scheduler->GetNextFrame ();
+
+      // flows served in the round, the same flow gets consecutive Tx opportunities
+      std::vector<FlowKey_t> served;
+      for (uint32_t j = firstTxOpportunity; j < buffers->m_txOpportunities.size (); j++)
+        {
+          if (served.empty () || served.back () != buffers->m_txOpportunities[j])
+            {
+              served.push_back (buffers->m_txOpportunities[j]);
+            }
+        }
+
+      if (served.empty ())
+        {
+          continue;
+        }
+
+      numOfRounds++;
+
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (served.size (), backlog.size (), "More flows served than backlogged in round " << numOfRounds);
+
+      // partial sort of the backlog with the sorting criteria, ties in MAC address order
+      for (uint32_t j = 0; j < served.size () && j < backlog.size (); j++)
+        {
+          uint32_t first = j;
+          for (uint32_t k = j + 1; k < backlog.size (); k++)
+            {
+              const std::pair<FlowKey_t, SatFwdLinkSchedulerTestBuffers::flowBuffer_s> &a = backlog[k];
+              const std::pair<FlowKey_t, SatFwdLinkSchedulerTestBuffers::flowBuffer_s> &b = backlog[first];
+              bool before = ( a.first.first < b.first.first );
+
+              if ( m_criteria == SatFwdLinkScheduler::BUFFERING_DELAY_SORT && a.second.holTimestamp != b.second.holTimestamp )
+                {
+                  before = ( a.second.holTimestamp < b.second.holTimestamp );
+                }
+              else if ( m_criteria == SatFwdLinkScheduler::BUFFERING_LOAD_SORT && a.second.bufferedBytes != b.second.bufferedBytes )
+                {
+                  before = ( a.second.bufferedBytes > b.second.bufferedBytes );
+                }
+
+              if ( a.first.second != b.first.second )
+                {
+                  before = ( a.first.second < b.first.second );
+                }
+
+              if ( before )
+                {
+                  first = k;
+                }
+            }
+
+          std::swap (backlog[j], backlog[first]);
+
+          NS_TEST_ASSERT_MSG_EQ ((served[j] == backlog[j].first), true, "Flow " << j << " served out of order in round " << numOfRounds);
+        }
+    }
+
+  NS_TEST_ASSERT_MSG_GT (numOfRounds, 10, "Too few scheduling rounds");
+
+  scheduler->Dispose ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup satellite
+ * \brief Test case to unit test that the scheduling objects maintained incrementally
+ * are served in the order of the objects got from the buffers and sorted in every round.
+ *
+ *  1.  Create a scheduler maintaining the scheduling objects incrementally and one getting
+ *      them from the buffers in every round, both with delay sorting.
+ *  2.  Backlog flows of 200 UTs, then get frames from both schedulers while adding the same
+ *      data to random flows, draining some flows and backlogging others again. Every arrival
+ *      time is unique, so that the sorting of the objects got from the buffers has no ties.
+ *
+ *  Expected result:
+ *   Both schedulers give the same Tx opportunities to the flows in the same order.
+ */
+class SatFwdLinkSchedulerIncrementalTestCase : public TestCase
+{
+public:
+  SatFwdLinkSchedulerIncrementalTestCase ();
+  virtual ~SatFwdLinkSchedulerIncrementalTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+SatFwdLinkSchedulerIncrementalTestCase::SatFwdLinkSchedulerIncrementalTestCase ()
+  : TestCase ("Test incremental scheduling objects against sorted ones.")
+{
+}
+
+SatFwdLinkSchedulerIncrementalTestCase::~SatFwdLinkSchedulerIncrementalTestCase ()
+{
+}
+
+void
+SatFwdLinkSchedulerIncrementalTestCase::DoRun (void)
+{
+  uint32_t numOfUts = 200;
+  uint32_t numOfFrames = 300;
+  Ptr<SatFwdLinkScheduler> schedulers[2];
+  Ptr<SatFwdLinkSchedulerTestBuffers> buffers[2];
+
+  std::vector<Mac48Address> utMacs;
+  for (uint32_t i = 0; i < numOfUts; i++)
+    {
+      utMacs.push_back (Mac48Address::Allocate ());
+    }
+
+  for (uint32_t s = 0; s < 2; s++)
+    {
+      schedulers[s] = CreateTestScheduler (SatFwdLinkScheduler::BUFFERING_DELAY_SORT, s == 0);
+      buffers[s] = Create<SatFwdLinkSchedulerTestBuffers> (schedulers[s]);
+
+      for (uint32_t i = 0; i < numOfUts; i++)
+        {
+          buffers[s]->Enque (utMacs[i], 1 + i % 3, 5000 * (1 + i % 7), MilliSeconds (-100000 + i));
+        }
+    }
+
+  Ptr<UniformRandomVariable> unif = CreateObject<UniformRandomVariable> ();
+  unif->SetStream (1);
+
+  int64_t arrivalMs = 0;
+
+  for (uint32_t i = 0; i < numOfFrames; i++)
+    {
+      // the same data to both
+      for (uint32_t j = 0; j < 4; j++)
+        {
+          arrivalMs++;
+          uint32_t ut = unif->GetInteger (0, numOfUts - 1);
+          uint8_t flowId = unif->GetInteger (1, 3);
+          uint32_t bytes = 2000 * unif->GetInteger (1, 8);
+
+          for (uint32_t s = 0; s < 2; s++)
+            {
+              buffers[s]->Enque (utMacs[ut], flowId, bytes, MilliSeconds (arrivalMs));
+            }
+        }
+
+      for (uint32_t s = 0; s < 2; s++)
+        {
+          schedulers[s]->GetNextFrame ();
+        }
+
+      NS_TEST_ASSERT_MSG_EQ (buffers[0]->m_txOpportunities.size (), buffers[1]->m_txOpportunities.size (),
+                             "Different number of Tx opportunities in frame " << i);
+    }
+
+  NS_TEST_ASSERT_MSG_GT (buffers[0]->m_txOpportunities.size (), numOfFrames, "Too few Tx opportunities");
+
+  for (uint32_t j = 0; j < buffers[0]->m_txOpportunities.size (); j++)
+    {
+      NS_TEST_ASSERT_MSG_EQ ((buffers[0]->m_txOpportunities[j] == buffers[1]->m_txOpportunities[j]), true,
+                             "Tx opportunity " << j << " given to a different flow");
+    }
+
+  for (uint32_t s = 0; s < 2; s++)
+    {
+      schedulers[s]->Dispose ();
+    }
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup satellite
+ * \brief Test suite for the forward link scheduler.
+ */
+class SatFwdLinkSchedulerTestSuite : public TestSuite
+{
+public:
+  SatFwdLinkSchedulerTestSuite ();
+};
+
+SatFwdLinkSchedulerTestSuite::SatFwdLinkSchedulerTestSuite ()
+  : TestSuite ("sat-fwd-link-scheduler-test", UNIT)
+{
+  AddTestCase (new SatFwdLinkSchedulerOrderTestCase (SatFwdLinkScheduler::NO_SORT, "no sorting"), TestCase::QUICK);
+  AddTestCase (new SatFwdLinkSchedulerOrderTestCase (SatFwdLinkScheduler::BUFFERING_DELAY_SORT, "delay sorting"), TestCase::QUICK);
+  AddTestCase (new SatFwdLinkSchedulerOrderTestCase (SatFwdLinkScheduler::BUFFERING_LOAD_SORT, "load sorting"), TestCase::QUICK);
+  AddTestCase (new SatFwdLinkSchedulerIncrementalTestCase, TestCase::QUICK);
+}
+
+// Do allocate an instance of this TestSuite
+static SatFwdLinkSchedulerTestSuite satFwdLinkSchedulerTestSuite;
@@ -0,0 +1,204 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file satellite-gw-llc-test.cc
+ * \ingroup satellite
+ * \brief Test cases to unit test the queue statistics of the GW LLC per UT.
+ */
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/mac48-address.h"
+#include "ns3/random-variable-stream.h"
+#include "../model/satellite-gw-llc.h"
+#include "../model/satellite-generic-stream-encapsulator.h"
+#include "../model/satellite-queue.h"
+#include "../model/satellite-node-info.h"
+#include "../model/satellite-enums.h"
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup satellite
+ * \brief Test case to unit test the number of bytes and packets queued per UT
+ * in the GW LLC.
+ *
+ *  1.  Create a GW LLC with a control encapsulator added like the helper does.
+ *  2.  Enque packets of random size to 2 flows of 6 UTs and control messages.
+ *  3.  Get packets with Tx opportunities of random size, fragmenting the packets.
+ *  4.  Drain the flows of one UT at a time.
+ *
+ *  Expected result:
+ *   The bytes and packets of the UTs always sum to the ones in all the queues of the
+ *   LLC, and the ones of the control encapsulator are the ones in its queue. Drained
+ *   UTs have no bytes or packets queued, the other UTs keep theirs.
+ */
+class SatGwLlcQueueStatsTestCase : public TestCase
+{
+public:
+  SatGwLlcQueueStatsTestCase ();
+  virtual ~SatGwLlcQueueStatsTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Check the bytes and packets of the UTs against the queues of the LLC.
+   * \param llc LLC
+   * \param utMacs UT addresses
+   * \param ctrlQueue Queue of the control encapsulator
+   * \param step Step of the test
+   */
+  void CheckQueueStats (Ptr<SatLlc> llc, const std::vector<Mac48Address> &utMacs, Ptr<SatQueue> ctrlQueue, uint32_t step);
+};
+
+SatGwLlcQueueStatsTestCase::SatGwLlcQueueStatsTestCase ()
+  : TestCase ("Test queue statistics of GW LLC per UT.")
+{
+}
+
+SatGwLlcQueueStatsTestCase::~SatGwLlcQueueStatsTestCase ()
+{
+}
+
+void
+SatGwLlcQueueStatsTestCase::CheckQueueStats (Ptr<SatLlc> llc, const std::vector<Mac48Address> &utMacs, Ptr<SatQueue> ctrlQueue, uint32_t step)
+{
+  uint32_t nBytes = 0;
+  uint32_t nPackets = 0;
+
+  for (uint32_t i = 0; i < utMacs.size (); i++)
+    {
+      nBytes += llc->GetNBytesInQueue (utMacs[i]);
+      nPackets += llc->GetNPacketsInQueue (utMacs[i]);
+    }
+
+  Mac48Address broadcast = Mac48Address::GetBroadcast ();
+
+  NS_TEST_ASSERT_MSG_EQ (llc->GetNBytesInQueue (broadcast), ctrlQueue->GetNBytes (), "Wrong bytes of control messages at step " << step);
+  NS_TEST_ASSERT_MSG_EQ (llc->GetNPacketsInQueue (broadcast), ctrlQueue->GetNPackets (), "Wrong packets of control messages at step " << step);
+  NS_TEST_ASSERT_MSG_EQ (nBytes + ctrlQueue->GetNBytes (), llc->GetNBytesInQueue (), "Wrong bytes of UTs at step " << step);
+  NS_TEST_ASSERT_MSG_EQ (nPackets + ctrlQueue->GetNPackets (), llc->GetNPacketsInQueue (), "Wrong packets of UTs at step " << step);
+}
+
+void
+SatGwLlcQueueStatsTestCase::DoRun (void)
+{
+  Mac48Address gwMac = Mac48Address::Allocate ();
+  Mac48Address broadcast = Mac48Address::GetBroadcast ();
+
+  Ptr<SatGwLlc> llc = CreateObject<SatGwLlc> ();
+  llc->SetNodeInfo (Create<SatNodeInfo> (SatEnums::NT_GW, 0, gwMac));
+
+  Ptr<SatBaseEncapsulator> ctrlEncap = CreateObject<SatGenericStreamEncapsulator> (gwMac, broadcast, SatEnums::CONTROL_FID);
+  Ptr<SatQueue> ctrlQueue = CreateObject<SatQueue> (SatEnums::CONTROL_FID);
+  ctrlEncap->SetQueue (ctrlQueue);
+  llc->AddEncap (gwMac, broadcast, SatEnums::CONTROL_FID, ctrlEncap);
+
+  std::vector<Mac48Address> utMacs;
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      utMacs.push_back (Mac48Address::Allocate ());
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (llc->GetNBytesInQueue (utMacs[0]), 0, "Bytes of UT without encapsulators");
+
+  // encapsulators of all the flows created with the first packets
+  for (uint32_t i = 0; i < utMacs.size (); i++)
+    {
+      llc->Enque (Create<Packet> (1000), utMacs[i], 1);
+      llc->Enque (Create<Packet> (1000), utMacs[i], 2);
+    }
+
+  Ptr<UniformRandomVariable> unif = CreateObject<UniformRandomVariable> ();
+  unif->SetStream (1);
+
+  uint32_t bytesLeft = 0;
+  uint32_t nextMinTxO = 0;
+
+  for (uint32_t i = 0; i < 300; i++)
+    {
+      uint32_t ut = unif->GetInteger (0, utMacs.size () - 1);
+      uint8_t flowId = unif->GetInteger (1, 2);
+
+      if (unif->GetInteger (0, 7) == 0)
+        {
+          llc->Enque (Create<Packet> (100), broadcast, SatEnums::CONTROL_FID);
+        }
+      else
+        {
+          llc->Enque (Create<Packet> (unif->GetInteger (50, 1449)), utMacs[ut], flowId);
+        }
+
+      // data of the flows taken after most of the packets, in fragments of varying size
+      if (i % 4 != 0)
+        {
+          ut = unif->GetInteger (0, utMacs.size () - 1);
+          flowId = unif->GetInteger (1, 2);
+          llc->NotifyTxOpportunity (unif->GetInteger (100, 799), utMacs[ut], flowId, bytesLeft, nextMinTxO);
+        }
+
+      CheckQueueStats (llc, utMacs, ctrlQueue, i);
+    }
+
+  for (uint32_t i = 0; i < utMacs.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_GT (llc->GetNBytesInQueue (utMacs[i]), 0, "No bytes queued to UT " << i);
+
+      uint32_t nBytesOfNextUt = (i + 1 < utMacs.size ()) ? llc->GetNBytesInQueue (utMacs[i + 1]) : 0;
+
+      for (uint8_t flowId = 1; flowId <= 2; flowId++)
+        {
+          do
+            {
+              llc->NotifyTxOpportunity (500, utMacs[i], flowId, bytesLeft, nextMinTxO);
+            }
+          while (bytesLeft > 0);
+        }
+
+      NS_TEST_ASSERT_MSG_EQ (llc->GetNBytesInQueue (utMacs[i]), 0, "Bytes queued to drained UT " << i);
+      NS_TEST_ASSERT_MSG_EQ (llc->GetNPacketsInQueue (utMacs[i]), 0, "Packets queued to drained UT " << i);
+      NS_TEST_ASSERT_MSG_EQ ((i + 1 < utMacs.size ()) ? llc->GetNBytesInQueue (utMacs[i + 1]) : 0, nBytesOfNextUt, "Bytes of UT " << i + 1 << " changed");
+
+      CheckQueueStats (llc, utMacs, ctrlQueue, 300 + i);
+    }
+
+  llc->Dispose ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup satellite
+ * \brief Test suite for the GW LLC.
+ */
+class SatGwLlcTestSuite : public TestSuite
+{
+public:
+  SatGwLlcTestSuite ();
+};
+
+SatGwLlcTestSuite::SatGwLlcTestSuite ()
+  : TestSuite ("sat-gw-llc-test", UNIT)
+{
+  AddTestCase (new SatGwLlcQueueStatsTestCase, TestCase::QUICK);
+}
+
+// Do allocate an instance of this TestSuite
+static SatGwLlcTestSuite satGwLlcTestSuite;
@@ -0,0 +1,285 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file satellite-id-mapper-test.cc
+ * \ingroup satellite
+ * \brief Test cases to unit test the MAC address to ID mapping.
+ */
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/mac48-address.h"
+#include "ns3/mac16-address.h"
+#include "../model/satellite-id-mapper.h"
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup satellite
+ * \brief Test case to unit test the IDs got from the ID mapper.
+ *
+ *  1.  Attach UT, UT user, beam, GW and trace IDs to MAC48 addresses, and a beam ID to a
+ *      MAC16 address.
+ *  2.  Get the IDs of the attached and some unknown addresses.
+ *  3.  Reset the mapper.
+ *
+ *  Expected result:
+ *   The IDs are the attached ones, -1 for the IDs an address has not been attached to.
+ *   No ID is found after the reset.
+ */
+class SatIdMapperTestCase : public TestCase
+{
+public:
+  SatIdMapperTestCase ();
+  virtual ~SatIdMapperTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+SatIdMapperTestCase::SatIdMapperTestCase ()
+  : TestCase ("Test MAC address to ID mapping.")
+{
+}
+
+SatIdMapperTestCase::~SatIdMapperTestCase ()
+{
+}
+
+void
+SatIdMapperTestCase::DoRun (void)
+{
+  Ptr<SatIdMapper> mapper = CreateObject<SatIdMapper> ();
+
+  uint32_t numOfUts = 1000;
+  uint32_t numOfBeams = 72;
+  std::vector<Address> utMacs;
+  std::vector<Address> utUserMacs;
+
+  for (uint32_t i = 0; i < numOfUts; i++)
+    {
+      utMacs.push_back (Mac48Address::Allocate ());
+      utUserMacs.push_back (Mac48Address::Allocate ());
+
+      NS_TEST_ASSERT_MSG_EQ (mapper->AttachMacToTraceId (utMacs[i]), 2 * i + 1, "Unexpected trace ID");
+      NS_TEST_ASSERT_MSG_EQ (mapper->AttachMacToUtId (utMacs[i]), i + 1, "Unexpected UT ID");
+      mapper->AttachMacToBeamId (utMacs[i], i % numOfBeams + 1);
+      NS_TEST_ASSERT_MSG_EQ (mapper->AttachMacToTraceId (utUserMacs[i]), 2 * i + 2, "Unexpected trace ID");
+      NS_TEST_ASSERT_MSG_EQ (mapper->AttachMacToUtUserId (utUserMacs[i]), i + 1, "Unexpected UT user ID");
+    }
+
+  Address gwMac = Mac48Address::Allocate ();
+  mapper->AttachMacToGwId (gwMac, 5);
+  mapper->AttachMacToBeamId (gwMac, 3);
+  NS_TEST_ASSERT_MSG_EQ (mapper->AttachMacToGwUserId (gwMac), 1, "Unexpected GW user ID");
+
+  uint8_t buffer[2] = {0, 1};
+  Mac16Address mac16;
+  mac16.CopyFrom (buffer);
+  mapper->AttachMacToBeamId (mac16, 7);
+
+  for (uint32_t i = 0; i < numOfUts; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (mapper->GetUtIdWithMac (utMacs[i]), int32_t (i + 1), "Wrong UT ID of UT " << i);
+      NS_TEST_ASSERT_MSG_EQ (mapper->GetTraceIdWithMac (utMacs[i]), int32_t (2 * i + 1), "Wrong trace ID of UT " << i);
+      NS_TEST_ASSERT_MSG_EQ (mapper->GetBeamIdWithMac (utMacs[i]), int32_t (i % numOfBeams + 1), "Wrong beam ID of UT " << i);
+      NS_TEST_ASSERT_MSG_EQ (mapper->GetUtUserIdWithMac (utMacs[i]), -1, "UT user ID of UT " << i);
+      NS_TEST_ASSERT_MSG_EQ (mapper->GetGwIdWithMac (utMacs[i]), -1, "GW ID of UT " << i);
+      NS_TEST_ASSERT_MSG_EQ (mapper->GetUtUserIdWithMac (utUserMacs[i]), int32_t (i + 1), "Wrong UT user ID of UT user " << i);
+      NS_TEST_ASSERT_MSG_EQ (mapper->GetUtIdWithMac (utUserMacs[i]), -1, "UT ID of UT user " << i);
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (mapper->GetGwIdWithMac (gwMac), 5, "Wrong GW ID");
+  NS_TEST_ASSERT_MSG_EQ (mapper->GetBeamIdWithMac (gwMac), 3, "Wrong beam ID of GW");
+  NS_TEST_ASSERT_MSG_EQ (mapper->GetGwUserIdWithMac (gwMac), 1, "Wrong GW user ID");
+  NS_TEST_ASSERT_MSG_EQ (mapper->GetTraceIdWithMac (gwMac), -1, "Trace ID of GW");
+  NS_TEST_ASSERT_MSG_EQ (mapper->GetBeamIdWithMac (mac16), 7, "Wrong beam ID of MAC16 address");
+  NS_TEST_ASSERT_MSG_EQ (mapper->GetUtIdWithMac (mac16), -1, "UT ID of MAC16 address");
+  NS_TEST_ASSERT_MSG_EQ (mapper->GetBeamIdWithMac (Mac48Address::Allocate ()), -1, "Beam ID of unknown address");
+  NS_TEST_ASSERT_MSG_EQ (mapper->GetBeamIdWithMac (Address ()), -1, "Beam ID of invalid address");
+
+  std::string info = mapper->GetMacInfo (utMacs[0]);
+  NS_TEST_ASSERT_MSG_NE (info.find ("trace ID: 1 beam ID: 1 UT ID: 1"), std::string::npos, "Wrong MAC info " << info);
+
+  mapper->Reset ();
+
+  NS_TEST_ASSERT_MSG_EQ (mapper->GetUtIdWithMac (utMacs[0]), -1, "UT ID after reset");
+  NS_TEST_ASSERT_MSG_EQ (mapper->GetBeamIdWithMac (mac16), -1, "Beam ID of MAC16 address after reset");
+  NS_TEST_ASSERT_MSG_EQ (mapper->AttachMacToUtId (utMacs[1]), 1, "UT ID not restarted after reset");
+  NS_TEST_ASSERT_MSG_EQ (mapper->GetUtIdWithMac (utMacs[1]), 1, "Wrong UT ID after reset");
+
+  mapper->Dispose ();
+}
+
+/**
+ * \brief Create a MAC48 address from its 48 bits
+ * \param bits bits of the address, the first byte in the most significant bits
+ * \return the address
+ */
+static Mac48Address
+CreateMac48Address (uint64_t bits)
+{
+  uint8_t buffer[6];
+
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      buffer[i] = (bits >> (8 * (5 - i))) & 0xff;
+    }
+
+  Mac48Address mac;
+  mac.CopyFrom (buffer);
+  return mac;
+}
+
+/**
+ * \brief Get the slot of a MAC48 address in a hash table of 64 slots of the ID mapper
+ * \param bits bits of the address
+ * \return the slot
+ */
+static uint32_t
+GetMac48Slot (uint64_t bits)
+{
+  uint64_t hash = (bits + 1) * 0x9E3779B97F4A7C15ULL;
+  return (hash ^ (hash >> 32)) & 63;
+}
+
+/**
+ * \ingroup satellite
+ * \brief Test case to unit test the hash table of the MAC48 addresses of the ID mapper.
+ *
+ *  1.  Attach UT IDs to addresses in the same slot of the hash table, and to the all
+ *      zeros and all ones addresses.
+ *  2.  Get the UT IDs of those and of absent addresses in the same slot.
+ *  3.  Attach enough addresses to grow the table, and get the UT IDs again.
+ *  4.  Reset the mapper, which removes all the addresses, and attach some of them again.
+ *
+ *  Expected result:
+ *   The colliding and the extreme addresses have the attached IDs, before and after the
+ *   table grows, and the absent addresses have none. After the reset only the attached
+ *   again addresses have IDs.
+ */
+class SatIdMapperMac48TableTestCase : public TestCase
+{
+public:
+  SatIdMapperMac48TableTestCase ();
+  virtual ~SatIdMapperMac48TableTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+SatIdMapperMac48TableTestCase::SatIdMapperMac48TableTestCase ()
+  : TestCase ("Test colliding, absent and removed MAC48 addresses of the ID mapper.")
+{
+}
+
+SatIdMapperMac48TableTestCase::~SatIdMapperMac48TableTestCase ()
+{
+}
+
+void
+SatIdMapperMac48TableTestCase::DoRun (void)
+{
+  Ptr<SatIdMapper> mapper = CreateObject<SatIdMapper> ();
+
+  // addresses in the same slot of the table, the first ones attached, the others absent
+  uint32_t numOfAttached = 8;
+  std::vector<Address> colliding;
+  uint32_t slot = GetMac48Slot (0x000102030405ULL);
+
+  for (uint64_t bits = 0x000102030405ULL; colliding.size () < 2 * numOfAttached; bits += 0x010000000001ULL)
+    {
+      if (GetMac48Slot (bits) == slot)
+        {
+          colliding.push_back (CreateMac48Address (bits));
+        }
+    }
+
+  Address zeros = CreateMac48Address (0);
+  Address ones = CreateMac48Address (0xffffffffffffULL);
+
+  for (uint32_t i = 0; i < numOfAttached; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (mapper->AttachMacToUtId (colliding[i]), i + 1, "Unexpected UT ID of colliding address " << i);
+    }
+  NS_TEST_ASSERT_MSG_EQ (mapper->AttachMacToUtId (zeros), numOfAttached + 1, "Unexpected UT ID of all zeros address");
+  NS_TEST_ASSERT_MSG_EQ (mapper->AttachMacToUtId (ones), numOfAttached + 2, "Unexpected UT ID of all ones address");
+
+  // attaching again keeps the address in its slot
+  mapper->AttachMacToBeamId (colliding[numOfAttached - 1], 4);
+
+  for (uint32_t step = 0; step < 2; step++)
+    {
+      for (uint32_t i = 0; i < numOfAttached; i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (mapper->GetUtIdWithMac (colliding[i]), int32_t (i + 1), "Wrong UT ID of colliding address " << i << " at step " << step);
+          NS_TEST_ASSERT_MSG_EQ (mapper->GetUtIdWithMac (colliding[numOfAttached + i]), -1, "UT ID of absent address " << i << " at step " << step);
+        }
+      NS_TEST_ASSERT_MSG_EQ (mapper->GetBeamIdWithMac (colliding[numOfAttached - 1]), 4, "Wrong beam ID at step " << step);
+      NS_TEST_ASSERT_MSG_EQ (mapper->GetBeamIdWithMac (colliding[0]), -1, "Beam ID of colliding address at step " << step);
+      NS_TEST_ASSERT_MSG_EQ (mapper->GetUtIdWithMac (zeros), int32_t (numOfAttached + 1), "Wrong UT ID of all zeros address at step " << step);
+      NS_TEST_ASSERT_MSG_EQ (mapper->GetUtIdWithMac (ones), int32_t (numOfAttached + 2), "Wrong UT ID of all ones address at step " << step);
+
+      // grow the table to many times its first size
+      if (step == 0)
+        {
+          for (uint32_t i = 0; i < 1000; i++)
+            {
+              mapper->AttachMacToTraceId (CreateMac48Address (0x020000000000ULL + i));
+            }
+        }
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (mapper->GetTraceIdWithMac (CreateMac48Address (0x020000000000ULL + 999)), 1000, "Wrong trace ID after growing");
+
+  mapper->Reset ();
+
+  for (uint32_t i = 0; i < numOfAttached; i += 2)
+    {
+      NS_TEST_ASSERT_MSG_EQ (mapper->AttachMacToUtId (colliding[i]), i / 2 + 1, "Unexpected UT ID of colliding address " << i << " after reset");
+    }
+
+  for (uint32_t i = 0; i < numOfAttached; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (mapper->GetUtIdWithMac (colliding[i]), ((i % 2 == 0) ? int32_t (i / 2 + 1) : -1), "Wrong UT ID of colliding address " << i << " after reset");
+    }
+  NS_TEST_ASSERT_MSG_EQ (mapper->GetUtIdWithMac (zeros), -1, "UT ID of all zeros address after reset");
+  NS_TEST_ASSERT_MSG_EQ (mapper->GetTraceIdWithMac (CreateMac48Address (0x020000000000ULL)), -1, "Trace ID after reset");
+
+  mapper->Dispose ();
+}
+
+/**
+ * \ingroup satellite
+ * \brief Test suite for the ID mapper.
+ */
+class SatIdMapperTestSuite : public TestSuite
+{
+public:
+  SatIdMapperTestSuite ();
+};
+
+SatIdMapperTestSuite::SatIdMapperTestSuite ()
+  : TestSuite ("sat-id-mapper-test", UNIT)
+{
+  AddTestCase (new SatIdMapperTestCase, TestCase::QUICK);
+  AddTestCase (new SatIdMapperMac48TableTestCase, TestCase::QUICK);
+}
+
+// Do allocate an instance of this TestSuite
+static SatIdMapperTestSuite satIdMapperTestSuite;
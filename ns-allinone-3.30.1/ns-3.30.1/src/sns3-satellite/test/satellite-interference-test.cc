@@ -38,6 +38,8 @@
 #include "../model/satellite-per-packet-interference.h"
 #include "ns3/singleton.h"
 #include "../utils/satellite-env-variables.h"
+#include <algorithm>
+#include <vector>
 
 using namespace ns3;
 
@@ -239,6 +241,126 @@ SatPerPacketInterferenceTestCase::DoRun (void)
   Singleton<SatEnvVariables>::Get ()->DoDispose ();
 }
 
+/**
+ * \ingroup satellite
+ * \brief Test case to unit test satellite per packet interference model on a busy receiver.
+ *
+ * This case tests that SatPerPacketInterference calculates interference correctly, when
+ * receivings overlap so that the receiver is never idle:
+ *  1.  Create SatPerPacketInterference object.
+ *  2.  Start overlapping receivings one after another and add interference between them.
+ *  3.  Calculate interference of each receiving at its end.
+ *
+ *  Expected result:
+ *   Calculated interference of each receiving is the time weighted sum of the power of
+ *   all the other transmissions during the receiving.
+ *
+ */
+class SatPerPacketInterferenceBusyTestCase : public TestCase
+{
+public:
+  SatPerPacketInterferenceBusyTestCase ();
+  virtual ~SatPerPacketInterferenceBusyTestCase ();
+
+  // adds interference or receivers own interference to model object and schedules receiving
+  void Add (Time duration, double power, bool receive);
+
+  // receives packets i.e. calculates interference and stops receiving.
+  void Receive (uint32_t rxIndex);
+
+private:
+  virtual void DoRun (void);
+
+  // time weighted power of the other transmissions during receiving
+  double GetExpectedPower (uint32_t rxIndex) const;
+
+  Ptr<SatPerPacketInterference> m_interference;
+  std::vector<Ptr<SatInterference::InterferenceChangeEvent> > m_events;
+  std::vector<uint32_t> m_rxEvents;
+  std::vector<double> m_finalPower;
+};
+
+SatPerPacketInterferenceBusyTestCase::SatPerPacketInterferenceBusyTestCase ()
+  : TestCase ("Test satellite per packet interference model with overlapping receivings.")
+{
+  m_interference = CreateObject<SatPerPacketInterference> ();
+}
+
+SatPerPacketInterferenceBusyTestCase::~SatPerPacketInterferenceBusyTestCase ()
+{
+}
+
+void
+SatPerPacketInterferenceBusyTestCase::Add (Time duration, double power, bool receive)
+{
+  m_events.push_back (m_interference->Add (duration, power, Mac48Address::ConvertFrom (Mac48Address::Allocate ())));
+
+  if (receive)
+    {
+      m_interference->NotifyRxStart (m_events.back ());
+      Simulator::Schedule (duration, &SatPerPacketInterferenceBusyTestCase::Receive, this, m_rxEvents.size ());
+      m_rxEvents.push_back (m_events.size () - 1);
+      m_finalPower.push_back (0);
+    }
+}
+
+void
+SatPerPacketInterferenceBusyTestCase::Receive (uint32_t rxIndex)
+{
+  Ptr<SatInterference::InterferenceChangeEvent> event = m_events[m_rxEvents[rxIndex]];
+  m_finalPower[rxIndex] = m_interference->Calculate (event);
+  m_interference->NotifyRxEnd (event);
+}
+
+double
+SatPerPacketInterferenceBusyTestCase::GetExpectedPower (uint32_t rxIndex) const
+{
+  Ptr<SatInterference::InterferenceChangeEvent> rxEvent = m_events[m_rxEvents[rxIndex]];
+  double power = 0;
+
+  for (uint32_t i = 0; i < m_events.size (); i++)
+    {
+      Time start = std::max (m_events[i]->GetStartTime (), rxEvent->GetStartTime ());
+      Time end = std::min (m_events[i]->GetEndTime (), rxEvent->GetEndTime ());
+
+      if (i != m_rxEvents[rxIndex] && start < end)
+        {
+          power += m_events[i]->GetRxPower () * (end - start).GetDouble () / rxEvent->GetDuration ().GetDouble ();
+        }
+    }
+
+  return power;
+}
+
+void
+SatPerPacketInterferenceBusyTestCase::DoRun (void)
+{
+  // receivings of 100 time units every 60 time units, so that two receivings always overlap,
+  // and interference of 30 time units every 20 time units
+  for (uint32_t i = 0; i < 200; i++)
+    {
+      Simulator::Schedule (Time (60 * i), &SatPerPacketInterferenceBusyTestCase::Add, this, Time (100), 10 + i % 7, true);
+    }
+
+  for (uint32_t i = 0; i < 600; i++)
+    {
+      Simulator::Schedule (Time (20 * i + 5), &SatPerPacketInterferenceBusyTestCase::Add, this, Time (30), 1 + i % 5, false);
+    }
+
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_finalPower.size (), 200, "Receivings not done");
+
+  for (uint32_t i = 0; i < m_finalPower.size (); i++)
+    {
+      double expected = GetExpectedPower (i);
+      NS_TEST_ASSERT_MSG_EQ_TOL (m_finalPower[i], expected, expected * 1e-12, "Final power of receiving " << i << " incorrect");
+    }
+
+  m_events.clear ();
+  Simulator::Destroy ();
+}
+
 /**
  * \ingroup satellite
  * \brief Test suite for Satellite interference unit test cases.
@@ -254,6 +376,7 @@ SatInterferenceTestSuite::SatInterferenceTestSuite ()
 {
   AddTestCase (new SatConstantInterferenceTestCase, TestCase::QUICK);
   AddTestCase (new SatPerPacketInterferenceTestCase, TestCase::QUICK);
+  AddTestCase (new SatPerPacketInterferenceBusyTestCase, TestCase::QUICK);
 }
 
 // Do allocate an instance of this TestSuite
@@ -0,0 +1,317 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file satellite-output-fstream-test.cc
+ * \ingroup satellite
+ * \brief Test cases to unit test the output file stream container for double values
+ */
+
+#include <vector>
+#include <sstream>
+#include <sys/resource.h>
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/enum.h"
+#include "ns3/uinteger.h"
+#include "../utils/satellite-output-fstream-double-container.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup satellite
+ * \brief Test case to unit test that the rows added to the output file stream
+ * container, both as vectors and as arrays, are written into the file while
+ * they are added, and read back from the file as they were added. The number
+ * of buffered rows is changed after the first row is added.
+ *
+ *  Expected result:
+ *    Only the rows of full buffers of the first number of buffered rows are in
+ *    the file before the container is written, and all the rows are in the
+ *    file after it. Values are equal to the added ones, exactly in the binary
+ *    format.
+ *
+ */
+class SatOutputFileStreamDoubleContainerTestCase : public TestCase
+{
+public:
+  SatOutputFileStreamDoubleContainerTestCase (SatOutputFileStreamDoubleContainer::OutputFormat_t format, std::string name);
+  virtual ~SatOutputFileStreamDoubleContainerTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  SatOutputFileStreamDoubleContainer::OutputFormat_t m_format;
+};
+
+SatOutputFileStreamDoubleContainerTestCase::SatOutputFileStreamDoubleContainerTestCase (SatOutputFileStreamDoubleContainer::OutputFormat_t format, std::string name)
+  : TestCase ("Test output file stream container with " + name + " format."),
+    m_format (format)
+{
+}
+
+SatOutputFileStreamDoubleContainerTestCase::~SatOutputFileStreamDoubleContainerTestCase ()
+{
+}
+
+void
+SatOutputFileStreamDoubleContainerTestCase::DoRun (void)
+{
+  uint32_t valuesInRow = 3;
+  uint32_t bufferedRows = 4;
+  uint32_t numOfRows = 10;
+  std::string fileName = CreateTempDirFilename ("output_fstream_double_container");
+
+  Ptr<SatOutputFileStreamDoubleContainer> container = CreateObject<SatOutputFileStreamDoubleContainer> (fileName, std::ios::out, valuesInRow);
+  container->SetAttribute ("BufferedRows", UintegerValue (bufferedRows));
+  container->SetAttribute ("OutputFormat", EnumValue (m_format));
+
+  std::vector<std::vector<double> > added;
+
+  for (uint32_t i = 0; i < numOfRows; i++)
+    {
+      std::vector<double> row;
+      row.push_back (i * 0.5);
+      row.push_back (i * 0.25 - 1.0);
+      row.push_back (m_format == SatOutputFileStreamDoubleContainer::BINARY ? 1.0 / (i + 3.0) : i * 1000.0);
+      if (i % 2 == 0)
+        {
+          container->AddToContainer (row);
+        }
+      else
+        {
+          container->AddToContainer (&row[0], valuesInRow);
+        }
+      added.push_back (row);
+
+      if (i == 0)
+        {
+          container->SetAttribute ("BufferedRows", UintegerValue (bufferedRows * 16));
+        }
+
+      if (i == 6)
+        {
+          std::vector<std::vector<double> > written = SatOutputFileStreamDoubleContainer::ReadFile (fileName, valuesInRow);
+          NS_TEST_ASSERT_MSG_EQ (written.size (), bufferedRows, "Full buffer not written");
+        }
+    }
+
+  container->WriteContainerToFile ();
+
+  std::vector<std::vector<double> > written = SatOutputFileStreamDoubleContainer::ReadFile (fileName, valuesInRow);
+  NS_TEST_ASSERT_MSG_EQ (written.size (), numOfRows, "Rows missing from the file");
+
+  for (uint32_t i = 0; i < numOfRows; i++)
+    {
+      for (uint32_t j = 0; j < valuesInRow; j++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (written[i][j], added[i][j], "Value " << j << " of row " << i << " differs");
+        }
+    }
+
+  container->Dispose ();
+}
+
+/**
+ * \ingroup satellite
+ * \brief Test case to unit test that the number of output file stream containers
+ * is not limited by the number of files a process may have open.
+ *
+ *  1.  Lower the limit of open files of the process.
+ *  2.  Add rows to twice as many containers as files may be open, in turns, so that
+ *      every container writes full buffers before any container is written.
+ *  3.  Write the containers and restore the limit.
+ *
+ *  Expected result:
+ *    All the rows of every container are in its file, in the order they were added.
+ *
+ */
+class SatOutputFileStreamManyContainersTestCase : public TestCase
+{
+public:
+  SatOutputFileStreamManyContainersTestCase (SatOutputFileStreamDoubleContainer::OutputFormat_t format, std::string name);
+  virtual ~SatOutputFileStreamManyContainersTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  SatOutputFileStreamDoubleContainer::OutputFormat_t m_format;
+};
+
+SatOutputFileStreamManyContainersTestCase::SatOutputFileStreamManyContainersTestCase (SatOutputFileStreamDoubleContainer::OutputFormat_t format, std::string name)
+  : TestCase ("Test more output file stream containers than open files with " + name + " format."),
+    m_format (format)
+{
+}
+
+SatOutputFileStreamManyContainersTestCase::~SatOutputFileStreamManyContainersTestCase ()
+{
+}
+
+void
+SatOutputFileStreamManyContainersTestCase::DoRun (void)
+{
+  uint32_t valuesInRow = 2;
+  uint32_t bufferedRows = 2;
+  uint32_t numOfRows = 5;
+
+  struct rlimit limit;
+  NS_TEST_ASSERT_MSG_EQ (getrlimit (RLIMIT_NOFILE, &limit), 0, "Limit of open files not available");
+
+  struct rlimit lowered = limit;
+  if (lowered.rlim_cur == RLIM_INFINITY || lowered.rlim_cur > 128)
+    {
+      lowered.rlim_cur = 128;
+    }
+  NS_TEST_ASSERT_MSG_EQ (setrlimit (RLIMIT_NOFILE, &lowered), 0, "Limit of open files not lowered");
+
+  uint32_t numOfContainers = 2 * lowered.rlim_cur;
+  std::vector<Ptr<SatOutputFileStreamDoubleContainer> > containers;
+  std::vector<std::string> fileNames;
+
+  for (uint32_t k = 0; k < numOfContainers; k++)
+    {
+      std::stringstream fileName;
+      fileName << CreateTempDirFilename ("output_fstream_double_container_") << k;
+      fileNames.push_back (fileName.str ());
+
+      containers.push_back (CreateObject<SatOutputFileStreamDoubleContainer> (fileNames.back (), std::ios::out, valuesInRow));
+      containers.back ()->SetAttribute ("BufferedRows", UintegerValue (bufferedRows));
+      containers.back ()->SetAttribute ("OutputFormat", EnumValue (m_format));
+    }
+
+  for (uint32_t i = 0; i < numOfRows; i++)
+    {
+      for (uint32_t k = 0; k < numOfContainers; k++)
+        {
+          std::vector<double> row;
+          row.push_back (i);
+          row.push_back (k);
+          containers[k]->AddToContainer (row);
+        }
+    }
+
+  for (uint32_t k = 0; k < numOfContainers; k++)
+    {
+      containers[k]->WriteContainerToFile ();
+      containers[k]->Dispose ();
+    }
+
+  setrlimit (RLIMIT_NOFILE, &limit);
+
+  for (uint32_t k = 0; k < numOfContainers; k++)
+    {
+      std::vector<std::vector<double> > written = SatOutputFileStreamDoubleContainer::ReadFile (fileNames[k], valuesInRow);
+      NS_TEST_ASSERT_MSG_EQ (written.size (), numOfRows, "Rows missing from the file of container " << k);
+
+      for (uint32_t i = 0; i < written.size (); i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (written[i][0], i, "Row " << i << " of container " << k << " out of order");
+          NS_TEST_ASSERT_MSG_EQ (written[i][1], k, "Row " << i << " of container " << k << " differs");
+        }
+    }
+}
+
+/**
+ * \ingroup satellite
+ * \brief Test case to unit test that rows appended into an existing file in the
+ * binary format are read back after the rows already in it.
+ *
+ *  1.  Write rows into a file with a container of file mode out.
+ *  2.  Write more rows into the same file with a container of file mode out | app.
+ *
+ *  Expected result:
+ *    The file has a single header and the rows of both containers in the order
+ *    they were written.
+ *
+ */
+class SatOutputFileStreamAppendTestCase : public TestCase
+{
+public:
+  SatOutputFileStreamAppendTestCase ();
+  virtual ~SatOutputFileStreamAppendTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+SatOutputFileStreamAppendTestCase::SatOutputFileStreamAppendTestCase ()
+  : TestCase ("Test appending into an existing file with binary format.")
+{
+}
+
+SatOutputFileStreamAppendTestCase::~SatOutputFileStreamAppendTestCase ()
+{
+}
+
+void
+SatOutputFileStreamAppendTestCase::DoRun (void)
+{
+  uint32_t valuesInRow = 2;
+  uint32_t numOfRows = 3;
+  std::string fileName = CreateTempDirFilename ("output_fstream_double_container_append");
+  std::ios::openmode fileModes[2] = {std::ios::out, std::ios::out | std::ios::app};
+
+  for (uint32_t k = 0; k < 2; k++)
+    {
+      Ptr<SatOutputFileStreamDoubleContainer> container = CreateObject<SatOutputFileStreamDoubleContainer> (fileName, fileModes[k], valuesInRow);
+      container->SetAttribute ("BufferedRows", UintegerValue (2));
+      container->SetAttribute ("OutputFormat", EnumValue (SatOutputFileStreamDoubleContainer::BINARY));
+
+      for (uint32_t i = 0; i < numOfRows; i++)
+        {
+          std::vector<double> row;
+          row.push_back (k);
+          row.push_back (i);
+          container->AddToContainer (row);
+        }
+
+      container->WriteContainerToFile ();
+      container->Dispose ();
+    }
+
+  std::vector<std::vector<double> > written = SatOutputFileStreamDoubleContainer::ReadFile (fileName, valuesInRow);
+  NS_TEST_ASSERT_MSG_EQ (written.size (), 2 * numOfRows, "Rows missing from the file");
+
+  for (uint32_t i = 0; i < written.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (written[i][0], i / numOfRows, "Row " << i << " of the wrong container");
+      NS_TEST_ASSERT_MSG_EQ (written[i][1], i % numOfRows, "Row " << i << " out of order");
+    }
+}
+
+/**
+ * \ingroup satellite
+ * \brief Test suite for the output file stream containers.
+ */
+class SatOutputFileStreamTestSuite : public TestSuite
+{
+public:
+  SatOutputFileStreamTestSuite ();
+};
+
+SatOutputFileStreamTestSuite::SatOutputFileStreamTestSuite ()
+  : TestSuite ("sat-output-fstream-test", UNIT)
+{
+  AddTestCase (new SatOutputFileStreamDoubleContainerTestCase (SatOutputFileStreamDoubleContainer::TEXT, "text"), TestCase::QUICK);
+  AddTestCase (new SatOutputFileStreamDoubleContainerTestCase (SatOutputFileStreamDoubleContainer::BINARY, "binary"), TestCase::QUICK);
+  AddTestCase (new SatOutputFileStreamManyContainersTestCase (SatOutputFileStreamDoubleContainer::TEXT, "text"), TestCase::QUICK);
+  AddTestCase (new SatOutputFileStreamManyContainersTestCase (SatOutputFileStreamDoubleContainer::BINARY, "binary"), TestCase::QUICK);
+  AddTestCase (new SatOutputFileStreamAppendTestCase, TestCase::QUICK);
+}
+
+// Do allocate an instance of this TestSuite
+static SatOutputFileStreamTestSuite satOutputFstreamTestSuite;
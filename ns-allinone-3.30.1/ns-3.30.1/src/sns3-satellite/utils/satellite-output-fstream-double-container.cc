@@ -22,26 +22,51 @@
 #include "ns3/log.h"
 #include "ns3/abort.h"
 #include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/enum.h"
+#include <cstring>
 
 NS_LOG_COMPONENT_DEFINE ("SatOutputFileStreamDoubleContainer");
 
 namespace ns3 {
 
+/// Magic at the start of the files in the binary format
+static const char SAT_TRACE_MAGIC[8] = {'S', 'A', 'T', 'T', 'R', 'A', 'C', 'E'};
+
+/// Version of the binary format
+static const uint32_t SAT_TRACE_VERSION = 1;
+
 TypeId
 SatOutputFileStreamDoubleContainer::GetTypeId (void)
 {
   static TypeId tid = TypeId ("ns3::SatOutputFileStreamDoubleContainer")
     .SetParent<Object> ()
-    .AddConstructor<SatOutputFileStreamDoubleContainer> ();
+    .AddConstructor<SatOutputFileStreamDoubleContainer> ()
+    .AddAttribute ("BufferedRows",
+                   "Number of rows buffered before they are written into the file.",
+                   UintegerValue (1024),
+                   MakeUintegerAccessor (&SatOutputFileStreamDoubleContainer::m_bufferedRows),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("OutputFormat",
+                   "Format of the file.",
+                   EnumValue (SatOutputFileStreamDoubleContainer::TEXT),
+                   MakeEnumAccessor (&SatOutputFileStreamDoubleContainer::m_outputFormat),
+                   MakeEnumChecker (SatOutputFileStreamDoubleContainer::TEXT, "Text",
+                                    SatOutputFileStreamDoubleContainer::BINARY, "Binary"));
   return tid;
 }
 
 SatOutputFileStreamDoubleContainer::SatOutputFileStreamDoubleContainer (std::string filename, std::ios::openmode filemode, uint32_t valuesInRow)
   : m_outputFileStreamWrapper (),
     m_outputFileStream (),
-    m_container (),
+    m_buffer (),
+    m_rowsInBuffer (0),
+    m_bufferedRows (1024),
+    m_bufferCapacity (0),
+    m_outputFormat (TEXT),
     m_fileName (filename),
     m_fileMode (filemode),
+    m_fileOpened (false),
     m_valuesInRow (valuesInRow),
     m_printFigure (false),
     m_figureUnitConversionType (RAW),
@@ -58,9 +83,14 @@ SatOutputFileStreamDoubleContainer::SatOutputFileStreamDoubleContainer (std::str
 SatOutputFileStreamDoubleContainer::SatOutputFileStreamDoubleContainer ()
   : m_outputFileStreamWrapper (),
     m_outputFileStream (),
-    m_container (),
+    m_buffer (),
+    m_rowsInBuffer (0),
+    m_bufferedRows (1024),
+    m_bufferCapacity (0),
+    m_outputFormat (TEXT),
     m_fileName (),
     m_fileMode (),
+    m_fileOpened (false),
     m_valuesInRow (),
     m_printFigure (),
     m_figureUnitConversionType (),
@@ -91,26 +121,15 @@ SatOutputFileStreamDoubleContainer::WriteContainerToFile ()
 {
   NS_LOG_FUNCTION (this);
 
-  OpenStream ();
+  if (m_outputFileStream == NULL)
+    {
+      OpenStream ();
+    }
 
   if (m_outputFileStream->is_open ())
     {
-      for (uint32_t i = 0; i < m_container.size (); i++)
-        {
-          for (uint32_t j = 0; j < m_valuesInRow; j++ )
-            {
-              if (j + 1 == m_valuesInRow)
-                {
-                  *m_outputFileStream << m_container[i].at (j);
-                }
-              else
-                {
-                  *m_outputFileStream << m_container[i].at (j) << "\t";
-                }
-            }
-          *m_outputFileStream << std::endl;
-        }
-      m_outputFileStream->close ();
+      FlushBuffer ();
+      CloseStream ();
     }
   else
     {
@@ -150,7 +169,7 @@ SatOutputFileStreamDoubleContainer::PrintFigure ()
 }
 
 void
-SatOutputFileStreamDoubleContainer::AddToContainer (std::vector<double> newItem)
+SatOutputFileStreamDoubleContainer::AddToContainer (const std::vector<double> &newItem)
 {
   NS_LOG_FUNCTION (this);
 
@@ -159,29 +178,72 @@ SatOutputFileStreamDoubleContainer::AddToContainer (std::vector<double> newItem)
       NS_FATAL_ERROR ("SatOutputFileStreamDoubleContainer::AddToContainer - Invalid vector size");
     }
 
-  m_container.push_back (newItem);
+  AddToContainer (&newItem[0], m_valuesInRow);
 }
 
 void
-SatOutputFileStreamDoubleContainer::OpenStream ()
+SatOutputFileStreamDoubleContainer::AddToContainer (const double *newItem, uint32_t valuesInRow)
 {
   NS_LOG_FUNCTION (this);
 
-  m_outputFileStreamWrapper = new SatOutputFileStreamWrapper (m_fileName,m_fileMode);
-  m_outputFileStream = m_outputFileStreamWrapper->GetStream ();
+  if (valuesInRow != m_valuesInRow)
+    {
+      NS_FATAL_ERROR ("SatOutputFileStreamDoubleContainer::AddToContainer - Invalid number of values");
+    }
+
+  if (m_buffer.empty ())
+    {
+      m_bufferCapacity = m_bufferedRows;
+      m_buffer.resize (m_valuesInRow * m_bufferCapacity);
+    }
+
+  for (uint32_t j = 0; j < m_valuesInRow; j++)
+    {
+      m_buffer[j * m_bufferCapacity + m_rowsInBuffer] = newItem[j];
+    }
+
+  if (++m_rowsInBuffer == m_bufferCapacity)
+    {
+      FlushBuffer ();
+    }
 }
 
 void
-SatOutputFileStreamDoubleContainer::Reset ()
+SatOutputFileStreamDoubleContainer::OpenStream ()
 {
   NS_LOG_FUNCTION (this);
 
-  ResetStream ();
-  ClearContainer ();
+  /// the stream is closed between the writes, so that the number of containers is not limited
+  /// by the number of open files, and the file mode only applies to the first opening
+  std::ios::openmode fileMode = m_fileOpened ? std::ios::out | std::ios::app : m_fileMode;
+
+  if (m_outputFormat == BINARY)
+    {
+      fileMode |= std::ios::binary;
+    }
+
+  m_outputFileStreamWrapper = new SatOutputFileStreamWrapper (m_fileName, fileMode);
+  m_outputFileStream = m_outputFileStreamWrapper->GetStream ();
+
+  if (m_outputFormat == BINARY && !m_fileOpened)
+    {
+      // the position of a stream opened for appending stays at 0 until it is
+      // written, so the header is only left out if the file has content at its end
+      m_outputFileStream->seekp (0, std::ios::end);
+
+      if (m_outputFileStream->tellp () == 0)
+        {
+          uint32_t header[2] = {SAT_TRACE_VERSION, m_valuesInRow};
+          m_outputFileStream->write (SAT_TRACE_MAGIC, sizeof (SAT_TRACE_MAGIC));
+          m_outputFileStream->write (reinterpret_cast<const char *> (header), sizeof (header));
+        }
+    }
+
+  m_fileOpened = true;
 }
 
 void
-SatOutputFileStreamDoubleContainer::ResetStream ()
+SatOutputFileStreamDoubleContainer::CloseStream ()
 {
   NS_LOG_FUNCTION (this);
 
@@ -191,28 +253,168 @@ SatOutputFileStreamDoubleContainer::ResetStream ()
       m_outputFileStreamWrapper = 0;
     }
   m_outputFileStream = 0;
-
-  m_fileName = "";
-  m_fileMode = std::ofstream::out;
 }
 
 void
-SatOutputFileStreamDoubleContainer::ClearContainer ()
+SatOutputFileStreamDoubleContainer::FlushBuffer ()
 {
-  NS_LOG_FUNCTION (this);
+  NS_LOG_FUNCTION (this << m_rowsInBuffer);
+
+  if (m_rowsInBuffer == 0)
+    {
+      return;
+    }
+
+  if (m_outputFileStream == NULL)
+    {
+      OpenStream ();
+    }
+
+  if (m_outputFormat == BINARY)
+    {
+      uint32_t blockHeader[2] = {m_rowsInBuffer, 0};
+      m_outputFileStream->write (reinterpret_cast<const char *> (blockHeader), sizeof (blockHeader));
+
+      for (uint32_t j = 0; j < m_valuesInRow; j++)
+        {
+          m_outputFileStream->write (reinterpret_cast<const char *> (&m_buffer[j * m_bufferCapacity]), m_rowsInBuffer * sizeof (double));
+        }
+    }
+  else
+    {
+      for (uint32_t i = 0; i < m_rowsInBuffer; i++)
+        {
+          for (uint32_t j = 0; j < m_valuesInRow; j++ )
+            {
+              if (j + 1 == m_valuesInRow)
+                {
+                  *m_outputFileStream << m_buffer[j * m_bufferCapacity + i] << "\n";
+                }
+              else
+                {
+                  *m_outputFileStream << m_buffer[j * m_bufferCapacity + i] << "\t";
+                }
+            }
+        }
+    }
+
+  m_outputFileStream->flush ();
+
+  if (!m_outputFileStream->good ())
+    {
+      NS_ABORT_MSG ("SatOutputFileStreamDoubleContainer::FlushBuffer - Unable to write " << m_fileName);
+    }
+
+  CloseStream ();
+  m_rowsInBuffer = 0;
+}
+
+std::vector<std::vector<double> >
+SatOutputFileStreamDoubleContainer::ReadFile (std::string fileName, uint32_t valuesInRow)
+{
+  NS_LOG_FUNCTION (fileName << valuesInRow);
+
+  std::vector<std::vector<double> > rows;
+  std::ifstream file (fileName.c_str (), std::ios::in | std::ios::binary);
+
+  if (!file.is_open ())
+    {
+      NS_FATAL_ERROR ("SatOutputFileStreamDoubleContainer::ReadFile - Unable to open " << fileName);
+    }
+
+  char magic[sizeof (SAT_TRACE_MAGIC)];
+  file.read (magic, sizeof (magic));
 
-  if (!m_container.empty ())
+  if (file.gcount () == sizeof (magic) && std::memcmp (magic, SAT_TRACE_MAGIC, sizeof (magic)) == 0)
     {
-      for (uint32_t i = 0; i < m_container.size (); i++)
+      uint32_t header[2];
+      file.read (reinterpret_cast<char *> (header), sizeof (header));
+
+      if (!file || header[0] != SAT_TRACE_VERSION || header[1] != valuesInRow)
+        {
+          NS_FATAL_ERROR ("SatOutputFileStreamDoubleContainer::ReadFile - Invalid header in " << fileName);
+        }
+
+      uint32_t blockHeader[2];
+      std::vector<double> block;
+
+      while (file.read (reinterpret_cast<char *> (blockHeader), sizeof (blockHeader)))
         {
-          if (!m_container[i].empty ())
+          uint32_t blockRows = blockHeader[0];
+          block.resize (blockRows * valuesInRow);
+
+          if (blockRows > 0 && !file.read (reinterpret_cast<char *> (&block[0]), block.size () * sizeof (double)))
+            {
+              NS_FATAL_ERROR ("SatOutputFileStreamDoubleContainer::ReadFile - Truncated block in " << fileName);
+            }
+
+          for (uint32_t i = 0; i < blockRows; i++)
             {
-              m_container[i].clear ();
+              rows.push_back (std::vector<double> (valuesInRow));
+
+              for (uint32_t j = 0; j < valuesInRow; j++)
+                {
+                  rows.back ()[j] = block[j * blockRows + i];
+                }
             }
         }
-      m_container.clear ();
+
+      if (file.gcount () != 0)
+        {
+          NS_FATAL_ERROR ("SatOutputFileStreamDoubleContainer::ReadFile - Truncated block in " << fileName);
+        }
     }
+  else
+    {
+      file.clear ();
+      file.seekg (0);
+
+      std::vector<double> row (valuesInRow);
 
+      while (file >> row[0])
+        {
+          for (uint32_t j = 1; j < valuesInRow; j++)
+            {
+              if (!(file >> row[j]))
+                {
+                  NS_FATAL_ERROR ("SatOutputFileStreamDoubleContainer::ReadFile - Incomplete row in " << fileName);
+                }
+            }
+          rows.push_back (row);
+        }
+    }
+
+  return rows;
+}
+
+void
+SatOutputFileStreamDoubleContainer::Reset ()
+{
+  NS_LOG_FUNCTION (this);
+
+  ResetStream ();
+  ClearContainer ();
+}
+
+void
+SatOutputFileStreamDoubleContainer::ResetStream ()
+{
+  NS_LOG_FUNCTION (this);
+
+  CloseStream ();
+
+  m_fileName = "";
+  m_fileMode = std::ofstream::out;
+}
+
+void
+SatOutputFileStreamDoubleContainer::ClearContainer ()
+{
+  NS_LOG_FUNCTION (this);
+
+  std::vector<double> ().swap (m_buffer);
+  m_bufferCapacity = 0;
+  m_rowsInBuffer = 0;
   m_valuesInRow = 0;
 }
 
@@ -225,15 +427,17 @@ SatOutputFileStreamDoubleContainer::GetGnuplotDataset ()
   ret.SetTitle (m_title);
   ret.SetStyle (m_style);
 
-  if (!m_container.empty ())
+  std::vector<std::vector<double> > rows = ReadFile (m_fileName, m_valuesInRow);
+
+  if (!rows.empty ())
     {
       switch (m_valuesInRow)
         {
         case 2:
           {
-            for (uint32_t i = 0; i < m_container.size (); i++)
+            for (uint32_t i = 0; i < rows.size (); i++)
               {
-                ret.Add (m_container[i].at (0), ConvertValue (m_container[i].at (1)));
+                ret.Add (rows[i].at (0), ConvertValue (rows[i].at (1)));
               }
             break;
           }
@@ -34,6 +34,19 @@ namespace ns3 {
  * \brief Class for output file stream container for double values.
  * The class implements storing the values and writing the stored
  * values into a file. A figure output in two dimensions is also supported.
+ *
+ * The values are kept in a buffer of BufferedRows rows, which is written
+ * into the file whenever it gets full, so that the memory used by the
+ * container does not grow with the length of the simulation.
+ *
+ * The file is written either as tab separated text, one row per line, or
+ * in a binary format selected with the OutputFormat attribute. The binary
+ * file starts with a header of the 8 byte magic "SATTRACE", the version and
+ * the number of values in a row as 32 bit unsigned integers. The header is
+ * followed by blocks of the 32 bit number of rows in the block, 32 bits of
+ * padding and the values of the block as 64 bit doubles, column after column.
+ * All the fields are in the byte order of the host. The files can be read
+ * with ReadFile or converted into text with ext-utils/readBinaryTrace.py.
  */
 class SatOutputFileStreamDoubleContainer : public Object
 {
@@ -45,6 +58,12 @@ public:
     DECIBEL_AMPLITUDE
   } FigureUnitConversion_t;
 
+  typedef enum
+  {
+    TEXT,
+    BINARY
+  } OutputFormat_t;
+
   /**
    * \brief NS-3 function for type id
    * \return type id
@@ -77,7 +96,34 @@ public:
   /**
    * \brief Function for adding the values to container
    */
-  void AddToContainer (std::vector<double> newItem);
+  void AddToContainer (const std::vector<double> &newItem);
+
+  /**
+   * \brief Function for adding the values of a row to container without
+   * creating a vector for them
+   * \param newItem values of the row
+   * \param valuesInRow number of values in newItem
+   */
+  void AddToContainer (const double *newItem, uint32_t valuesInRow);
+
+  /**
+   * \brief Function for checking whether rows can still be added, i.e. the
+   * container has not been written into the file yet
+   * \return true if rows can be added
+   */
+  bool IsWritable () const
+  {
+    return m_valuesInRow > 0;
+  }
+
+  /**
+   * \brief Function for reading the rows of a file written by the container
+   * in either format
+   * \param fileName file name
+   * \param valuesInRow number of values in a row
+   * \return rows of the file
+   */
+  static std::vector<std::vector<double> > ReadFile (std::string fileName, uint32_t valuesInRow);
 
   /**
    * \brief Do needed dispose actions
@@ -117,10 +163,22 @@ private:
   void ClearContainer ();
 
   /**
-   * \brief Function for opening the output file stream
+   * \brief Function for opening the output file stream and writing the
+   * header of the binary format
    */
   void OpenStream ();
 
+  /**
+   * \brief Function for closing the output file stream
+   */
+  void CloseStream ();
+
+  /**
+   * \brief Function for writing the buffered rows into the file and
+   * closing the output file stream
+   */
+  void FlushBuffer ();
+
   /**
    * \brief Function for printing the container contents into a figure
    */
@@ -156,9 +214,32 @@ private:
   std::ofstream* m_outputFileStream;
 
   /**
-   * \brief Container for value rows
+   * \brief Buffer for the values of the rows not yet written into the file,
+   * stored column after column
+   */
+  std::vector<double> m_buffer;
+
+  /**
+   * \brief Number of rows in the buffer
+   */
+  uint32_t m_rowsInBuffer;
+
+  /**
+   * \brief Number of rows the buffer holds, set by the BufferedRows attribute
    */
-  std::vector<std::vector<double> > m_container;
+  uint32_t m_bufferedRows;
+
+  /**
+   * \brief Number of rows the allocated buffer holds, taken from m_bufferedRows
+   * when the buffer is allocated so that later changes of the attribute do not
+   * change the layout of the buffered rows
+   */
+  uint32_t m_bufferCapacity;
+
+  /**
+   * \brief Format of the file
+   */
+  OutputFormat_t m_outputFormat;
 
   /**
    * \brief File name
@@ -170,6 +251,11 @@ private:
    */
   std::ios::openmode m_fileMode;
 
+  /**
+   * \brief Whether the file has been opened, later openings append to it
+   */
+  bool m_fileOpened;
+
   /**
    * \brief Number of values in a row
    */